@@ -26,6 +26,8 @@
 #include "CCDB/CcdbObjectInfo.h"
 #include "CCDB/CCDBDownloader.h"
 #include <CommonUtils/ConfigurableParam.h>
+#include "CommonUtils/MemFileHelper.h"
+#include "Framework/TypeTraits.h"
 #include <type_traits>
 #include <vector>
 
@@ -161,6 +163,41 @@ class CcdbApi //: public DatabaseInterface
     return storeAsTFile(rootobj, path, metadata, startValidityTimestamp, endValidityTimestamp, maxSize);
   }
 
+  /**
+   * Store a flat object (o2::gpu::FlatObject) as a flat image: the object and its flat buffer are
+   * stored as-is, such that consumers copy it with a pointer fix-up instead of the ROOT deserialisation.
+   * The image is read back by retrieveFromTFileAny (hence by BasicCCDBManager) and by the DPL CCDB inputs.
+   *
+   * @param obj The flat object to store.
+   * @param path The path where the object is going to be stored.
+   * @param metadata Key-values representing the metadata for this object.
+   * @param startValidityTimestamp Start of validity. If omitted, current timestamp is used.
+   * @param endValidityTimestamp End of validity. If omitted, current timestamp + 1 day is used.
+   * @return same as storeAsTFileAny
+   */
+  template <typename T>
+  int storeFlatObject(const T& obj, std::string const& path, std::map<std::string, std::string> const& metadata,
+                      long startValidityTimestamp = -1, long endValidityTimestamp = -1, std::vector<char>::size_type maxSize = 0 /*bytes*/) const
+  {
+    auto image = T::createFlatImage(obj);
+    auto className = o2::utils::MemFileHelper::getClassName(typeid(T));
+    return storeAsBinaryFile(image.data(), image.size(), generateFileName(className), className, path, metadata, startValidityTimestamp, endValidityTimestamp, maxSize);
+  }
+
+  /**
+   * Retrieve a flat object stored with storeFlatObject at the given path for the given timestamp.
+   * Same as retrieveFromTFileAny, which recognizes the flat images of the FlatObject types.
+   * @return the object owning its flat buffer, or nullptr if none was found or type does not match the stored one.
+   */
+  template <typename T>
+  T* retrieveFlatObject(std::string const& path, std::map<std::string, std::string> const& metadata,
+                        long timestamp = -1, std::map<std::string, std::string>* headers = nullptr, std::string const& etag = "",
+                        const std::string& createdNotAfter = "", const std::string& createdNotBefore = "") const
+  {
+    static_assert(o2::framework::is_flat_object<T>::value, "retrieveFlatObject needs a FlatObject type");
+    return retrieveFromTFileAny<T>(path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore);
+  }
+
   /**
    * Retrieve object at the given path for the given timestamp.
    *
@@ -171,6 +208,8 @@ class CcdbApi //: public DatabaseInterface
    * @param optional etag from previous call
    * @param optional createdNotAfter upper time limit for the object creation timestamp (TimeMachine mode)
    * @param optional createdNotBefore lower time limit for the object creation timestamp (TimeMachine mode)
+   * For the FlatObject types the flat images stored by storeFlatObject are recognized and copied to an object
+   * owning its buffer, other blobs are read as TFile.
    * @return the object, or nullptr if none were found or type does not match serialized type.
    */
   template <typename T>
@@ -351,6 +390,22 @@ class CcdbApi //: public DatabaseInterface
                         const std::string& createdNotAfter, const std::string& createdNotBefore, bool considerSnapshot = true) const;
   void navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL* curl_handle, std::string const& url, std::map<string, string>* headers) const;
 
+  /// one object of a batch loaded by vectoredLoadFileToMemory, the fields are the arguments of loadFileToMemory
+  struct RequestContext {
+    o2::pmr::vector<char>* dest = nullptr;
+    std::string path;
+    std::map<std::string, std::string> const* metadata = nullptr;
+    long timestamp = -1;
+    std::map<std::string, std::string>* headers = nullptr;
+    std::string etag;
+    std::string createdNotAfter;
+    std::string createdNotBefore;
+    bool considerSnapshot = true;
+  };
+  /// same as loadFileToMemory for many objects, the server requests are performed concurrently by the
+  /// multi-handle downloader instead of one after the other
+  void vectoredLoadFileToMemory(std::vector<RequestContext>& requests) const;
+
   // the failure to load the file to memory is signaled by 0 size and non-0 capacity
   static bool isMemoryFileInvalid(const o2::pmr::vector<char>& v) { return v.size() == 0 && v.capacity() > 0; }
   template <typename T>
@@ -574,6 +629,20 @@ typename std::enable_if<!std::is_base_of<o2::conf::ConfigurableParam, T>::value,
                                 long timestamp, std::map<std::string, std::string>* headers, std::string const& etag,
                                 const std::string& createdNotAfter, const std::string& createdNotBefore) const
 {
+#if !defined(__CINT__) && !defined(__MAKECINT__) && !defined(__ROOTCLING__) && !defined(__CLING__)
+  if constexpr (o2::framework::is_flat_object<T>::value) {
+    // the blob is either a flat image (storeFlatObject) or a TFile (storeAsTFileAny of the ROOT-streamed object)
+    o2::pmr::vector<char> blob;
+    loadFileToMemory(blob, path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore);
+    if (blob.empty()) {
+      return nullptr;
+    }
+    if (T::template isFlatImage<T>(blob.data(), blob.size())) {
+      return T::template cloneFlatImage<T>(blob.data(), blob.size());
+    }
+    return extractFromMemoryBlob<T>(blob);
+  }
+#endif
   return static_cast<T*>(retrieveFromTFile(typeid(T), path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore));
 }
 
@@ -24,6 +24,7 @@
 #include "Framework/DefaultsHelpers.h"
 #include "Framework/DataTakingContext.h"
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <sstream>
 #include <TFile.h>
@@ -566,6 +567,39 @@ size_t header_map_callback(char* buffer, size_t size, size_t nitems, void* userd
   }
   return size * nitems;
 }
+
+// destination of a transfer to memory and headers of the response
+struct HeaderObjectPair_t {
+  std::map<std::string, std::string> header;
+  o2::pmr::vector<char>* object = nullptr;
+  int counter = 0;
+};
+
+size_t writeToMemoryCallback(void* contents, size_t size, size_t nmemb, void* chunkptr)
+{
+  auto& ho = *static_cast<HeaderObjectPair_t*>(chunkptr);
+  auto& chunk = *ho.object;
+  size_t realsize = size * nmemb, sz = 0;
+  ho.counter++;
+  try {
+    if (chunk.capacity() < chunk.size() + realsize) {
+      auto cl = ho.header.find("Content-Length");
+      if (cl != ho.header.end()) {
+        sz = std::max(chunk.size() + realsize, (size_t)std::stol(cl->second));
+      } else {
+        sz = chunk.size() + realsize;
+        LOGP(debug, "SIZE IS NOT IN HEADER, allocate {}", sz);
+      }
+      chunk.reserve(sz);
+    }
+    char* contC = (char*)contents;
+    chunk.insert(chunk.end(), contC, contC + realsize);
+  } catch (std::exception e) {
+    LOGP(alarm, "failed to reserve {} bytes in CURL write callback (realsize = {}): {}", sz, realsize, e.what());
+    realsize = 0;
+  }
+  return realsize;
+}
 } // namespace
 
 void CcdbApi::initCurlHTTPHeaderOptionsForRetrieve(CURL* curlHandle, curl_slist*& option_list, long timestamp, std::map<std::string, std::string>* headers, std::string const& etag,
@@ -1584,11 +1618,7 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
     return loadFileToMemory(dest, url, nullptr); // headers loaded from the file in case of the snapshot reading only
   }
   // otherwise make an HTTP/CURL request
-  struct HeaderObjectPair_t {
-    std::map<std::string, std::string> header;
-    o2::pmr::vector<char>* object = nullptr;
-    int counter = 0;
-  } hoPair{{}, &dest, 0};
+  HeaderObjectPair_t hoPair{{}, &dest, 0};
 
   bool errorflag = false;
   auto signalError = [&chunk = dest, &errorflag]() {
@@ -1596,34 +1626,9 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
     chunk.reserve(1);
     errorflag = true;
   };
-  auto writeCallBack = [](void* contents, size_t size, size_t nmemb, void* chunkptr) {
-    auto& ho = *static_cast<HeaderObjectPair_t*>(chunkptr);
-    auto& chunk = *ho.object;
-    size_t realsize = size * nmemb, sz = 0;
-    ho.counter++;
-    try {
-      if (chunk.capacity() < chunk.size() + realsize) {
-        auto cl = ho.header.find("Content-Length");
-        if (cl != ho.header.end()) {
-          sz = std::max(chunk.size() + realsize, (size_t)std::stol(cl->second));
-        } else {
-          sz = chunk.size() + realsize;
-          LOGP(debug, "SIZE IS NOT IN HEADER, allocate {}", sz);
-        }
-        chunk.reserve(sz);
-      }
-      char* contC = (char*)contents;
-      chunk.insert(chunk.end(), contC, contC + realsize);
-    } catch (std::exception e) {
-      LOGP(alarm, "failed to reserve {} bytes in CURL write callback (realsize = {}): {}", sz, realsize, e.what());
-      realsize = 0;
-    }
-    return realsize;
-  };
-
   // specify URL to get
   curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-  initCurlOptionsForRetrieve(curl_handle, (void*)&hoPair, writeCallBack, false);
+  initCurlOptionsForRetrieve(curl_handle, (void*)&hoPair, writeToMemoryCallback, false);
   curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(hoPair.header)>);
   hoPair.header.clear();
   curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, (void*)&hoPair.header);
@@ -1698,6 +1703,154 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
   return;
 }
 
+void CcdbApi::vectoredLoadFileToMemory(std::vector<RequestContext>& requests) const
+{
+  // Same as loadFileToMemory for a batch of objects: the server requests of all objects are performed together by
+  // the multi-handle downloader, the redirections being followed in the subsequent rounds. The requests involving
+  // the snapshots (reading, creation or the semaphores protecting it) are processed one by one by loadFileToMemory
+  struct Transfer {
+    RequestContext* request = nullptr;
+    CURL* handle = nullptr;
+    curl_slist* options = nullptr;
+    std::deque<std::string> urls; // locations still to try, those from a redirection come first
+    HeaderObjectPair_t hoPair;
+    int attempts = 0; // performed requests of the first location, retried as CURL_perform does
+    bool error = false;
+  };
+  std::vector<Transfer> transfers;
+  transfers.reserve(requests.size());
+  for (auto& request : requests) {
+    bool snapshot = mInSnapshotMode || (request.considerSnapshot && !mSnapshotCachePath.empty()) ||
+                    (mPreferSnapshotCache && std::filesystem::exists(getSnapshotFile(mSnapshotCachePath, request.path)));
+    if (snapshot) {
+      loadFileToMemory(*request.dest, request.path, *request.metadata, request.timestamp, request.headers, request.etag,
+                       request.createdNotAfter, request.createdNotBefore, request.considerSnapshot);
+      continue;
+    }
+    LOGP(debug, "vectoredLoadFileToMemory {} ETag=[{}]", request.path, request.etag);
+    auto& transfer = transfers.emplace_back();
+    transfer.request = &request;
+    transfer.handle = curl_easy_init();
+    curl_easy_setopt(transfer.handle, CURLOPT_USERAGENT, mUniqueAgentID.c_str());
+    transfer.urls.push_back(getFullUrlForRetrieval(transfer.handle, request.path, *request.metadata, request.timestamp));
+    initCurlHTTPHeaderOptionsForRetrieve(transfer.handle, transfer.options, request.timestamp, request.headers, request.etag,
+                                         request.createdNotAfter, request.createdNotBefore);
+    transfer.hoPair.object = request.dest;
+  }
+  if (transfers.empty()) {
+    return;
+  }
+  if (!mDownloader) { // the multi-handle downloader is used for the batches even if it is not enabled for the single requests
+    mDownloader = new CCDBDownloader();
+  }
+
+  std::vector<Transfer*> active;
+  std::vector<CURL*> handles;
+  while (true) {
+    active.clear();
+    handles.clear();
+    for (auto& transfer : transfers) {
+      auto& dest = *transfer.request->dest;
+      while (dest.empty() && !transfer.urls.empty() && transfer.urls.front().find("alien:/", 0) != std::string::npos) {
+        loadFileToMemory(dest, transfer.urls.front(), nullptr); // curl cannot handle it
+        transfer.urls.pop_front();
+      }
+      if (!dest.empty() || transfer.urls.empty()) {
+        continue;
+      }
+      curl_easy_setopt(transfer.handle, CURLOPT_URL, transfer.urls.front().c_str());
+      initCurlOptionsForRetrieve(transfer.handle, (void*)&transfer.hoPair, writeToMemoryCallback, false);
+      curl_easy_setopt(transfer.handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(transfer.hoPair.header)>);
+      transfer.hoPair.header.clear();
+      curl_easy_setopt(transfer.handle, CURLOPT_HEADERDATA, (void*)&transfer.hoPair.header);
+      curlSetSSLOptions(transfer.handle);
+      active.push_back(&transfer);
+      handles.push_back(transfer.handle);
+    }
+    if (active.empty()) {
+      break;
+    }
+    auto results = mDownloader->batchBlockingPerform(handles);
+    int retryAttempts = 0; // largest attempt number of the transfers to retry, for the backoff
+    for (size_t i = 0; i < active.size(); i++) {
+      auto& transfer = *active[i];
+      auto& dest = *transfer.request->dest;
+      auto* headers = transfer.request->headers;
+      if (results[i] != CURLE_OK && ++transfer.attempts < mCurlRetries) {
+        retryAttempts = std::max(retryAttempts, transfer.attempts);
+        dest.clear(); // drop what a broken transfer may have written
+        continue; // the same location is requested again in the next round
+      }
+      transfer.attempts = 0;
+      auto url = std::move(transfer.urls.front());
+      transfer.urls.pop_front();
+      long response_code = -1;
+      bool failed = false;
+      if (results[i] == CURLE_OK && curl_easy_getinfo(transfer.handle, CURLINFO_RESPONSE_CODE, &response_code) == CURLE_OK) {
+        if (headers) {
+          for (auto& p : transfer.hoPair.header) {
+            (*headers)[p.first] = p.second;
+          }
+        }
+        if (response_code == 304) {
+          LOGP(debug, "Object exists but I am not serving it since it's already in your possession");
+        } else if (300 <= response_code && response_code < 400) {
+          // the locations are tried in order of appearance, before those remaining from a previous redirection
+          std::vector<std::string> locs;
+          auto iter = transfer.hoPair.header.find("Location");
+          if (iter != transfer.hoPair.header.end()) {
+            locs.push_back(iter->second[0] == '/' ? getURL() + iter->second : iter->second);
+          }
+          auto range = transfer.hoPair.header.equal_range("Content-Location");
+          for (auto it = range.first; it != range.second; ++it) {
+            if (std::find(locs.begin(), locs.end(), it->second) == locs.end()) {
+              locs.push_back(it->second[0] == '/' ? getURL() + it->second : it->second);
+            }
+          }
+          for (auto it = locs.rbegin(); it != locs.rend(); ++it) {
+            if (it->size() > 0) {
+              transfer.urls.push_front(*it);
+            }
+          }
+        } else if (response_code == 404) {
+          LOG(error) << "Requested resource does not exist: " << url;
+          failed = true;
+        } else if (response_code < 200 || response_code >= 300) {
+          LOG(error) << "Error in fetching object " << url << ", curl response code:" << response_code;
+          failed = true;
+        }
+      } else {
+        LOGP(alarm, "Curl request to {} failed with result {}, response code: {}", url, int(results[i]), response_code);
+        failed = true;
+      }
+      if (failed) { // signal the error as navigateURLsAndLoadFileToMemory does
+        dest.clear();
+        dest.reserve(1);
+        transfer.error = true;
+      }
+    }
+    if (retryAttempts) {
+      usleep(mCurlDelayRetries * retryAttempts);
+    }
+  }
+
+  for (auto& transfer : transfers) {
+    auto& request = *transfer.request;
+    if (transfer.error && request.headers) {
+      (*request.headers)["Error"] = "An error occurred during retrieval";
+    }
+    for (size_t hostIndex = 1; hostIndex < hostsPool.size() && isMemoryFileInvalid(*request.dest); hostIndex++) {
+      auto fullUrl = getFullUrlForRetrieval(transfer.handle, request.path, *request.metadata, request.timestamp, hostIndex);
+      loadFileToMemory(*request.dest, fullUrl, request.headers); // headers loaded from the file in case of the snapshot reading only
+    }
+    curl_slist_free_all(transfer.options);
+    curl_easy_cleanup(transfer.handle);
+    if (!request.dest->empty()) {
+      logReading(request.path, request.timestamp, request.headers, request.considerSnapshot ? "load to memory" : "retrieve");
+    }
+  }
+}
+
 void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, const std::string& path, std::map<std::string, std::string>* localHeaders) const
 {
   // Read file to memory as vector. For special case of the locally cached file retriev metadata stored directly in the file
@@ -553,3 +553,53 @@ BOOST_AUTO_TEST_CASE(TestUpdateMetadata, *utf::precondition(if_reachable()))
   BOOST_CHECK(headers.count("custom") > 0);
   BOOST_CHECK(headers.at("custom") == "second");
 }
+
+BOOST_AUTO_TEST_CASE(TestVectoredLoadFileToMemory, *utf::precondition(if_reachable()))
+{
+  test_fixture f;
+
+  TH1F h1("object1", "object1", 100, 0, 99);
+  h1.FillRandom("gaus", 1000);
+  f.api.storeAsTFile(&h1, basePath + "Vectored/1", f.metadata);
+  TH1F h2("object2", "object2", 10, 0, 9);
+  f.api.storeAsTFile(&h2, basePath + "Vectored/2", f.metadata);
+
+  std::vector<std::string> paths{basePath + "Vectored/1", basePath + "Vectored/2", basePath + "Vectored/Wrong"};
+  std::vector<o2::pmr::vector<char>> blobs(paths.size());
+  std::vector<std::map<std::string, std::string>> headers(paths.size());
+  std::map<std::string, std::string> metadata;
+  std::vector<CcdbApi::RequestContext> requests(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    requests[i].dest = &blobs[i];
+    requests[i].path = paths[i];
+    requests[i].metadata = &metadata;
+    requests[i].headers = &headers[i];
+  }
+  f.api.vectoredLoadFileToMemory(requests);
+
+  // same objects and headers as with the serial loading
+  for (size_t i = 0; i < 2; i++) {
+    o2::pmr::vector<char> blob;
+    std::map<std::string, std::string> serialHeaders;
+    f.api.loadFileToMemory(blob, paths[i], metadata, -1, &serialHeaders, "", "", "");
+    BOOST_CHECK(!blobs[i].empty());
+    BOOST_CHECK(blobs[i] == blob);
+    BOOST_CHECK_EQUAL(headers[i]["ETag"], serialHeaders["ETag"]);
+    BOOST_CHECK(headers[i].count("Error") == 0);
+  }
+  BOOST_CHECK(blobs[2].empty());
+  BOOST_CHECK(headers[2].count("Error") == 1);
+
+  // the validity check with the ETag of the object in possession does not transfer it again
+  requests.resize(2);
+  for (size_t i = 0; i < 2; i++) {
+    requests[i].etag = headers[i]["ETag"];
+    blobs[i].clear();
+    headers[i].clear();
+  }
+  f.api.vectoredLoadFileToMemory(requests);
+  for (size_t i = 0; i < 2; i++) {
+    BOOST_CHECK(blobs[i].empty());
+    BOOST_CHECK(headers[i].count("Error") == 0);
+  }
+}
@@ -22,6 +22,8 @@
 #if defined(DEBUG_STREAMER)
 #include "CommonUtils/TreeStreamRedirector.h"
 #include <tbb/concurrent_unordered_map.h>
+#include <memory>
+#include <mutex>
 #endif
 #endif
 
@@ -63,6 +65,7 @@ struct ParameterDebugStreamer : public o2::conf::ConfigurableParamHelper<Paramet
   SamplingTypes samplingType[StreamFlags::streamFlagsCount]{};                                    ///< sampling type for each streamer (default = SamplingTypes::sampleAll)
   float samplingFrequency[StreamFlags::streamFlagsCount]{0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1}; ///< frequency which is used for the sampling (0.1 -> 10% is written if sampling is used)
   int sampleIDGlobal[StreamFlags::streamFlagsCount]{};                                            ///< storage of reference streamer used for sampleIDFromOtherStreamer
+  int asyncBufferSizeMB{0};                                                                       ///< size of the buffer of each streamer in asynchronous mode, in which the trees are filled by a background thread (0: synchronous streaming)
   O2ParamDef(ParameterDebugStreamer, "DebugStreamerParam");
 };
 
@@ -101,6 +104,9 @@ class DebugStreamer
   /// flush all TTrees to disc
   void flush();
 
+  /// \return returns number of rows dropped by all streamers in asynchronous mode since their buffer was full
+  uint64_t getNDropped() const;
+
   /// \return returns streamer object for given id
   /// \param id unique id of streamer
   o2::utils::TreeStreamRedirector& getStreamer(const size_t id = getCPUID()) { return *(mTreeStreamer[id]); }
@@ -159,6 +165,9 @@ class DebugStreamer
   using StreamersPerFlag = tbb::concurrent_unordered_map<size_t, std::unique_ptr<o2::utils::TreeStreamRedirector>>;
   StreamersPerFlag mTreeStreamer; ///< streamer which is used for the debugging
 
+  std::shared_ptr<o2::utils::TreeStreamAsyncWriter> mAsyncWriter; ///< thread filling the trees of all the streamers in asynchronous mode
+  std::once_flag mAsyncWriterFlag;                                ///< creation of the writer
+
 #else
 
   // empty implementation of the class for GPU or when the debug streamer is not build for CPU
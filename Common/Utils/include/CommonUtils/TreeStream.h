@@ -16,8 +16,10 @@
 #ifndef ALICEO2_TREESTREAM_H
 #define ALICEO2_TREESTREAM_H
 
+#include <TBufferFile.h>
 #include <TString.h>
 #include <TTree.h>
+#include <memory>
 #include <vector>
 #include "GPUCommonDef.h"
 
@@ -29,6 +31,8 @@ namespace o2
 {
 namespace utils
 {
+class TreeStreamRing;
+
 /// The TreeStream class allows creating a root tree of any objects having root
 /// dictionary, using operator<< interface, and w/o prior tree declaration.
 /// The format is:
@@ -49,11 +53,14 @@ class TreeStream
     std::string name;            ///< name of the element
   };
 
+  static constexpr uint32_t kNullObject = 0xffffffff; ///< length of a null object in the serialised row
+
   TreeStream(const char* treename);
   TreeStream() = default;
   virtual ~TreeStream() = default;
   void Close() { mTree.Write(); }
   Int_t CheckIn(Char_t type, const void* pointer);
+  Int_t CheckIn(const TClass* cls, const void* obj);
   void BuildTree();
   void Fill();
   Double_t getSize() { return mTree.GetZipBytes(); }
@@ -63,6 +70,15 @@ class TreeStream
   const char* getName() const { return mTree.GetName(); }
   void setID(int id) { mID = id; }
   int getID() const { return mID; }
+
+  /// in asynchronous mode the rows are serialised in the ring and filled into the tree of
+  /// the redirector on the writer thread, the own tree stays empty
+  void setAsync(TreeStreamRing* ring, int index);
+  bool isAsync() const { return mRing != nullptr; }
+
+  /// size in bytes of the data of the elementary type
+  static int getTypeSize(Char_t type);
+
   TreeStream& operator<<(const Bool_t& b)
   {
     CheckIn('B', &b);
@@ -161,6 +177,8 @@ class TreeStream
   Int_t CheckIn(const T* obj);
 
  private:
+  void Publish();
+
   //
   std::vector<TreeDataElement> mElements;
   std::vector<TBranch*> mBranches; ///< pointers to branches
@@ -171,6 +189,13 @@ class TreeStream
   int mStatus = 0;                 ///< status of the layout
   TString mNextName;               ///< name for next entry
 
+  TreeStreamRing* mRing = nullptr;            ///< ring buffer of the asynchronous mode
+  int mAsyncIndex = -1;                       ///< index of the layout in the asynchronous mode
+  bool mAnnounced = false;                    ///< the writer knows the layout
+  size_t mNPublished = 0;                     ///< number of elements described to the writer
+  std::vector<char> mRecord;                  ///< serialised row
+  std::unique_ptr<TBufferFile> mObjectBuffer; ///< streaming buffer of the objects
+
   ClassDefNV(TreeStream, 0);
 };
 
@@ -182,35 +207,7 @@ Int_t TreeStream::CheckIn(const T* obj)
   if (obj) {
     pClass = TClass::GetClass(typeid(*obj));
   }
-
-  if (mCurrentIndex >= static_cast<int>(mElements.size())) {
-    mElements.emplace_back();
-    auto& element = mElements.back();
-    element.cls = pClass;
-    TString name = mNextName;
-    if (name.Length()) {
-      if (mNextNameCounter > 0) {
-        name += mNextNameCounter;
-      }
-    } else {
-      name = TString::Format("B%d", static_cast<int>(mElements.size()));
-    }
-    element.name = name.Data();
-    element.ptr = obj;
-  } else {
-    auto& element = mElements[mCurrentIndex];
-    if (!element.cls) {
-      element.cls = pClass;
-    } else {
-      if (element.cls != pClass && pClass) {
-        mStatus++;
-        return 1; // mismatched data element
-      }
-    }
-    element.ptr = obj;
-  }
-  mCurrentIndex++;
-  return 0;
+  return CheckIn(pClass, obj);
 }
 
 } // namespace utils
@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TreeStreamAsyncWriter.h
+/// \brief Background filling of the trees of TreeStreamRedirector objects
+
+#ifndef ALICEO2_TREESTREAMASYNCWRITER_H
+#define ALICEO2_TREESTREAMASYNCWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+namespace utils
+{
+class TreeStreamRedirector;
+
+/// Lock-free single-producer single-consumer ring buffer of variable size records.
+/// The memory is allocated once, a record which does not fit into the free space
+/// is dropped and counted: the producer never blocks and never allocates.
+/// Records are 8-byte aligned and never wrap around the end of the buffer,
+/// the remaining space is skipped with a padding marker instead.
+class TreeStreamRing
+{
+ public:
+  explicit TreeStreamRing(size_t capacity);
+
+  /// copy the record into the ring, returns false if it was dropped
+  bool push(const char* data, uint32_t size);
+
+  /// pass the records available to f(const char* data, uint32_t size), returns their number
+  template <typename F>
+  size_t consume(F&& f);
+
+  size_t getCapacity() const { return mCapacity; }
+  uint64_t getNDropped() const { return mNDropped.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr uint32_t Padding = 0xffffffff;
+  static constexpr size_t HeaderSize = 2 * sizeof(uint32_t); ///< space taken by the record and the payload sizes
+
+  std::unique_ptr<uint64_t[]> mData;
+  size_t mCapacity = 0;                     ///< size of the buffer in bytes
+  alignas(64) std::atomic<size_t> mHead{0}; ///< written bytes, updated by the producer
+  alignas(64) std::atomic<size_t> mTail{0}; ///< consumed bytes, updated by the consumer
+  std::atomic<uint64_t> mNDropped{0};       ///< records which did not fit
+};
+
+template <typename F>
+size_t TreeStreamRing::consume(F&& f)
+{
+  const auto* base = reinterpret_cast<const char*>(mData.get());
+  const size_t head = mHead.load(std::memory_order_acquire);
+  size_t tail = mTail.load(std::memory_order_relaxed);
+  size_t nRecords = 0;
+  while (tail != head) {
+    const size_t pos = tail % mCapacity;
+    uint32_t header[2];
+    std::memcpy(header, base + pos, HeaderSize);
+    if (header[0] == Padding) {
+      tail += mCapacity - pos;
+    } else {
+      f(base + pos + HeaderSize, header[1]);
+      tail += header[0];
+      nRecords++;
+    }
+    mTail.store(tail, std::memory_order_release); // free the space as early as possible
+  }
+  return nRecords;
+}
+
+/// Thread filling and compressing the trees of the TreeStreamRedirector objects in asynchronous mode.
+/// The rows streamed on the producer threads are serialised in the ring buffer of their redirector,
+/// this thread deserialises them into the trees, such that TTree::Fill and the compression
+/// do not run on the producer threads. One writer can serve many redirectors.
+class TreeStreamAsyncWriter
+{
+ public:
+  TreeStreamAsyncWriter();
+  ~TreeStreamAsyncWriter();
+  TreeStreamAsyncWriter(const TreeStreamAsyncWriter&) = delete;
+  TreeStreamAsyncWriter& operator=(const TreeStreamAsyncWriter&) = delete;
+
+  /// start serving the redirector
+  void attach(TreeStreamRedirector* redirector);
+
+  /// fill all the pending rows of the redirector and stop serving it
+  void detach(TreeStreamRedirector* redirector);
+
+ private:
+  void run();
+  size_t fillPending();
+
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::vector<TreeStreamRedirector*> mRedirectors;
+  bool mStop = false;
+  std::thread mThread;
+};
+
+} // namespace utils
+} // namespace o2
+
+#endif
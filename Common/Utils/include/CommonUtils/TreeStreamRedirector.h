@@ -18,7 +18,11 @@
 
 #include <Rtypes.h>
 #include <TDirectory.h>
+#include <deque>
+#include <memory>
+#include <string>
 #include "CommonUtils/TreeStream.h"
+#include "CommonUtils/TreeStreamAsyncWriter.h"
 
 namespace o2
 {
@@ -36,6 +40,11 @@ namespace utils
 /// The flushing of trees to the file happens on TreeStreamRedirector::Close() call
 /// or at its desctruction.
 ///
+/// In asynchronous mode (see SetAsync) the streamed rows are serialised into a bounded
+/// ring buffer and the trees are filled and compressed by a TreeStreamAsyncWriter thread.
+/// The redirector must then be used by a single thread, rows which do not fit into
+/// the buffer are dropped and counted.
+///
 /// See testTreeStream.cxx for functional example
 ///
 class TreeStreamRedirector
@@ -52,7 +61,38 @@ class TreeStreamRedirector
   void SetFile(TFile* sfile);
   static void FixLeafNameBug(TTree* tree);
 
+  /// switch to asynchronous mode, to be called before anything is streamed
+  /// \param bufferSize size in bytes of the ring buffer of the serialised rows
+  /// \param writer writer thread (can be shared between redirectors), a new one is started if null
+  void SetAsync(size_t bufferSize, std::shared_ptr<TreeStreamAsyncWriter> writer = nullptr);
+  bool IsAsync() const { return mRing != nullptr; }
+
+  /// number of rows dropped in asynchronous mode because the buffer was full
+  uint64_t GetNDropped() const { return mRing ? mRing->getNDropped() : 0; }
+
+  /// fill the rows pending in asynchronous mode into the trees, called by the writer thread
+  size_t FillPending();
+
  private:
+  /// storage of a data element on the writer side
+  struct AsyncElement {
+    Char_t type = 0;        // elementary type
+    TClass* cls = nullptr;  // class of the object
+    std::string name;       // branch name
+    uint64_t value = 0;     // storage of the elementary type
+    void* object = nullptr; // storage of the object
+  };
+  /// tree filled by the writer thread for one data layout
+  struct AsyncLayout {
+    ~AsyncLayout();
+    std::deque<AsyncElement> elements; // stable addresses for the branches
+    std::unique_ptr<TreeStream> stream;
+    size_t nNamed = 0; // elements whose name was passed to the stream
+  };
+
+  TreeStream& AddLayout(const char* name, Int_t id);
+  void Replay(const char* data);
+
   TreeStreamRedirector(const TreeStreamRedirector& tsr);
   TreeStreamRedirector& operator=(const TreeStreamRedirector& tsr);
 
@@ -60,6 +100,11 @@ class TreeStreamRedirector
   TDirectory* mDirectory = nullptr;                      // output directory
   std::vector<std::unique_ptr<TreeStream>> mDataLayouts; // array of data layouts
 
+  std::unique_ptr<TreeStreamRing> mRing;                   // serialised rows in asynchronous mode
+  std::shared_ptr<TreeStreamAsyncWriter> mAsyncWriter;     // thread filling the trees in asynchronous mode
+  std::vector<std::unique_ptr<AsyncLayout>> mAsyncLayouts; // trees filled by the writer thread, per data layout
+  std::unique_ptr<TBufferFile> mReadBuffer;                // buffer to deserialise the objects
+
   ClassDefNV(TreeStreamRedirector, 0);
 };
 } // namespace utils
@@ -31,7 +31,13 @@ o2::utils::DebugStreamer::DebugStreamer()
 void o2::utils::DebugStreamer::setStreamer(const char* outFile, const char* option, const size_t id)
 {
   if (!isStreamerSet(id)) {
-    mTreeStreamer[id] = std::make_unique<o2::utils::TreeStreamRedirector>(fmt::format("{}_{}.root", outFile, id).data(), option);
+    auto streamer = std::make_unique<o2::utils::TreeStreamRedirector>(fmt::format("{}_{}.root", outFile, id).data(), option);
+    if (const int bufferSizeMB = ParameterDebugStreamer::Instance().asyncBufferSizeMB; bufferSizeMB > 0) {
+      // one ring buffer per thread, one writer thread for all of them
+      std::call_once(mAsyncWriterFlag, [this]() { mAsyncWriter = std::make_shared<o2::utils::TreeStreamAsyncWriter>(); });
+      streamer->SetAsync(size_t(bufferSizeMB) << 20, mAsyncWriter);
+    }
+    mTreeStreamer[id] = std::move(streamer);
   }
 }
 
@@ -55,6 +61,15 @@ void o2::utils::DebugStreamer::flush()
   }
 }
 
+uint64_t o2::utils::DebugStreamer::getNDropped() const
+{
+  uint64_t nDropped = 0;
+  for (const auto& pair : mTreeStreamer) {
+    nDropped += pair.second ? pair.second->GetNDropped() : 0;
+  }
+  return nDropped;
+}
+
 bool o2::utils::DebugStreamer::checkStream(const StreamFlags streamFlag, const size_t samplingID)
 {
   const bool isStreamerSet = ((getStreamFlags() & streamFlag) == streamFlag);
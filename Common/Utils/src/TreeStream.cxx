@@ -12,7 +12,11 @@
 //  For the functionality of TreeStream see the testTreeStream.cxx
 
 #include "CommonUtils/TreeStream.h"
+#include "CommonUtils/TreeStreamAsyncWriter.h"
 #include <TBranch.h>
+#include <TClass.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace o2::utils;
 
@@ -54,6 +58,78 @@ int TreeStream::CheckIn(Char_t type, const void* pointer)
   return 0;
 }
 
+//_________________________________________________
+int TreeStream::CheckIn(const TClass* cls, const void* obj)
+{
+  // Insert object of the class (nullptr if the pointer is null)
+
+  if (mCurrentIndex >= static_cast<int>(mElements.size())) {
+    mElements.emplace_back();
+    auto& element = mElements.back();
+    element.cls = cls;
+    TString name = mNextName;
+    if (name.Length()) {
+      if (mNextNameCounter > 0) {
+        name += mNextNameCounter;
+      }
+    } else {
+      name = TString::Format("B%d", static_cast<int>(mElements.size()));
+    }
+    element.name = name.Data();
+    element.ptr = obj;
+  } else {
+    auto& element = mElements[mCurrentIndex];
+    if (!element.cls) {
+      element.cls = cls;
+    } else {
+      if (element.cls != cls && cls) {
+        mStatus++;
+        return 1; // mismatched data element
+      }
+    }
+    element.ptr = obj;
+  }
+  mCurrentIndex++;
+  return 0;
+}
+
+//_________________________________________________
+void TreeStream::setAsync(TreeStreamRing* ring, int index)
+{
+  // Serialise the rows in the ring instead of filling the tree
+
+  mRing = ring;
+  mAsyncIndex = index;
+  mAnnounced = false;
+  mNPublished = 0;
+  if (mRing && !mObjectBuffer) {
+    mObjectBuffer = std::make_unique<TBufferFile>(TBuffer::kWrite);
+  }
+}
+
+//_________________________________________________
+int TreeStream::getTypeSize(Char_t type)
+{
+  switch (type) {
+    case 'B':
+    case 'b':
+      return 1;
+    case 'S':
+    case 's':
+      return 2;
+    case 'I':
+    case 'i':
+    case 'F':
+      return 4;
+    case 'L':
+    case 'l':
+    case 'D':
+      return 8;
+    default:
+      return 0;
+  }
+}
+
 //_________________________________________________
 void TreeStream::BuildTree()
 {
@@ -135,15 +211,82 @@ TreeStream& TreeStream::Endl()
 {
   // Perform pseudo endl operation
 
-  if (mTree.GetNbranches() == 0) {
-    BuildTree();
+  if (mRing) {
+    Publish();
+  } else {
+    if (mTree.GetNbranches() == 0) {
+      BuildTree();
+    }
+    Fill();
   }
-  Fill();
   mStatus = 0;
   mCurrentIndex = 0;
   return *this;
 }
 
+//_________________________________________________
+void TreeStream::Publish()
+{
+  // Serialise the checked-in elements of the row and pass them to the writer thread.
+  // Record: uint32_t layout index, announcement flag, index of the first new element, number of elements,
+  //         [tree name], description of the new elements (type, name, class name), data of all elements.
+  // Strings and streamed objects are preceded by their uint32_t length, null objects (or objects w/o dictionary)
+  // have length kNullObject.
+
+  if (mStatus) {
+    return; // mismatched data element, not filled in the synchronous mode either
+  }
+  const uint32_t nElements = mCurrentIndex;
+  const uint32_t firstNew = std::min<size_t>(mNPublished, nElements);
+  mRecord.clear();
+  auto put = [this](const void* data, size_t size) {
+    auto* bytes = static_cast<const char*>(data);
+    mRecord.insert(mRecord.end(), bytes, bytes + size);
+  };
+  auto putString = [&put](const char* str, uint32_t length) {
+    put(&length, sizeof(length));
+    put(str, length);
+  };
+  const uint32_t header[4] = {uint32_t(mAsyncIndex), uint32_t(!mAnnounced), firstNew, nElements};
+  put(header, sizeof(header));
+  if (!mAnnounced) {
+    putString(getName(), std::strlen(getName()));
+  }
+  for (uint32_t i = firstNew; i < nElements; i++) {
+    const auto& element = mElements[i];
+    put(&element.type, sizeof(element.type));
+    putString(element.name.data(), element.name.size());
+    const char* clsName = element.cls ? element.cls->GetName() : "";
+    putString(clsName, std::strlen(clsName));
+  }
+  for (uint32_t i = 0; i < nElements; i++) {
+    const auto& element = mElements[i];
+    if (element.type > 0) {
+      put(element.ptr, getTypeSize(element.type));
+    } else {
+      uint32_t length = kNullObject;
+      if (element.cls && element.ptr) {
+        mObjectBuffer->Reset();
+        const_cast<TClass*>(element.cls)->Streamer(const_cast<void*>(element.ptr), *mObjectBuffer);
+        length = mObjectBuffer->Length();
+      }
+      put(&length, sizeof(length));
+      if (length != kNullObject) {
+        put(mObjectBuffer->Buffer(), length);
+      }
+    }
+  }
+  if (mRing->push(mRecord.data(), mRecord.size())) {
+    mAnnounced = true;
+    // objects streamed so far only as null pointers are described again once their class is known
+    for (mNPublished = firstNew; mNPublished < nElements; mNPublished++) {
+      if (!mElements[mNPublished].type && !mElements[mNPublished].cls) {
+        break;
+      }
+    }
+  }
+}
+
 //_________________________________________________
 TreeStream& TreeStream::operator<<(const Char_t* name)
 {
@@ -154,7 +297,7 @@ TreeStream& TreeStream::operator<<(const Char_t* name)
   }
   //
   // if tree was already defined ignore
-  if (mTree.GetEntries() > 0) {
+  if (mTree.GetEntries() > 0 || mAnnounced) {
     return *this;
   }
   // check branch name if tree was not
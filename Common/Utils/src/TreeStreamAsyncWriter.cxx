@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "CommonUtils/TreeStreamAsyncWriter.h"
+#include "CommonUtils/TreeStreamRedirector.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace o2::utils;
+
+//_________________________________________________
+TreeStreamRing::TreeStreamRing(size_t capacity)
+{
+  mCapacity = std::max<size_t>((capacity + 7) & ~size_t(7), 64);
+  mData = std::make_unique<uint64_t[]>(mCapacity / sizeof(uint64_t));
+}
+
+//_________________________________________________
+bool TreeStreamRing::push(const char* data, uint32_t size)
+{
+  const size_t length = HeaderSize + ((size_t(size) + 7) & ~size_t(7));
+  const size_t head = mHead.load(std::memory_order_relaxed);
+  const size_t pos = head % mCapacity;
+  const size_t contiguous = mCapacity - pos;
+  const size_t needed = contiguous < length ? contiguous + length : length;
+  if (needed > mCapacity - (head - mTail.load(std::memory_order_acquire))) {
+    mNDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  auto* base = reinterpret_cast<char*>(mData.get());
+  size_t start = pos;
+  if (contiguous < length) { // positions are 8-byte aligned, there is always space for the marker
+    const uint32_t padding = Padding;
+    std::memcpy(base + pos, &padding, sizeof(padding));
+    start = 0;
+  }
+  const uint32_t header[2] = {uint32_t(length), size};
+  std::memcpy(base + start, header, HeaderSize);
+  std::memcpy(base + start + HeaderSize, data, size);
+  mHead.store(head + needed, std::memory_order_release);
+  return true;
+}
+
+//_________________________________________________
+TreeStreamAsyncWriter::TreeStreamAsyncWriter() : mThread([this]() { run(); })
+{
+}
+
+//_________________________________________________
+TreeStreamAsyncWriter::~TreeStreamAsyncWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCondition.notify_one();
+  mThread.join();
+}
+
+//_________________________________________________
+void TreeStreamAsyncWriter::attach(TreeStreamRedirector* redirector)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (std::find(mRedirectors.begin(), mRedirectors.end(), redirector) == mRedirectors.end()) {
+    mRedirectors.push_back(redirector);
+  }
+}
+
+//_________________________________________________
+void TreeStreamAsyncWriter::detach(TreeStreamRedirector* redirector)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto it = std::find(mRedirectors.begin(), mRedirectors.end(), redirector);
+  if (it != mRedirectors.end()) {
+    redirector->FillPending();
+    mRedirectors.erase(it);
+  }
+}
+
+//_________________________________________________
+size_t TreeStreamAsyncWriter::fillPending()
+{
+  size_t nRows = 0;
+  for (auto* redirector : mRedirectors) {
+    nRows += redirector->FillPending();
+  }
+  return nRows;
+}
+
+//_________________________________________________
+void TreeStreamAsyncWriter::run()
+{
+  // the producers never signal, not to pay for a wake-up per row: poll while idle
+  constexpr auto IdlePeriod = std::chrono::milliseconds(2);
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (!mStop) {
+    if (!fillPending()) {
+      mCondition.wait_for(lock, IdlePeriod);
+    }
+  }
+  fillPending();
+}
@@ -12,12 +12,56 @@
 //  For the functionality of TreeStreamRedirector see the testTreeStream.cxx
 
 #include "CommonUtils/TreeStreamRedirector.h"
+#include "Framework/Logger.h"
+#include <TClass.h>
 #include <TFile.h>
 #include <TLeaf.h>
+#include <TROOT.h>
 #include <cstring>
 
 using namespace o2::utils;
 
+namespace
+{
+/// sequential reader of the rows serialised by TreeStream
+struct RecordReader {
+  const char* pos = nullptr;
+
+  template <typename T>
+  T get()
+  {
+    T value;
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+
+  const char* take(size_t size)
+  {
+    auto* data = pos;
+    pos += size;
+    return data;
+  }
+
+  std::string getString()
+  {
+    const auto length = get<uint32_t>();
+    return std::string(take(length), length);
+  }
+};
+} // namespace
+
+//_________________________________________________
+TreeStreamRedirector::AsyncLayout::~AsyncLayout()
+{
+  stream.reset(); // the branches point to the elements
+  for (auto& element : elements) {
+    if (element.object) {
+      element.cls->Destructor(element.object);
+    }
+  }
+}
+
 //_________________________________________________
 TreeStreamRedirector::TreeStreamRedirector(const char* fname, const char* option)
 {
@@ -72,15 +116,7 @@ TreeStream& TreeStreamRedirector::operator<<(Int_t id)
     }
   }
 
-  TDirectory* backup = gDirectory;
-  mDirectory->cd();
-  mDataLayouts.emplace_back(std::unique_ptr<TreeStream>(new TreeStream(Form("Tree%d", id))));
-  auto layout = mDataLayouts.back().get();
-  layout->setID(id);
-  if (backup) {
-    backup->cd();
-  }
-  return *layout;
+  return AddLayout(Form("Tree%d", id), id);
 }
 
 //_________________________________________________
@@ -96,13 +132,23 @@ TreeStream& TreeStreamRedirector::operator<<(const char* name)
   }
 
   // create new
-  TDirectory* backup = gDirectory;
-  mDirectory->cd();
-  mDataLayouts.emplace_back(std::unique_ptr<TreeStream>(new TreeStream(name)));
+  return AddLayout(name, -1);
+}
+
+//_________________________________________________
+TreeStream& TreeStreamRedirector::AddLayout(const char* name, Int_t id)
+{
+  // create the data layout; in asynchronous mode the tree of the writer thread is stored
+  // instead, this one is built detached so that mDirectory is only used by the writer thread
+
+  {
+    TDirectory::TContext ctx(mRing ? nullptr : mDirectory);
+    mDataLayouts.emplace_back(std::unique_ptr<TreeStream>(new TreeStream(name)));
+  }
   auto layout = mDataLayouts.back().get();
-  layout->setID(-1);
-  if (backup) {
-    backup->cd();
+  layout->setID(id);
+  if (mRing) {
+    layout->setAsync(mRing.get(), mDataLayouts.size() - 1);
   }
   return *layout;
 }
@@ -112,12 +158,28 @@ void TreeStreamRedirector::Close()
 {
   // flush and close
 
+  if (mAsyncWriter) {
+    mAsyncWriter->detach(this); // fills the pending rows
+    mAsyncWriter.reset();
+    if (GetNDropped()) {
+      LOGP(warning, "TreeStreamRedirector: {} rows were dropped since the buffer of {} bytes was full", GetNDropped(), mRing->getCapacity());
+    }
+  }
+
   TDirectory* backup = gDirectory;
   mDirectory->cd();
   for (auto& layout : mDataLayouts) {
-    layout->getTree().Write(layout->getName());
+    if (!layout->isAsync()) {
+      layout->getTree().Write(layout->getName());
+    }
+  }
+  for (auto& layout : mAsyncLayouts) {
+    if (layout) {
+      layout->stream->getTree().Write(layout->stream->getName());
+    }
   }
   mDataLayouts.clear();
+  mAsyncLayouts.clear();
   if (backup) {
     backup->cd();
   }
@@ -129,6 +191,107 @@ void TreeStreamRedirector::Close()
   }
 }
 
+//_________________________________________________
+void TreeStreamRedirector::SetAsync(size_t bufferSize, std::shared_ptr<TreeStreamAsyncWriter> writer)
+{
+  // Fill the trees on the writer thread, the rows are passed via a ring buffer of bufferSize bytes
+
+  if (!mDataLayouts.empty()) {
+    LOGP(error, "TreeStreamRedirector: asynchronous mode must be set before streaming");
+    return;
+  }
+  if (mAsyncWriter) {
+    mAsyncWriter->detach(this);
+  }
+  ROOT::EnableThreadSafety();
+  mRing = std::make_unique<TreeStreamRing>(bufferSize);
+  mReadBuffer = std::make_unique<TBufferFile>(TBuffer::kRead);
+  mAsyncWriter = writer ? std::move(writer) : std::make_shared<TreeStreamAsyncWriter>();
+  mAsyncWriter->attach(this);
+}
+
+//_________________________________________________
+size_t TreeStreamRedirector::FillPending()
+{
+  // Fill the rows waiting in the ring buffer
+
+  return mRing ? mRing->consume([this](const char* data, uint32_t) { Replay(data); }) : 0;
+}
+
+//_________________________________________________
+void TreeStreamRedirector::Replay(const char* data)
+{
+  // Fill the row serialised by TreeStream::Publish into the tree of its data layout
+
+  RecordReader record{data};
+  const auto index = record.get<uint32_t>();
+  const bool announce = record.get<uint32_t>();
+  const auto firstNew = record.get<uint32_t>();
+  const auto nElements = record.get<uint32_t>();
+  if (index >= mAsyncLayouts.size()) {
+    mAsyncLayouts.resize(index + 1);
+  }
+  auto& layout = mAsyncLayouts[index];
+  if (announce) {
+    const auto name = record.getString();
+    if (!layout) {
+      TDirectory::TContext ctx(mDirectory);
+      layout = std::make_unique<AsyncLayout>();
+      layout->stream = std::make_unique<TreeStream>(name.data());
+    }
+  }
+  if (!layout) {
+    return; // cannot happen: rows are announced until one of them is accepted by the ring
+  }
+  for (auto i = firstNew; i < nElements; i++) {
+    const auto type = record.get<Char_t>();
+    auto name = record.getString();
+    const auto clsName = record.getString();
+    if (i == layout->elements.size()) {
+      auto& element = layout->elements.emplace_back();
+      element.type = type;
+      element.name = std::move(name);
+    }
+    auto& element = layout->elements[i];
+    if (!type && !element.cls && !clsName.empty()) {
+      element.cls = TClass::GetClass(clsName.data());
+      element.object = element.cls ? element.cls->New() : nullptr;
+    }
+  }
+
+  auto& stream = *layout->stream;
+  for (uint32_t i = 0; i < nElements; i++) {
+    auto& element = layout->elements[i];
+    if (i >= layout->nNamed) {
+      stream << (element.name + "=").data();
+      layout->nNamed = i + 1;
+    }
+    if (element.type > 0) {
+      const auto typeSize = TreeStream::getTypeSize(element.type);
+      std::memcpy(&element.value, record.take(typeSize), typeSize);
+      stream.CheckIn(element.type, &element.value);
+      continue;
+    }
+    const auto length = record.get<uint32_t>();
+    const char* bytes = record.take(length == TreeStream::kNullObject ? 0 : length);
+    if (!element.object) {
+      stream.CheckIn(static_cast<const TClass*>(nullptr), nullptr);
+    } else {
+      if (length == TreeStream::kNullObject) {
+        element.cls->Destructor(element.object, kTRUE); // null pointer: default constructed object
+        element.cls->New(element.object);
+      } else {
+        mReadBuffer->SetBuffer(const_cast<char*>(bytes), length, kFALSE);
+        mReadBuffer->SetReadMode();
+        mReadBuffer->Reset();
+        element.cls->Streamer(element.object, *mReadBuffer);
+      }
+      stream.CheckIn(element.cls, element.object);
+    }
+  }
+  stream.Endl();
+}
+
 //_________________________________________________
 void TreeStreamRedirector::FixLeafNameBug(TTree* tree)
 {
@@ -107,6 +107,74 @@ BOOST_AUTO_TEST_CASE(TreeStream_test)
   //
 }
 
+BOOST_AUTO_TEST_CASE(TreeStreamAsync_test)
+{
+  // the same trees are produced when they are filled by the background writer
+
+  std::string outFName("testTreeStreamAsync.root");
+  int nit = 1000;
+  {
+    TreeStreamRedirector tstStream(outFName.data(), "recreate");
+    tstStream.SetAsync(16 << 20);
+    BOOST_CHECK(tstStream.IsAsync());
+    std::array<float, o2::track::kNParams> par{};
+    for (int i = 0; i < nit; i++) {
+      par[o2::track::kQ2Pt] = 0.5 + float(i) / nit;
+      float x = 10. + float(i) / nit * 200.;
+      o2::track::TrackPar trc(0., 0., par);
+      trc.propagateParamTo(x, 0.5);
+      TNamed nm(Form("obj%d", i), "");
+      tstStream << "TrackTree"
+                << "id=" << i << "x=" << x << "track=" << &trc << "named=" << (i % 2 ? &nm : nullptr) << "\n";
+    }
+    tstStream.Close();
+    BOOST_CHECK(tstStream.GetNDropped() == 0);
+  }
+  {
+    TFile inpf(outFName.data());
+    BOOST_CHECK(!inpf.IsZombie());
+    auto tree = (TTree*)inpf.GetObjectChecked("TrackTree", "TTree");
+    BOOST_CHECK(tree);
+    BOOST_CHECK(tree->GetEntries() == nit);
+    int id;
+    float x;
+    o2::track::TrackPar* trc = nullptr;
+    TNamed* nm = nullptr;
+    BOOST_CHECK(!tree->SetBranchAddress("id", &id));
+    BOOST_CHECK(!tree->SetBranchAddress("x", &x));
+    BOOST_CHECK(!tree->SetBranchAddress("track", &trc));
+    BOOST_CHECK(!tree->SetBranchAddress("named", &nm));
+    for (int i = 0; i < nit; i++) {
+      tree->GetEntry(i);
+      BOOST_CHECK(id == i);
+      BOOST_CHECK(std::abs(x - trc->getX()) < 1e-4);
+      BOOST_CHECK(std::string(nm->GetName()) == (i % 2 ? Form("obj%d", i) : ""));
+    }
+  }
+
+  // rows not fitting into the buffer are dropped and counted, the others are stored
+  int nStored = 0;
+  uint64_t nDropped = 0;
+  {
+    TreeStreamRedirector tstStream(outFName.data(), "recreate");
+    tstStream.SetAsync(256);
+    TVectorD vec(100);
+    for (int i = 0; i < nit; i++) {
+      tstStream << "Vectors"
+                << "id=" << i << "vec=" << &vec << "\n";
+    }
+    tstStream.Close();
+    nDropped = tstStream.GetNDropped();
+  }
+  {
+    TFile inpf(outFName.data());
+    auto tree = (TTree*)inpf.GetObjectChecked("Vectors", "TTree");
+    nStored = tree ? tree->GetEntries() : 0;
+  }
+  BOOST_CHECK(nDropped > 0);
+  BOOST_CHECK(nStored + nDropped == uint64_t(nit));
+}
+
 //_________________________________________________
 bool UnitTestSparse(Double_t scale, Int_t testEntries)
 {
@@ -16,6 +16,8 @@
 #include "Framework/Logger.h"
 #include "ReconstructionDataFormats/Vertex.h"
 
+class TRandom;
+
 namespace o2
 {
 namespace dataformats
@@ -71,6 +73,8 @@ class MeanVertexObject : public VertexBase
 
   /// sample a vertex from the MeanVertex parameters
   math_utils::Point3D<float> sample() const;
+  /// sample a vertex from the MeanVertex parameters, drawing from the given engine
+  math_utils::Point3D<float> sample(TRandom& rnd) const;
 
   VertexBase getMeanVertex(float z) const
   {
@@ -61,12 +61,17 @@ void MeanVertexObject::print() const
 }
 
 math_utils::Point3D<float> MeanVertexObject::sample() const
+{
+  return sample(*gRandom);
+}
+
+math_utils::Point3D<float> MeanVertexObject::sample(TRandom& rnd) const
 {
   // this assumes gaussian sampling
   // first determine z; then x and y
-  const auto z = gRandom->Gaus(getZ(), getSigmaZ());
-  const auto x = gRandom->Gaus(getXAtZ(z), getSigmaX());
-  const auto y = gRandom->Gaus(getYAtZ(z), getSigmaY());
+  const auto z = rnd.Gaus(getZ(), getSigmaZ());
+  const auto x = rnd.Gaus(getXAtZ(z), getSigmaX());
+  const auto y = rnd.Gaus(getYAtZ(z), getSigmaY());
   return math_utils::Point3D<float>(x, y, z);
 }
 
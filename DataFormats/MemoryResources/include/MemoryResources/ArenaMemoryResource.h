@@ -0,0 +1,224 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @brief Memory resource carving many small messages out of a few large transport regions
+
+#ifndef ALICEO2_ARENA_MEMORY_RESOURCE_
+#define ALICEO2_ARENA_MEMORY_RESOURCE_
+
+#include "MemoryResources/MemoryResources.h"
+#include <fairmq/UnmanagedRegion.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::pmr
+{
+
+//__________________________________________________________________________________________________
+/// Bump allocator over unmanaged regions of a transport. Every allocation is carved from the
+/// current region and becomes a message referring to the region memory, so that many small
+/// outputs cost no allocation in the shared memory segment. The transport notifies the release
+/// of the messages, a region is rewound and reused in bulk once its last block is released.
+/// When all the regions are in use and no new one may be created, the allocation falls back
+/// to a regular message of the transport.
+/// The allocations are meant to be done from one thread, the releases may come from the
+/// transport threads. The arena must outlive the messages created from it.
+class ArenaMemoryResource : public FairMQMemoryResource
+{
+ public:
+  static constexpr size_t DefaultRegionSize = 32 << 20;
+  static constexpr size_t DefaultMaxRegions = 8;
+  static constexpr size_t MinAlignment = 64;
+
+  ArenaMemoryResource(fair::mq::TransportFactory* factory, size_t regionSize = DefaultRegionSize, size_t maxRegions = DefaultMaxRegions)
+    : mFactory{factory}, mRegionSize{align(regionSize, MinAlignment)}, mMaxRegions{maxRegions}
+  {
+    if (!mFactory) {
+      throw std::runtime_error("ArenaMemoryResource: transport factory is nullptr");
+    }
+  }
+  ArenaMemoryResource(const ArenaMemoryResource&) = delete;
+  ArenaMemoryResource& operator=(const ArenaMemoryResource&) = delete;
+  ~ArenaMemoryResource() override
+  {
+    // the regions first, their release callbacks refer to this object
+    for (auto& region : mRegions) {
+      region->region.reset();
+    }
+  }
+
+  /// create a message of given size carved from the arena
+  fair::mq::MessagePtr createMessage(size_t size)
+  {
+    auto message = getMessage(allocate(size, MinAlignment));
+    message->SetUsedSize(size);
+    return message;
+  }
+
+  /// message for the memory allocated at p, ownership of the memory goes to the message
+  fair::mq::MessagePtr getMessage(void* p) override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (auto block = mBlocks.find(p); block != mBlocks.end()) {
+      auto& region = *mRegions[block->second.region];
+      auto size = block->second.size;
+      mBlocks.erase(block);
+      return mFactory->CreateMessage(region.region, p, size, nullptr);
+    }
+    if (auto message = mMessages.find(p); message != mMessages.end()) {
+      auto ret = std::move(message->second);
+      mMessages.erase(message);
+      return ret;
+    }
+    return nullptr;
+  }
+
+  void* setMessage(fair::mq::MessagePtr message) override
+  {
+    void* data = message->GetData();
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMessages[data] = std::move(message);
+    return data;
+  }
+
+  fair::mq::TransportFactory* getTransportFactory() noexcept override { return mFactory; }
+
+  size_t getNumberOfMessages() const noexcept override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mBlocks.size() + mMessages.size();
+  }
+
+  size_t getNumberOfRegions() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRegions.size();
+  }
+
+  /// number of blocks carved from the regions and not released yet
+  size_t getNumberOfBlocksInUse() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t n = 0;
+    for (const auto& region : mRegions) {
+      n += region->nBlocks;
+    }
+    return n;
+  }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    alignment = std::max(alignment, MinAlignment);
+    std::lock_guard<std::mutex> lock(mMutex);
+    int index = findRegion(bytes, alignment);
+    if (index < 0) {
+      auto message = mFactory->CreateMessage(bytes, fair::mq::Alignment{alignment});
+      void* data = message->GetData();
+      mMessages[data] = std::move(message);
+      return data;
+    }
+    auto& region = *mRegions[index];
+    size_t offset = align(region.offset, alignment);
+    void* data = region.data + offset;
+    region.offset = offset + bytes;
+    region.nBlocks++;
+    mBlocks[data] = {index, bytes};
+    return data;
+  }
+
+  void do_deallocate(void* p, std::size_t /*bytes*/, std::size_t /*alignment*/) override
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (auto block = mBlocks.find(p); block != mBlocks.end()) {
+      int index = block->second.region;
+      mBlocks.erase(block);
+      releaseBlocks(index, 1);
+    } else {
+      mMessages.erase(p); // nothing to do if the block was already turned into a message
+    }
+  }
+
+  bool do_is_equal(const memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+ private:
+  struct Region {
+    fair::mq::UnmanagedRegionPtr region;
+    char* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;  ///< bump pointer
+    size_t nBlocks = 0; ///< blocks allocated and not released
+  };
+  struct Block {
+    int region = -1;
+    size_t size = 0;
+  };
+
+  static size_t align(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+  // index of a region with space for the allocation, -1 if none is available
+  int findRegion(size_t bytes, size_t alignment)
+  {
+    if (mCurrent >= 0 && align(mRegions[mCurrent]->offset, alignment) + bytes <= mRegions[mCurrent]->size) {
+      return mCurrent;
+    }
+    for (size_t i = 0; i < mRegions.size(); i++) {
+      if (mRegions[i]->nBlocks == 0 && bytes <= mRegions[i]->size) {
+        mRegions[i]->offset = 0;
+        return mCurrent = i;
+      }
+    }
+    if (mRegions.size() >= mMaxRegions) {
+      return -1;
+    }
+    int index = mRegions.size();
+    auto region = std::make_unique<Region>();
+    region->size = std::max(mRegionSize, align(bytes, MinAlignment));
+    fair::mq::RegionBulkCallback release = [this, index](const std::vector<fair::mq::RegionBlock>& blocks) {
+      std::lock_guard<std::mutex> lock(mMutex);
+      releaseBlocks(index, blocks.size());
+    };
+    region->region = mFactory->CreateUnmanagedRegion(region->size, release);
+    region->data = static_cast<char*>(region->region->GetData());
+    mRegions.push_back(std::move(region));
+    return mCurrent = index;
+  }
+
+  // the whole region is free again once its last block is released
+  void releaseBlocks(int index, size_t n)
+  {
+    auto& region = *mRegions[index];
+    region.nBlocks -= std::min(n, region.nBlocks);
+    if (region.nBlocks == 0) {
+      region.offset = 0;
+    }
+  }
+
+  fair::mq::TransportFactory* mFactory = nullptr;
+  size_t mRegionSize = DefaultRegionSize;
+  size_t mMaxRegions = DefaultMaxRegions;
+  mutable std::mutex mMutex;
+  std::vector<std::unique_ptr<Region>> mRegions;
+  int mCurrent = -1;                                         ///< region used for the bump allocation
+  std::unordered_map<void*, Block> mBlocks;                  ///< allocated blocks not yet turned into messages
+  std::unordered_map<void*, fair::mq::MessagePtr> mMessages; ///< fallback and adopted messages
+};
+
+} // namespace o2::pmr
+
+#endif
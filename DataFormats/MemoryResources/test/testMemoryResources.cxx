@@ -14,6 +14,7 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include "MemoryResources/MemoryResources.h"
+#include "MemoryResources/ArenaMemoryResource.h"
 #include <fairmq/TransportFactory.h>
 #include <fairmq/Tools.h>
 #include <fairmq/ProgOptions.h>
@@ -216,4 +217,56 @@ BOOST_AUTO_TEST_CASE(test_SpectatorMemoryResource)
   BOOST_CHECK(vecmove.size() == size);
 }
 
+BOOST_AUTO_TEST_CASE(ArenaMemoryResource_test)
+{
+  size_t session{fair::mq::tools::UuidHash()};
+  fair::mq::ProgOptions config;
+  config.SetProperty<std::string>("session", std::to_string(session));
+
+  auto factoryZMQ = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  ArenaMemoryResource arena(factoryZMQ.get(), 1 << 16, 2);
+
+  // the messages are carved one after the other from the same region
+  auto msg1 = arena.createMessage(100);
+  auto msg2 = arena.createMessage(10);
+  BOOST_CHECK_EQUAL(arena.getNumberOfRegions(), 1);
+  BOOST_CHECK_EQUAL(msg1->GetSize(), 100);
+  BOOST_CHECK_EQUAL(msg2->GetSize(), 10);
+  BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(msg1->GetData()) % ArenaMemoryResource::MinAlignment, 0);
+  BOOST_CHECK(static_cast<char*>(msg2->GetData()) == static_cast<char*>(msg1->GetData()) + 128);
+
+  // blocks released before becoming messages are accounted immediately
+  void* p = arena.allocate(64, 64);
+  BOOST_CHECK_EQUAL(arena.getNumberOfBlocksInUse(), 3);
+  arena.deallocate(p, 64, 64);
+  BOOST_CHECK_EQUAL(arena.getNumberOfBlocksInUse(), 2);
+
+  // containers allocated in the arena become messages without copy
+  void* vectorBeginPtr = nullptr;
+  fair::mq::MessagePtr message;
+  {
+    std::vector<testData, polymorphic_allocator<testData>> v(polymorphic_allocator<testData>{&arena});
+    v.reserve(3);
+    v.emplace_back(1);
+    v.emplace_back(2);
+    v.emplace_back(3);
+    vectorBeginPtr = v.data();
+    message = o2::pmr::getMessage(std::move(v));
+  }
+  BOOST_CHECK(message != nullptr);
+  BOOST_CHECK(message->GetData() == vectorBeginPtr);
+  BOOST_CHECK_EQUAL(message->GetSize(), 3 * sizeof(testData));
+  BOOST_CHECK_EQUAL(arena.getNumberOfMessages(), 0);
+
+  // a request larger than the regions gets a region of its own
+  auto large = arena.createMessage(1 << 17);
+  BOOST_CHECK_EQUAL(arena.getNumberOfRegions(), 2);
+  BOOST_CHECK_EQUAL(large->GetSize(), 1 << 17);
+
+  // no more regions allowed: falls back to a transport message
+  auto fallback = arena.createMessage(1 << 17);
+  BOOST_CHECK_EQUAL(arena.getNumberOfRegions(), 2);
+  BOOST_CHECK(fallback != nullptr);
+}
+
 }; // namespace o2::pmr
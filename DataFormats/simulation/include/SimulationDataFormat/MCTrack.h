@@ -153,6 +153,8 @@ class MCTrackT
   void SetSecondMotherTrackId(Int_t id) { mSecondMotherTrackId = id; }
   void SetFirstDaughterTrackId(Int_t id) { mFirstDaughterTrackId = id; }
   void SetLastDaughterTrackId(Int_t id) { mLastDaughterTrackId = id; }
+  void setWeight(_T weight) { mWeight = weight; }
+  void setStatusCode(int code) { mStatusCode = code; }
   // set bit indicating that this track
   // left a hit in detector with id iDet
   void setHit(Int_t iDet)
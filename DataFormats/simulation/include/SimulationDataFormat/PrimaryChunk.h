@@ -13,6 +13,10 @@
 #define ALICEO2_DATA_PRIMARYCHUNK_H_
 
 #include <cstring>
+#include <vector>
+#include <type_traits>
+#include <TParticle.h>
+#include <TVector3.h>
 #include <SimulationDataFormat/MCEventHeader.h>
 
 namespace o2
@@ -52,6 +56,50 @@ struct PrimaryChunk {
   std::vector<TParticle> mParticles; // the particles for this chunk
   ClassDefNV(PrimaryChunk, 1);
 };
+
+// A flat (trivially copyable) image of a TParticle, used to ship the primaries
+// of a chunk from the primary server to the workers without ROOT streaming.
+struct FlatParticle {
+  static constexpr UInt_t UserBitsMask = 0x00ffc000; // TObject bits 14-23 (used for transport flags)
+
+  Int_t pdg = 0;
+  Int_t status = 0;
+  Int_t mother[2] = {-1, -1};
+  Int_t daughter[2] = {-1, -1};
+  UInt_t bits = 0;
+  UInt_t uniqueID = 0;
+  Float_t weight = 1.;
+  Double_t calcMass = 0.;
+  Double_t polarisation[3] = {0., 0., 0.};
+  Double_t momentum[4] = {0., 0., 0., 0.}; // px, py, pz, e
+  Double_t vertex[4] = {0., 0., 0., 0.};   // vx, vy, vz, t
+
+  FlatParticle() = default;
+  explicit FlatParticle(TParticle const& p)
+    : pdg(p.GetPdgCode()), status(p.GetStatusCode()), mother{p.GetFirstMother(), p.GetSecondMother()}, daughter{p.GetFirstDaughter(), p.GetLastDaughter()}, bits(p.TestBits(UserBitsMask)), uniqueID(p.GetUniqueID()), weight(p.GetWeight()), calcMass(p.GetCalcMass()), momentum{p.Px(), p.Py(), p.Pz(), p.Energy()}, vertex{p.Vx(), p.Vy(), p.Vz(), p.T()}
+  {
+    TVector3 pol;
+    p.GetPolarisation(pol);
+    polarisation[0] = pol.X();
+    polarisation[1] = pol.Y();
+    polarisation[2] = pol.Z();
+  }
+
+  TParticle toTParticle() const
+  {
+    TParticle p(pdg, status, mother[0], mother[1], daughter[0], daughter[1],
+                momentum[0], momentum[1], momentum[2], momentum[3], vertex[0], vertex[1], vertex[2], vertex[3]);
+    if (polarisation[0] != 0. || polarisation[1] != 0. || polarisation[2] != 0.) {
+      p.SetPolarisation(polarisation[0], polarisation[1], polarisation[2]);
+    }
+    p.SetWeight(weight);
+    p.SetCalcMass(calcMass);
+    p.SetUniqueID(uniqueID);
+    p.SetBit(bits);
+    return p;
+  }
+};
+static_assert(std::is_trivially_copyable_v<FlatParticle>, "FlatParticle must be trivially copyable");
 } // namespace data
 } // namespace o2
 
@@ -275,6 +275,60 @@ T decodeTMessage(fair::mq::Parts& dataparts, int index)
   return static_cast<T>(decodeTMessageCore(dataparts, index));
 }
 
+// a trait to determine if a hit container can be sent as a flat binary copy
+// of its elements rather than being streamed with a TMessage
+template <typename Container>
+struct is_flat_hit_container : std::false_type {
+};
+
+template <typename T, typename A>
+struct is_flat_hit_container<std::vector<T, A>> : std::bool_constant<std::is_trivially_copyable_v<T>> {
+};
+
+// these go into the source
+void attachBinaryMessageCore(const void* data, size_t size, fair::mq::Channel& channel, fair::mq::Parts& parts);
+std::pair<const void*, size_t> getMessageBuffer(fair::mq::Parts& dataparts, int index);
+
+template <typename Container>
+void attachBinaryMessage(Container const& hits, fair::mq::Channel& channel, fair::mq::Parts& parts)
+{
+  static_assert(is_flat_hit_container<Container>::value, "binary hit messages require a vector of trivially copyable hits");
+  attachBinaryMessageCore(hits.data(), hits.size() * sizeof(typename Container::value_type), channel, parts);
+}
+
+template <typename T>
+T decodeBinaryMessage(fair::mq::Parts& dataparts, int index)
+{
+  using Container = std::remove_pointer_t<T>;
+  using Hit = typename Container::value_type;
+  static_assert(is_flat_hit_container<Container>::value, "binary hit messages require a vector of trivially copyable hits");
+  auto [data, size] = getMessageBuffer(dataparts, index);
+  auto hits = reinterpret_cast<const Hit*>(data);
+  return new Container(hits, hits + size / sizeof(Hit));
+}
+
+// sends hits with the binary format when possible, with a TMessage otherwise
+template <typename Container>
+void attachHitsMessage(Container const& hits, fair::mq::Channel& channel, fair::mq::Parts& parts)
+{
+  if constexpr (is_flat_hit_container<Container>::value) {
+    attachBinaryMessage(hits, channel, parts);
+  } else {
+    attachTMessage(hits, channel, parts);
+  }
+}
+
+// counterpart of attachHitsMessage
+template <typename T>
+T decodeHitsMessage(fair::mq::Parts& dataparts, int index)
+{
+  if constexpr (is_flat_hit_container<std::remove_pointer_t<T>>::value) {
+    return decodeBinaryMessage<T>(dataparts, index);
+  } else {
+    return decodeTMessage<T>(dataparts, index);
+  }
+}
+
 void attachDetIDHeaderMessage(int id, fair::mq::Channel& channel, fair::mq::Parts& parts);
 
 template <typename T>
@@ -342,7 +396,7 @@ class DetImpl : public o2::base::Detector
 
     while (auto hits = static_cast<Det*>(this)->Det::getHits(probe++)) {
       if (!UseShm<Det>::value || !o2::utils::ShmManager::Instance().isOperational()) {
-        attachTMessage(*hits, channel, parts);
+        attachHitsMessage(*hits, channel, parts);
       } else {
         // this is the shared mem variant
         // we will just send the sharedmem ID and the offset inside
@@ -563,7 +617,7 @@ class DetImpl : public o2::base::Detector
     while (name.size() > 0) {
       if (!UseShm<Det>::value || !o2::utils::ShmManager::Instance().isOperational()) {
         // for each branch name we extract/decode hits from the message parts ...
-        auto hitsptr = decodeTMessage<HitPtr_t>(parts, index++);
+        auto hitsptr = decodeHitsMessage<HitPtr_t>(parts, index++);
         if (hitsptr) {
           // ... and copy them to the buffer
           copyToBuffer(hitsptr, hitcollector, probe);
@@ -596,7 +650,7 @@ class DetImpl : public o2::base::Detector
       if (!UseShm<Det>::value || !o2::utils::ShmManager::Instance().isOperational()) {
 
         // for each branch name we extract/decode hits from the message parts ...
-        auto hitsptr = decodeTMessage<Hit_t>(parts, index++);
+        auto hitsptr = decodeHitsMessage<Hit_t>(parts, index++);
         if (hitsptr) {
           // ... and fill the tree branch
           auto br = getOrMakeBranch(tr, name.c_str(), hitsptr);
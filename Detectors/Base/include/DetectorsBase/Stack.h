@@ -27,9 +27,9 @@
 
 #include <map>
 #include <memory>
-#include <stack>
 #include <utility>
 #include <functional>
+#include <vector>
 
 class TClonesArray;
 class TRefArray;
@@ -43,9 +43,29 @@ class Detector;
 
 namespace data
 {
+/// Compact record of a particle waiting for transport on the stack.
+/// Unlike TParticle it is trivially copyable and free of the TObject/TAttLine baggage,
+/// the TParticle handed to the VMC is filled from it only when the particle is popped.
+struct StackParticle {
+  double px = 0., py = 0., pz = 0., e = 0.;   ///< momentum at start vertex [GeV]
+  double vx = 0., vy = 0., vz = 0., t = 0.;   ///< start vertex [cm, s]
+  float polarTheta = -99.f, polarPhi = -99.f; ///< polarisation angles, TParticle convention
+  float weight = 1.f;                         ///< particle weight
+  int pdg = 0;                                ///< PDG code
+  int status = 0;                             ///< generator status code for primaries, track ID for secondaries
+  int mother[2] = {-1, -1};                   ///< mother track IDs
+  int daughter[2] = {-1, -1};                 ///< daughter track IDs
+  unsigned int process = 0;                   ///< production process (TMCProcess)
+  unsigned int bits = 0;                      ///< ParticleStatus bits
+
+  bool testBit(unsigned int bit) const { return (bits & bit) != 0; }
+  void setBit(unsigned int bit, bool on) { bits = on ? (bits | bit) : (bits & ~bit); }
+};
+
 /// This class handles the particle stack for the transport simulation.
-/// For the stack FILO functunality, it uses the STL stack. To store
-/// the tracks during transport, a TParticle array is used.
+/// For the stack FILO functunality, it uses a vector of compact StackParticle
+/// records which keeps its capacity between events. To store
+/// the tracks during transport, an MCTrack array is used.
 /// At the end of the event, tracks satisfying the filter criteria
 /// are copied to a MCTrack array, which is stored in the output.
 ///
@@ -240,9 +260,8 @@ class Stack : public FairGenericStack
   typedef std::function<bool(const TParticle& p, const std::vector<TParticle>& particles)> TransportFcn;
 
  private:
-  /// STL stack (FILO) used to handle the TParticles for tracking
-  /// stack entries refer to
-  std::stack<TParticle> mStack; //!
+  /// FILO of the particles to be tracked, the back is the top of the stack
+  std::vector<StackParticle> mStack; //!
 
   /// Array of TParticles (contains all TParticles put into or created
   /// by the transport)
@@ -250,9 +269,10 @@ class Stack : public FairGenericStack
   std::vector<int> mTransportedIDs;          //! prim + sec trackIDs transported for "current" primary
   std::vector<int> mIndexOfPrimaries;        //! index of primaries in mParticles
   std::vector<int> mTrackIDtoParticlesEntry; //! an O(1) mapping of trackID to the entry of mParticles
-  // the current TParticle object
+  // the current TParticle object, handed to the VMC
   TParticle mCurrentParticle;
-  TParticle mCurrentParticle0;
+  // the last pushed secondary
+  StackParticle mCurrentParticle0; //!
 
   // keep primary particles in its original form
   // (mainly for the PopPrimaryParticleInterface
@@ -326,6 +346,11 @@ class Stack : public FairGenericStack
 
   void handleTransportPrimary(TParticle& p);
 
+  /// conversions between the compact stack record and the TParticle/MCTrack representations
+  static StackParticle toStackParticle(const TParticle& p);
+  static void fillTParticle(const StackParticle& sp, TParticle& p);
+  static MCTrack toMCTrack(const StackParticle& sp);
+
   ClassDefOverride(Stack, 1);
 };
 
@@ -195,6 +195,7 @@ int Detector::registerSensitiveVolumeAndGetVolID(std::string const& name)
 #include <fairmq/Message.h>
 #include <fairmq/Parts.h>
 #include <fairmq/Channel.h>
+#include <cstring>
 namespace o2
 {
 namespace base
@@ -206,6 +207,19 @@ void attachMessageBufferToParts(fair::mq::Parts& parts, fair::mq::Channel& chann
   std::unique_ptr<fair::mq::Message> message(channel.NewMessage(data, size, free_func, hint));
   parts.AddPart(std::move(message));
 }
+void attachBinaryMessageCore(const void* data, size_t size, fair::mq::Channel& channel, fair::mq::Parts& parts)
+{
+  std::unique_ptr<fair::mq::Message> message(channel.NewMessage(size, fair::mq::Alignment{64}));
+  if (size) {
+    std::memcpy(message->GetData(), data, size);
+  }
+  parts.AddPart(std::move(message));
+}
+std::pair<const void*, size_t> getMessageBuffer(fair::mq::Parts& dataparts, int index)
+{
+  auto& rawmessage = dataparts.At(index);
+  return {rawmessage->GetData(), rawmessage->GetSize()};
+}
 void attachDetIDHeaderMessage(int id, fair::mq::Channel& channel, fair::mq::Parts& parts)
 {
   std::unique_ptr<fair::mq::Message> message(channel.NewSimpleMessage(id));
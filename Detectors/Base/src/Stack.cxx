@@ -36,12 +36,21 @@
 #include <cassert>
 #include <cstddef> // for NULL
 #include <cmath>
+#include <type_traits>
 
 using std::cout;
 using std::endl;
 using std::pair;
 using namespace o2::data;
 
+static_assert(std::is_trivially_copyable_v<StackParticle>, "StackParticle must stay a plain record");
+
+namespace
+{
+// all the status bits of a particle carried by the stack
+constexpr unsigned int ParticleStatusMask = kKeep | kDaughters | kToBeDone | kPrimary | kTransport | kInhibited | kHasHits | kHasTrackRefs;
+} // namespace
+
 // small helper function to append to vector at arbitrary position
 template <typename T, typename I>
 void insertInVector(std::vector<T>& v, I index, T e)
@@ -77,6 +86,7 @@ Stack::Stack(Int_t size)
     mTrackRefs(new std::vector<o2::TrackReference>),
     mIsG4Like(false)
 {
+  mStack.reserve(size);
   auto vmc = TVirtualMC::GetMC();
   if (vmc) {
     mIsG4Like = !(vmc->SecondariesAreOrdered());
@@ -205,28 +215,46 @@ void Stack::PushTrack(Int_t toBeDone, Int_t parentId, Int_t pdgCode, Double_t px
   // - in all cases to push a secondary particle
   //
   //
-  // Create new TParticle and add it to the TParticle array
+  // Create the compact stack record, a TParticle is only created for primaries
 
   Int_t trackId = mNumberOfEntriesInParticles;
   // Set track variable
   ntr = trackId;
   //  Int_t daughter1Id = -1;
   //  Int_t daughter2Id = -1;
-  Int_t iStatus = (proc == kPPrimary) ? is : trackId;
-  TParticle p(pdgCode, iStatus, parentId, secondparentId, daughter1Id, daughter2Id, px, py, pz, e, vx, vy, vz, time);
-  p.SetPolarisation(polx, poly, polz);
-  p.SetWeight(weight);
-  p.SetUniqueID(proc);                                           // using the unique ID to transfer process ID
-  p.SetBit(ParticleStatus::kPrimary, proc == kPPrimary ? 1 : 0); // set primary bit
-  p.SetBit(ParticleStatus::kToBeDone, toBeDone == 1 ? 1 : 0);    // set to be done bit
+  StackParticle sp;
+  sp.pdg = pdgCode;
+  sp.status = (proc == kPPrimary) ? is : trackId;
+  sp.mother[0] = parentId;
+  sp.mother[1] = secondparentId;
+  sp.daughter[0] = daughter1Id;
+  sp.daughter[1] = daughter2Id;
+  sp.px = px;
+  sp.py = py;
+  sp.pz = pz;
+  sp.e = e;
+  sp.vx = vx;
+  sp.vy = vy;
+  sp.vz = vz;
+  sp.t = time;
+  if (polx || poly || polz) { // same convention as TParticle::SetPolarisation
+    sp.polarTheta = std::acos(polz / std::sqrt(polx * polx + poly * poly + polz * polz));
+    sp.polarPhi = M_PI + std::atan2(-poly, -polx);
+  }
+  sp.weight = weight;
+  sp.process = proc;                                      // the process ID is transferred as unique ID of the TParticle
+  sp.setBit(ParticleStatus::kPrimary, proc == kPPrimary); // set primary bit
+  sp.setBit(ParticleStatus::kToBeDone, toBeDone == 1);    // set to be done bit
   mNumberOfEntriesInParticles++;
 
   insertInVector(mTrackIDtoParticlesEntry, trackId, (int)(mParticles.size()));
 
-  handleTransportPrimary(p); // handle selective transport of primary particles
-
   // Push particle on the stack if toBeDone is set
-  if (p.TestBit(ParticleStatus::kPrimary)) {
+  if (sp.testBit(ParticleStatus::kPrimary)) {
+    TParticle p;
+    fillTParticle(sp, p);
+    handleTransportPrimary(p); // handle selective transport of primary particles
+
     // This is a particle from the primary particle generator
     //
     // SetBit is used to pass information about the primary particle to the stack during transport.
@@ -248,11 +276,12 @@ void Stack::PushTrack(Int_t toBeDone, Int_t parentId, Int_t pdgCode, Double_t px
     mNumberOfPrimaryParticles++;
     mPrimaryParticles.push_back(p);
     mTracks->emplace_back(p);
+    sp = toStackParticle(p);
   } else {
-    mParticles.emplace_back(p);
-    mCurrentParticle0 = p;
+    mParticles.emplace_back(toMCTrack(sp));
+    mCurrentParticle0 = sp;
   }
-  mStack.push(p);
+  mStack.push_back(sp);
 }
 
 void Stack::handleTransportPrimary(TParticle& p)
@@ -286,11 +315,77 @@ void Stack::PushTrack(int toBeDone, TParticle& p)
     if (p.TestBit(ParticleStatus::kToBeDone)) {
       mNumberOfPrimariesforTracking++;
     }
-    mStack.push(p);
+    mStack.push_back(toStackParticle(p));
     mTracks->emplace_back(p);
   }
 }
 
+StackParticle Stack::toStackParticle(const TParticle& p)
+{
+  StackParticle sp;
+  sp.px = p.Px();
+  sp.py = p.Py();
+  sp.pz = p.Pz();
+  sp.e = p.Energy();
+  sp.vx = p.Vx();
+  sp.vy = p.Vy();
+  sp.vz = p.Vz();
+  sp.t = p.T();
+  sp.polarTheta = p.GetPolarTheta();
+  sp.polarPhi = p.GetPolarPhi();
+  sp.weight = p.GetWeight();
+  sp.pdg = p.GetPdgCode();
+  sp.status = p.GetStatusCode();
+  sp.mother[0] = p.GetFirstMother();
+  sp.mother[1] = p.GetSecondMother();
+  sp.daughter[0] = p.GetFirstDaughter();
+  sp.daughter[1] = p.GetLastDaughter();
+  sp.process = p.GetUniqueID();
+  sp.bits = p.TestBits(ParticleStatusMask);
+  return sp;
+}
+
+void Stack::fillTParticle(const StackParticle& sp, TParticle& p)
+{
+  // fill the fields in place: no TParticle is constructed or copied
+  p.SetMomentum(sp.px, sp.py, sp.pz, sp.e);
+  // the PDG database lookup is skipped for a repeated species with a database entry (its calc mass is the
+  // PDG mass), GetPDG(1) returning the entry cached by SetPdgCode. Otherwise (e.g. ions) SetPdgCode
+  // computes the calc mass from the momentum, hence set before
+  if (p.GetPdgCode() != sp.pdg || !p.GetPDG(1)) {
+    p.SetPdgCode(sp.pdg);
+  }
+  p.SetStatusCode(sp.status);
+  p.SetFirstMother(sp.mother[0]);
+  p.SetLastMother(sp.mother[1]);
+  p.SetFirstDaughter(sp.daughter[0]);
+  p.SetLastDaughter(sp.daughter[1]);
+  p.SetProductionVertex(sp.vx, sp.vy, sp.vz, sp.t);
+  p.SetPolarTheta(sp.polarTheta);
+  p.SetPolarPhi(sp.polarPhi);
+  p.SetWeight(sp.weight);
+  p.SetUniqueID(sp.process);
+  p.ResetBit(ParticleStatusMask);
+  p.SetBit(sp.bits);
+}
+
+o2::MCTrack Stack::toMCTrack(const StackParticle& sp)
+{
+  // same content as the MCTrack constructed from the corresponding TParticle
+  o2::MCTrack track(sp.pdg, sp.mother[0], sp.mother[1], sp.daughter[0], sp.daughter[1],
+                    sp.px, sp.py, sp.pz, sp.vx, sp.vy, sp.vz, sp.t * 1e09, 0);
+  track.setWeight(sp.weight);
+  track.setProcess(sp.process);
+  track.setStore(sp.testBit(ParticleStatus::kKeep));
+  track.setToBeDone(sp.testBit(ParticleStatus::kToBeDone));
+  if (sp.testBit(ParticleStatus::kInhibited)) {
+    track.setToBeDone(true); // if inhibited, it had to be done: restore flag
+    track.setInhibited(true);
+  }
+  track.setStatusCode(sp.testBit(ParticleStatus::kPrimary) ? sp.status : -1);
+  return track;
+}
+
 /// Set the current track number
 /// Declared in TVirtualMCStack
 /// \param iTrack track number
@@ -302,7 +397,7 @@ void Stack::SetCurrentTrack(Int_t iTrack)
     mCurrentParticle = p;
     mIndexOfCurrentPrimary = iTrack;
   } else {
-    mCurrentParticle = mCurrentParticle0;
+    fillTParticle(mCurrentParticle0, mCurrentParticle);
   }
 }
 
@@ -344,12 +439,13 @@ TParticle* Stack::PopNextTrack(Int_t& iTrack)
   TParticle* nextParticle = nullptr;
   while (!found && !mStack.empty()) {
     // get next particle from stack
-    mCurrentParticle = mStack.top();
+    const StackParticle next = mStack.back();
     // remove particle from the top
-    mStack.pop();
+    mStack.pop_back();
     // test if primary to be transported
-    if (mCurrentParticle.TestBit(ParticleStatus::kToBeDone)) {
-      if (mCurrentParticle.TestBit(ParticleStatus::kPrimary)) {
+    if (next.testBit(ParticleStatus::kToBeDone)) {
+      fillTParticle(next, mCurrentParticle);
+      if (next.testBit(ParticleStatus::kPrimary)) {
         // particle is primary and needs to be tracked -> indicates that previous particle finished
         mNumberOfPrimariesPopped++;
         mIndexOfCurrentPrimary = mStack.size();
@@ -591,9 +687,7 @@ void Stack::Reset()
 
   mIndexOfCurrentTrack = -1;
   mNumberOfPrimaryParticles = mNumberOfEntriesInParticles = mNumberOfEntriesInTracks = 0;
-  while (!mStack.empty()) {
-    mStack.pop();
-  }
+  mStack.clear(); // keeps the capacity for the next event
   mParticles.clear();
   mTracks->clear();
   if (!mIsExternalMode && (mPrimariesDone != mNumberOfPrimariesforTracking)) {
@@ -44,3 +44,49 @@ BOOST_AUTO_TEST_CASE(Stack_test)
     BOOST_CHECK(inst->getPrimaries().size() == 2);
   }
 }
+
+// particles pushed as compact records are handed to the VMC as TParticle when popped
+BOOST_AUTO_TEST_CASE(Stack_pushpop_test)
+{
+  o2::data::Stack st;
+  int primary, secondary;
+  st.PushTrack(1, -1, 211, 1., 2., 3., 4., 0.1, 0.2, 0.3, 1e-9, 0., 0., 0., kPPrimary, primary, 1., 1);
+  st.PushTrack(1, primary, 11, 0.5, 0., 0., 0.6, 1., 2., 3., 2e-9, 0., 0., 1., kPDecay, secondary, 0.5, 0);
+  BOOST_CHECK_EQUAL(st.GetNtrack(), 2);
+
+  int iTrack = -1;
+  auto p = st.PopNextTrack(iTrack);
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(iTrack, secondary);
+  BOOST_CHECK_EQUAL(p->GetPdgCode(), 11);
+  BOOST_CHECK_EQUAL(p->GetFirstMother(), primary);
+  BOOST_CHECK_EQUAL((int)p->GetUniqueID(), (int)kPDecay);
+  BOOST_CHECK(!p->TestBit(ParticleStatus::kPrimary));
+  BOOST_CHECK_CLOSE(p->Px(), 0.5, 1e-9);
+  BOOST_CHECK_CLOSE(p->Energy(), 0.6, 1e-9);
+  BOOST_CHECK_CLOSE(p->Vz(), 3., 1e-9);
+  BOOST_CHECK_CLOSE(p->T(), 2e-9, 1e-9);
+  BOOST_CHECK_CLOSE(p->GetWeight(), 0.5, 1e-6);
+  BOOST_CHECK_CLOSE(p->GetPolarTheta(), 0., 1e-6); // polarisation along z
+
+  p = st.PopNextTrack(iTrack);
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(p->GetPdgCode(), 211);
+  BOOST_CHECK(p->TestBit(ParticleStatus::kPrimary));
+  BOOST_CHECK_CLOSE(p->Pz(), 3., 1e-9);
+  BOOST_CHECK(st.PopNextTrack(iTrack) == nullptr);
+  BOOST_CHECK_EQUAL(iTrack, -1);
+
+  // the calc mass of a species without PDG database entry (ion) follows the momentum of every popped particle
+  const int ion = 1000501200;
+  st.PushTrack(1, primary, ion, 0., 0., 3., 5., 0., 0., 0., 3e-9, 0., 0., 0., kPDecay, secondary, 1., 0);
+  st.PushTrack(1, primary, ion, 0., 0., 5., 13., 0., 0., 0., 4e-9, 0., 0., 0., kPDecay, secondary, 1., 0);
+  p = st.PopNextTrack(iTrack);
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(p->GetPdgCode(), ion);
+  BOOST_CHECK_CLOSE(p->GetCalcMass(), 12., 1e-9);
+  p = st.PopNextTrack(iTrack);
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(p->GetPdgCode(), ion);
+  BOOST_CHECK_CLOSE(p->GetCalcMass(), 4., 1e-9);
+}
@@ -186,15 +186,46 @@ class DataPointIdentifier final
   }
 
   /**
-         * Returns a hash code calculated from the alias. <em>Note that the
-         * hash code is recalculated every time when this function is called.
-         * </em>
+         * Returns a hash code calculated from the 64-byte identifier. The
+         * eight words are mixed in four independent lanes, without copying
+         * the alias, and the top bit of the type byte, which
+         * <tt>operator==</tt> ignores, is masked out so that the hash is
+         * consistent with it. <em>Note that the hash code is
+         * recalculated every time when this function is called.</em>
          *
          * @return An unsigned integer.
          */
   inline size_t hash_code() const noexcept
   {
-    return o2::dcs::hash_code(std::string((char*)&pt1));
+    constexpr uint64_t typeMask = 0x7FFFFFFFFFFFFFFF;
+    constexpr uint64_t k1 = 0x9E3779B97F4A7C15;
+    constexpr uint64_t k2 = 0xC2B2AE3D27D4EB4F;
+    const uint64_t l0 = (pt1 * k1) ^ rotl(pt5 * k2, 31);
+    const uint64_t l1 = (pt2 * k1) ^ rotl(pt6 * k2, 31);
+    const uint64_t l2 = (pt3 * k1) ^ rotl(pt7 * k2, 31);
+    const uint64_t l3 = (pt4 * k1) ^ rotl((pt8 & typeMask) * k2, 31);
+    return mix(l0 + rotl(l1, 17) + rotl(l2, 29) + rotl(l3, 43));
+  }
+
+  /**
+         * The 64-bit finaliser used by <tt>hash_code</tt> (MurmurHash3 fmix64).
+         */
+  static constexpr uint64_t mix(uint64_t h) noexcept
+  {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCD;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /**
+         * Rotates the given word left by r bits (0 < r < 64).
+         */
+  static constexpr uint64_t rotl(uint64_t x, int r) noexcept
+  {
+    return (x << r) | (x >> (64 - r));
   }
 
   /**
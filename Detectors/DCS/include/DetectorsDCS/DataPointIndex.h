@@ -0,0 +1,84 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_DCS_DATAPOINT_INDEX_H
+#define O2_DCS_DATAPOINT_INDEX_H
+
+#include "DetectorsDCS/DataPointIdentifier.h"
+#include <cstdint>
+#include <vector>
+
+namespace o2
+{
+namespace dcs
+{
+/**
+ * Immutable perfect-hash index over a fixed set of DataPointIdentifiers.
+ *
+ * The index is built once, at configuration time, from the list of data
+ * points a component is interested in (e.g. the expanded alias list). Every
+ * configured DPID is mapped to a dense slot in [0, size()), in the order of
+ * first appearance in the input list, so that per-DP state can be kept in
+ * plain vectors. A lookup costs one DPID hash, two table reads and one
+ * identifier comparison, and never allocates; unknown DPIDs return NotFound.
+ *
+ * The table uses the hash-and-displace scheme: keys are distributed over
+ * small buckets and each bucket gets a displacement seed chosen such that
+ * all keys of all buckets land on distinct table positions.
+ */
+class DataPointIndex
+{
+ public:
+  static constexpr int NotFound = -1;
+
+  DataPointIndex() = default;
+  explicit DataPointIndex(const std::vector<DataPointIdentifier>& dpids) { build(dpids); }
+
+  /// (re)build the index from the list of DPIDs, duplicates are ignored
+  void build(const std::vector<DataPointIdentifier>& dpids);
+
+  /// dense slot of the DPID or NotFound if it is not in the index
+  int find(const DataPointIdentifier& dpid) const noexcept
+  {
+    if (mKeys.empty()) {
+      return NotFound;
+    }
+    const uint64_t h = dpid.hash_code();
+    const auto pos = position(h, mSeeds[h % mSeeds.size()]);
+    const int slot = mTable[pos];
+    return (slot != NotFound && mKeys[slot] == dpid) ? slot : NotFound;
+  }
+
+  bool contains(const DataPointIdentifier& dpid) const noexcept { return find(dpid) != NotFound; }
+
+  /// number of indexed DPIDs
+  size_t size() const noexcept { return mKeys.size(); }
+  bool empty() const noexcept { return mKeys.empty(); }
+
+  /// DPID stored in the given dense slot
+  const DataPointIdentifier& operator[](int slot) const { return mKeys[slot]; }
+  const std::vector<DataPointIdentifier>& keys() const noexcept { return mKeys; }
+
+ private:
+  size_t position(uint64_t h, uint32_t seed) const noexcept
+  {
+    return DataPointIdentifier::mix(h ^ (uint64_t(seed) * 0x9E3779B97F4A7C15)) % mTable.size();
+  }
+
+  std::vector<uint32_t> mSeeds;           // displacement seed per bucket
+  std::vector<int> mTable;                // table position -> dense slot (or NotFound)
+  std::vector<DataPointIdentifier> mKeys; // dense slot -> DPID
+};
+
+} // namespace dcs
+} // namespace o2
+
+#endif /* O2_DCS_DATAPOINT_INDEX_H */
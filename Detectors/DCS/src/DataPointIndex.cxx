@@ -0,0 +1,105 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "DetectorsDCS/DataPointIndex.h"
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace o2::dcs;
+
+void DataPointIndex::build(const std::vector<DataPointIdentifier>& dpids)
+{
+  constexpr uint32_t MaxSeed = 1u << 16; // seeds tried per bucket before enlarging the table
+  constexpr int MaxAttempts = 8;         // table enlargements before giving up
+
+  mKeys.clear();
+  mSeeds.clear();
+  mTable.clear();
+
+  std::unordered_set<DataPointIdentifier> seen;
+  seen.reserve(dpids.size());
+  for (const auto& dpid : dpids) {
+    if (seen.insert(dpid).second) {
+      mKeys.push_back(dpid);
+    }
+  }
+  const size_t n = mKeys.size();
+  if (n == 0) {
+    return;
+  }
+
+  std::vector<uint64_t> hashes(n);
+  for (size_t i = 0; i < n; i++) {
+    hashes[i] = mKeys[i].hash_code();
+  }
+  // distinct DPIDs with identical 64-bit hash cannot be separated by any seed
+  std::vector<uint64_t> sorted(hashes);
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+    throw std::runtime_error("DataPointIndex: 64-bit hash collision between distinct DPIDs");
+  }
+
+  const size_t nBuckets = std::max<size_t>(1, (n + 3) / 4);
+  std::vector<std::vector<int>> buckets(nBuckets);
+  for (size_t i = 0; i < n; i++) {
+    buckets[hashes[i] % nBuckets].push_back(i);
+  }
+  // place the most populated buckets first, while the table is still empty
+  std::vector<int> order(nBuckets);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+
+  size_t tableSize = n + n / 4 + 1;
+  std::vector<size_t> positions;
+  for (int attempt = 0; attempt < MaxAttempts; attempt++, tableSize += tableSize / 2) {
+    mTable.assign(tableSize, NotFound);
+    mSeeds.assign(nBuckets, 0);
+    bool placedAll = true;
+    for (int b : order) {
+      const auto& bucket = buckets[b];
+      if (bucket.empty()) {
+        break; // buckets are sorted by size
+      }
+      bool placed = false;
+      for (uint32_t seed = 0; seed < MaxSeed && !placed; seed++) {
+        positions.clear();
+        placed = true;
+        for (int key : bucket) {
+          auto pos = position(hashes[key], seed);
+          if (mTable[pos] != NotFound || std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+            placed = false;
+            break;
+          }
+          positions.push_back(pos);
+        }
+        if (placed) {
+          mSeeds[b] = seed;
+          for (size_t i = 0; i < bucket.size(); i++) {
+            mTable[positions[i]] = bucket[i];
+          }
+        }
+      }
+      if (!placed) {
+        placedAll = false;
+        break;
+      }
+    }
+    if (placedAll) {
+      return;
+    }
+  }
+  std::ostringstream msg;
+  msg << "DataPointIndex: failed to build perfect hash for " << n << " DPIDs";
+  throw std::runtime_error(msg.str());
+}
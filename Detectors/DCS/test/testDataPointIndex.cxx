@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test DCS DataPointIndex
+#define BOOST_TEST_MAIN
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "DetectorsDCS/DataPointIndex.h"
+#include "DetectorsDCS/AliasExpander.h"
+#include <string>
+#include <vector>
+
+using o2::dcs::DataPointIdentifier;
+using o2::dcs::DataPointIndex;
+
+namespace
+{
+std::vector<DataPointIdentifier> makeDPIDs(const std::vector<std::string>& aliases, o2::dcs::DeliveryType type)
+{
+  std::vector<DataPointIdentifier> dpids;
+  for (const auto& alias : aliases) {
+    DataPointIdentifier dpid;
+    DataPointIdentifier::FILL(dpid, alias, type);
+    dpids.push_back(dpid);
+  }
+  return dpids;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(HashIsConsistentWithEquality)
+{
+  DataPointIdentifier a("TOF_HVSTATUS_SIDE0", o2::dcs::DPVAL_INT);
+  DataPointIdentifier b;
+  DataPointIdentifier::FILL(b, std::string("TOF_HVSTATUS_SIDE0"), o2::dcs::DPVAL_INT);
+  DataPointIdentifier c("TOF_HVSTATUS_SIDE1", o2::dcs::DPVAL_INT);
+  BOOST_CHECK(a == b);
+  BOOST_CHECK_EQUAL(a.hash_code(), b.hash_code());
+  BOOST_CHECK(a != c);
+  BOOST_CHECK_NE(a.hash_code(), c.hash_code());
+  // the top bit of the type is ignored by the comparison, the other bits are not
+  DataPointIdentifier d("TOF_HVSTATUS_SIDE0", (o2::dcs::DeliveryType)(o2::dcs::DPVAL_INT | 0x80));
+  DataPointIdentifier e("TOF_HVSTATUS_SIDE0", o2::dcs::DPVAL_DOUBLE);
+  BOOST_CHECK(a == d);
+  BOOST_CHECK_EQUAL(a.hash_code(), d.hash_code());
+  BOOST_CHECK(a != e);
+  BOOST_CHECK_NE(a.hash_code(), e.hash_code());
+}
+
+BOOST_AUTO_TEST_CASE(IndexMapsEveryConfiguredDPToItsSlot)
+{
+  auto dpids = makeDPIDs(o2::dcs::expandAliases({"TOF_HVSTATUS_SIDE[0..1]_SECTOR[0..17]_MODULE[0..4]", "TRD_trd_gas[CO2,O2,H2O]"}), o2::dcs::DPVAL_DOUBLE);
+  DataPointIndex index(dpids);
+  BOOST_CHECK_EQUAL(index.size(), dpids.size());
+  for (size_t i = 0; i < dpids.size(); i++) {
+    BOOST_CHECK_EQUAL(index.find(dpids[i]), int(i));
+    BOOST_CHECK(index[i] == dpids[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(IndexRejectsUnknownDPs)
+{
+  DataPointIndex empty;
+  DataPointIdentifier unknown("UNKNOWN_ALIAS", o2::dcs::DPVAL_INT);
+  BOOST_CHECK_EQUAL(empty.find(unknown), DataPointIndex::NotFound);
+
+  DataPointIndex index(makeDPIDs({"ADAPOS_LG/TEST_000100", "ADAPOS_LG/TEST_000110"}, o2::dcs::DPVAL_STRING));
+  BOOST_CHECK_EQUAL(index.find(unknown), DataPointIndex::NotFound);
+  BOOST_CHECK(!index.contains(DataPointIdentifier("ADAPOS_LG/TEST_000120", o2::dcs::DPVAL_STRING)));
+}
+
+BOOST_AUTO_TEST_CASE(IndexIgnoresDuplicates)
+{
+  auto dpids = makeDPIDs({"A", "B", "A", "C", "B"}, o2::dcs::DPVAL_INT);
+  DataPointIndex index(dpids);
+  BOOST_CHECK_EQUAL(index.size(), 3);
+  BOOST_CHECK_EQUAL(index.find(dpids[0]), 0);
+  BOOST_CHECK_EQUAL(index.find(dpids[1]), 1);
+  BOOST_CHECK_EQUAL(index.find(dpids[3]), 2);
+}
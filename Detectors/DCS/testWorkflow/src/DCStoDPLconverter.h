@@ -19,6 +19,7 @@
 #include "DetectorsDCS/DataPointIdentifier.h"
 #include "DetectorsDCS/DataPointValue.h"
 #include "DetectorsDCS/DataPointCompositeObject.h"
+#include "DetectorsDCS/DataPointIndex.h"
 #include "CommonUtils/StringUtils.h"
 #include <unordered_map>
 #include <functional>
@@ -53,9 +54,22 @@ using DPCOM = o2::dcs::DataPointCompositeObject;
 
 o2f::InjectorFunction dcs2dpl(std::unordered_map<DPID, o2h::DataDescription>& dpid2group, bool fbiFirst, bool verbose = false, int FBIPerInterval = 1)
 {
+  // the set of requested DPs is fixed: build once a perfect-hash index over it and keep the output group of each DP in its slot
+  std::vector<DPID> dpids;
+  dpids.reserve(dpid2group.size());
+  for (const auto& it : dpid2group) {
+    dpids.push_back(it.first);
+  }
+  DataPointIndex dpIndex(dpids);
+  std::vector<o2h::DataDescription> slot2group(dpIndex.size());
+  for (size_t slot = 0; slot < dpIndex.size(); slot++) {
+    slot2group[slot] = dpid2group.at(dpIndex[slot]);
+  }
 
-  return [dpid2group, fbiFirst, verbose, FBIPerInterval](o2::framework::TimingInfo& tinfo, fair::mq::Device& device, fair::mq::Parts& parts, o2f::ChannelRetriever channelRetriever, size_t newTimesliceId, bool& stop) {
-    static std::unordered_map<DPID, DPCOM> cache; // will keep only the latest measurement in the 1-second wide window for each DPID
+  return [dpIndex, slot2group, fbiFirst, verbose, FBIPerInterval](o2::framework::TimingInfo& tinfo, fair::mq::Device& device, fair::mq::Parts& parts, o2f::ChannelRetriever channelRetriever, size_t newTimesliceId, bool& stop) {
+    static std::vector<DPCOM> cache(dpIndex.size());          // will keep only the latest measurement in the 1-second wide window for each DPID
+    static std::vector<bool> isCached(dpIndex.size(), false); // whether the slot was filled in the current window
+    static std::vector<int> cachedSlots;                      // filled slots, in order of first arrival
     static std::unordered_map<std::string, int> sentToChannel;
     static auto timer = std::chrono::high_resolution_clock::now();
     static auto timer0 = std::chrono::high_resolution_clock::now();
@@ -64,7 +78,7 @@ o2f::InjectorFunction dcs2dpl(std::unordered_map<DPID, o2h::DataDescription>& dp
     static size_t nInp = 0, nInpFBI = 0;
     static size_t szInp = 0, szInpFBI = 0;
     if (verbose) {
-      LOG(info) << "In lambda function: ********* Size of unordered_map (--> number of defined groups) = " << dpid2group.size();
+      LOG(info) << "In lambda function: ********* Size of DP index (--> number of requested DPs) = " << dpIndex.size();
     }
     // check if we got FBI (Master) or delta (MasterDelta)
     if (!parts.Size()) {
@@ -102,12 +116,16 @@ o2f::InjectorFunction dcs2dpl(std::unordered_map<DPID, o2h::DataDescription>& dp
         DPCOM src;
         memcpy(&src, ptr, sizeof(DPCOM));
         // do we want to check if this DP was requested ?
-        auto mapEl = dpid2group.find(src.id);
+        auto slot = dpIndex.find(src.id);
         if (verbose) {
-          LOG(info) << "Received DP " << src.id << " (data = " << src.data << "), matched to output-> " << (mapEl == dpid2group.end() ? "none " : mapEl->second.as<std::string>());
+          LOG(info) << "Received DP " << src.id << " (data = " << src.data << "), matched to output-> " << (slot == DataPointIndex::NotFound ? "none " : slot2group[slot].as<std::string>());
         }
-        if (mapEl != dpid2group.end()) {
-          cache[src.id] = src; // this is needed in case in the 1s window we get a new value for the same DP
+        if (slot != DataPointIndex::NotFound) {
+          cache[slot] = src; // this is needed in case in the 1s window we get a new value for the same DP
+          if (!isCached[slot]) {
+            isCached[slot] = true;
+            cachedSlots.push_back(slot);
+          }
         }
       }
     }
@@ -128,11 +146,8 @@ o2f::InjectorFunction dcs2dpl(std::unordered_map<DPID, o2h::DataDescription>& dp
       std::unordered_map<o2h::DataDescription, pmr::vector<DPCOM>, std::hash<o2h::DataDescription>> outputs;
       // in the cache we have the final values of the DPs that we should put in the output
       // distribute DPs over the vectors for each requested output
-      for (auto& it : cache) {
-        auto mapEl = dpid2group.find(it.first);
-        if (mapEl != dpid2group.end()) {
-          outputs[mapEl->second].push_back(it.second);
-        }
+      for (auto slot : cachedSlots) {
+        outputs[slot2group[slot]].push_back(cache[slot]);
       }
       std::uint64_t creation = std::chrono::time_point_cast<std::chrono::milliseconds>(timerNow).time_since_epoch().count();
       std::unordered_map<std::string, std::unique_ptr<fair::mq::Parts>> messagesPerRoute;
@@ -185,7 +200,10 @@ o2f::InjectorFunction dcs2dpl(std::unordered_map<DPID, o2h::DataDescription>& dp
         sentToChannel[msgIt.first]++;
       }
       timer = timerNow;
-      cache.clear();
+      for (auto slot : cachedSlots) {
+        isCached[slot] = false;
+      }
+      cachedSlots.clear();
       if (!messagesPerRoute.empty()) {
         localTFCounter++;
       }
@@ -130,6 +130,8 @@ class MatchGlobalFwd
   bool isMFTTriggered() const { return mMFTTriggered; }
 
   void setMCTruthOn(bool v) { mMCTruthON = v; }
+  ///< set the number of threads matching the MFT ROFrames in parallel
+  void setNThreads(int n);
   ///< set MFT ROFrame duration in microseconds
   void setMFTROFrameLengthMUS(float fums);
   ///< set MFT ROFrame duration in BC (continuous mode only)
@@ -153,11 +155,37 @@ class MatchGlobalFwd
   void doMCMatching();
   void loadMatches();
 
-  o2::MCCompLabel computeLabel(const int MCHId, const int MFTid);
+  o2::MCCompLabel computeLabel(const int MCHId, const int MFTid) const;
 
-  ///< Matches MFT tracks in one MFT ROFrame with all MCH tracks in the overlapping MCH ROFrames
+  ///< MFT-MCH pair passing the candidate cut
+  struct MatchCandidate {
+    int MCHId = -1;
+    int MFTId = -1;
+    double score = 0.;
+    bool correct = false; ///< the MC labels of the pair agree
+  };
+
+  ///< MFT tracks of one ROFrame binned in (x, y) at the matching plane
+  struct MFTPlaneGrid {
+    static constexpr int MaxCells = 128; ///< max number of cells per dimension
+    float xMin = 0.f, yMin = 0.f;
+    float cellInvX = 0.f, cellInvY = 0.f;
+    int nX = 0, nY = 0;
+    std::vector<int> cellStart; ///< first entry of each cell in trackIDs, nX * nY + 1 entries
+    std::vector<int> trackIDs;  ///< track IDs sorted by cell
+
+    void build(const TrackLocMFT* tracks, int firstID, int nTracks, float cellSize);
+    ///< fill the IDs of the tracks in the cells overlapping the square of half-size r around (x, y), in increasing order
+    void query(float x, float y, float r, std::vector<int>& ids) const;
+  };
+
+  ///< Finds the candidates of the MFT tracks in one MFT ROFrame with the MCH tracks in the overlapping MCH ROFrames.
+  ///< The candidates are listed in the order of the MCH tracks, then of the MFT tracks. Thread-safe.
+  void findROFCandidates(int MFTROFId, int firstMCHROFId, int lastMCHROFId, std::vector<MatchCandidate>& candidates, MFTPlaneGrid& grid, std::vector<int>& ids) const;
+
+  ///< Updates the MCH tracks with the candidates of one MFT ROFrame and fills the outputs of the save mode
   template <int saveMode>
-  void ROFMatch(int MFTROFId, int firstMCHROFId, int lastMCHROFId);
+  void storeROFCandidates(const std::vector<MatchCandidate>& candidates);
 
   void fitTracks();                                          ///< Fit all matched tracks
   void fitGlobalMuonTrack(o2::dataformats::GlobalFwdTrack&); ///< Kalman filter fit global Forward track by attaching MFT clusters
@@ -327,9 +355,12 @@ class MatchGlobalFwd
 
   const o2::itsmft::TopologyDictionary* mMFTDict{nullptr}; // cluster patterns dictionary
   o2::itsmft::ChipMappingMFT mMFTMapping;
-  bool mMCTruthON = false;      ///< Flag availability of MC truth
-  bool mUseMIDMCHMatch = false; ///< Flag for using MCHMID matches (TrackMCHMID)
-  int mSaveMode = 0;            ///< Output mode [0 = SaveBestMatch; 1 = SaveAllMatches; 2 = SaveTrainingData]
+  bool mMCTruthON = false;        ///< Flag availability of MC truth
+  bool mUseMIDMCHMatch = false;   ///< Flag for using MCHMID matches (TrackMCHMID)
+  int mSaveMode = 0;              ///< Output mode [0 = SaveBestMatch; 1 = SaveAllMatches; 2 = SaveTrainingData]
+  int mNThreads = 1;              ///< number of OMP threads
+  float mSearchWindowNSigma = 0.; ///< MFT candidates searched within nSigma of the MCH track position, 0: all MFT tracks of the ROF
+  float mSearchGridCellSize = 2.; ///< size of the (x, y) cells of the MFT tracks at the matching plane, cm
   MatchingType mMatchingType = MATCHINGUNDEFINED;
   TGeoManager* mGeoManager;
 };
@@ -41,6 +41,8 @@ struct GlobalFwdMatchingParam : public o2::conf::ConfigurableParamHelper<GlobalF
   Int_t saveMode = kBestMatch;                            ///< Global Forward Tracks save mode
   float MFTRadLength = 0.042;                             ///< MFT thickness in radiation length
   float alignResidual = 1.;                               ///< Alignment residual for cluster position uncertainty
+  float searchWindowNSigma = 0.;                          ///< MFT candidates searched within nSigma of the MCH track position (0: all, implied 3 for the cut3Sigma cuts)
+  float searchGridCellSize = 2.;                          ///< Size of the (x, y) cells binning the MFT tracks at the matching plane, cm
 
   bool
     isMatchUpstream() const
@@ -10,6 +10,13 @@
 // or submit itself to any jurisdiction.
 
 #include "GlobalTracking/MatchGlobalFwd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::globaltracking;
 
@@ -66,6 +73,30 @@ void MatchGlobalFwd::init()
 
   mSaveMode = matchingParam.saveMode;
   LOG(info) << "Save mode MFTMCH candidates = " << mSaveMode;
+
+  // the built-in 3 sigma cuts reject the MFT tracks farther than 3 sigma of the MCH track position,
+  // searching only the neighbourhood of the MCH track gives then the same candidates
+  mSearchWindowNSigma = matchingParam.searchWindowNSigma;
+  if (!matchingParam.cutExternalFunction() && (cutFcnStr == "cut3Sigma" || cutFcnStr == "cut3SigmaXYAngles") &&
+      (mSearchWindowNSigma <= 0. || mSearchWindowNSigma > 3.)) {
+    mSearchWindowNSigma = 3.;
+  }
+  mSearchGridCellSize = matchingParam.searchGridCellSize;
+  if (mSearchWindowNSigma > 0.) {
+    LOG(info) << "MFT candidates searched within " << mSearchWindowNSigma << " sigma of the MCH tracks, grid cell size = " << mSearchGridCellSize << " cm";
+  }
+  LOG(info) << "MFTMCH matching threads = " << mNThreads;
+}
+
+//_________________________________________________________
+void MatchGlobalFwd::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  LOG(warning) << "Multithreading is not supported, imposing single thread";
+  mNThreads = 1;
+#endif
 }
 
 //_________________________________________________________
@@ -339,6 +370,7 @@ void MatchGlobalFwd::doMatching()
   auto firstMFTTrackIdInROF = 0;
   auto MFTROFId = mMFTWork.front().roFrame;
   LOG(debug) << "(*) nMCHROFs: " << nMCHROFs << ", mMFTTracks.size(): " << mMFTTracks.size() << " MFTROFId: " << MFTROFId << ",  mMFTTrackROFRec.size(): " << mMFTTrackROFRec.size();
+  std::vector<std::array<int, 3>> rofRanges; // MFT ROF with its first and last compatible MCH ROFs
 
   while ((firstMFTTrackIdInROF < mMFTTracks.size()) && (MFTROFId < mMFTTrackROFRec.size())) {
     auto MFTROFId = mMFTWork[firstMFTTrackIdInROF].roFrame;
@@ -376,10 +408,36 @@ void MatchGlobalFwd::doMatching()
                << mMCHROFTimes[mchROFMatchLast].getMin() << ","
                << mMCHROFTimes[mchROFMatchLast].getMax() << "]  size: " << mMCHTrackROFRec[mchROFMatchLast].getNEntries();
 
-    ROFMatch<saveAllMode>(MFTROFId, mchROFMatchFirst, mchROFMatchLast);
+    rofRanges.push_back({MFTROFId, mchROFMatchFirst, mchROFMatchLast});
   }
 
-  if constexpr (saveAllMode == SaveMode::kBestMatch) { // Otherwise output container is filled by ROFMatch()
+  // The candidates of the MFT ROFs are searched in parallel, then stored in the order of the MFT ROFs
+  // such that the result does not depend on the number of threads. The ROFs are processed by chunks
+  // to bound the memory taken by the candidates.
+  const int chunkSize = 4 * mNThreads;
+  std::vector<std::vector<MatchCandidate>> candidates(chunkSize);
+  std::vector<MFTPlaneGrid> grids(mNThreads);
+  std::vector<std::vector<int>> ids(mNThreads);
+  for (size_t firstROF = 0; firstROF < rofRanges.size(); firstROF += chunkSize) {
+    const int nROFs = std::min<size_t>(chunkSize, rofRanges.size() - firstROF);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int i = 0; i < nROFs; i++) {
+#ifdef WITH_OPENMP
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+      const auto& range = rofRanges[firstROF + i];
+      findROFCandidates(range[0], range[1], range[2], candidates[i], grids[tid], ids[tid]);
+    }
+    for (int i = 0; i < nROFs; i++) {
+      storeROFCandidates<saveAllMode>(candidates[i]);
+    }
+  }
+
+  if constexpr (saveAllMode == SaveMode::kBestMatch) { // Otherwise output container is filled by storeROFCandidates()
     int nFakes = 0, nTrue = 0;
     for (auto& thisMCHTrack : mMCHWork) {
       auto bestMFTMatchID = thisMCHTrack.getMFTTrackID();
@@ -404,14 +462,85 @@ void MatchGlobalFwd::doMatching()
 }
 
 //_________________________________________________________
-template <Int_t saveAllMode>
-void MatchGlobalFwd::ROFMatch(int MFTROFId, int firstMCHROFId, int lastMCHROFId)
+void MatchGlobalFwd::MFTPlaneGrid::build(const TrackLocMFT* tracks, int firstID, int nTracks, float cellSize)
+{
+  float xMax = std::numeric_limits<float>::lowest(), yMax = std::numeric_limits<float>::lowest();
+  xMin = yMin = std::numeric_limits<float>::max();
+  for (int i = 0; i < nTracks; i++) {
+    float x = tracks[i].getX(), y = tracks[i].getY();
+    if (std::isfinite(x) && std::isfinite(y)) {
+      xMin = std::min(xMin, x);
+      xMax = std::max(xMax, x);
+      yMin = std::min(yMin, y);
+      yMax = std::max(yMax, y);
+    }
+  }
+  if (xMin > xMax) { // no valid track
+    nX = nY = 0;
+    cellStart.assign(1, 0);
+    trackIDs.clear();
+    return;
+  }
+  nX = std::min(MaxCells, int((xMax - xMin) / cellSize) + 1);
+  nY = std::min(MaxCells, int((yMax - yMin) / cellSize) + 1);
+  cellInvX = nX / std::max(xMax - xMin, 1e-3f) * (1.f - 1e-6f); // the track at xMax goes into the last cell
+  cellInvY = nY / std::max(yMax - yMin, 1e-3f) * (1.f - 1e-6f);
+  auto getCell = [this](float x, float y) {
+    int ix = std::min(nX - 1, int((x - xMin) * cellInvX));
+    int iy = std::min(nY - 1, int((y - yMin) * cellInvY));
+    return iy * nX + ix;
+  };
+  // counting sort of the tracks by cell, preserving the order of the IDs in each cell
+  cellStart.assign(nX * nY + 1, 0);
+  for (int i = 0; i < nTracks; i++) {
+    float x = tracks[i].getX(), y = tracks[i].getY();
+    if (std::isfinite(x) && std::isfinite(y)) {
+      cellStart[getCell(x, y) + 1]++;
+    }
+  }
+  for (int cell = 0; cell < nX * nY; cell++) {
+    cellStart[cell + 1] += cellStart[cell];
+  }
+  trackIDs.resize(cellStart.back());
+  for (int i = 0; i < nTracks; i++) {
+    float x = tracks[i].getX(), y = tracks[i].getY();
+    if (std::isfinite(x) && std::isfinite(y)) {
+      trackIDs[cellStart[getCell(x, y)]++] = firstID + i;
+    }
+  }
+  for (int cell = nX * nY; cell > 0; cell--) { // restore the cell starts shifted by the filling
+    cellStart[cell] = cellStart[cell - 1];
+  }
+  cellStart[0] = 0;
+}
+
+//_________________________________________________________
+void MatchGlobalFwd::MFTPlaneGrid::query(float x, float y, float r, std::vector<int>& ids) const
 {
-  /// Matches MFT tracks on a given ROF with MCH tracks in a range of ROFs
+  ids.clear();
+  if (!nX) {
+    return;
+  }
+  auto getBin = [](float v, float vMin, float inv, int n) { return std::clamp(int(std::floor((v - vMin) * inv)), 0, n - 1); };
+  constexpr float Margin = 1e-3; // cm, against the rounding at the cell boundaries
+  if (x + r + Margin < xMin || y + r + Margin < yMin || (x - r - Margin - xMin) * cellInvX >= nX || (y - r - Margin - yMin) * cellInvY >= nY) {
+    return;
+  }
+  int ix0 = getBin(x - r - Margin, xMin, cellInvX, nX), ix1 = getBin(x + r + Margin, xMin, cellInvX, nX);
+  int iy0 = getBin(y - r - Margin, yMin, cellInvY, nY), iy1 = getBin(y + r + Margin, yMin, cellInvY, nY);
+  for (int iy = iy0; iy <= iy1; iy++) {
+    ids.insert(ids.end(), trackIDs.begin() + cellStart[iy * nX + ix0], trackIDs.begin() + cellStart[iy * nX + ix1 + 1]);
+  }
+  std::sort(ids.begin(), ids.end());
+}
+
+//_________________________________________________________
+void MatchGlobalFwd::findROFCandidates(int MFTROFId, int firstMCHROFId, int lastMCHROFId, std::vector<MatchCandidate>& candidates, MFTPlaneGrid& grid, std::vector<int>& ids) const
+{
+  /// Finds the candidates of the MFT tracks on a given ROF with MCH tracks in a range of ROFs
   const auto& thisMFTROF = mMFTTrackROFRec[MFTROFId];
   const auto& firstMCHROF = mMCHTrackROFRec[firstMCHROFId];
   const auto& lastMCHROF = mMCHTrackROFRec[lastMCHROFId];
-  int nFakes = 0, nTrue = 0;
 
   auto firstMFTTrackID = thisMFTROF.getFirstEntry();
   auto lastMFTTrackID = firstMFTTrackID + thisMFTROF.getNEntries() - 1;
@@ -419,78 +548,97 @@ void MatchGlobalFwd::ROFMatch(int MFTROFId, int firstMCHROFId, int lastMCHROFId)
   auto firstMCHTrackID = firstMCHROF.getFirstIdx();
   auto lastMCHTrackID = lastMCHROF.getLastIdx();
 
-  auto nMFTTracks = thisMFTROF.getNEntries();
-  auto nMCHTracks = lastMCHTrackID - firstMCHTrackID + 1;
-
-  auto& matchAllChi2 = mMatchingFunctionMap["matchALL"];
-
   LOG(debug) << "Matching MFT ROF " << MFTROFId << " with MCH ROFs [" << firstMCHROFId << "->" << lastMCHROFId << "]";
   LOG(debug) << "   firstMFTTrackID = " << firstMFTTrackID << " ; lastMFTTrackID = " << lastMFTTrackID;
   LOG(debug) << "   firstMCHTrackID = " << firstMCHTrackID << " ; lastMCHTrackID = " << lastMCHTrackID;
-  LOG(debug) << "   thisMFTROF:  " << thisMFTROF.getBCData();
-  LOG(debug) << "   firstMCHROF: " << firstMCHROF;
-  LOG(debug) << "   lastMCHROF:  " << lastMCHROF;
+
+  candidates.clear();
+  const bool useGrid = mSearchWindowNSigma > 0.;
+  if (useGrid) {
+    grid.build(&mMFTWork[firstMFTTrackID], firstMFTTrackID, thisMFTROF.getNEntries(), mSearchGridCellSize);
+  }
 
   // loop over all MCH tracks
   for (auto MCHId = firstMCHTrackID; MCHId <= lastMCHTrackID; MCHId++) {
-    auto& thisMCHTrack = mMCHWork[MCHId];
-    o2::MCCompLabel matchLabel;
-    for (auto MFTId = firstMFTTrackID; MFTId <= lastMFTTrackID; MFTId++) {
-      auto& thisMFTTrack = mMFTWork[MFTId];
-      if (mMCTruthON) {
-        matchLabel = computeLabel(MCHId, MFTId);
-      }
+    const auto& thisMCHTrack = mMCHWork[MCHId];
+    auto testPair = [&](int MFTId) {
+      const auto& thisMFTTrack = mMFTWork[MFTId];
       if (mCutFunc(thisMCHTrack, thisMFTTrack)) {
-        thisMCHTrack.countMFTCandidate();
-        if (mMCTruthON) {
-          if (matchLabel.isCorrect()) {
-            thisMCHTrack.setCloseMatch();
-          }
-        }
-        auto score = mMatchFunc(thisMCHTrack, thisMFTTrack);
-        if (score < thisMCHTrack.getMFTMCHMatchingScore()) {
-          thisMCHTrack.setMFTTrackID(MFTId);
-          auto chi2 = matchAllChi2(thisMCHTrack, thisMFTTrack); // Matching chi2 is stored independently
-          thisMCHTrack.setMFTMCHMatchingScore(score);
-          thisMCHTrack.setMFTMCHMatchingChi2(chi2);
-        }
-        if constexpr (saveAllMode == SaveMode::kSaveAll) { // In saveAllmode save all pairs to output container
-          thisMCHTrack.setMFTTrackID(MFTId);
-          mMatchedTracks.emplace_back(thisMCHTrack);
-          mMatchingInfo.emplace_back(thisMCHTrack);
-          if (mMCTruthON) {
-            mMatchLabels.push_back(matchLabel);
-            mMatchLabels.back().isFake() ? nFakes++ : nTrue++;
-          }
-        }
+        auto& candidate = candidates.emplace_back();
+        candidate.MCHId = MCHId;
+        candidate.MFTId = MFTId;
+        candidate.score = mMatchFunc(thisMCHTrack, thisMFTTrack);
+        candidate.correct = mMCTruthON && computeLabel(MCHId, MFTId).isCorrect();
+      }
+    };
+    if (useGrid) {
+      // only the MFT tracks around the MCH track position at the matching plane
+      const float r = mSearchWindowNSigma * std::sqrt(thisMCHTrack.getSigma2X() + thisMCHTrack.getSigma2Y());
+      if (!std::isfinite(r)) {
+        continue;
+      }
+      grid.query(thisMCHTrack.getX(), thisMCHTrack.getY(), r, ids);
+      for (auto MFTId : ids) {
+        testPair(MFTId);
+      }
+    } else {
+      for (auto MFTId = firstMFTTrackID; MFTId <= lastMFTTrackID; MFTId++) {
+        testPair(MFTId);
+      }
+    }
+  } // /loop over MCH tracks seeds
+}
 
-        if constexpr (saveAllMode == SaveMode::kSaveTrainingData) { // In save training data mode store track parameters at matching plane
-          thisMCHTrack.setMFTTrackID(MFTId);
-          mMatchingInfo.emplace_back(thisMCHTrack);
-          mMCHMatchPlaneParams.emplace_back(thisMCHTrack);
-          mMFTMatchPlaneParams.emplace_back(static_cast<o2::mft::TrackMFT>(thisMFTTrack));
+//_________________________________________________________
+template <Int_t saveAllMode>
+void MatchGlobalFwd::storeROFCandidates(const std::vector<MatchCandidate>& candidates)
+{
+  /// Updates the MCH tracks with the candidates in the order of the serial matching
+  auto& matchAllChi2 = mMatchingFunctionMap["matchALL"];
+  int nFakes = 0, nTrue = 0;
 
-          if (mMCTruthON) {
-            mMatchLabels.push_back(matchLabel);
-            mMatchLabels.back().isFake() ? nFakes++ : nTrue++;
-          }
-        }
+  for (const auto& candidate : candidates) {
+    auto& thisMCHTrack = mMCHWork[candidate.MCHId];
+    const auto& thisMFTTrack = mMFTWork[candidate.MFTId];
+    thisMCHTrack.countMFTCandidate();
+    if (candidate.correct) {
+      thisMCHTrack.setCloseMatch();
+    }
+    if (candidate.score < thisMCHTrack.getMFTMCHMatchingScore()) {
+      thisMCHTrack.setMFTTrackID(candidate.MFTId);
+      auto chi2 = matchAllChi2(thisMCHTrack, thisMFTTrack); // Matching chi2 is stored independently
+      thisMCHTrack.setMFTMCHMatchingScore(candidate.score);
+      thisMCHTrack.setMFTMCHMatchingChi2(chi2);
+    }
+    if constexpr (saveAllMode == SaveMode::kSaveAll) { // In saveAllmode save all pairs to output container
+      thisMCHTrack.setMFTTrackID(candidate.MFTId);
+      mMatchedTracks.emplace_back(thisMCHTrack);
+      mMatchingInfo.emplace_back(thisMCHTrack);
+      if (mMCTruthON) {
+        mMatchLabels.push_back(computeLabel(candidate.MCHId, candidate.MFTId));
+        mMatchLabels.back().isFake() ? nFakes++ : nTrue++;
       }
     }
-    auto bestMFTMatchID = thisMCHTrack.getMFTTrackID();
-    LOG(debug) << "       Matching MCHId = " << MCHId << " ==> bestMFTMatchID = " << thisMCHTrack.getMFTTrackID() << " ; thisMCHTrack.getMFTMCHMatchingChi2() =  " << thisMCHTrack.getMFTMCHMatchingChi2();
-    LOG(debug) << "         MCH COV<X,X> = " << thisMCHTrack.getSigma2X() << " ; COV<Y,Y> = " << thisMCHTrack.getSigma2Y() << " ; pt = " << thisMCHTrack.getPt();
 
-  } // /loop over MCH tracks seeds
+    if constexpr (saveAllMode == SaveMode::kSaveTrainingData) { // In save training data mode store track parameters at matching plane
+      thisMCHTrack.setMFTTrackID(candidate.MFTId);
+      mMatchingInfo.emplace_back(thisMCHTrack);
+      mMCHMatchPlaneParams.emplace_back(thisMCHTrack);
+      mMFTMatchPlaneParams.emplace_back(static_cast<o2::mft::TrackMFT>(thisMFTTrack));
 
-  LOG(debug) << "Finished matching MFT ROF " << MFTROFId << ": " << nMFTTracks << " MFT tracks and " << nMCHTracks << "  MCH Tracks.";
-  if (mMCTruthON) {
+      if (mMCTruthON) {
+        mMatchLabels.push_back(computeLabel(candidate.MCHId, candidate.MFTId));
+        mMatchLabels.back().isFake() ? nFakes++ : nTrue++;
+      }
+    }
+  }
+  if (mMCTruthON && saveAllMode != SaveMode::kBestMatch) {
     LOG(debug) << "   nFakes = " << nFakes << " nTrue = " << nTrue;
   }
 }
 
 //_________________________________________________________
-o2::MCCompLabel MatchGlobalFwd::computeLabel(const int MCHId, const int MFTId)
+o2::MCCompLabel MatchGlobalFwd::computeLabel(const int MCHId, const int MFTId) const
 {
   const auto& mchlabel = mMCHTrkLabels[MCHId];
   const auto& mftlabel = mMFTTrkLabels[MFTId];
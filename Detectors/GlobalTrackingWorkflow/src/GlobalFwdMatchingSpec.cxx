@@ -72,6 +72,7 @@ void GlobalFwdMatchingDPL::init(InitContext& ic)
 {
   o2::base::GRPGeomHelper::instance().setRequest(mGGCCDBRequest);
   mMatching.setMCTruthOn(mUseMC);
+  mMatching.setNThreads(std::max(1, ic.options().get<int>("nthreads")));
 
   const auto& matchingParam = GlobalFwdMatchingParam::Instance();
   if (matchingParam.isMatchUpstream() && mMatchRootOutput) {
@@ -209,7 +210,7 @@ DataProcessorSpec getGlobalFwdMatchingSpec(bool useMC, bool matchRootOutput)
     dataRequest->inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<GlobalFwdMatchingDPL>(dataRequest, ggRequest, useMC, matchRootOutput)},
-    Options{}};
+    Options{{"nthreads", VariantType::Int, 1, {"Number of MFT-MCH matching threads"}}}};
 }
 
 } // namespace globaltracking
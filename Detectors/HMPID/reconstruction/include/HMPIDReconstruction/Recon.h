@@ -25,6 +25,8 @@
 #include <TVector2.h>
 #include <TVector3.h>
 
+#include <cmath>
+#include <gsl/span>
 #include <vector>
 
 #include "HMPIDBase/Param.h"
@@ -50,11 +52,6 @@ class Recon : public TNamed
 
   Recon() : TNamed("RichRec", "RichPat"), // ef : moved from cxx
             fPhotCnt(-1),
-            fPhotFlag(0x0),
-            fPhotClusIndex(0x0),
-            fPhotCkov(0x0),
-            fPhotPhi(0x0),
-            fPhotWei(0x0),
             fCkovSigma2(0),
             fIsWEIGHT(kFALSE),
             fDTheta(0.001),
@@ -85,7 +82,7 @@ class Recon : public TNamed
   // void deleteVars() const; // delete variables
 
   // void     CkovAngle    (AliESDtrack *pTrk,TClonesArray *pCluLst,int index,double nmean,float xRa,float yRa );
-  void ckovAngle(o2::dataformats::MatchInfoHMP* match, const std::vector<o2::hmpid::Cluster> clusters, int index, double nmean, float xRa, float yRa); // reconstructed Theta Cerenkov
+  void ckovAngle(o2::dataformats::MatchInfoHMP* match, gsl::span<const o2::hmpid::Cluster> clusters, int index, double nmean, float xRa, float yRa); // reconstructed Theta Cerenkov
 
   bool findPhotCkov(double cluX, double cluY, double& thetaCer, double& phiCer); // find ckov angle for single photon candidate
   bool findPhotCkov2(double cluX, double cluY, double& thetaCer, double& phiCer);
@@ -95,8 +92,7 @@ class Recon : public TNamed
   // template <typename T = double>
   const TVector2 intWithEdge(TVector2 p1, TVector2 p2); // find intercection between plane and lines of 2 thetaC
 
-  int flagPhot(double ckov, const std::vector<o2::hmpid::Cluster> clusters, float* photChargeVec); // is photon ckov near most probable track ckov
-                                                                                                   //  int flagPhot(double ckov, const std::vector<o2::hmpid::Cluster> clusters); // is photon ckov near most probable track ckov
+  int flagPhot(double ckov, gsl::span<const o2::hmpid::Cluster> clusters, float* photChargeVec); // is photon ckov near most probable track ckov
 
   double houghResponse(); // most probable track ckov angle
   // template <typename T = double>
@@ -106,7 +102,8 @@ class Recon : public TNamed
   // template <typename T = double>
   void refract(TVector3& dir, double n1, double n2) const; //
 
-  TVector2 tracePhot(double ckovTh, double ckovPh) const; // trace photon created by track to PC
+  TVector2 tracePhot(double ckovTh, double ckovPh) const;                       // trace photon created by track to PC
+  bool tracePhot(double ckovTh, double ckovPh, double& xPc, double& yPc) const; // same without temporaries, false if the photon does not reach PC
 
   // ef : commented out addObjectToFriends
   // void     addObjectToFriends(TClonesArray *pCluLst, int photonIndex, AliESDtrack *pTrk   );     // Add AliHMPIDCluster object to ESD friends
@@ -135,6 +132,10 @@ class Recon : public TNamed
   {
     fTrkDir.SetMagThetaPhi(1., theta, phi);
     fTrkPos.Set(xRad, yRad);
+    fTrkCosTh = std::cos(theta);
+    fTrkSinTh = std::sin(theta);
+    fTrkCosPh = std::cos(phi);
+    fTrkSinPh = std::sin(phi);
   } // set track parameter at RAD
 
   void setImpPC(double xPc, double yPc)
@@ -154,14 +155,38 @@ class Recon : public TNamed
                         kNoRad = -22 };
   //
  protected:
+  /// Constants of the photon tracing from the middle of RAD to PC, they depend only on the
+  /// running refractive index of the radiator and are recomputed only when it changes.
+  /// A photon of polar angle theta in LORS reaches PC at the distance
+  /// halfRad*tan(theta) + winThick*tan(thetaWin) + gapThick*tan(thetaGap) from the track at RAD
+  struct TraceGeom {
+    double refIdx = -1.;     // radiator refractive index the constants were computed for
+    double thetaCrit = 0.;   // total reflection angle on the WIN-GAP boundary, [rad]
+    double tanCrit = 0.;     // its tangent
+    double radWinRatio = 0.; // ratio of the RAD and WIN refractive indices
+    double radGapRatio = 0.; // ratio of the RAD and GAP refractive indices
+    double halfRad = 0.;     // distance from the middle of RAD to the RAD-WIN boundary
+    double winThick = 0.;    // WIN thickness
+    double gapThick = 0.;    // GAP thickness
+  };
+
+  const TraceGeom& traceGeom() const;                                                  // tracing constants for the running refractive index
+  double radialShift(const TraceGeom& geom, double sinThe, double cosThe) const;       // distance travelled in XY from the middle of RAD to PC
+  void lors2Trs(double x, double y, double z, double& thetaCer, double& phiCer) const; // LORS to TRS without temporaries
+  double ringWeight(int bin);                                                          // weight of the photons in a Hough bin
+
   int fPhotCnt; // counter of photons candidate
 
-  //  ef : changed to smart-pointer arrays
-  std::unique_ptr<int[]> fPhotFlag;      // flags of photon candidates
-  std::unique_ptr<int[]> fPhotClusIndex; // cluster index of photon candidates
-  std::unique_ptr<double[]> fPhotCkov;   // Ckov angles of photon candidates, [rad]
-  std::unique_ptr<double[]> fPhotPhi;    // phis of photons candidates, [rad]
-  std::unique_ptr<double[]> fPhotWei;    // weigths of photon candidates
+  // ef : changed to vectors, kept allocated across the tracks
+  std::vector<int> fPhotFlag;          //! flags of photon candidates
+  std::vector<int> fPhotClusIndex;     //! cluster index of photon candidates
+  std::vector<double> fPhotCkov;       //! Ckov angles of photon candidates, [rad]
+  std::vector<double> fPhotPhi;        //! phis of photons candidates, [rad]
+  std::vector<double> fPhotWei;        //! weigths of photon candidates
+  std::vector<double> fHoughPhots;     //! Hough histogram of the photon candidates, bin 0 is the underflow
+  std::vector<double> fHoughPhotsW;    //! same weighted
+  std::vector<double> fHoughResult;    //! weighted photons in the sliding window
+  std::vector<double> fHoughBinWeight; //! cache of the weights per bin, 0 if not yet computed
 
   // int    *fPhotClusIndex;                     // cluster index of photon candidates
 
@@ -180,13 +205,20 @@ class Recon : public TNamed
   TVector2 fMipPos; // mip positon for a given trackf // XY
   TVector2 fPc;     // track position at PC           // XY
 
+  double fTrkCosTh = 1.; //! cos of the track theta in LORS
+  double fTrkSinTh = 0.; //! sin of the track theta in LORS
+  double fTrkCosPh = 1.; //! cos of the track phi in LORS
+  double fTrkSinPh = 0.; //! sin of the track phi in LORS
+
+  mutable TraceGeom fTraceGeom; //! tracing constants
+
   o2::hmpid::Param* fParam = o2::hmpid::Param::instance(); // Pointer to HMPIDParam
 
  private:
   Recon(const Recon& r);            // dummy copy constructor
   Recon& operator=(const Recon& r); // dummy assignment operator
   //
-  ClassDef(Recon, 3)
+  ClassDef(Recon, 4)
 };
 
 } // namespace hmpid
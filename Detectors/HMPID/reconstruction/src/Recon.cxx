@@ -14,8 +14,9 @@
 // #include "ReconstructionDataFormats/MatchInfoHMP.h"
 
 #include <TRotation.h> //TracePhot()
-#include <TH1D.h>      //HoughResponse()
-#include <TRandom.h>   //HoughResponse()
+#include <TMath.h>
+
+#include <cmath>
 
 #include "ReconstructionDataFormats/MatchInfoHMP.h"
 #include "ReconstructionDataFormats/Track.h"
@@ -35,18 +36,18 @@ void Recon::initVars(int n)
     return;
   }
 
-  // ef : changed to smart-pointer Array
-  // fPhotFlag = new int[n];
-  fPhotFlag = std::unique_ptr<int[]>(new int[n]);
-  fPhotClusIndex = std::unique_ptr<int[]>(new int[n]);
-
-  fPhotCkov = std::unique_ptr<double[]>(new double[n]);
-  fPhotPhi = std::unique_ptr<double[]>(new double[n]);
-  fPhotWei = std::unique_ptr<double[]>(new double[n]);
+  // ef : changed to vectors, they only grow so that there is no allocation per track
+  if (fPhotCkov.size() < (size_t)n) {
+    fPhotFlag.resize(n);
+    fPhotClusIndex.resize(n);
+    fPhotCkov.resize(n);
+    fPhotPhi.resize(n);
+    fPhotWei.resize(n);
+  }
   //
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-void Recon::ckovAngle(o2::dataformats::MatchInfoHMP* match, const std::vector<o2::hmpid::Cluster> clusters, int index, double nmean, float xRa, float yRa)
+void Recon::ckovAngle(o2::dataformats::MatchInfoHMP* match, gsl::span<const o2::hmpid::Cluster> clusters, int index, double nmean, float xRa, float yRa)
 {
   // Pattern recognition method based on Hough transform
   // Arguments:   pTrk     - track for which Ckov angle is to be found
@@ -76,7 +77,7 @@ void Recon::ckovAngle(o2::dataformats::MatchInfoHMP* match, const std::vector<o2
 
   for (int iClu = 0; iClu < clusters.size(); iClu++) { // clusters loop
 
-    o2::hmpid::Cluster cluster = clusters.at(iClu);
+    const auto& cluster = clusters[iClu];
     nPads += cluster.size();
     if (iClu == index) { // this is the MIP! not a photon candidate: just store mip info
       mipX = cluster.x();
@@ -146,14 +147,15 @@ bool Recon::findPhotCkov(double cluX, double cluY, double& thetaCer, double& phi
   // Arguments: cluX,cluY - position of cadidate's cluster
   // Returns: Cerenkov angle
 
-  TVector3 dirCkov;
-
-  double zRad = -0.5 * fParam->radThick() - 0.5 * fParam->winThick();   // z position of middle of RAD
-  TVector3 rad(fTrkPos.X(), fTrkPos.Y(), zRad);                         // impact point at middle of RAD
-  TVector3 pc(cluX, cluY, 0.5 * fParam->winThick() + fParam->gapIdx()); // mip at PC
+  // the photon stays in the plane of the track at RAD and the cluster, the bisection only moves it
+  // along the line: no vector temporaries, the tracing is a closed form function of theta
+  const auto& geom = traceGeom();
   double cluR = TMath::Sqrt((cluX - fPc.X()) * (cluX - fPc.X()) +
                             (cluY - fPc.Y()) * (cluY - fPc.Y())); // ref. distance impact RAD-CLUSTER
-  double phi = (pc - rad).Phi();                                  // phi of photon
+  double dx = cluX - fTrkPos.X(), dy = cluY - fTrkPos.Y();
+  double phi = (dx == 0 && dy == 0) ? 0. : std::atan2(dy, dx); // phi of photon
+  double cosPhi = std::cos(phi), sinPhi = std::sin(phi);
+  double x0 = fTrkPos.X() - fPc.X(), y0 = fTrkPos.Y() - fPc.Y(); // RAD impact w.r.t. PC impact
 
   double ckov1 = 0;
   double ckov2 = 0.75 + fTrkDir.Theta(); // start to find theta cerenkov in DRS
@@ -164,22 +166,22 @@ bool Recon::findPhotCkov(double cluX, double cluY, double& thetaCer, double& phi
       return kFALSE;
     }
     double ckov = 0.5 * (ckov1 + ckov2);
-    dirCkov.SetMagThetaPhi(1, ckov, phi);
-    TVector2 posC = traceForward(dirCkov);   // trace photon with actual angles
-    double dist = cluR - (posC - fPc).Mod(); // get distance between trial point and cluster position
-    if (posC.X() == -999) {
-      dist = -999;
-    }           // total reflection problem
+    double dist = -999; // total reflection problem
+    double r = ckov > geom.thetaCrit ? -1. : radialShift(geom, std::sin(ckov), std::cos(ckov)); // trace photon with actual angles
+    if (r >= 0) {
+      double xC = x0 + r * cosPhi, yC = y0 + r * sinPhi;
+      dist = cluR - std::sqrt(xC * xC + yC * yC); // get distance between trial point and cluster position
+    }
     iIterCnt++; // counter step
     if (dist > kTol) {
       ckov1 = ckov;
     } // cluster @ larger ckov
     else if (dist < -kTol) {
       ckov2 = ckov;
-    }                                       // cluster @ smaller ckov
-    else {                                  // precision achived: ckov in DRS found
-      dirCkov.SetMagThetaPhi(1, ckov, phi); //
-      lors2Trs(dirCkov, thetaCer, phiCer);  // find ckov (in TRS:the effective Cherenkov angle!)
+    }      // cluster @ smaller ckov
+    else { // precision achived: ckov in DRS found
+      double sinCkov = std::sin(ckov);
+      lors2Trs(sinCkov * cosPhi, sinCkov * sinPhi, std::cos(ckov), thetaCer, phiCer); // find ckov (in TRS:the effective Cherenkov angle!)
       return kTRUE;
     }
   }
@@ -230,21 +232,55 @@ TVector2 Recon::traceForward(TVector3 dirCkov) const
   //    Returns: pos of traced photon at PC
 
   TVector2 pos(-999, -999);
-  double thetaCer = dirCkov.Theta();
-  if (thetaCer > TMath::ASin(1. / fParam->getRefIdx())) {
+  const auto& geom = traceGeom();
+  if (dirCkov.Theta() > geom.thetaCrit) {
+    return pos;
+  } // total refraction on WIN-GAP boundary
+  double perp = dirCkov.Perp();
+  double r = radialShift(geom, perp / dirCkov.Mag(), dirCkov.CosTheta()); // RAD: photon starts at the track position @ middle of RAD
+  if (r < 0) {
     return pos;
-  }                                                                           // total refraction on WIN-GAP boundary
-  double zRad = -0.5 * fParam->radThick() - 0.5 * fParam->winThick();         // z position of middle of RAD
-  TVector3 posCkov(fTrkPos.X(), fTrkPos.Y(), zRad);                           // RAD: photon position is track position @ middle of RAD
-  propagate(dirCkov, posCkov, -0.5 * fParam->winThick());                     // go to RAD-WIN boundary
-  refract(dirCkov, fParam->getRefIdx(), fParam->winIdx());                    // RAD-WIN refraction
-  propagate(dirCkov, posCkov, 0.5 * fParam->winThick());                      // go to WIN-GAP boundary
-  refract(dirCkov, fParam->winIdx(), fParam->gapIdx());                       // WIN-GAP refraction
-  propagate(dirCkov, posCkov, 0.5 * fParam->winThick() + fParam->gapThick()); // go to PC
-  pos.Set(posCkov.X(), posCkov.Y());
+  }
+  double cosPhi = perp > 0 ? dirCkov.X() / perp : 1., sinPhi = perp > 0 ? dirCkov.Y() / perp : 0.;
+  pos.Set(fTrkPos.X() + r * cosPhi, fTrkPos.Y() + r * sinPhi);
   return pos;
 
 } // TraceForward()
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+const Recon::TraceGeom& Recon::traceGeom() const
+{
+  // Constants of the photon tracing for the running refractive index of the radiator
+  double refIdx = fParam->getRefIdx();
+  if (fTraceGeom.refIdx != refIdx) {
+    fTraceGeom.refIdx = refIdx;
+    fTraceGeom.thetaCrit = TMath::ASin(1. / refIdx);
+    fTraceGeom.tanCrit = std::tan(fTraceGeom.thetaCrit);
+    fTraceGeom.radWinRatio = refIdx / fParam->winIdx();
+    fTraceGeom.radGapRatio = refIdx / fParam->gapIdx();
+    fTraceGeom.halfRad = 0.5 * fParam->radThick();
+    fTraceGeom.winThick = fParam->winThick();
+    fTraceGeom.gapThick = fParam->gapThick();
+  }
+  return fTraceGeom;
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+double Recon::radialShift(const TraceGeom& geom, double sinThe, double cosThe) const
+{
+  // Distance in XY travelled by a photon from the middle of RAD up to PC
+  //  Arguments: sinThe,cosThe - polar angle of the photon in LORS, below the total reflection angle
+  //    Returns: distance, negative if the photon is reflected on the WIN-GAP boundary
+  // Same as propagating through RAD, WIN and GAP with the Snell law at each boundary:
+  // n_RAD*sin(theta) is conserved, the azimuth is not changed by the refractions
+
+  double sinWin = geom.radWinRatio * sinThe; // RAD-WIN refraction
+  double sinGap = geom.radGapRatio * sinThe; // WIN-GAP refraction
+  if (sinGap >= 1.) {
+    return -1;
+  }
+  return geom.halfRad * sinThe / cosThe +
+         geom.winThick * sinWin / std::sqrt(1. - sinWin * sinWin) +
+         geom.gapThick * sinGap / std::sqrt(1. - sinGap * sinGap);
+}
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 void Recon::lors2Trs(TVector3 dirCkov, double& thetaCer, double& phiCer) const
@@ -271,6 +307,19 @@ void Recon::lors2Trs(TVector3 dirCkov, double& thetaCer, double& phiCer) const
   thetaCer = dirCkovTRS.Theta(); // actual value of thetaCerenkov of the photon
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+void Recon::lors2Trs(double x, double y, double z, double& thetaCer, double& phiCer) const
+{
+  // Same as above for the photon vector (x,y,z) in LORS, with the rotation by -phi around Z
+  // and then by -theta around Y of the track computed from its cached sin and cos
+
+  double x1 = fTrkCosPh * x + fTrkSinPh * y;
+  double y1 = -fTrkSinPh * x + fTrkCosPh * y;
+  double x2 = fTrkCosTh * x1 - fTrkSinTh * z;
+  double z2 = fTrkSinTh * x1 + fTrkCosTh * z;
+  phiCer = (x2 == 0 && y1 == 0) ? 0. : std::atan2(y1, x2);
+  thetaCer = (x2 == 0 && y1 == 0 && z2 == 0) ? 0. : std::atan2(std::sqrt(x2 * x2 + y1 * y1), z2);
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 void Recon::trs2Lors(TVector3 dirCkov, double& thetaCer, double& phiCer) const
 {
   // Theta Cerenkov reconstruction
@@ -308,39 +357,28 @@ void Recon::findRingGeom(double ckovAng, int level)
   Double_t area = 0;
 
   Bool_t first = kFALSE;
-  TVector2 pos1;
+  double x1 = 0, y1 = 0, xMip = fMipPos.X(), yMip = fMipPos.Y();
 
   for (Int_t i = 0; i < kN; i++) {
-    if (!first) {
-      pos1 = tracePhot(ckovAng, Double_t(TMath::TwoPi() * (i + 1) / kN)); // find a good trace for the first photon
-      if (pos1.X() == -999) {
-        continue;
-      } // no area: open ring
-      if (!fParam->isInside(pos1.X(), pos1.Y(), 0)) {
-        pos1 = intWithEdge(fMipPos, pos1); // find the very first intersection...
-      } else {
-        if (!fParam->isInDead(pos1.X(), pos1.Y())) {
-          nPoints++;
-        } // photon is accepted if not in dead zone
-      }
-      first = kTRUE;
+    double x2, y2;
+    if (!tracePhot(ckovAng, Double_t(TMath::TwoPi() * (i + 1) / kN), x2, y2)) { // trace the next photon
       continue;
-    }
-    TVector2 pos2 = tracePhot(ckovAng, Double_t(TMath::TwoPi() * (i + 1) / kN)); // trace the next photon
-    if (pos2.X() == -999) {
-      {
-        continue;
-      }
     } // no area: open ring
-    if (!fParam->isInside(pos2.X(), pos2.Y(), 0)) {
-      pos2 = intWithEdge(fMipPos, pos2);
+    if (!fParam->isInside(x2, y2, 0)) {
+      TVector2 pint = intWithEdge(fMipPos, TVector2(x2, y2)); // find the intersection with the edge
+      x2 = pint.X();
+      y2 = pint.Y();
     } else {
-      if (!fParam->isInDead(pos2.X(), pos2.Y())) {
+      if (!fParam->isInDead(x2, y2)) {
         nPoints++;
       } // photon is accepted if not in dead zone
     }
-    area += TMath::Abs((pos1 - fMipPos).X() * (pos2 - fMipPos).Y() - (pos1 - fMipPos).Y() * (pos2 - fMipPos).X()); // add area of the triangle...
-    pos1 = pos2;
+    if (first) {
+      area += TMath::Abs((x1 - xMip) * (y2 - yMip) - (y1 - yMip) * (x2 - xMip)); // add area of the triangle...
+    }
+    first = kTRUE;
+    x1 = x2;
+    y1 = y2;
   }
   //---  find area and length of the ring;
   fRingAcc = (Double_t)nPoints / (Double_t)kN;
@@ -437,8 +475,7 @@ double Recon::findRingCkov(int)
 
 } // FindCkovRing()
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-int Recon::flagPhot(double ckov, const std::vector<o2::hmpid::Cluster> clusters, float* photChargeVec)
-// int Recon::flagPhot(double ckov, const std::vector<o2::hmpid::Cluster> clusters)
+int Recon::flagPhot(double ckov, gsl::span<const o2::hmpid::Cluster> clusters, float* photChargeVec)
 {
   // Flag photon candidates if their individual ckov angle is inside the window around ckov angle returned by  HoughResponse()
   // Arguments: ckov- value of most probable ckov angle for track as returned by HoughResponse()
@@ -462,8 +499,7 @@ int Recon::flagPhot(double ckov, const std::vector<o2::hmpid::Cluster> clusters,
     fPhotFlag[i] = 0;
     if (fPhotCkov[i] >= tmin && fPhotCkov[i] <= tmax) {
       fPhotFlag[i] = 2;
-      o2::hmpid::Cluster cluster = clusters.at(fPhotClusIndex[i]);
-      float charge = cluster.q();
+      float charge = clusters[fPhotClusIndex[i]].q();
       if (iInsideCnt < 10) {
         photChargeVec[iInsideCnt] = charge;
       } // AddObjectToFriends(pCluLst,i,pTrk);
@@ -481,15 +517,42 @@ TVector2 Recon::tracePhot(double ckovThe, double ckovPhi) const
   // Arguments: ckovThe,ckovPhi- photon ckov angles in TRS, [rad]
   //   Returns: distance between photon point on PC and track projection
 
-  double theta, phi;
-  TVector3 dirTRS, dirLORS;
-  dirTRS.SetMagThetaPhi(1, ckovThe, ckovPhi); // photon in TRS
-  trs2Lors(dirTRS, theta, phi);
-  dirLORS.SetMagThetaPhi(1, theta, phi); // photon in LORS
-  return traceForward(dirLORS);          // now foward tracing
+  TVector2 pos(-999, -999);
+  double x, y;
+  if (tracePhot(ckovThe, ckovPhi, x, y)) {
+    pos.Set(x, y);
+  }
+  return pos;
 
 } // tracePhot()
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+bool Recon::tracePhot(double ckovThe, double ckovPhi, double& xPc, double& yPc) const
+{
+  // Same as above without temporaries
+  // Arguments: ckovThe,ckovPhi- photon ckov angles in TRS, [rad]
+  //   Returns: false if the photon does not reach PC
+  //   On exit: xPc,yPc photon point on PC
+
+  double sinThe = std::sin(ckovThe);
+  double x = sinThe * std::cos(ckovPhi), y = sinThe * std::sin(ckovPhi), z = std::cos(ckovThe); // photon in TRS
+  double x1 = fTrkCosTh * x + fTrkSinTh * z;                                                      // rotation by theta around Y and phi around Z of the track
+  double z1 = -fTrkSinTh * x + fTrkCosTh * z;
+  double xL = fTrkCosPh * x1 - fTrkSinPh * y; // photon in LORS
+  double yL = fTrkSinPh * x1 + fTrkCosPh * y;
+  double perp = std::sqrt(xL * xL + yL * yL);
+  const auto& geom = traceGeom();
+  if (z1 <= 0 || perp > geom.tanCrit * z1) {
+    return false;
+  } // total refraction on WIN-GAP boundary
+  double r = radialShift(geom, perp, z1); // now foward tracing
+  if (r < 0) {
+    return false;
+  }
+  xPc = fTrkPos.X() + (perp > 0 ? r * xL / perp : r);
+  yPc = fTrkPos.Y() + (perp > 0 ? r * yL / perp : 0.);
+  return true;
+} // tracePhot()
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 void Recon::propagate(const TVector3 dir, TVector3& pos, double z) const
 {
   // Finds an intersection point between a line and XY plane shifted along Z.
@@ -525,36 +588,27 @@ void Recon::refract(TVector3& dir, double n1, double n2) const
 double Recon::houghResponse()
 {
   //    fIdxMip = mipId;
+  // The histograms are plain arrays with the binning of TH1D(nChannels, 0, kThetaMax), bin 0 is the underflow
 
   Double_t kThetaMax = 0.75;
   Int_t nChannels = (Int_t)(kThetaMax / fDTheta + 0.5);
-  TH1D* phots = new TH1D("Rphot", "phots", nChannels, 0, kThetaMax);
-  TH1D* photsw = new TH1D("RphotWeighted", "photsw", nChannels, 0, kThetaMax);
-  TH1D* resultw = new TH1D("resultw", "resultw", nChannels, 0, kThetaMax);
   Int_t nBin = (Int_t)(kThetaMax / fDTheta);
   Int_t nCorrBand = (Int_t)(fWindowWidth / (2 * fDTheta));
+  fHoughPhots.assign(nChannels + 2, 0.);
+  fHoughPhotsW.assign(nChannels + 2, 0.);
+  fHoughResult.assign(nChannels + 2, 0.);
+  fHoughBinWeight.assign(nChannels + 2, 0.);
+  auto findBin = [nChannels, kThetaMax](double x) { return x < kThetaMax ? 1 + (Int_t)(nChannels * x / kThetaMax) : nChannels + 1; };
 
   for (Int_t i = 0; i < fPhotCnt; i++) { // photon cadidates loop
     Double_t angle = fPhotCkov[i];
     if (angle < 0 || angle > kThetaMax) {
       continue;
     }
-    phots->Fill(angle);
-    Int_t bin = (Int_t)(0.5 + angle / (fDTheta));
-    Double_t weight = 1.;
-    if (fIsWEIGHT) {
-      Double_t lowerlimit = ((Double_t)bin) * fDTheta - 0.5 * fDTheta;
-      Double_t upperlimit = ((Double_t)bin) * fDTheta + 0.5 * fDTheta;
-      findRingGeom(lowerlimit);
-      Double_t areaLow = getRingArea();
-      findRingGeom(upperlimit);
-      Double_t areaHigh = getRingArea();
-      Double_t diffArea = areaHigh - areaLow;
-      if (diffArea > 0) {
-        weight = 1. / diffArea;
-      }
-    }
-    photsw->Fill(angle, weight);
+    Int_t hbin = findBin(angle);
+    fHoughPhots[hbin] += 1.;
+    Double_t weight = fIsWEIGHT ? ringWeight((Int_t)(0.5 + angle / (fDTheta))) : 1.;
+    fHoughPhotsW[hbin] += weight;
     fPhotWei[i] = weight;
   } // photon candidates loop
 
@@ -567,27 +621,53 @@ double Recon::houghResponse()
     if (bin2 > nBin) {
       bin2 = nBin;
     }
-    Double_t sumPhots = phots->Integral(bin1, bin2);
+    Double_t sumPhots = 0;
+    for (Int_t j = bin1; j <= bin2; j++) {
+      sumPhots += fHoughPhots[j];
+    }
     if (sumPhots < 3) {
       continue;
     } // if less then 3 photons don't trust to this ring
-    Double_t sumPhotsw = photsw->Integral(bin1, bin2);
     if ((Double_t)((i + 0.5) * fDTheta) > 0.7) {
       continue;
     }
-    resultw->Fill((Double_t)((i + 0.5) * fDTheta), sumPhotsw);
+    Double_t sumPhotsw = 0;
+    for (Int_t j = bin1; j <= bin2; j++) {
+      sumPhotsw += fHoughPhotsW[j];
+    }
+    fHoughResult[findBin((Double_t)((i + 0.5) * fDTheta))] += sumPhotsw;
   }
   // evaluate the "BEST" theta ckov as the maximum value of histogramm
-  Double_t* pVec = resultw->GetArray();
-  Int_t locMax = TMath::LocMax(nBin, pVec);
-  delete phots;
-  delete photsw;
-  delete resultw; // Reset and delete objects
+  Int_t locMax = TMath::LocMax(nBin, fHoughResult.data());
 
   return (Double_t)(locMax * fDTheta + 0.5 * fDTheta); // final most probable track theta ckov
 
 } // HoughResponse()
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+double Recon::ringWeight(int bin)
+{
+  // Weight of the photon candidates in a bin of the Hough transform: inverse of the ring area between its limits.
+  // The weight depends only on the bin, it is computed once per track for all the candidates sharing the bin
+  if (bin >= (int)fHoughBinWeight.size()) {
+    fHoughBinWeight.resize(bin + 1, 0.);
+  }
+  if (fHoughBinWeight[bin] == 0.) {
+    Double_t weight = 1.;
+    Double_t lowerlimit = ((Double_t)bin) * fDTheta - 0.5 * fDTheta;
+    Double_t upperlimit = ((Double_t)bin) * fDTheta + 0.5 * fDTheta;
+    findRingGeom(lowerlimit);
+    Double_t areaLow = getRingArea();
+    findRingGeom(upperlimit);
+    Double_t areaHigh = getRingArea();
+    Double_t diffArea = areaHigh - areaLow;
+    if (diffArea > 0) {
+      weight = 1. / diffArea;
+    }
+    fHoughBinWeight[bin] = weight;
+  }
+  return fHoughBinWeight[bin];
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 double Recon::findRingExt(double ckov, Int_t ch, double xPc, double yPc, double thRa, double phRa)
 {
   // To find the acceptance of the ring even from external inputs.
@@ -604,12 +684,12 @@ double Recon::findRingExt(double ckov, Int_t ch, double xPc, double yPc, double
   if (ckov > 0) {
     setTrack(xRa, yRa, thRa, phRa);
     for (int j = 0; j < nStep; j++) {
-      TVector2 pos;
-      pos = tracePhot(ckov, j * TMath::TwoPi() / (double)(nStep - 1));
-      if (Param::isInDead(pos.X(), pos.Y())) {
+      double x = -999, y = -999;
+      tracePhot(ckov, j * TMath::TwoPi() / (double)(nStep - 1), x, y);
+      if (Param::isInDead(x, y)) {
         continue;
       }
-      fParam->lors2Pad(pos.X(), pos.Y(), ipc, ipadx, ipady);
+      fParam->lors2Pad(x, y, ipc, ipadx, ipady);
       ipadx += (ipc % 2) * fParam->kPadPcX;
       ipady += (ipc / 2) * fParam->kPadPcY;
       if (ipadx < 0 || ipady > 160 || ipady < 0 || ipady > 144 || ch < 0 || ch > 6) {
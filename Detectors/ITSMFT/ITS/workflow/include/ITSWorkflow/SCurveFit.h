@@ -0,0 +1,131 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   SCurveFit.h
+/// @brief  Poisson likelihood fit of the threshold scan S-curves of several pixels at once
+
+#ifndef O2_ITS_SCURVE_FIT_
+#define O2_ITS_SCURVE_FIT_
+
+#include <algorithm>
+#include <cmath>
+
+namespace o2
+{
+namespace its
+{
+
+constexpr int SCurveFitMaxPixels = 64; // max number of pixels fitted together
+
+enum class SCurveFitStatus : unsigned char {
+  Converged,    // parameter steps below tolerance
+  NotConverged, // maximum number of iterations reached
+  Diverged,     // singular information matrix or parameters out of the scan range
+  Invalid       // no valid starting values
+};
+
+/// Fit the S-curves amplitude * (1 + sign * erf((x - thr) / (sqrt(2) * noise))) of nc <= SCurveFitMaxPixels pixels
+/// measured at the same points x[0..nx), using only the points within [xMin, xMax].
+/// counts(i) returns the pointer to the hits of the nc pixels at x[i].
+/// On input thr/noise hold the starting values (pixels with status Invalid are skipped), on output the fitted ones;
+/// chi2 is the likelihood chi2 (as reported by ROOT for likelihood fits) and the return value the number of degrees of freedom.
+/// The likelihood is maximised with Fisher scoring (Gauss-Newton on the Poisson likelihood) until both parameter
+/// steps are below tolerance * noise; the loops over the pixels are kept innermost to be vectorised.
+template <typename Counts>
+int fitSCurves(const double* x, int nx, double xMin, double xMax, Counts&& counts, int nc, double amplitude, double sign,
+               double* thr, double* noise, double* chi2, SCurveFitStatus* status, int maxIterations = 50, double tolerance = 1e-4)
+{
+  const double twoOverSqrtPi = 2. / std::sqrt(M_PI);
+  const double sqrt2 = std::sqrt(2.);
+  const double range = xMax - xMin;
+
+  bool active[SCurveFitMaxPixels];
+  int nActive = 0;
+  for (int c = 0; c < nc; c++) {
+    active[c] = status[c] != SCurveFitStatus::Invalid;
+    if (active[c]) {
+      status[c] = SCurveFitStatus::NotConverged;
+      nActive++;
+    }
+  }
+
+  for (int iter = 0; iter < maxIterations && nActive > 0; iter++) {
+    double g0[SCurveFitMaxPixels] = {0.}, g1[SCurveFitMaxPixels] = {0.};
+    double i00[SCurveFitMaxPixels] = {0.}, i01[SCurveFitMaxPixels] = {0.}, i11[SCurveFitMaxPixels] = {0.};
+    for (int i = 0; i < nx; i++) {
+      if (x[i] < xMin || x[i] > xMax) {
+        continue;
+      }
+      const auto* data = counts(i);
+      for (int c = 0; c < nc; c++) {
+        double z = (x[i] - thr[c]) / (sqrt2 * noise[c]);
+        double f = std::max(amplitude * (1. + sign * std::erf(z)), 1e-9);
+        double dfdz = sign * amplitude * twoOverSqrtPi * std::exp(-z * z);
+        double d0 = -dfdz / (sqrt2 * noise[c]);
+        double d1 = -dfdz * z / noise[c];
+        double r = data[c] / f - 1.;
+        g0[c] += r * d0;
+        g1[c] += r * d1;
+        i00[c] += d0 * d0 / f;
+        i01[c] += d0 * d1 / f;
+        i11[c] += d1 * d1 / f;
+      }
+    }
+    for (int c = 0; c < nc; c++) {
+      if (!active[c]) {
+        continue;
+      }
+      double det = i00[c] * i11[c] - i01[c] * i01[c];
+      double step0 = (i11[c] * g0[c] - i01[c] * g1[c]) / det;
+      double step1 = (i00[c] * g1[c] - i01[c] * g0[c]) / det;
+      if (!(det > 0.) || !std::isfinite(step0) || !std::isfinite(step1)) {
+        status[c] = SCurveFitStatus::Diverged;
+      } else {
+        // damped steps: the threshold moves by at most the noise and the noise changes by at most a factor 2
+        step0 = std::clamp(step0, -noise[c], noise[c]);
+        step1 = std::clamp(step1, -0.5 * noise[c], noise[c]);
+        thr[c] += step0;
+        noise[c] = std::max(noise[c] + step1, 1e-3);
+        if (thr[c] < xMin - range || thr[c] > xMax + range || noise[c] > range) {
+          status[c] = SCurveFitStatus::Diverged;
+        } else if (std::abs(step0) < tolerance * noise[c] && std::abs(step1) < tolerance * noise[c]) {
+          status[c] = SCurveFitStatus::Converged;
+        }
+      }
+      if (status[c] != SCurveFitStatus::NotConverged) {
+        active[c] = false;
+        nActive--;
+      }
+    }
+  }
+
+  int ndf = -2;
+  std::fill(chi2, chi2 + nc, 0.);
+  for (int i = 0; i < nx; i++) {
+    if (x[i] < xMin || x[i] > xMax) {
+      continue;
+    }
+    ndf++;
+    const auto* data = counts(i);
+    for (int c = 0; c < nc; c++) {
+      double z = (x[i] - thr[c]) / (sqrt2 * noise[c]);
+      double f = std::max(amplitude * (1. + sign * std::erf(z)), 1e-9);
+      double y = data[c];
+      chi2[c] += 2. * (f - y + (y > 0 ? y * std::log(y / f) : 0.));
+    }
+  }
+  return ndf;
+}
+
+} // namespace its
+} // namespace o2
+
+#endif
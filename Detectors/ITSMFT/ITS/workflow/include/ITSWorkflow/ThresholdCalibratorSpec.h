@@ -21,6 +21,9 @@
 #include <array>
 #include <set>
 #include <deque>
+#include <algorithm>
+#include <cmath>
+#include <gsl/span>
 
 #include <iostream>
 #include <fstream>
@@ -140,7 +143,11 @@ class ITSThresholdCalibrator : public Task
   float* mX = nullptr;
 
   // Hash tables to store the hit and threshold information per pixel
-  std::map<short int, std::map<int, std::vector<std::vector<std::vector<unsigned short int>>>>> mPixelHits;
+  // The counters of a row are one contiguous block laid out as [step][step2][column] (see hitIndex),
+  // so that for a given scan point the counters of all the pixels of the row are adjacent
+  std::map<short int, std::map<int, std::vector<unsigned short int>>> mPixelHits;
+  size_t hitIndex(short int col, short int step, short int step2 = 0) const { return (size_t(step) * N_RANGE2 + step2) * N_COL + col; }
+  size_t rowHitsSize() const { return size_t(N_COL) * N_RANGE * N_RANGE2; }
   std::map<short int, std::deque<short int>> mForbiddenRows;
   // Unordered map for saving sum of values (thr/ithr/vcasn) for avg calculation
   std::map<short int, std::array<long int, 6>> mThresholds;
@@ -169,6 +176,9 @@ class ITSThresholdCalibrator : public Task
   // Initialize pointers for doing error function fits
   TH1F* mFitHist = nullptr;
   TF1* mFitFunction = nullptr;
+  // Points (bin centres of mFitHist) and range used by the error function fits
+  std::vector<double> mFitX;
+  double mFitXMin = 0., mFitXMax = 0.;
 
   // Some private helper functions
   // Helper functions related to the running over data
@@ -182,11 +192,13 @@ class ITSThresholdCalibrator : public Task
 
   // Helper functions related to threshold extraction
   void initThresholdTree(bool recreate = true);
-  bool findUpperLower(std::vector<std::vector<unsigned short int>>, const short int&, short int&, short int&, bool);
-  bool findThreshold(const short int&, std::vector<std::vector<unsigned short int>>, const float*, short int&, float&, float&);
-  bool findThresholdFit(const short int&, std::vector<std::vector<unsigned short int>>, const float*, const short int&, float&, float&);
-  bool findThresholdDerivative(std::vector<std::vector<unsigned short int>>, const float*, const short int&, float&, float&);
-  bool findThresholdHitcounting(std::vector<std::vector<unsigned short int>>, const float*, const short int&, float&);
+  // These work on the counters of a full row (see hitIndex) and give one result per pixel
+  void findUpperLower(gsl::span<const unsigned short int>, short int*, short int*, bool);
+  void findThreshold(const short int&, const short int&, gsl::span<const unsigned short int>, float*, float*, bool*);
+  void findThresholdFit(gsl::span<const unsigned short int>, const short int*, const short int*, short int, short int, float*, float*, bool*);
+  bool findThresholdFitROOT(const short int&, const short int&, gsl::span<const unsigned short int>, short int, short int, short int, float&, float&);
+  void findThresholdDerivative(gsl::span<const unsigned short int>, const short int*, const short int*, float*, float*, bool*);
+  void findThresholdHitcounting(gsl::span<const unsigned short int>, float*, bool*);
   bool isScanFinished(const short int&, const short int&, const short int&);
   void findAverage(const std::array<long int, 6>&, float&, float&, float&, float&);
   void saveThreshold();
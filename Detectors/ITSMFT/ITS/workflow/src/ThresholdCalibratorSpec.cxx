@@ -12,6 +12,7 @@
 /// @file   ThresholdCalibratorSpec.cxx
 
 #include "ITSWorkflow/ThresholdCalibratorSpec.h"
+#include "ITSWorkflow/SCurveFit.h"
 #include "CommonUtils/FileSystemUtils.h"
 #include "CCDB/BasicCCDBManager.h"
 
@@ -378,112 +379,140 @@ void ITSThresholdCalibrator::initThresholdTree(bool recreate /*=true*/)
 }
 
 //////////////////////////////////////////////////////////////////////////////
-// Returns upper / lower limits for threshold determination.
-// data is the number of trigger counts per charge injected;
-// x is the array of charge injected values;
-// NPoints is the length of both arrays.
-bool ITSThresholdCalibrator::findUpperLower(
-  std::vector<std::vector<unsigned short int>> data, const short int& NPoints,
-  short int& lower, short int& upper, bool flip)
+// Returns upper / lower limits for threshold determination, for all the pixels of a row.
+// hits are the counters of the row (see hitIndex): for every charge injected,
+// the number of trigger counts of each pixel;
+// lower and upper are set to -1 for the pixels for which the search fails.
+void ITSThresholdCalibrator::findUpperLower(
+  gsl::span<const unsigned short int> hits, short int* lower, short int* upper, bool flip)
 {
   // Initialize (or re-initialize) upper and lower
-  upper = -1;
-  lower = -1;
-
-  if (flip) { // ITHR case. lower is at large mX[i], upper is at small mX[i]
-
-    for (int i = 0; i < NPoints; i++) {
-      if (data[i][0] == 0) {
-        upper = i;
-        break;
-      }
-    }
-
-    if (upper == -1) {
-      return false;
-    }
-    for (int i = upper; i > 0; i--) {
-      if (data[i][0] >= nInj) {
-        lower = i;
-        break;
-      }
-    }
-
-  } else { // not flipped
-
-    for (int i = 0; i < NPoints; i++) {
-      if (data[i][0] >= nInj) {
-        upper = i;
-        break;
-      }
-    }
-
-    if (upper == -1) {
-      return false;
-    }
-    for (int i = upper; i > 0; i--) {
-      if (data[i][0] == 0) {
-        lower = i;
-        break;
-      }
+  std::fill(upper, upper + N_COL, -1);
+  std::fill(lower, lower + N_COL, -1);
+
+  // not flipped: upper is the first point with all the injections seen, lower the last point before
+  // upper without hits. ITHR case (flipped): lower is at large mX[i], upper is at small mX[i]
+  for (short int i = 0; i < N_RANGE; i++) {
+    const unsigned short int* data = hits.data() + hitIndex(0, i);
+    for (short int col_i = 0; col_i < N_COL; col_i++) {
+      bool found = flip ? (data[col_i] == 0) : (data[col_i] >= nInj);
+      upper[col_i] = (upper[col_i] == -1 && found) ? i : upper[col_i];
     }
   }
-
-  // If search was successful, return central x value
-  if ((lower == -1) || (upper < lower)) {
-    return false;
+  for (short int i = 1; i < N_RANGE; i++) {
+    const unsigned short int* data = hits.data() + hitIndex(0, i);
+    for (short int col_i = 0; col_i < N_COL; col_i++) {
+      bool found = flip ? (data[col_i] >= nInj) : (data[col_i] == 0);
+      lower[col_i] = (found && i <= upper[col_i]) ? i : lower[col_i];
+    }
   }
-  return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 // Main findThreshold function which calls one of the three methods
-bool ITSThresholdCalibrator::findThreshold(
-  const short int& chipID, std::vector<std::vector<unsigned short int>> data, const float* x, short int& NPoints,
-  float& thresh, float& noise)
+// for all the pixels of a row
+void ITSThresholdCalibrator::findThreshold(
+  const short int& chipID, const short int& row, gsl::span<const unsigned short int> hits, float* thresh, float* noise, bool* success)
 {
-  bool success = false;
+  std::fill(thresh, thresh + N_COL, 0.f);
+  std::fill(noise, noise + N_COL, 0.f);
+  std::fill(success, success + N_COL, false);
+
+  short int lower[N_COL], upper[N_COL];
+  bool flip = (this->mScanType == 'I');
 
   switch (this->mFitType) {
     case DERIVATIVE: // Derivative method
-      success = this->findThresholdDerivative(data, x, NPoints, thresh, noise);
+      this->findUpperLower(hits, lower, upper, flip);
+      this->findThresholdDerivative(hits, lower, upper, thresh, noise, success);
       break;
 
     case FIT: // Fit method
-      success = this->findThresholdFit(chipID, data, x, NPoints, thresh, noise);
+      this->findUpperLower(hits, lower, upper, flip);
+      if (isDumpS) { // the s-curves are dumped as fitted histograms
+        for (short int col_i = 0; col_i < N_COL; col_i++) {
+          success[col_i] = this->findThresholdFitROOT(chipID, row, hits, col_i, lower[col_i], upper[col_i], thresh[col_i], noise[col_i]);
+        }
+      } else {
+#ifdef WITH_OPENMP
+        omp_set_num_threads(mNThreads);
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (short int col_i = 0; col_i < N_COL; col_i += 64) {
+          this->findThresholdFit(hits, lower, upper, col_i, std::min<short int>(col_i + 64, N_COL), thresh, noise, success);
+        }
+      }
       break;
 
     case HITCOUNTING: // Hit-counting method
-      success = this->findThresholdHitcounting(data, x, NPoints, thresh);
+      this->findThresholdHitcounting(hits, thresh, success);
       // noise = 0;
       break;
   }
+}
 
-  return success;
+//////////////////////////////////////////////////////////////////////////////
+// Find the threshold and noise via a Poisson likelihood fit of the S-curve,
+// for the pixels [colBegin, colEnd) of a row, without creating ROOT objects.
+// Same model, points and range as the ROOT fit (see findThresholdFitROOT).
+void ITSThresholdCalibrator::findThresholdFit(
+  gsl::span<const unsigned short int> hits, const short int* lower, const short int* upper, short int colBegin, short int colEnd,
+  float* thresh, float* noise, bool* success)
+{
+  const int nc = colEnd - colBegin;
+  double par0[SCurveFitMaxPixels], par1[SCurveFitMaxPixels], chi2[SCurveFitMaxPixels];
+  SCurveFitStatus status[SCurveFitMaxPixels];
+  for (int c = 0; c < nc; c++) {
+    int col_i = colBegin + c;
+    bool valid = upper[col_i] >= 0 && lower[col_i] >= 0 && upper[col_i] > lower[col_i];
+    par0[c] = valid ? (this->mX[upper[col_i]] + this->mX[lower[col_i]]) / 2 : 0.;
+    par1[c] = 8.;
+    status[c] = (valid && par0[c] >= 0) ? SCurveFitStatus::NotConverged : SCurveFitStatus::Invalid;
+  }
+
+  int ndf = fitSCurves(
+    mFitX.data(), N_RANGE, mFitXMin, mFitXMax, [&](int i) { return hits.data() + hitIndex(colBegin, i); }, nc,
+    nInj / 2, (this->mScanType == 'I') ? -1. : 1., par0, par1, chi2, status); // ITHR erf is reversed
+
+  for (int c = 0; c < nc; c++) {
+    int col_i = colBegin + c;
+    if (status[c] == SCurveFitStatus::Invalid) {
+      if (this->mVerboseOutput) {
+        LOG(warning) << "Start-finding unsuccessful: (lower, upper) = ("
+                     << lower[col_i] << ", " << upper[col_i] << ")";
+      }
+      continue;
+    }
+    if (status[c] != SCurveFitStatus::Converged && this->mVerboseOutput) {
+      LOG(warning) << "S-curve fit " << (status[c] == SCurveFitStatus::Diverged ? "diverged" : "did not converge")
+                   << " for column " << col_i;
+    }
+    thresh[col_i] = par0[c];
+    noise[col_i] = par1[c];
+    success[col_i] = status[c] == SCurveFitStatus::Converged && ndf > 0 && (chi2[c] / ndf < 5);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
-// Use ROOT to find the threshold and noise via S-curve fit
-// data is the number of trigger counts per charge injected;
-// x is the array of charge injected values;
-// NPoints is the length of both arrays.
-// thresh, noise, chi2 pointers are updated with results from the fit
-bool ITSThresholdCalibrator::findThresholdFit(
-  const short int& chipID, std::vector<std::vector<unsigned short int>> data, const float* x, const short int& NPoints,
+// Use ROOT to find the threshold and noise via S-curve fit, for one pixel
+// (used when the s-curves are dumped)
+// hits are the counters of the row, col the pixel;
+// thresh, noise pointers are updated with results from the fit
+bool ITSThresholdCalibrator::findThresholdFitROOT(
+  const short int& chipID, const short int& row, gsl::span<const unsigned short int> hits, short int col, short int lower, short int upper,
   float& thresh, float& noise)
 {
+  mFitHist->SetName(Form("scurve_chip%d_row%d_col%d", chipID, row, col));
   // Find lower & upper values of the S-curve region
-  short int lower, upper;
-  bool flip = (this->mScanType == 'I');
-  if (!this->findUpperLower(data, NPoints, lower, upper, flip) || lower == upper) {
+  if (lower == -1 || upper == -1 || lower == upper) {
     if (this->mVerboseOutput) {
       LOG(warning) << "Start-finding unsuccessful: (lower, upper) = ("
                    << lower << ", " << upper << ")";
     }
 
     if (isDumpS && (dumpCounterS[chipID] < maxDumpS || maxDumpS < 0)) { // save bad s-curves
-      for (int i = 0; i < NPoints; i++) {
-        this->mFitHist->SetBinContent(i + 1, data[i][0]);
+      for (int i = 0; i < N_RANGE; i++) {
+        this->mFitHist->SetBinContent(i + 1, hits[hitIndex(col, i)]);
       }
       fileDumpS->cd();
       mFitHist->Write();
@@ -503,8 +532,8 @@ bool ITSThresholdCalibrator::findThresholdFit(
     return false;
   }
 
-  for (int i = 0; i < NPoints; i++) {
-    this->mFitHist->SetBinContent(i + 1, data[i][0]);
+  for (int i = 0; i < N_RANGE; i++) {
+    this->mFitHist->SetBinContent(i + 1, hits[hitIndex(col, i)]);
   }
 
   // Initialize starting parameters
@@ -531,98 +560,112 @@ bool ITSThresholdCalibrator::findThresholdFit(
 }
 
 //////////////////////////////////////////////////////////////////////////////
-// Use ROOT to find the threshold and noise via derivative method
-// data is the number of trigger counts per charge injected;
-// x is the array of charge injected values;
-// NPoints is the length of both arrays.
+// Find the threshold and noise via derivative method, for all the pixels of a row
+// hits are the counters of the row; lower and upper the limits from findUpperLower.
 
-bool ITSThresholdCalibrator::findThresholdDerivative(std::vector<std::vector<unsigned short int>> data, const float* x, const short int& NPoints,
-                                                     float& thresh, float& noise)
+void ITSThresholdCalibrator::findThresholdDerivative(gsl::span<const unsigned short int> hits, const short int* lower, const short int* upper,
+                                                     float* thresh, float* noise, bool* success)
 {
-  // Find lower & upper values of the S-curve region
-  short int lower, upper;
-  bool flip = (this->mScanType == 'I');
-  if (!this->findUpperLower(data, NPoints, lower, upper, flip) || lower == upper) {
-    if (this->mVerboseOutput) {
-      LOG(warning) << "Start-finding unsuccessful: (lower, upper) = (" << lower << ", " << upper << ")";
+  float xfx[N_COL] = {0.}, fx[N_COL] = {0.};
+
+  // Accumulate the derivatives within [lower, upper) of each pixel
+  for (short int i = 0; i + 1 < N_RANGE; i++) {
+    const unsigned short int* data = hits.data() + hitIndex(0, i);
+    const unsigned short int* next = hits.data() + hitIndex(0, i + 1);
+    const float dx = this->mX[i + 1] - mX[i];
+    for (short int col_i = 0; col_i < N_COL; col_i++) {
+      float deriv = std::abs(next[col_i] - data[col_i]) / dx;
+      bool inside = i >= lower[col_i] && i < upper[col_i];
+      xfx[col_i] += inside ? this->mX[i] * deriv : 0.f;
+      fx[col_i] += inside ? deriv : 0.f;
     }
-    return false;
   }
 
-  int deriv_size = upper - lower;
-  float deriv[deriv_size];
-  float xfx = 0, fx = 0;
-
-  // Fill array with derivatives
-  for (int i = lower; i < upper; i++) {
-    deriv[i - lower] = std::abs(data[i + 1][0] - data[i][0]) / (this->mX[i + 1] - mX[i]);
-    xfx += this->mX[i] * deriv[i - lower];
-    fx += deriv[i - lower];
+  for (short int col_i = 0; col_i < N_COL; col_i++) {
+    if (fx[col_i] > 0.) {
+      thresh[col_i] = xfx[col_i] / fx[col_i];
+    }
   }
 
-  if (fx > 0.) {
-    thresh = xfx / fx;
-  }
-  float stddev = 0;
-  for (int i = lower; i < upper; i++) {
-    stddev += std::pow(this->mX[i] - thresh, 2) * deriv[i - lower];
+  float stddev[N_COL] = {0.};
+  for (short int i = 0; i + 1 < N_RANGE; i++) {
+    const unsigned short int* data = hits.data() + hitIndex(0, i);
+    const unsigned short int* next = hits.data() + hitIndex(0, i + 1);
+    const float dx = this->mX[i + 1] - mX[i];
+    for (short int col_i = 0; col_i < N_COL; col_i++) {
+      float deriv = std::abs(next[col_i] - data[col_i]) / dx;
+      bool inside = i >= lower[col_i] && i < upper[col_i];
+      stddev[col_i] += inside ? std::pow(this->mX[i] - thresh[col_i], 2) * deriv : 0.f;
+    }
   }
 
-  stddev /= fx;
-  noise = std::sqrt(stddev);
-
-  return fx > 0.;
+  for (short int col_i = 0; col_i < N_COL; col_i++) {
+    if (lower[col_i] == -1 || upper[col_i] == -1 || lower[col_i] == upper[col_i]) {
+      if (this->mVerboseOutput) {
+        LOG(warning) << "Start-finding unsuccessful: (lower, upper) = (" << lower[col_i] << ", " << upper[col_i] << ")";
+      }
+      thresh[col_i] = 0.;
+      noise[col_i] = 0.;
+      success[col_i] = false;
+      continue;
+    }
+    noise[col_i] = std::sqrt(stddev[col_i] / fx[col_i]);
+    success[col_i] = fx[col_i] > 0.;
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
-// Use ROOT to find the threshold and noise via derivative method
-// data is the number of trigger counts per charge injected;
-// x is the array of charge injected values;
-// NPoints is the length of both arrays.
-bool ITSThresholdCalibrator::findThresholdHitcounting(
-  std::vector<std::vector<unsigned short int>> data, const float* x, const short int& NPoints, float& thresh)
+// Find the threshold via hit-counting method, for all the pixels of a row
+// hits are the counters of the row.
+void ITSThresholdCalibrator::findThresholdHitcounting(
+  gsl::span<const unsigned short int> hits, float* thresh, bool* success)
 {
-  unsigned short int numberOfHits = 0;
-  bool is50 = false;
-  for (unsigned short int i = 0; i < NPoints; i++) {
-    numberOfHits += data[i][0];
-    if (!is50 && data[i][0] == nInj) {
-      is50 = true;
-    }
-  }
-
-  // If not enough counts return a failure
-  if (!is50) {
-    if (this->mVerboseOutput) {
-      LOG(warning) << "Calculation unsuccessful: too few hits. Skipping this pixel";
+  unsigned short int numberOfHits[N_COL] = {0};
+  bool is50[N_COL] = {false};
+  for (short int i = 0; i < N_RANGE; i++) {
+    const unsigned short int* data = hits.data() + hitIndex(0, i);
+    for (short int col_i = 0; col_i < N_COL; col_i++) {
+      numberOfHits[col_i] += data[col_i];
+      is50[col_i] = is50[col_i] || data[col_i] == nInj;
     }
-    return false;
   }
 
-  if (this->mScanType == 'T') {
-    thresh = this->mX[N_RANGE - 1] - numberOfHits / float(nInj);
-  } else if (this->mScanType == 'V') {
-    thresh = (this->mX[N_RANGE - 1] * nInj - numberOfHits) / float(nInj);
-  } else if (this->mScanType == 'I') {
-    thresh = (numberOfHits + nInj * this->mX[0]) / float(nInj);
-  } else {
+  if (this->mScanType != 'T' && this->mScanType != 'V' && this->mScanType != 'I') {
     LOG(error) << "Unexpected runtype encountered in findThresholdHitcounting()";
-    return false;
+    return;
   }
 
-  return true;
+  for (short int col_i = 0; col_i < N_COL; col_i++) {
+    // If not enough counts return a failure
+    if (!is50[col_i]) {
+      if (this->mVerboseOutput) {
+        LOG(warning) << "Calculation unsuccessful: too few hits. Skipping this pixel";
+      }
+      continue;
+    }
+
+    if (this->mScanType == 'T') {
+      thresh[col_i] = this->mX[N_RANGE - 1] - numberOfHits[col_i] / float(nInj);
+    } else if (this->mScanType == 'V') {
+      thresh[col_i] = (this->mX[N_RANGE - 1] * nInj - numberOfHits[col_i]) / float(nInj);
+    } else if (this->mScanType == 'I') {
+      thresh[col_i] = (numberOfHits[col_i] + nInj * this->mX[0]) / float(nInj);
+    }
+    success[col_i] = true;
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 // Run threshold extraction on completed row and update memory
 void ITSThresholdCalibrator::extractThresholdRow(const short int& chipID, const short int& row)
 {
+  gsl::span<const unsigned short int> hits(this->mPixelHits[chipID][row]);
   if (this->mScanType == 'D' || this->mScanType == 'A') {
     // Loop over all columns (pixels) in the row
     for (short int col_i = 0; col_i < this->N_COL; col_i++) {
       vChipid[col_i] = chipID;
       vRow[col_i] = row;
-      vThreshold[col_i] = this->mPixelHits[chipID][row][col_i][0][0];
+      vThreshold[col_i] = hits[hitIndex(col_i, 0)];
       if (vThreshold[col_i] > nInj) {
         this->mNoisyPixID[chipID].push_back(col_i * 1000 + row);
       } else if (vThreshold[col_i] > 0 && vThreshold[col_i] < nInj) {
@@ -638,7 +681,7 @@ void ITSThresholdCalibrator::extractThresholdRow(const short int& chipID, const
         for (short int col_i = 0; col_i < this->N_COL; col_i++) {
           vChipid[col_i] = chipID;
           vRow[col_i] = row;
-          vThreshold[col_i] = this->mPixelHits[chipID][row][col_i][sdel_i][chg_i];
+          vThreshold[col_i] = hits[hitIndex(col_i, sdel_i, chg_i)];
           vStrobeDel[col_i] = (sdel_i * this->mStep) + 1 + mMin; // +1 because a delay of n correspond to a real delay of n+1 (from ALPIDE manual)
           vCharge[col_i] = (unsigned char)(chg_i * this->mStep2 + mMin2);
         }
@@ -652,7 +695,7 @@ void ITSThresholdCalibrator::extractThresholdRow(const short int& chipID, const
         for (short int chg_i = 0; chg_i < 2; chg_i++) {
           int checkchg = !chg_i ? chargeA / mStep2 : chargeB / mStep2;
           for (short int sdel_i = N_RANGE - 1; sdel_i >= 0; sdel_i--) {
-            if (mPixelHits[chipID][row][col_i][sdel_i][checkchg] == nInj) {
+            if (hits[hitIndex(col_i, sdel_i, checkchg)] == nInj) {
               if (!chg_i) {
                 delA = sdel_i * mStep + mStep / 2;
               } else {
@@ -677,28 +720,18 @@ void ITSThresholdCalibrator::extractThresholdRow(const short int& chipID, const
 
   } else { // threshold, vcasn, ithr
 
-#ifdef WITH_OPENMP
-    omp_set_num_threads(mNThreads);
-#pragma omp parallel for schedule(dynamic)
-#endif
+    // Do the threshold fit for all the pixels of the row at once
+    float thresh[N_COL], noise[N_COL];
+    bool success[N_COL];
+    this->findThreshold(chipID, row, hits, thresh, noise, success);
+
     // Loop over all columns (pixels) in the row
     for (short int col_i = 0; col_i < this->N_COL; col_i++) {
-
-      // Do the threshold fit
-      float thresh = 0., noise = 0.;
-      bool success = false;
-      if (isDumpS) { // already protected for multi-thread in the init
-        mFitHist->SetName(Form("scurve_chip%d_row%d_col%d", chipID, row, col_i));
-      }
-
-      success = this->findThreshold(chipID, mPixelHits[chipID][row][col_i],
-                                    this->mX, N_RANGE, thresh, noise);
-
       vChipid[col_i] = chipID;
       vRow[col_i] = row;
-      vThreshold[col_i] = this->mScanType == 'T' ? (short int)(thresh * 10.) : (short int)(thresh);
-      vNoise[col_i] = (unsigned char)(noise * 10.); // always factor 10 also for ITHR/VCASN to not have all zeros
-      vSuccess[col_i] = success;
+      vThreshold[col_i] = this->mScanType == 'T' ? (short int)(thresh[col_i] * 10.) : (short int)(thresh[col_i]);
+      vNoise[col_i] = (unsigned char)(noise[col_i] * 10.); // always factor 10 also for ITHR/VCASN to not have all zeros
+      vSuccess[col_i] = success[col_i];
     }
   }
 
@@ -969,6 +1002,14 @@ void ITSThresholdCalibrator::setRunType(const short int& runtype)
                            : new TF1("mFitFunction", erf, mScanType == 'T' ? 3 : mMin, mMax, 2);
     this->mFitFunction->SetParName(0, "Threshold");
     this->mFitFunction->SetParName(1, "Noise");
+
+    // Same points and range for the native fit (see findThresholdFit)
+    this->mFitX.resize(N_RANGE);
+    for (short int i = 0; i < N_RANGE; i++) {
+      this->mFitX[i] = this->mFitHist->GetBinCenter(i + 1);
+    }
+    this->mFitXMin = (this->mScanType == 'T') ? 3 : mMin;
+    this->mFitXMax = mMax;
   }
 
   return;
@@ -983,7 +1024,7 @@ bool ITSThresholdCalibrator::isScanFinished(const short int& chipID, const short
   short int chg = (mScanType == 'I' || mScanType == 'D' || mScanType == 'A') ? 0 : (N_RANGE - 1);
 
   // check 2 pixels in case one of them is dead
-  return ((this->mPixelHits[chipID][row][col][chg][0] >= nInj || this->mPixelHits[chipID][row][col + 100][chg][0] >= nInj) && (!mCheckCw || cwcnt == nInj - 1));
+  return ((this->mPixelHits[chipID][row][hitIndex(col, chg)] >= nInj || this->mPixelHits[chipID][row][hitIndex(col + 100, chg)] >= nInj) && (!mCheckCw || cwcnt == nInj - 1));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -995,13 +1036,13 @@ std::vector<float> ITSThresholdCalibrator::calculatePulseParams(const short int&
   int sumRt = 0, sumSqRt = 0, countRt = 0, sumTot = 0, sumSqTot = 0, countTot = 0;
 
   for (auto itrow = mPixelHits[chipID].begin(); itrow != mPixelHits[chipID].end(); itrow++) { // loop over the chip rows
-    short int row = itrow->first;
+    const auto& hits = itrow->second;
     for (short int col_i = 0; col_i < this->N_COL; col_i++) {                                                                     // loop over the pixels on the row
       for (short int sdel_i = 0; sdel_i < this->N_RANGE; sdel_i++) {                                                              // loop over the strobe delays
-        if (mPixelHits[chipID][row][col_i][sdel_i][0] > 0 && mPixelHits[chipID][row][col_i][sdel_i][0] < nInj && rt_mindel < 0) { // from left, the last bin with 0 hits or the first with some hits
+        if (hits[hitIndex(col_i, sdel_i)] > 0 && hits[hitIndex(col_i, sdel_i)] < nInj && rt_mindel < 0) { // from left, the last bin with 0 hits or the first with some hits
           rt_mindel = sdel_i > 0 ? ((sdel_i - 1) * mStep) + 1 : (sdel_i * mStep) + 1;                                             // + 1 because if delay = n, we get n+1 in reality (ALPIDE feature)
         }
-        if (mPixelHits[chipID][row][col_i][sdel_i][0] == nInj) {
+        if (hits[hitIndex(col_i, sdel_i)] == nInj) {
           rt_maxdel = (sdel_i * mStep) + 1;
           tot_mindel = (sdel_i * mStep) + 1;
           break;
@@ -1009,7 +1050,7 @@ std::vector<float> ITSThresholdCalibrator::calculatePulseParams(const short int&
       }
 
       for (short int sdel_i = N_RANGE - 1; sdel_i >= 0; sdel_i--) { // from right, the first bin with nInj hits
-        if (mPixelHits[chipID][row][col_i][sdel_i][0] == nInj) {
+        if (hits[hitIndex(col_i, sdel_i)] == nInj) {
           tot_maxdel = (sdel_i * mStep) + 1;
           break;
         }
@@ -1065,14 +1106,14 @@ std::vector<float> ITSThresholdCalibrator::calculatePulseParams2D(const short in
   long int sumMaxPlChg = 0, sumSqMaxPlChg = 0;
 
   for (auto itrow = mPixelHits[chipID].begin(); itrow != mPixelHits[chipID].end(); itrow++) { // loop over the chip rows
-    short int row = itrow->first;
+    const auto& hits = itrow->second;
     for (short int col_i = 0; col_i < this->N_COL; col_i++) { // loop over the pixels on the row
       int minThr = 1e7, minThrDel = 1e7, maxPl = -1, maxPlChg = -1;
       int tot_mindel = 1e7;
       bool isFound = false;
       for (short int chg_i = 0; chg_i < this->N_RANGE2; chg_i++) {     // loop over charges
         for (short int sdel_i = 0; sdel_i < this->N_RANGE; sdel_i++) { // loop over the strobe delays
-          if (mPixelHits[chipID][row][col_i][sdel_i][chg_i] == nInj) { // minimum threshold charge and delay
+          if (hits[hitIndex(col_i, sdel_i, chg_i)] == nInj) { // minimum threshold charge and delay
             minThr = chg_i * mStep2;
             minThrDel = (sdel_i * mStep) + 1; // +1 because n->n+1 (as from alpide manual)
             isFound = true;
@@ -1086,7 +1127,7 @@ std::vector<float> ITSThresholdCalibrator::calculatePulseParams2D(const short in
       isFound = false;
       for (short int sdel_i = this->N_RANGE - 1; sdel_i >= 0; sdel_i--) { // loop over the strobe delays
         for (short int chg_i = this->N_RANGE2 - 1; chg_i >= 0; chg_i--) { // loop over charges
-          if (mPixelHits[chipID][row][col_i][sdel_i][chg_i] == nInj) {    // max pulse length charge and delay
+          if (hits[hitIndex(col_i, sdel_i, chg_i)] == nInj) {    // max pulse length charge and delay
             maxPl = (sdel_i * mStep) + 1;
             maxPlChg = chg_i * mStep2;
             isFound = true;
@@ -1100,7 +1141,7 @@ std::vector<float> ITSThresholdCalibrator::calculatePulseParams2D(const short in
       isFound = false;
       for (short int sdel_i = 0; sdel_i < this->N_RANGE; sdel_i++) {   // loop over the strobe delays
         for (short int chg_i = 0; chg_i < this->N_RANGE2; chg_i++) {   // loop over charges
-          if (mPixelHits[chipID][row][col_i][sdel_i][chg_i] == nInj) { // min delay for the ToT calculation
+          if (hits[hitIndex(col_i, sdel_i, chg_i)] == nInj) { // min delay for the ToT calculation
             tot_mindel = (sdel_i * mStep) + 1;
             isFound = true;
             break;
@@ -1327,13 +1368,13 @@ void ITSThresholdCalibrator::run(ProcessingContext& pc)
         if (!this->mPixelHits.count(chipID)) {
           if (mScanType == 'D' || mScanType == 'A') { // for digital and analog scan initialize the full matrix for each chipID
             for (int irow = 0; irow < 512; irow++) {
-              this->mPixelHits[chipID][irow] = std::vector<std::vector<std::vector<unsigned short int>>>(this->N_COL, std::vector<std::vector<unsigned short int>>(N_RANGE, std::vector<unsigned short int>(N_RANGE2, 0)));
+              this->mPixelHits[chipID][irow] = std::vector<unsigned short int>(rowHitsSize(), 0);
             }
           } else {
-            this->mPixelHits[chipID][row] = std::vector<std::vector<std::vector<unsigned short int>>>(this->N_COL, std::vector<std::vector<unsigned short int>>(N_RANGE, std::vector<unsigned short int>(N_RANGE2, 0)));
+            this->mPixelHits[chipID][row] = std::vector<unsigned short int>(rowHitsSize(), 0);
           }
         } else if (!this->mPixelHits[chipID].count(row)) { // allocate memory for chip = chipID or for a row of this chipID
-          this->mPixelHits[chipID][row] = std::vector<std::vector<std::vector<unsigned short int>>>(this->N_COL, std::vector<std::vector<unsigned short int>>(N_RANGE, std::vector<unsigned short int>(N_RANGE2, 0)));
+          this->mPixelHits[chipID][row] = std::vector<unsigned short int>(rowHitsSize(), 0);
         }
       }
 
@@ -1351,7 +1392,7 @@ void ITSThresholdCalibrator::run(ProcessingContext& pc)
 
         if (!mChipsForbRows[chipID] && (!mCheckExactRow || d.getRow() == row)) { // row has NOT to be forbidden and we ignore hits coming from other rows (potential masking issue on chip)
           // Increment the number of counts for this pixel
-          this->mPixelHits[chipID][d.getRow()][col][loopPoint][chgPoint]++;
+          this->mPixelHits[chipID][d.getRow()][hitIndex(col, loopPoint, chgPoint)]++;
         }
       }
       // check collected chips in previous loop on digits
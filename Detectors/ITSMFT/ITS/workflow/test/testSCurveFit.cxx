@@ -0,0 +1,100 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS SCurveFit
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+#include <TF1.h>
+#include <TH1F.h>
+#include <TMath.h>
+#include <TRandom3.h>
+#include "ITSWorkflow/SCurveFit.h"
+
+using namespace o2::its;
+
+// threshold scan as in the ITS threshold calibrator: 50 injections, charges 0..50, fit range [3, 50]
+constexpr int NInj = 50;
+constexpr int NRange = 51;
+constexpr double FitMin = 3., FitMax = 50.;
+
+BOOST_AUTO_TEST_CASE(SCurveFit_vs_TF1)
+{
+  TRandom3 rnd(1234);
+  TH1F hist("hist", "hist", NRange, -0.5, NRange - 0.5);
+  TF1 func(
+    "func", [](double* x, double* par) { return (NInj / 2) * TMath::Erf((x[0] - par[0]) / (std::sqrt(2.) * par[1])) + (NInj / 2); }, FitMin, FitMax, 2);
+
+  std::vector<double> x(NRange);
+  for (int i = 0; i < NRange; i++) {
+    x[i] = hist.GetBinCenter(i + 1);
+  }
+  // S-curves of SCurveFitMaxPixels pixels with different thresholds and noises, stored as [point][pixel]
+  const int nc = SCurveFitMaxPixels;
+  std::vector<unsigned short> hits(NRange * nc);
+  double thr[nc], noise[nc], chi2[nc];
+  SCurveFitStatus status[nc];
+  for (int c = 0; c < nc; c++) {
+    double trueThr = 6. + 0.5 * c, trueNoise = 1. + 0.05 * c;
+    for (int i = 0; i < NRange; i++) {
+      hits[i * nc + c] = rnd.Binomial(NInj, 0.5 * (1. + std::erf((x[i] - trueThr) / (std::sqrt(2.) * trueNoise))));
+    }
+    thr[c] = trueThr + 2.;
+    noise[c] = 8.;
+    status[c] = SCurveFitStatus::NotConverged;
+  }
+  int ndf = fitSCurves(
+    x.data(), NRange, FitMin, FitMax, [&](int i) { return hits.data() + i * nc; }, nc, NInj / 2, 1., thr, noise, chi2, status);
+
+  for (int c = 0; c < nc; c++) {
+    for (int i = 0; i < NRange; i++) {
+      hist.SetBinContent(i + 1, hits[i * nc + c]);
+    }
+    func.SetParameter(0, 6. + 0.5 * c + 2.);
+    func.SetParameter(1, 8.);
+    hist.Fit(&func, "RQLN");
+    double thrROOT = func.GetParameter(0), noiseROOT = func.GetParameter(1);
+    BOOST_CHECK(status[c] == SCurveFitStatus::Converged);
+    BOOST_CHECK(ndf == func.GetNDF());
+    BOOST_CHECK_SMALL(thr[c] - thrROOT, 0.01 * noiseROOT);
+    BOOST_CHECK_SMALL(noise[c] - noiseROOT, 0.01 * noiseROOT);
+    BOOST_CHECK_SMALL(chi2[c] - func.GetChisquare(), 0.01 + 0.01 * func.GetChisquare());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SCurveFit_failures)
+{
+  std::vector<double> x(NRange);
+  for (int i = 0; i < NRange; i++) {
+    x[i] = i;
+  }
+  // 0: flat curve without threshold, 1: no valid starting values, 2: regular curve
+  const int nc = 3;
+  std::vector<unsigned short> hits(NRange * nc);
+  for (int i = 0; i < NRange; i++) {
+    hits[i * nc] = NInj / 2;
+    hits[i * nc + 1] = 0;
+    hits[i * nc + 2] = i < 20 ? 0 : NInj;
+  }
+  double thr[nc] = {20., 0., 18.}, noise[nc] = {8., 8., 8.}, chi2[nc];
+  SCurveFitStatus status[nc] = {SCurveFitStatus::NotConverged, SCurveFitStatus::Invalid, SCurveFitStatus::NotConverged};
+  fitSCurves(x.data(), NRange, FitMin, FitMax, [&](int i) { return hits.data() + i * nc; }, nc, NInj / 2, 1., thr, noise, chi2, status, 100);
+  BOOST_CHECK(status[0] == SCurveFitStatus::Diverged);
+  BOOST_CHECK(status[1] == SCurveFitStatus::Invalid);
+  BOOST_CHECK(status[2] != SCurveFitStatus::Invalid);
+  // with a single iteration the fit cannot converge from a far starting point
+  double thr1 = 35., noise1 = 8., chi21;
+  SCurveFitStatus status1 = SCurveFitStatus::NotConverged;
+  fitSCurves(x.data(), NRange, FitMin, FitMax, [&](int i) { return hits.data() + i * nc + 2; }, 1, NInj / 2, 1., &thr1, &noise1, &chi21, &status1, 1);
+  BOOST_CHECK(status1 == SCurveFitStatus::NotConverged);
+}
@@ -20,6 +20,7 @@
 #define ALICEO2_MFT_MILLEPEDE2_H
 
 #include <vector>
+#include <memory>
 #include <TString.h>
 #include <TTree.h>
 #include "MFTAlignment/MinResSolve.h"
@@ -50,6 +51,8 @@ class MillePede2
          kNoInversion };   // used global matrix solution methods
   enum { kFixParID = -1 }; // dummy id for fixed param
 
+  enum { kRecordBatchSize = 1000 }; // number of records per thread fitted in one batch
+
   MillePede2();
   MillePede2(const MillePede2& src);
   virtual ~MillePede2();
@@ -97,7 +100,7 @@ class MillePede2
   }
 
   MatrixSq* GetGlobalMatrix() const { return fMatCGlo; }
-  SymMatrix* GetLocalMatrix() const { return fMatCLoc; }
+  SymMatrix* GetLocalMatrix() const { return fLocFitWs.empty() ? nullptr : &fLocFitWs[0]->matCLoc; }
   std::vector<double> GetGlobals() const { return fVecBGlo; }
   std::vector<double> GetDeltaPars() const { return fDeltaPar; }
   std::vector<double> GetInitPars() const { return fInitPar; }
@@ -144,6 +147,8 @@ class MillePede2
   bool GetUseRecordWeight() const { return fUseRecordWeight; }
   void SetMinRecordLength(const int v = 1) { fMinRecordLength = v; }
   int GetMinRecordLength() const { return fMinRecordLength; }
+  void SetNThreads(const int n = 1) { fNThreads = n > 0 ? n : 1; }
+  int GetNThreads() const { return fNThreads; }
 
   void SetParamGrID(const int grID, int i)
   {
@@ -286,6 +291,49 @@ class MillePede2
   }
 
  protected:
+  /// \brief chi2 of a fitted record, to be stored in the chi2 tree
+  struct RecordChi2 {
+    float sumChi2;
+    bool isChi2BelowLimit;
+    int recNDoF;
+  };
+
+  /// \brief working space of the local fits of one thread
+  ///
+  /// The contributions of the fitted records to the global equations are buffered
+  /// in the order of the records and added to them by AddLocalFitContributions()
+  struct LocalFitWorkspace {
+    LocalFitWorkspace(int nGlo, int nLoc);
+
+    /// \brief buffer the addition of n elements to row r of the global matrix, see MatrixSq::AddToRow
+    void AddToRow(int r, const double* valc, const int* indc, int n);
+
+    /// \brief clear the buffered contributions
+    void ClearContributions();
+
+    SymMatrix matCLoc;                     ///< Matrix C local
+    std::unique_ptr<SymMatrix> matScratch; ///< scratch matrix for the solution of the local system
+    RectMatrix matCGloLoc;                 ///< Rectangular matrix C g*l
+    std::vector<double> vecBLoc;           ///< [nLoc] Vector B local (parameters)
+    std::vector<int> glo2CGlo;             ///< [nGlo] global ID to compressed ID buffer
+    std::vector<int> cGlo2Glo;             ///< [nGlo] compressed ID to global ID buffer
+    std::vector<int> fillIndex;            ///< [nGlo] auxilary index array for fast matrix fill
+    std::vector<double> fillValue;         ///< [nGlo] auxilary value array for fast matrix fill
+    std::vector<int> refLoc, refGlo;       ///< position of the local and global derivatives of each point in the record
+    std::vector<int> nrefLoc, nrefGlo;     ///< number of local and global derivatives of each point in the record
+    std::vector<int> matRows;              ///< rows of the global matrix to update
+    std::vector<int> matRowStart;          ///< start of each row update in matIndex, matValue
+    std::vector<int> matIndex;             ///< columns of the global matrix elements to update
+    std::vector<double> matValue;          ///< values to add to the global matrix elements
+    std::vector<int> vecIndex;             ///< global vector elements to update
+    std::vector<double> vecValue;          ///< values to add to the global vector elements
+    std::vector<int> procPnt;              ///< [nGlo] N of processed points per global variable
+    std::vector<RecordChi2> recChi2;       ///< chi2 of the records to store in the chi2 tree
+    long nLocFits = 0;                     ///< Number of local fits
+    long nLocFitsRejected = 0;             ///< Number of local fits rejected
+    long nLocEquations = 0;                ///< Number of local equations
+  };
+
   /// \brief read data record (if any) at entry recID
   void ReadRecordData(const long recID, const bool doPrint = false);
 
@@ -297,6 +345,18 @@ class MillePede2
   /// localParams = (if !=0) will contain the fitted track parameters and related errors
   int LocalFit(std::vector<double>& localParams);
 
+  /// \brief Perform the local fit of a record, its contributions to the global equations are buffered in ws
+  int LocalFit(MillePedeRecord& record, long recID, double runWgh, LocalFitWorkspace& ws, std::vector<double>& localParams);
+
+  /// \brief add the current data record to the batch of records to be fitted
+  void AddRecordToBatch();
+
+  /// \brief fit the batch of records in parallel and add their contributions to the global equations
+  void ProcessRecordBatch();
+
+  /// \brief add the buffered contributions of the local fits to the global equations, in the order of the records
+  void AddLocalFitContributions();
+
   bool IsZero(const double v, const double eps = 1e-16) const { return TMath::Abs(v) < eps; }
 
  protected:
@@ -325,7 +385,6 @@ class MillePede2
   int fNGroupsSet;               ///< number of groups set
   std::vector<int> fParamGrID;   ///< [fNGloPar] group id for the every parameter
   std::vector<int> fProcPnt;     ///< [fNGloPar] N of processed points per global variable
-  std::vector<double> fVecBLoc;  ///< [fNLocPar] Vector B local (parameters)
   std::vector<double> fDiagCGlo; ///< [fNGloPar] Initial diagonal elements of C global matrix
   std::vector<double> fVecBGlo;  //! Vector B global (parameters)
 
@@ -336,15 +395,16 @@ class MillePede2
   std::vector<bool> fIsLinear;   ///< [fNGloPar] Flag for linear parameters
   std::vector<bool> fConstrUsed; //! Flag for used constraints
 
-  std::vector<int> fGlo2CGlo; ///< [fNGloPar] global ID to compressed ID buffer
-  std::vector<int> fCGlo2Glo; ///< [fNGloPar] compressed ID to global ID buffer
-
   // Matrices
-  o2::mft::SymMatrix* fMatCLoc;     ///< Matrix C local
-  o2::mft::MatrixSq* fMatCGlo;      ///< Matrix C global
-  o2::mft::RectMatrix* fMatCGloLoc; ///< Rectangular matrix C g*l
-  std::vector<int> fFillIndex;      ///< [fNGloPar] auxilary index array for fast matrix fill
-  std::vector<double> fFillValue;   ///< [fNGloPar] auxilary value array for fast matrix fill
+  o2::mft::MatrixSq* fMatCGlo; ///< Matrix C global
+
+  // Local fits
+  int fNThreads;                                              ///< number of threads for the local fits
+  std::vector<std::unique_ptr<LocalFitWorkspace>> fLocFitWs; //! working space of the local fits, one per thread
+  std::vector<MillePedeRecord> fRecBatch;                     //! batch of records to be fitted in parallel
+  std::vector<long> fRecBatchID;                              //! IDs of the records of the batch
+  std::vector<double> fRecBatchWgh;                           //! run weights of the records of the batch
+  int fNRecBatch;                                             //! number of records in the batch
 
   TFile* fRecChi2File;
   TString fRecChi2FName;
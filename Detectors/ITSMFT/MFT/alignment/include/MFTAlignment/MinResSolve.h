@@ -19,6 +19,7 @@
 #include <TObject.h>
 #include <TVectorD.h>
 #include <TString.h>
+#include <vector>
 
 namespace o2
 {
@@ -93,6 +94,16 @@ class MinResSolve : public TObject
 
   Int_t GetPrecon() const { return fPrecon; }
 
+  /// \brief number of threads used for the matrix-vector products
+  void SetNThreads(Int_t n) { fNThreads = n > 0 ? n : 1; }
+  Int_t GetNThreads() const { return fNThreads; }
+
+  /// \brief build the compressed sparse row copy of the matrix, used for the matrix-vector products
+  void BuildCSR();
+
+  /// \brief fill vecOut by matrix * vecIn, using the CSR copy of the matrix if it was built
+  void ApplyMatrix(const double* vecIn, double* vecOut) const;
+
   /// \brief clear aux. space
   void ClearAux();
 
@@ -132,6 +143,11 @@ class MinResSolve : public TObject
   MatrixSparse* fMatU; // aux. space
   SymBDMatrix* fMatBD; // aux. space
 
+  Int_t fNThreads;               ///< number of threads for the matrix-vector products
+  std::vector<Int_t> fCSRRowPtr; //! start of the rows of the CSR matrix in fCSRCol, fCSRVal
+  std::vector<Int_t> fCSRCol;    //! columns of the CSR matrix elements
+  std::vector<Double_t> fCSRVal; //! values of the CSR matrix elements (both triangles of symmetric matrices)
+
   ClassDefOverride(MinResSolve, 0);
 };
 
@@ -16,6 +16,7 @@
 #ifndef ALICEO2_MFT_SYMMATRIX_H
 #define ALICEO2_MFT_SYMMATRIX_H
 
+#include <memory>
 #include <TVectorD.h>
 #include <TString.h>
 
@@ -164,7 +165,8 @@ class SymMatrix : public MatrixSq
   /// Only upper triangle of the matrix has to be filled.
   /// In opposite to function from the book, the matrix is modified:
   /// lower triangle and diagonal are refilled.
-  SymMatrix* DecomposeChol();
+  /// The decomposition is stored in the provided scratch buffer (recreated if its size differs).
+  SymMatrix* DecomposeChol(std::unique_ptr<SymMatrix>& buffer);
 
   /// \brief Invert using provided Choleski decomposition, provided the Cholseki's L matrix
   void InvertChol(SymMatrix* mchol);
@@ -182,6 +184,9 @@ class SymMatrix : public MatrixSq
   /// right-hand side vector. The solution vector is returned in b[1..n].
   Bool_t SolveChol(Double_t* brhs, Bool_t invert = kFALSE);
 
+  /// \brief Same as above, using the provided scratch buffer for the Choleski decomposition
+  Bool_t SolveChol(Double_t* brhs, std::unique_ptr<SymMatrix>& buffer, Bool_t invert = kFALSE);
+
   Bool_t SolveChol(Double_t* brhs, Double_t* bsol, Bool_t invert = kFALSE);
   Bool_t SolveChol(TVectorD& brhs, Bool_t invert = kFALSE);
   Bool_t SolveChol(const TVectorD& brhs, TVectorD& bsol, Bool_t invert = kFALSE);
@@ -203,17 +208,20 @@ class SymMatrix : public MatrixSq
   /// Solution a la MP1: gaussian eliminations
   int SolveSpmInv(double* vecB, Bool_t stabilize = kTRUE);
 
+  /// \brief Same as above, using the provided scratch buffer
+  int SolveSpmInv(double* vecB, std::unique_ptr<SymMatrix>& buffer, Bool_t stabilize = kTRUE);
+
  protected:
   virtual Int_t GetIndex(Int_t row, Int_t col) const;
   Double_t GetEl(Int_t row, Int_t col) const { return operator()(row, col); }
+  void CopyToBuffer(std::unique_ptr<SymMatrix>& buffer) const;
   void SetEl(Int_t row, Int_t col, Double_t val) { operator()(row, col) = val; }
 
  protected:
   Double_t* fElems;     ///<   Elements booked by constructor
   Double_t** fElemsAdd; ///<   Elements (rows) added dynamicaly
 
-  static SymMatrix* fgBuffer; ///< buffer for fast solution
-  static Int_t fgCopyCnt;     ///< matrix copy counter
+  std::unique_ptr<SymMatrix> fBuffer; //! scratch matrix of Multiply and of the solutions without explicit buffer
 
   ClassDefOverride(SymMatrix, 0);
 };
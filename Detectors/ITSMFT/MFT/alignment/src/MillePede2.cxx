@@ -26,6 +26,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <fstream>
+#include <algorithm>
 
 //#define _DUMP_EQ_BEFORE_
 //#define _DUMP_EQ_AFTER_
@@ -69,9 +70,9 @@ MillePede2::MillePede2()
     fResCut(100.),
     fMinPntValid(1),
     fNGroupsSet(0),
-    fMatCLoc(nullptr),
     fMatCGlo(nullptr),
-    fMatCGloLoc(nullptr),
+    fNThreads(1),
+    fNRecBatch(0),
     fRecChi2File(nullptr),
     fRecChi2FName("chi2_records.root"),
     fRecChi2TreeName("chi2Records"),
@@ -122,9 +123,9 @@ MillePede2::MillePede2(const MillePede2& src)
     fResCut(100.),
     fMinPntValid(1),
     fNGroupsSet(0),
-    fMatCLoc(nullptr),
     fMatCGlo(nullptr),
-    fMatCGloLoc(nullptr),
+    fNThreads(1),
+    fNRecBatch(0),
     fRecChi2File(nullptr),
     fRecChi2FName("chi2_records.root"),
     fRecChi2TreeName("chi2Records"),
@@ -157,15 +158,9 @@ MillePede2::MillePede2(const MillePede2& src)
 //_____________________________________________________________________________
 MillePede2::~MillePede2()
 {
-  if (fMatCLoc) {
-    delete fMatCLoc;
-  }
   if (fMatCGlo) {
     delete fMatCGlo;
   }
-  if (fMatCGloLoc) {
-    delete fMatCGloLoc;
-  }
 
   if (fRejRunList) {
     delete fRejRunList;
@@ -235,15 +230,11 @@ int MillePede2::InitMille(int nGlo, const int nLoc,
     fMatCGlo = new SymMatrix(fNGloPar);
   }
 
-  fFillIndex = std::vector<int>(fNGloPar);
-  fFillValue = std::vector<double>(fNGloPar);
-
-  fMatCLoc = new SymMatrix(fNLocPar);
-  fMatCGloLoc = new RectMatrix(fNGloPar, fNLocPar);
+  fLocFitWs.clear();
+  fLocFitWs.emplace_back(std::make_unique<LocalFitWorkspace>(fNGloPar, fNLocPar));
 
   fParamGrID = std::vector<int>(fNGloPar);
   fProcPnt = std::vector<int>(fNGloPar);
-  fVecBLoc = std::vector<double>(fNGloPar);
   fDiagCGlo = std::vector<double>(fNGloPar);
 
   fInitPar = std::vector<double>(fNGloPar);
@@ -251,11 +242,7 @@ int MillePede2::InitMille(int nGlo, const int nLoc,
   fSigmaPar = std::vector<double>(fNGloPar);
   fIsLinear = std::vector<bool>(fNGloPar);
 
-  fGlo2CGlo = std::vector<int>(fNGloPar);
-  fCGlo2Glo = std::vector<int>(fNGloPar);
-
   for (int i = fNGloPar; i--;) {
-    fGlo2CGlo[i] = fCGlo2Glo[i] = -1;
     fIsLinear[i] = true;
     fParamGrID[i] = -1;
   }
@@ -498,55 +485,85 @@ void MillePede2::ReadRecordConstraint(const long recID, bool doPrint)
   fCurrRecConstrID = recID;
 }
 
+//_____________________________________________________________________________
+MillePede2::LocalFitWorkspace::LocalFitWorkspace(int nGlo, int nLoc)
+  : matCLoc(nLoc),
+    matCGloLoc(nGlo, nLoc),
+    vecBLoc(nLoc),
+    glo2CGlo(nGlo, -1),
+    cGlo2Glo(nGlo, -1),
+    fillIndex(nGlo),
+    fillValue(nGlo),
+    procPnt(nGlo)
+{
+  matRowStart.push_back(0);
+}
+
+//_____________________________________________________________________________
+void MillePede2::LocalFitWorkspace::AddToRow(int r, const double* valc, const int* indc, int n)
+{
+  matRows.push_back(r);
+  matIndex.insert(matIndex.end(), indc, indc + n);
+  matValue.insert(matValue.end(), valc, valc + n);
+  matRowStart.push_back(matIndex.size());
+}
+
+//_____________________________________________________________________________
+void MillePede2::LocalFitWorkspace::ClearContributions()
+{
+  matRows.clear();
+  matRowStart.resize(1);
+  matIndex.clear();
+  matValue.clear();
+  vecIndex.clear();
+  vecValue.clear();
+  std::fill(procPnt.begin(), procPnt.end(), 0);
+  recChi2.clear();
+  nLocFits = nLocFitsRejected = nLocEquations = 0;
+}
+
 //_____________________________________________________________________________
 int MillePede2::LocalFit(std::vector<double>& localParams)
 {
-  static int nrefSize = 0;
-  //  static TArrayI refLoc,refGlo,nrefLoc,nrefGlo;
-  static int *refLoc = nullptr, *refGlo = nullptr, *nrefLoc = nullptr, *nrefGlo = nullptr;
+  auto& ws = *fLocFitWs[0];
+  int res = LocalFit(*fRecord, fCurrRecDataID, fRunWgh, ws, localParams);
+  AddLocalFitContributions();
+  return res;
+}
+
+//_____________________________________________________________________________
+int MillePede2::LocalFit(MillePedeRecord& record, long recID, double runWgh, LocalFitWorkspace& ws, std::vector<double>& localParams)
+{
   int nPoints = 0;
-  fIsChi2BelowLimit = true;
+  bool isChi2BelowLimit = true;
 
-  SymMatrix& matCLoc = *fMatCLoc;
-  MatrixSq& matCGlo = *fMatCGlo;
-  RectMatrix& matCGloLoc = *fMatCGloLoc;
+  SymMatrix& matCLoc = ws.matCLoc;
+  RectMatrix& matCGloLoc = ws.matCGloLoc;
+  std::vector<double>& vecBLoc = ws.vecBLoc;
+  std::vector<int>& refLoc = ws.refLoc;
+  std::vector<int>& refGlo = ws.refGlo;
+  std::vector<int>& nrefLoc = ws.nrefLoc;
+  std::vector<int>& nrefGlo = ws.nrefGlo;
 
-  std::fill(fVecBLoc.begin(), fVecBLoc.end(), 0.);
+  std::fill(vecBLoc.begin(), vecBLoc.end(), 0.);
   matCLoc.Reset();
 
   int cnt = 0;
-  int recSz = fRecord->GetSize();
+  int recSz = record.GetSize();
 
   while (cnt < recSz) { // Transfer the measurement records to matrices
     // extract addresses of residual, weight and pointers on local and global derivatives for each point
-    if (nrefSize <= nPoints) {
-      int* tmpA = nullptr;
-      nrefSize = 2 * (nPoints + 1);
-      tmpA = refLoc;
-      refLoc = new int[nrefSize];
-      if (tmpA) {
-        memcpy(refLoc, tmpA, nPoints * sizeof(int));
-      }
-      tmpA = refGlo;
-      refGlo = new int[nrefSize];
-      if (tmpA) {
-        memcpy(refGlo, tmpA, nPoints * sizeof(int));
-      }
-      tmpA = nrefLoc;
-      nrefLoc = new int[nrefSize];
-      if (tmpA) {
-        memcpy(nrefLoc, tmpA, nPoints * sizeof(int));
-      }
-      tmpA = nrefGlo;
-      nrefGlo = new int[nrefSize];
-      if (tmpA) {
-        memcpy(nrefGlo, tmpA, nPoints * sizeof(int));
-      }
+    if (int(refLoc.size()) <= nPoints) {
+      int nrefSize = 2 * (nPoints + 1);
+      refLoc.resize(nrefSize);
+      refGlo.resize(nrefSize);
+      nrefLoc.resize(nrefSize);
+      nrefGlo.resize(nrefSize);
     }
 
     refLoc[nPoints] = ++cnt;
     int nLoc = 0;
-    while (!fRecord->IsWeight(cnt)) {
+    while (!record.IsWeight(cnt)) {
       nLoc++;
       cnt++;
     }
@@ -554,7 +571,7 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
 
     refGlo[nPoints] = ++cnt;
     int nGlo = 0;
-    while (!fRecord->IsResidual(cnt) && cnt < recSz) {
+    while (!record.IsResidual(cnt) && cnt < recSz) {
       nGlo++;
       cnt++;
     }
@@ -568,23 +585,23 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
 
   double vl;
 
-  double gloWgh = fRunWgh;
+  double gloWgh = runWgh;
   if (fUseRecordWeight) {
-    gloWgh *= fRecord->GetWeight(); // global weight for this set
+    gloWgh *= record.GetWeight(); // global weight for this set
   }
   int maxLocUsed = 0;
 
   for (int ip = nPoints; ip--;) { // Transfer the measurement records to matrices
-    double resid = fRecord->GetValue(refLoc[ip] - 1);
-    double weight = fRecord->GetValue(refGlo[ip] - 1) * gloWgh;
+    double resid = record.GetValue(refLoc[ip] - 1);
+    double weight = record.GetValue(refGlo[ip] - 1) * gloWgh;
     int odd = (ip & 0x1);
     if (fWghScl[odd] > 0) {
       weight *= fWghScl[odd];
     }
-    double* derLoc = fRecord->GetValue() + refLoc[ip];
-    double* derGlo = fRecord->GetValue() + refGlo[ip];
-    int* indLoc = fRecord->GetIndex() + refLoc[ip];
-    int* indGlo = fRecord->GetIndex() + refGlo[ip];
+    double* derLoc = record.GetValue() + refLoc[ip];
+    double* derGlo = record.GetValue() + refGlo[ip];
+    int* indLoc = record.GetIndex() + refLoc[ip];
+    int* indGlo = record.GetIndex() + refGlo[ip];
 
     for (int i = nrefGlo[ip]; i--;) { // suppress the global part (only relevant with iterations)
 
@@ -611,7 +628,7 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
 
     // Symmetric matrix, don't bother j>i coeffs
     for (int i = nrefLoc[ip]; i--;) { // Fill local matrix and vector
-      fVecBLoc[indLoc[i]] += weight * resid * derLoc[i];
+      vecBLoc[indLoc[i]] += weight * resid * derLoc[i];
       if (indLoc[i] > maxLocUsed) {
         maxLocUsed = indLoc[i];
       }
@@ -625,15 +642,15 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
   matCLoc.SetSizeUsed(++maxLocUsed); // data with B=0 may use less than declared nLocals
 
   /* //RRR
-  fRecord->Print("l");
+  record.Print("l");
   printf("\nBefore\nLocalMatrix: "); matCLoc.Print("l");
-  printf("RHSLoc: "); for (int i=0;i<fNLocPar;i++) printf("%+e |",fVecBLoc[i]); printf("\n");
+  printf("RHSLoc: "); for (int i=0;i<fNLocPar;i++) printf("%+e |",vecBLoc[i]); printf("\n");
   */
   // first try to solve by faster Cholesky decomposition, then by Gaussian elimination
-  double* pVecBLoc = &fVecBLoc[0];
-  if (!matCLoc.SolveChol(pVecBLoc, true)) {
+  double* pVecBLoc = &vecBLoc[0];
+  if (!matCLoc.SolveChol(pVecBLoc, ws.matScratch, true)) {
     LOG(warning) << "MillePede2 - Failed to solve locals by Cholesky, trying Gaussian Elimination";
-    if (!matCLoc.SolveSpmInv(pVecBLoc, true)) {
+    if (!matCLoc.SolveSpmInv(pVecBLoc, ws.matScratch, true)) {
       LOG(warning) << "MillePede2 - Failed to solve locals by Gaussian Elimination, skip...";
       matCLoc.Print("d");
       return 0; // failed to solve
@@ -641,11 +658,11 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
   }
 
   // If requested, store the track params and errors
-  // RRR  printf("locfit: "); for (int i=0;i<fNLocPar;i++) printf("%+e |",fVecBLoc[i]); printf("\n");
+  // RRR  printf("locfit: "); for (int i=0;i<fNLocPar;i++) printf("%+e |",vecBLoc[i]); printf("\n");
 
   if (localParams.size()) {
     for (int i = maxLocUsed; i--;) {
-      localParams[2 * i] = fVecBLoc[i];
+      localParams[2 * i] = vecBLoc[i];
       localParams[2 * i + 1] = TMath::Sqrt(TMath::Abs(matCLoc.QueryDiag(i)));
     }
   }
@@ -653,20 +670,20 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
   int nEq = 0;
 
   for (int ip = nPoints; ip--;) { // Calculate residuals
-    double resid = fRecord->GetValue(refLoc[ip] - 1);
-    double weight = fRecord->GetValue(refGlo[ip] - 1) * gloWgh;
+    double resid = record.GetValue(refLoc[ip] - 1);
+    double weight = record.GetValue(refGlo[ip] - 1) * gloWgh;
     int odd = (ip & 0x1);
     if (fWghScl[odd] > 0) {
       weight *= fWghScl[odd];
     }
-    double* derLoc = fRecord->GetValue() + refLoc[ip];
-    double* derGlo = fRecord->GetValue() + refGlo[ip];
-    int* indLoc = fRecord->GetIndex() + refLoc[ip];
-    int* indGlo = fRecord->GetIndex() + refGlo[ip];
+    double* derLoc = record.GetValue() + refLoc[ip];
+    double* derGlo = record.GetValue() + refGlo[ip];
+    int* indLoc = record.GetIndex() + refLoc[ip];
+    int* indGlo = record.GetIndex() + refGlo[ip];
 
     // Suppress local and global contribution in residuals;
     for (int i = nrefLoc[ip]; i--;) {
-      resid -= derLoc[i] * fVecBLoc[indLoc[i]];
+      resid -= derLoc[i] * vecBLoc[indLoc[i]];
     } // local part
 
     for (int i = nrefGlo[ip]; i--;) { // global part
@@ -685,9 +702,9 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
     double absres = TMath::Abs(resid);
     if ((absres >= fResCutInit && fIter == 1) || (absres >= fResCut && fIter > 1)) {
       if (fLocFitAdd) {
-        fNLocFitsRejected++;
+        ws.nLocFitsRejected++;
       }
-      LOGF(info, "MillePede2 - reject res %+e in record %5ld ", resid, fCurrRecDataID); // A.R. comment
+      LOGF(info, "MillePede2 - reject res %+e in record %5ld ", resid, recID); // A.R. comment
       return 0;
     }
 
@@ -698,28 +715,26 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
   lChi2 /= gloWgh;
   int nDoF = nEq - maxLocUsed;
   lChi2 = (nDoF > 0) ? lChi2 / nDoF : 0; // Chi^2/dof
-  fSumChi2 = lChi2;
-  fRecNDoF = nDoF;
 
   if (fNStdDev != 0 && nDoF > 0 && lChi2 > Chi2DoFLim(fNStdDev, nDoF) * fChi2CutFactor) { // check final chi2
-    fIsChi2BelowLimit = false;
+    isChi2BelowLimit = false;
     if (GetCurrentIteration() == 1 && fTreeChi2) {
-      fTreeChi2->Fill();
+      ws.recChi2.push_back({lChi2, isChi2BelowLimit, nDoF});
     }
     if (fLocFitAdd) {
-      fNLocFitsRejected++;
+      ws.nLocFitsRejected++;
     }
-    LOGF(debug, "MillePede2 - reject chi2 %+e record %5ld: (nDOF %d)", lChi2, fCurrRecDataID, nDoF); // A.R. comment
-    // fRecord->Print();                                                                                // A.R. comment
+    LOGF(debug, "MillePede2 - reject chi2 %+e record %5ld: (nDOF %d)", lChi2, recID, nDoF); // A.R. comment
+    // record.Print();                                                                              // A.R. comment
     return 0;
   }
 
   if (fLocFitAdd) {
-    fNLocFits++;
-    fNLocEquations += nEq;
+    ws.nLocFits++;
+    ws.nLocEquations += nEq;
   } else {
-    fNLocFits--;
-    fNLocEquations -= nEq;
+    ws.nLocFits--;
+    ws.nLocEquations -= nEq;
   }
 
   //  local operations are finished, track is accepted
@@ -728,16 +743,16 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
   int nGloInFit = 0;
 
   for (int ip = nPoints; ip--;) { // Update matrices
-    double resid = fRecord->GetValue(refLoc[ip] - 1);
-    double weight = fRecord->GetValue(refGlo[ip] - 1) * gloWgh;
+    double resid = record.GetValue(refLoc[ip] - 1);
+    double weight = record.GetValue(refGlo[ip] - 1) * gloWgh;
     int odd = (ip & 0x1);
     if (fWghScl[odd] > 0) {
       weight *= fWghScl[odd];
     }
-    double* derLoc = fRecord->GetValue() + refLoc[ip];
-    double* derGlo = fRecord->GetValue() + refGlo[ip];
-    int* indLoc = fRecord->GetIndex() + refLoc[ip];
-    int* indGlo = fRecord->GetIndex() + refGlo[ip];
+    double* derLoc = record.GetValue() + refLoc[ip];
+    double* derGlo = record.GetValue() + refGlo[ip];
+    int* indLoc = record.GetIndex() + refLoc[ip];
+    int* indGlo = record.GetIndex() + refGlo[ip];
 
     for (int i = nrefGlo[ip]; i--;) { // suppress the global part
       int iID = indGlo[i];            // Global param indice
@@ -756,10 +771,11 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
       if (iIDg < 0 || fSigmaPar[iIDg] <= 0.) {
         continue;
       } // fixed parameter RRRCheck
+      ws.vecIndex.push_back(iIDg);
       if (fLocFitAdd) {
-        fVecBGlo[iIDg] += weight * resid * derGlo[ig];
+        ws.vecValue.push_back(weight * resid * derGlo[ig]);
       } else {
-        fVecBGlo[iIDg] -= weight * resid * derGlo[ig];
+        ws.vecValue.push_back(-weight * resid * derGlo[ig]);
       }
 
       // First of all, the global/global terms (exactly like local matrix)
@@ -770,39 +786,37 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
           continue;
         } // fixed parameter RRRCheck
         if (!IsZero(vl = weight * derGlo[ig] * derGlo[jg])) {
-          fFillIndex[nfill] = jIDg;
-          fFillValue[nfill++] = fLocFitAdd ? vl : -vl;
+          ws.fillIndex[nfill] = jIDg;
+          ws.fillValue[nfill++] = fLocFitAdd ? vl : -vl;
         }
       }
       if (nfill) {
-        matCGlo.AddToRow(iIDg, fFillValue.data(), fFillIndex.data(), nfill);
+        ws.AddToRow(iIDg, ws.fillValue.data(), ws.fillIndex.data(), nfill);
       }
 
       // Now we have also rectangular matrices containing global/local terms.
-      int iCIDg = fGlo2CGlo[iIDg]; // compressed Index of index
+      int iCIDg = ws.glo2CGlo[iIDg]; // compressed Index of index
       if (iCIDg == -1) {
         double* rowGL = matCGloLoc(nGloInFit);
         for (int k = maxLocUsed; k--;) {
           rowGL[k] = 0.0;
         } // reset the row
-        iCIDg = fGlo2CGlo[iIDg] = nGloInFit;
-        fCGlo2Glo[nGloInFit++] = iIDg;
+        iCIDg = ws.glo2CGlo[iIDg] = nGloInFit;
+        ws.cGlo2Glo[nGloInFit++] = iIDg;
       }
 
       double* rowGLIDg = matCGloLoc(iCIDg);
       for (int il = nrefLoc[ip]; il--;) {
         rowGLIDg[indLoc[il]] += weight * derGlo[ig] * derLoc[il];
       }
-      fProcPnt[iIDg] += fLocFitAdd ? 1 : -1; // update counter
+      ws.procPnt[iIDg] += fLocFitAdd ? 1 : -1; // update counter
     }
   } // end of Update matrices
   //
   /*//RRR
   LOG(info) << "MillePede2 - After GLO";
-  printf("MatCLoc: "); fMatCLoc->Print("l");
-  printf("MatCGlo: "); fMatCGlo->Print("l");
-  printf("MatCGlLc:"); fMatCGloLoc->Print("l");
-  printf("BGlo: "); for (int i=0; i<fNGloPar; i++) printf("%+e |",fVecBGlo[i]); printf("\n");
+  printf("MatCLoc: "); matCLoc.Print("l");
+  printf("MatCGlLc:"); matCGloLoc.Print("l");
   */
   // calculate fMatCGlo -= fMatCGloLoc * fMatCLoc * fMatCGloLoc^T
   // and       fVecBGlo -= fMatCGloLoc * fVecBLoc
@@ -810,22 +824,23 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
   //-------------------------------------------------------------- >>>
   double vll;
   for (int iCIDg = 0; iCIDg < nGloInFit; iCIDg++) {
-    int iIDg = fCGlo2Glo[iCIDg];
+    int iIDg = ws.cGlo2Glo[iCIDg];
 
     vl = 0;
     double* rowGLIDg = matCGloLoc(iCIDg);
     for (int kl = 0; kl < maxLocUsed; kl++) {
       if (rowGLIDg[kl]) {
-        vl += rowGLIDg[kl] * fVecBLoc[kl];
+        vl += rowGLIDg[kl] * vecBLoc[kl];
       }
     }
     if (!IsZero(vl)) {
-      fVecBGlo[iIDg] -= fLocFitAdd ? vl : -vl;
+      ws.vecIndex.push_back(iIDg);
+      ws.vecValue.push_back(fLocFitAdd ? -vl : vl);
     }
 
     int nfill = 0;
     for (int jCIDg = 0; jCIDg <= iCIDg; jCIDg++) {
-      int jIDg = fCGlo2Glo[jCIDg];
+      int jIDg = ws.cGlo2Glo[jCIDg];
 
       vl = 0;
       double* rowGLJDg = matCGloLoc(jCIDg);
@@ -846,34 +861,99 @@ int MillePede2::LocalFit(std::vector<double>& localParams)
         }
       }
       if (!IsZero(vl)) {
-        fFillIndex[nfill] = jIDg;
-        fFillValue[nfill++] = fLocFitAdd ? -vl : vl;
+        ws.fillIndex[nfill] = jIDg;
+        ws.fillValue[nfill++] = fLocFitAdd ? -vl : vl;
       }
     }
     if (nfill) {
-      matCGlo.AddToRow(iIDg, fFillValue.data(), fFillIndex.data(), nfill);
+      ws.AddToRow(iIDg, ws.fillValue.data(), ws.fillIndex.data(), nfill);
     }
   }
 
   // reset compressed index array
 
-  /*//RRR
-  LOG(info) << "MillePede2 - After GLOLoc";
-  printf("MatCGlo: "); fMatCGlo->Print("");
-  printf("BGlo: "); for (int i=0; i<fNGloPar; i++) printf("%+e |",fVecBGlo[i]); printf("\n");
-  */
   for (int i = nGloInFit; i--;) {
-    fGlo2CGlo[fCGlo2Glo[i]] = -1;
-    fCGlo2Glo[i] = -1;
+    ws.glo2CGlo[ws.cGlo2Glo[i]] = -1;
+    ws.cGlo2Glo[i] = -1;
   }
   //
   //---------------------------------------------------- <<<
   if (GetCurrentIteration() == 1 && fTreeChi2) {
-    fTreeChi2->Fill();
+    ws.recChi2.push_back({lChi2, isChi2BelowLimit, nDoF});
   }
   return 1;
 }
 
+//_____________________________________________________________________________
+void MillePede2::AddRecordToBatch()
+{
+  if (int(fRecBatch.size()) <= fNRecBatch) {
+    fRecBatch.resize(fNRecBatch + 1);
+    fRecBatchID.resize(fNRecBatch + 1);
+    fRecBatchWgh.resize(fNRecBatch + 1);
+  }
+  fRecBatch[fNRecBatch] = *fRecord;
+  fRecBatchID[fNRecBatch] = fCurrRecDataID;
+  fRecBatchWgh[fNRecBatch] = fRunWgh;
+  fNRecBatch++;
+}
+
+//_____________________________________________________________________________
+void MillePede2::ProcessRecordBatch()
+{
+  if (!fNRecBatch) {
+    return;
+  }
+  while (int(fLocFitWs.size()) < fNThreads) {
+    fLocFitWs.emplace_back(std::make_unique<LocalFitWorkspace>(fNGloPar, fNLocPar));
+  }
+  // every thread fits a contiguous range of records, so that the contributions
+  // are added to the global equations in the same order as by a sequential processing
+  int nws = std::min(fNThreads, fNRecBatch);
+  int chunk = (fNRecBatch + nws - 1) / nws;
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(nws) schedule(static, 1)
+#endif
+  for (int iws = 0; iws < nws; iws++) {
+    std::vector<double> emptyLocalParams = {};
+    int last = std::min(fNRecBatch, (iws + 1) * chunk);
+    for (int ir = iws * chunk; ir < last; ir++) {
+      LocalFit(fRecBatch[ir], fRecBatchID[ir], fRecBatchWgh[ir], *fLocFitWs[iws], emptyLocalParams);
+    }
+  }
+  fNRecBatch = 0;
+  AddLocalFitContributions();
+}
+
+//_____________________________________________________________________________
+void MillePede2::AddLocalFitContributions()
+{
+  MatrixSq& matCGlo = *fMatCGlo;
+  for (auto& pws : fLocFitWs) {
+    auto& ws = *pws;
+    for (size_t i = 0; i < ws.matRows.size(); i++) {
+      int start = ws.matRowStart[i];
+      matCGlo.AddToRow(ws.matRows[i], ws.matValue.data() + start, ws.matIndex.data() + start, ws.matRowStart[i + 1] - start);
+    }
+    for (size_t i = 0; i < ws.vecIndex.size(); i++) {
+      fVecBGlo[ws.vecIndex[i]] += ws.vecValue[i];
+    }
+    for (int i = fNGloPar; i--;) {
+      fProcPnt[i] += ws.procPnt[i];
+    }
+    for (const auto& rc : ws.recChi2) {
+      fSumChi2 = rc.sumChi2;
+      fIsChi2BelowLimit = rc.isChi2BelowLimit;
+      fRecNDoF = rc.recNDoF;
+      fTreeChi2->Fill();
+    }
+    fNLocFits += ws.nLocFits;
+    fNLocFitsRejected += ws.nLocFitsRejected;
+    fNLocEquations += ws.nLocEquations;
+    ws.ClearContributions();
+  }
+}
+
 //_____________________________________________________________________________
 int MillePede2::GlobalFit(std::vector<double>& par,
                           std::vector<double>& error,
@@ -1006,12 +1086,15 @@ int MillePede2::GlobalFitIteration()
     if (!IsRecordAcceptable() || !fRecordReader->isReadEntryOk()) {
       continue;
     }
-    std::vector<double> emptyLocalParams = {};
-    LocalFit(emptyLocalParams);
+    AddRecordToBatch();
+    if (fNRecBatch >= fNThreads * kRecordBatchSize) {
+      ProcessRecordBatch();
+    }
     if ((i % int(0.2 * ndr)) == 0) {
       printf("%.1f%% of local fits done\n", double(100. * i) / ndr);
     }
   }
+  ProcessRecordBatch();
   swt.Stop();
   LOGF(info, "MillePede2 - %ld local fits done: ", ndr);
   /*
@@ -1115,10 +1198,13 @@ int MillePede2::GlobalFitIteration()
         }
       }
       if (suppr) {
-        std::vector<double> emptyLocalParams = {};
-        LocalFit(emptyLocalParams);
+        AddRecordToBatch();
+        if (fNRecBatch >= fNThreads * kRecordBatchSize) {
+          ProcessRecordBatch();
+        }
       }
     }
+    ProcessRecordBatch();
     fLocFitAdd = true;
 
     if (nFixedGroups) {
@@ -1377,6 +1463,7 @@ int MillePede2::SolveGlobalMatEq()
   if (!slv) {
     return kFailed;
   }
+  slv->SetNThreads(fNThreads);
   bool res = false;
   if (fgIterSol == MinResSolve::kSolMinRes) {
     res = slv->SolveMinRes(sol, fgMinResCondType, fgMinResMaxIter, fgMinResTol);
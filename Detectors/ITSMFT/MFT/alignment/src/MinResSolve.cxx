@@ -44,7 +44,8 @@ MinResSolve::MinResSolve()
     fDiagLU(nullptr),
     fMatL(nullptr),
     fMatU(nullptr),
-    fMatBD(nullptr)
+    fMatBD(nullptr),
+    fNThreads(1)
 {
 }
 
@@ -68,7 +69,8 @@ MinResSolve::MinResSolve(const MinResSolve& src)
     fDiagLU(nullptr),
     fMatL(nullptr),
     fMatU(nullptr),
-    fMatBD(nullptr)
+    fMatBD(nullptr),
+    fNThreads(1)
 {
 }
 
@@ -91,7 +93,8 @@ MinResSolve::MinResSolve(const MatrixSq* mat, const TVectorD* rhs)
     fDiagLU(nullptr),
     fMatL(nullptr),
     fMatU(nullptr),
-    fMatBD(nullptr)
+    fMatBD(nullptr),
+    fNThreads(1)
 {
 }
 
@@ -114,7 +117,8 @@ MinResSolve::MinResSolve(const MatrixSq* mat, const double* rhs)
     fDiagLU(nullptr),
     fMatL(nullptr),
     fMatU(nullptr),
-    fMatBD(nullptr)
+    fMatBD(nullptr),
+    fNThreads(1)
 {
 }
 
@@ -132,6 +136,7 @@ MinResSolve& MinResSolve::operator=(const MinResSolve& src)
     fPrecon = src.fPrecon;
     fMatrix = src.fMatrix;
     fRHS = src.fRHS;
+    fNThreads = src.fNThreads;
   }
   return *this;
 }
@@ -211,6 +216,7 @@ Bool_t MinResSolve::SolveFGMRES(double* VecSol, Int_t precon, int itnlim, double
   if (!InitAuxFGMRES(nkrylov)) {
     return kFALSE;
   }
+  BuildCSR();
 
   for (l = fSize; l--;) {
     VecSol[l] = 0;
@@ -222,7 +228,7 @@ Bool_t MinResSolve::SolveFGMRES(double* VecSol, Int_t precon, int itnlim, double
   while (1) {
 
     //-------------------- compute initial residual vector
-    fMatrix->MultiplyByVec(VecSol, fPvv[0]);
+    ApplyMatrix(VecSol, fPvv[0]);
     for (l = fSize; l--;) {
       fPvv[0][l] = fRHS[l] - fPvv[0][l]; //  fPvv[0]= initial residual
     }
@@ -263,7 +269,7 @@ Bool_t MinResSolve::SolveFGMRES(double* VecSol, Int_t precon, int itnlim, double
       }
 
       //-------------------- matvec operation w = A z_{j} = A M^{-1} v_{j}
-      fMatrix->MultiplyByVec(fPvz[i], fPvv[i1]);
+      ApplyMatrix(fPvz[i], fPvv[i1]);
 
       // modified gram - schmidt...
       // h_{i,j} = (w,v_{i})
@@ -414,6 +420,7 @@ Bool_t MinResSolve::SolveMinRes(double* VecSol, Int_t precon, int itnlim, double
   if (!InitAuxMinRes()) {
     return kFALSE;
   }
+  BuildCSR();
 
   memset(VecSol, 0, fSize * sizeof(double));
 
@@ -489,7 +496,7 @@ Bool_t MinResSolve::SolveMinRes(double* VecSol, Int_t precon, int itnlim, double
     for (int i = fSize; i--;) {
       fPVecV[i] = s * fPVecY[i]; // v = vk if P = I
     }
-    fMatrix->MultiplyByVec(fPVecV, fPVecY); //      APROD (VecV, VecY);
+    ApplyMatrix(fPVecV, fPVecY); //      APROD (VecV, VecY);
 
     if (itn >= 2) {
       double btrat = beta / oldb;
@@ -685,6 +692,103 @@ void MinResSolve::ApplyPrecon(const double* vecRHS, double* vecOut) const
   }
 }
 
+//___________________________________________________________
+void MinResSolve::BuildCSR()
+{
+  // the symmetric matrices store only the lower triangle: both triangles are stored
+  // in the CSR copy so that the rows can be multiplied independently by several threads
+  fCSRRowPtr.assign(fSize + 1, 0);
+  fCSRCol.clear();
+  fCSRVal.clear();
+  bool sym = fMatrix->IsSymmetric();
+  MatrixSparse* matSp = fMatrix->InheritsFrom("MatrixSparse") ? (MatrixSparse*)fMatrix : nullptr;
+
+  // count the elements of every row
+  for (int ir = 0; ir < fSize; ir++) {
+    if (matSp) {
+      VectorSparse* row = matSp->GetRow(ir);
+      for (int j = row->GetNElems(); j--;) {
+        int jc = row->GetIndex(j);
+        if (row->GetElem(j) == 0. || jc >= fSize) {
+          continue;
+        }
+        fCSRRowPtr[ir + 1]++;
+        if (sym && jc != ir) {
+          fCSRRowPtr[jc + 1]++;
+        }
+      }
+    } else {
+      for (int jc = 0; jc < (sym ? ir + 1 : fSize); jc++) {
+        if (fMatrix->Query(ir, jc) == 0.) {
+          continue;
+        }
+        fCSRRowPtr[ir + 1]++;
+        if (sym && jc != ir) {
+          fCSRRowPtr[jc + 1]++;
+        }
+      }
+    }
+  }
+  for (int ir = 0; ir < fSize; ir++) {
+    fCSRRowPtr[ir + 1] += fCSRRowPtr[ir];
+  }
+  fCSRCol.resize(fCSRRowPtr[fSize]);
+  fCSRVal.resize(fCSRRowPtr[fSize]);
+
+  // fill them
+  std::vector<Int_t> pos(fCSRRowPtr.begin(), fCSRRowPtr.end() - 1);
+  auto add = [&](int ir, int jc, double vl) {
+    fCSRCol[pos[ir]] = jc;
+    fCSRVal[pos[ir]++] = vl;
+    if (sym && jc != ir) {
+      fCSRCol[pos[jc]] = ir;
+      fCSRVal[pos[jc]++] = vl;
+    }
+  };
+  for (int ir = 0; ir < fSize; ir++) {
+    if (matSp) {
+      VectorSparse* row = matSp->GetRow(ir);
+      for (int j = 0; j < row->GetNElems(); j++) {
+        int jc = row->GetIndex(j);
+        if (row->GetElem(j) != 0. && jc < fSize) {
+          add(ir, jc, row->GetElem(j));
+        }
+      }
+    } else {
+      for (int jc = 0; jc < (sym ? ir + 1 : fSize); jc++) {
+        double vl = fMatrix->Query(ir, jc);
+        if (vl != 0.) {
+          add(ir, jc, vl);
+        }
+      }
+    }
+  }
+  LOG(info) << "Built CSR copy of the matrix with " << fCSRRowPtr[fSize] << " non-zero elements, "
+            << fNThreads << " thread(s) used for the products";
+}
+
+//___________________________________________________________
+void MinResSolve::ApplyMatrix(const double* vecIn, double* vecOut) const
+{
+  if (fCSRRowPtr.empty()) {
+    fMatrix->MultiplyByVec(vecIn, vecOut);
+    return;
+  }
+  const Int_t* rowPtr = fCSRRowPtr.data();
+  const Int_t* cols = fCSRCol.data();
+  const Double_t* vals = fCSRVal.data();
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(fNThreads) schedule(static)
+#endif
+  for (int ir = 0; ir < fSize; ir++) {
+    double sum = 0;
+    for (int j = rowPtr[ir]; j < rowPtr[ir + 1]; j++) {
+      sum += vals[j] * vecIn[cols[j]];
+    }
+    vecOut[ir] = sum;
+  }
+}
+
 //___________________________________________________________
 Bool_t MinResSolve::InitAuxMinRes()
 {
@@ -75,6 +75,7 @@ void RecordsToAlignParams::init()
     mMillepede->SetConstraintsRecReader(mConstraintsRecReader);
   }
 
+  mMillepede->SetNThreads(mNThreads);
   mMillepede->InitMille(mNumberOfGlobalParam,
                         mNumberOfTrackParam,
                         mChi2CutNStdDev,
@@ -86,6 +87,7 @@ void RecordsToAlignParams::init()
   LOGF(info, "ResidualCutInitial = %.3f", mResCutInitial);
   LOGF(info, "ResidualCut = %.3f", mResCut);
   LOGF(info, "mStartFac = %.3f", mStartFac);
+  LOGF(info, "NThreads = %d", mNThreads);
   LOGF(info,
        "Allowed variation: dx = %.3f, dy = %.3f, dz = %.3f, dRz = %.4f",
        mAllowVar[0], mAllowVar[1], mAllowVar[3], mAllowVar[2]);
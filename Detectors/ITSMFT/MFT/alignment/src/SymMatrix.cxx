@@ -22,16 +22,12 @@ using namespace o2::mft;
 
 ClassImp(SymMatrix);
 
-SymMatrix* SymMatrix::fgBuffer = nullptr;
-Int_t SymMatrix::fgCopyCnt = 0;
-
 //___________________________________________________________
 SymMatrix::SymMatrix()
   : fElems(nullptr),
     fElemsAdd(nullptr)
 {
   fSymmetric = kTRUE;
-  fgCopyCnt++;
 }
 
 //___________________________________________________________
@@ -45,7 +41,6 @@ SymMatrix::SymMatrix(Int_t size)
   fElems = new Double_t[fNcols * (fNcols + 1) / 2];
   fSymmetric = kTRUE;
   Reset();
-  fgCopyCnt++;
 }
 
 //___________________________________________________________
@@ -75,17 +70,12 @@ SymMatrix::SymMatrix(const SymMatrix& src)
     fElems = nullptr;
   }
   fElemsAdd = nullptr;
-  fgCopyCnt++;
 }
 
 //___________________________________________________________
 SymMatrix::~SymMatrix()
 {
   Clear();
-  if (--fgCopyCnt < 1 && fgBuffer) {
-    delete fgBuffer;
-    fgBuffer = nullptr;
-  }
 }
 
 //___________________________________________________________
@@ -234,18 +224,14 @@ Bool_t SymMatrix::Multiply(const SymMatrix& right)
     LOG(error) << "Matrix sizes are different";
     return kFALSE;
   }
-  if (!fgBuffer || fgBuffer->GetSizeUsed() != sz) {
-    delete fgBuffer;
-    fgBuffer = new SymMatrix(*this);
-  } else {
-    (*fgBuffer) = *this;
-  }
+  CopyToBuffer(fBuffer);
+  const SymMatrix& buffer = *fBuffer;
 
   for (int i = sz; i--;) {
     for (int j = i + 1; j--;) {
       double val = 0.;
       for (int k = sz; k--;) {
-        val += fgBuffer->GetEl(i, k) * right.GetEl(k, j);
+        val += buffer.GetEl(i, k) * right.GetEl(k, j);
       }
       SetEl(i, j, val);
     }
@@ -255,16 +241,20 @@ Bool_t SymMatrix::Multiply(const SymMatrix& right)
 }
 
 //___________________________________________________________
-SymMatrix* SymMatrix::DecomposeChol()
+void SymMatrix::CopyToBuffer(std::unique_ptr<SymMatrix>& buffer) const
 {
-  if (!fgBuffer || fgBuffer->GetSizeUsed() != GetSizeUsed()) {
-    delete fgBuffer;
-    fgBuffer = new SymMatrix(*this);
+  if (!buffer || buffer->GetSizeUsed() != GetSizeUsed()) {
+    buffer = std::make_unique<SymMatrix>(*this);
   } else {
-    (*fgBuffer) = *this;
+    (*buffer) = *this;
   }
+}
 
-  SymMatrix& mchol = *fgBuffer;
+//___________________________________________________________
+SymMatrix* SymMatrix::DecomposeChol(std::unique_ptr<SymMatrix>& buffer)
+{
+  CopyToBuffer(buffer);
+  SymMatrix& mchol = *buffer;
 
   for (int i = 0; i < GetSizeUsed(); i++) {
     Double_t* rowi = mchol.GetRow(i);
@@ -289,13 +279,13 @@ SymMatrix* SymMatrix::DecomposeChol()
       }
     }
   }
-  return fgBuffer;
+  return buffer.get();
 }
 
 //___________________________________________________________
 Bool_t SymMatrix::InvertChol()
 {
-  SymMatrix* mchol = DecomposeChol();
+  SymMatrix* mchol = DecomposeChol(fBuffer);
   if (!mchol) {
     LOG(error) << "Failed to invert the matrix";
     return kFALSE;
@@ -349,11 +339,17 @@ void SymMatrix::InvertChol(SymMatrix* pmchol)
 
 //___________________________________________________________
 Bool_t SymMatrix::SolveChol(Double_t* b, Bool_t invert)
+{
+  return SolveChol(b, fBuffer, invert);
+}
+
+//___________________________________________________________
+Bool_t SymMatrix::SolveChol(Double_t* b, std::unique_ptr<SymMatrix>& buffer, Bool_t invert)
 {
   Int_t i, k;
   Double_t sum;
 
-  SymMatrix* pmchol = DecomposeChol();
+  SymMatrix* pmchol = DecomposeChol(buffer);
   if (!pmchol) {
     LOG(debug) << "SolveChol failed";
     //    Print("l");
@@ -396,7 +392,7 @@ Bool_t SymMatrix::SolveCholN(Double_t* bn, int nRHS, Bool_t invert)
   Int_t i, k;
   Double_t sum;
 
-  SymMatrix* pmchol = DecomposeChol();
+  SymMatrix* pmchol = DecomposeChol(fBuffer);
   if (!pmchol) {
     LOG(debug) << "SolveChol failed";
     //    Print("l");
@@ -550,6 +546,12 @@ Double_t* SymMatrix::GetRow(Int_t r)
 
 //___________________________________________________________
 int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
+{
+  return SolveSpmInv(vecB, fBuffer, stabilize);
+}
+
+//___________________________________________________________
+int SymMatrix::SolveSpmInv(double* vecB, std::unique_ptr<SymMatrix>& buffer, Bool_t stabilize)
 {
   Int_t nRank = 0;
   int iPivot;
@@ -603,12 +605,8 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
     bUnUsed[i] = true;
   }
 
-  if (!fgBuffer || fgBuffer->GetSizeUsed() != GetSizeUsed()) {
-    delete fgBuffer;
-    fgBuffer = new SymMatrix(*this);
-  } else {
-    (*fgBuffer) = *this;
-  }
+  CopyToBuffer(buffer);
+  SymMatrix& upper = *buffer; // holds the upper triangle
 
   if (stabilize) {
     for (int i = 0; i < nGlo; i++) { // Small loop for matrix equilibration (gives a better conditioning)
@@ -621,13 +619,13 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
       for (int j = i + 1; j < nGlo; j++) {
         double vl = Query(j, i);
         if (!IsZero(vl)) {
-          fgBuffer->SetEl(j, i, TMath::Sqrt(rowMax[i]) * vl * TMath::Sqrt(colMax[j])); // Equilibrate the V matrix
+          upper.SetEl(j, i, TMath::Sqrt(rowMax[i]) * vl * TMath::Sqrt(colMax[j])); // Equilibrate the V matrix
         }
       }
     }
   }
   for (Int_t j = nGlo; j--;) {
-    fgBuffer->DiagElem(j) = TMath::Abs(QueryDiag(j)); // save diagonal elem absolute values
+    upper.DiagElem(j) = TMath::Abs(QueryDiag(j)); // save diagonal elem absolute values
   }
   for (Int_t i = 0; i < nGlo; i++) {
     vPivot = 0.0;
@@ -635,7 +633,7 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
 
     for (Int_t j = 0; j < nGlo; j++) { // First look for the pivot, ie max unused diagonal element
       double vl;
-      if (bUnUsed[j] && (TMath::Abs(vl = QueryDiag(j)) > TMath::Max(TMath::Abs(vPivot), eps * fgBuffer->QueryDiag(j)))) {
+      if (bUnUsed[j] && (TMath::Abs(vl = QueryDiag(j)) > TMath::Max(TMath::Abs(vPivot), eps * upper.QueryDiag(j)))) {
         vPivot = vl;
         iPivot = j;
       }
@@ -650,8 +648,8 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
       for (Int_t j = 0; j < nGlo; j++) {
         for (Int_t jj = 0; jj < nGlo; jj++) {
           if (j != iPivot && jj != iPivot) { // Other elements (!!! do them first as you use old matV[k][j]'s !!!)
-            double& r = j >= jj ? (*this)(j, jj) : (*fgBuffer)(jj, j);
-            r -= vPivot * (j > iPivot ? Query(j, iPivot) : fgBuffer->Query(iPivot, j)) * (iPivot > jj ? Query(iPivot, jj) : fgBuffer->Query(jj, iPivot));
+            double& r = j >= jj ? (*this)(j, jj) : upper(jj, j);
+            r -= vPivot * (j > iPivot ? Query(j, iPivot) : upper.Query(iPivot, j)) * (iPivot > jj ? Query(iPivot, jj) : upper.Query(jj, iPivot));
           }
         }
       }
@@ -659,7 +657,7 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
       for (Int_t j = 0; j < nGlo; j++) {
         if (j != iPivot) { // Pivot row or column elements
           (*this)(j, iPivot) *= vPivot;
-          (*fgBuffer)(iPivot, j) *= vPivot;
+          upper(iPivot, j) *= vPivot;
         }
       }
     } else { // No more pivot value (clear those elements)
@@ -669,7 +667,7 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
           for (Int_t k = 0; k < nGlo; k++) {
             (*this)(j, k) = 0.;
             if (j != k) {
-              (*fgBuffer)(j, k) = 0;
+              upper(j, k) = 0;
             }
           }
         }
@@ -685,7 +683,7 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
         if (i >= j) {
           (*this)(i, j) *= vl;
         } else {
-          (*fgBuffer)(j, i) *= vl;
+          upper(j, i) *= vl;
         }
       }
     }
@@ -697,7 +695,7 @@ int SymMatrix::SolveSpmInv(double* vecB, Bool_t stabilize)
       if (j >= jj) {
         vl = (*this)(j, jj) = -Query(j, jj);
       } else {
-        vl = (*fgBuffer)(j, jj) = -fgBuffer->Query(j, jj);
+        vl = upper(j, jj) = -upper.Query(j, jj);
       }
       rowMax[j] += vl * vecB[jj];
     }
@@ -42,7 +42,7 @@ constexpr int DefRDHVersion = o2::raw::RDHUtils::getVersion<o2::header::RAWDataH
 
 void setupLinks(o2::itsmft::MC2RawEncoder<MAP>& m2r, std::string_view outDir, std::string_view outPrefix, std::string_view fileFor);
 void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV = DefRDHVersion, bool enablePadding = false,
-              bool noEmptyHBF = false, int superPageSizeInB = 1024 * 1024);
+              bool noEmptyHBF = false, int nThreads = 1, int asyncBufferMB = 0, int superPageSizeInB = 1024 * 1024);
 
 int main(int argc, char** argv)
 {
@@ -63,6 +63,8 @@ int main(int argc, char** argv)
     add_option("rdh-version,r", bpo::value<uint32_t>()->default_value(DefRDHVersion), "RDH version to use");
     add_option("enable-padding", bpo::value<bool>()->default_value(false)->implicit_value(true), "enable GBT word padding to 128 bits even for RDH V7");
     add_option("no-empty-hbf,e", bpo::value<bool>()->default_value(false)->implicit_value(true), "do not create empty HBF pages (except for HBF starting TF)");
+    add_option("nthreads,t", bpo::value<int>()->default_value(1), "number of threads encoding the RUs and filling the links");
+    add_option("async-write-buffer", bpo::value<int>()->default_value(0), "size in MB of the buffers for asynchronous writing of the raw files (0: synchronous)");
     add_option("hbfutils-config,u", bpo::value<std::string>()->default_value(std::string(o2::base::NameConf::DIGITIZATIONCONFIGFILE)), "config file for HBFUtils (or none)");
     add_option("configKeyValues", bpo::value<std::string>()->default_value(""), "comma-separated configKeyValues");
 
@@ -96,7 +98,9 @@ int main(int argc, char** argv)
            vm["verbosity"].as<uint32_t>(),
            vm["rdh-version"].as<uint32_t>(),
            vm["enable-padding"].as<bool>(),
-           vm["no-empty-hbf"].as<bool>());
+           vm["no-empty-hbf"].as<bool>(),
+           vm["nthreads"].as<int>(),
+           vm["async-write-buffer"].as<int>());
   LOG(info) << "HBFUtils settings used for conversion:";
 
   o2::raw::HBFUtils::Instance().print();
@@ -104,7 +108,7 @@ int main(int argc, char** argv)
   return 0;
 }
 
-void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV, bool enablePadding, bool noEmptyHBF, int superPageSizeInB)
+void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV, bool enablePadding, bool noEmptyHBF, int nThreads, int asyncBufferMB, int superPageSizeInB)
 {
   TStopwatch swTot;
   swTot.Start();
@@ -165,6 +169,10 @@ void digi2raw(std::string_view inpName, std::string_view outDir, std::string_vie
     m2r.getWriter().setAlignmentPaddingFiller(0xff);
   }
   m2r.getWriter().setDontFillEmptyHBF(noEmptyHBF);
+  m2r.setNThreads(nThreads);
+  if (asyncBufferMB > 0) {
+    m2r.getWriter().useAsyncWriting(size_t(asyncBufferMB) * 1024 * 1024);
+  }
 
   m2r.setVerbosity(verbosity);
   setupLinks(m2r, outDir, MAP::getName(), fileFor);
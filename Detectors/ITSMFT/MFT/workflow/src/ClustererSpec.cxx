@@ -15,6 +15,7 @@
 
 #include "Framework/ControlService.h"
 #include "Framework/ConfigParamRegistry.h"
+#include "Framework/DataAllocator.h"
 #include "Framework/CCDBParamSpec.h"
 #include "MFTWorkflow/ClustererSpec.h"
 #include "DataFormatsITSMFT/Digit.h"
@@ -48,6 +49,15 @@ void ClustererDPL::init(InitContext& ic)
   mUseClusterDictionary = !ic.options().get<bool>("ignore-cluster-dictionary");
   o2::base::GRPGeomHelper::instance().setRequest(mGGCCDBRequest);
   mNThreads = std::max(1, ic.options().get<int>("nthreads"));
+  if (ic.options().get<bool>("use-arena")) { // small outputs, carve them from the arena rather than from individual messages
+    DataAllocator outputs{ic.services()};
+    auto orig = o2::header::gDataOriginMFT;
+    outputs.useArena(Output{orig, "CLUSTERSROF", 0, Lifetime::Timeframe});
+    outputs.useArena(Output{orig, "PATTERNS", 0, Lifetime::Timeframe});
+    if (mUseMC) {
+      outputs.useArena(Output{orig, "CLUSTERSMC2ROF", 0, Lifetime::Timeframe});
+    }
+  }
   mState = 1;
 }
 
@@ -204,7 +214,8 @@ DataProcessorSpec getClustererSpec(bool useMC)
     AlgorithmSpec{adaptFromTask<ClustererDPL>(ggRequest, useMC)},
     Options{
       {"ignore-cluster-dictionary", VariantType::Bool, false, {"do not use cluster dictionary, always store explicit patterns"}},
-      {"nthreads", VariantType::Int, 1, {"Number of clustering threads"}}}};
+      {"nthreads", VariantType::Int, 1, {"Number of clustering threads"}},
+      {"use-arena", VariantType::Bool, false, {"allocate the small outputs from the per-timeslice arena"}}}};
 }
 
 } // namespace mft
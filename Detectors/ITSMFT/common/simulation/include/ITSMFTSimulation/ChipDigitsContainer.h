@@ -20,6 +20,8 @@
 #include "SimulationDataFormat/MCCompLabel.h"
 #include "ITSMFTBase/SegmentationAlpide.h"
 #include "ITSMFTSimulation/PreDigit.h"
+#include "ITSMFTSimulation/DigiParams.h"
+#include "ITSMFTSimulation/RandomSampling.h"
 #include "DataFormatsITSMFT/NoiseMap.h"
 #include <map>
 #include <vector>
@@ -28,8 +30,6 @@ namespace o2
 {
 namespace itsmft
 {
-class DigiParams;
-
 /// @class ChipDigitsContainer
 /// @brief Container for similated points connected to a given chip
 
@@ -52,6 +52,9 @@ class ChipDigitsContainer
   o2::itsmft::PreDigit* findDigit(ULong64_t key);
   void addDigit(ULong64_t key, UInt_t roframe, UShort_t row, UShort_t col, int charge, o2::MCCompLabel lbl);
   void addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmft::DigiParams* params, int maxRows = o2::itsmft::SegmentationAlpide::NRows, int maxCols = o2::itsmft::SegmentationAlpide::NCols);
+  /// add noise drawing from the provided random generator instead of gRandom
+  template <typename Rng>
+  void addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmft::DigiParams* params, Rng& rng, int maxRows = o2::itsmft::SegmentationAlpide::NRows, int maxCols = o2::itsmft::SegmentationAlpide::NCols);
 
   /// Get global ordering key made of readout frame, column and row
   static ULong64_t getOrderingKey(UInt_t roframe, UShort_t row, UShort_t col)
@@ -92,6 +95,35 @@ inline void ChipDigitsContainer::addDigit(ULong64_t key, UInt_t roframe, UShort_
 {
   mDigits.emplace(std::make_pair(key, o2::itsmft::PreDigit(roframe, row, col, charge, lbl)));
 }
+
+//_______________________________________________________________________
+template <typename Rng>
+void ChipDigitsContainer::addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmft::DigiParams* params, Rng& rng, int maxRows, int maxCols)
+{
+  float mean = params->getNoisePerPixel() * o2::itsmft::SegmentationAlpide::NPixels;
+  if (mean <= 0.f) {
+    return;
+  }
+  int nel = params->getChargeThreshold() * 1.1; // RS: TODO: need realistic spectrum of noise above the threshold
+
+  for (UInt_t rof = rofMin; rof <= rofMax; rof++) {
+    int nhits = random_sampling::poisson(rng, mean);
+    for (int i = 0; i < nhits; ++i) {
+      UShort_t row = random_sampling::uniformInt(rng, maxRows);
+      UShort_t col = random_sampling::uniformInt(rng, maxCols);
+      if (mNoiseMap && mNoiseMap->isNoisy(mChipIndex, row, col)) {
+        continue;
+      }
+      if (mDeadChanMap && mDeadChanMap->isNoisy(mChipIndex, row, col)) {
+        continue;
+      }
+      auto key = getOrderingKey(rof, row, col);
+      if (!findDigit(key)) {
+        addDigit(key, rof, row, col, nel, o2::MCCompLabel(true));
+      }
+    }
+  }
+}
 } // namespace itsmft
 } // namespace o2
 
@@ -84,6 +84,18 @@ class Digitizer : public TObject
   // provide the common itsmft::GeometryTGeo to access matrices and segmentation
   void setGeometry(const o2::itsmft::GeometryTGeo* gm) { mGeometry = gm; }
 
+  /// number of threads digitizing different chips in parallel, the result does not depend on it
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  /// base seed of the per-chip random streams, by default taken from gRandom in init()
+  void setRandomSeed(ULong64_t seed)
+  {
+    mRandomSeed = seed;
+    mRandomSeedSet = true;
+  }
+  ULong64_t getRandomSeed() const { return mRandomSeed; }
+
   uint32_t getEventROFrameMin() const { return mEventROFrameMin; }
   uint32_t getEventROFrameMax() const { return mEventROFrameMax; }
   void resetEventROFrames()
@@ -93,9 +105,29 @@ class Digitizer : public TObject
   }
 
  private:
-  void processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID, int srcID);
-  void registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, float tInROF, int nROF,
+  /// label contribution to an already existing predigit, to be added to the shared extra digits buffers
+  struct ExtraContribution {
+    PreDigit* preDigit = nullptr;
+    uint32_t roFrame = 0;
+    o2::MCCompLabel label;
+  };
+
+  /// hits of a single chip and the bookkeeping of their digitization, different chips are processed concurrently
+  struct ChipHits {
+    int chipID = 0;
+    int first = 0;                         ///< first entry of the chip hits in the sorted hits indices
+    int last = 0;                          ///< last entry (exclusive) of the chip hits
+    uint32_t roFrameMax = 0;               ///< highest RO frame affected by the hits
+    uint32_t eventROFrameMin = 0xffffffff; ///< lowest RO frame with registered digits
+    uint32_t eventROFrameMax = 0;          ///< highest RO frame with registered digits
+    std::vector<ExtraContribution> extra;  ///< contributions to existing predigits
+  };
+
+  template <typename Rng>
+  void processHit(const o2::itsmft::Hit& hit, ChipHits& work, Rng& rng, int evID, int srcID);
+  void registerDigits(ChipDigitsContainer& chip, ChipHits& work, uint32_t roFrame, float tInROF, int nROF,
                       uint16_t row, uint16_t col, int nEle, o2::MCCompLabel& lbl);
+  void addExtraContribution(const ExtraContribution& contr);
 
   ExtraDig* getExtraDigBuffer(uint32_t roFrame)
   {
@@ -139,6 +171,12 @@ class Digitizer : public TObject
   const o2::itsmft::NoiseMap* mNoiseMap = nullptr;
   const o2::itsmft::NoiseMap* mDeadChanMap = nullptr;
 
+  std::vector<int> mHitIdx;        //! hits indices sorted by chip
+  std::vector<ChipHits> mChipHits; //! hits of the chips of the current event
+  int mNThreads = 1;               //! number of threads
+  ULong64_t mRandomSeed = 0;       //! base seed of the per-chip random streams
+  bool mRandomSeedSet = false;     //! seed was set explicitly
+
   ClassDefOverride(Digitizer, 2);
 };
 } // namespace itsmft
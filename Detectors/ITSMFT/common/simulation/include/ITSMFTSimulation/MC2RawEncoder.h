@@ -35,6 +35,7 @@ template <class Mapping>
 class MC2RawEncoder
 {
   using Coder = o2::itsmft::AlpideCoder;
+  using LinkPayload = o2::raw::RawFileWriter::LinkPayload;
 
  public:
   MC2RawEncoder()
@@ -62,6 +63,14 @@ class MC2RawEncoder
   }
   int getVerbosity() const { return mVerbosity; }
 
+  /// number of threads encoding the RUs and filling the links
+  void setNThreads(int n)
+  {
+    mNThreads = n > 0 ? n : 1;
+    mWriter.setNThreads(mNThreads);
+  }
+  int getNThreads() const { return mNThreads; }
+
   Mapping& getMapping() { return mMAP; }
 
   void setMinMaxRUSW(uint8_t ruMin, uint8_t ruMax)
@@ -104,8 +113,9 @@ class MC2RawEncoder
   const GBTLink* getGBTLink(int i) const { return i < 0 ? nullptr : &mGBTLinks[i]; }
 
  private:
-  void convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru);
-  void convertChip(ChipPixelData& chipData, RUDecodeData& ru);
+  void convertRU(RUDecodeData& ru, Coder& coder);
+  void convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru, Coder& coder);
+  void convertChip(ChipPixelData& chipData, RUDecodeData& ru, Coder& coder);
   void fillGBTLinks(RUDecodeData& ru);
 
   enum RoMode_t { NotSet,
@@ -115,7 +125,9 @@ class MC2RawEncoder
   o2::raw::RawFileWriter mWriter{Mapping::getOrigin()}; // set origin of data
   std::string mDefaultSinkName = "dataSink.raw";
   Mapping mMAP;
-  Coder mCoder;
+  std::vector<Coder> mCoders;                                //! coder per thread
+  std::vector<LinkPayload> mPayloads;                        //! payloads of all links for the current IR
+  int mNThreads = 1;                                         //! number of threads
   int mVerbosity = 0;                                        //! verbosity level
   uint8_t mRUSWMin = 0;                                      ///< min RU (SW) to convert
   uint8_t mRUSWMax = 0xff;                                   ///< max RU (SW) to convert
@@ -0,0 +1,98 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//
+/// \file RandomSampling.h
+/// \brief sampling from a 32 bit engine (e.g. pcg32) with algorithms fixed here
+//
+// The std:: distributions are implementation-defined, i.e. the same engine state gives
+// different digits with different standard libraries. These samplers only rely on the
+// 32 bit outputs of the engine.
+
+#ifndef ALICEO2_ITSMFT_RANDOMSAMPLING_H_
+#define ALICEO2_ITSMFT_RANDOMSAMPLING_H_
+
+#include <cmath>
+#include <cstdint>
+
+namespace o2
+{
+namespace itsmft
+{
+namespace random_sampling
+{
+
+/// uniform in the open interval (0, 1)
+template <typename Rng>
+inline double uniform(Rng& rng)
+{
+  return (double(uint32_t(rng())) + 0.5) * (1. / 4294967296.);
+}
+
+/// uniform integer in [0, n), unbiased (rejection of the incomplete last range)
+template <typename Rng>
+inline uint32_t uniformInt(Rng& rng, uint32_t n)
+{
+  const uint32_t threshold = -n % n;
+  while (true) {
+    const uint32_t r = rng();
+    if (r >= threshold) {
+      return r % n;
+    }
+  }
+}
+
+/// Poisson distributed integer: multiplication of uniforms for small means, transformed rejection
+/// with squeeze (W. Hoermann, "The transformed rejection method for generating Poisson random
+/// variables", Insurance: Mathematics and Economics 12 (1993) 39) otherwise
+template <typename Rng>
+inline int poisson(Rng& rng, double mean)
+{
+  if (mean <= 0.) {
+    return 0;
+  }
+  if (mean < 10.) {
+    const double limit = std::exp(-mean);
+    double prod = uniform(rng);
+    int n = 0;
+    while (prod > limit) {
+      prod *= uniform(rng);
+      n++;
+    }
+    return n;
+  }
+  const double slam = std::sqrt(mean), loglam = std::log(mean);
+  const double b = 0.931 + 2.53 * slam;
+  const double a = -0.059 + 0.02483 * b;
+  const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+  const double vr = 0.9277 - 3.6224 / (b - 2.);
+  while (true) {
+    const double u = uniform(rng) - 0.5;
+    const double v = uniform(rng);
+    const double us = 0.5 - std::abs(u);
+    const double k = std::floor((2. * a / us + b) * u + mean + 0.43);
+    if (us >= 0.07 && v <= vr) {
+      return int(k);
+    }
+    if (k < 0. || (us < 0.013 && v > us)) {
+      continue;
+    }
+    if (std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b) <= -mean + k * loglam - std::lgamma(k + 1.)) {
+      return int(k);
+    }
+  }
+}
+
+} // namespace random_sampling
+} // namespace itsmft
+} // namespace o2
+
+#endif
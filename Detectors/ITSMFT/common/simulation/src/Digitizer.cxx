@@ -19,8 +19,11 @@
 #include "MathUtils/Cartesian.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
 #include "DetectorsRaw/HBFUtils.h"
+#include "ITSMFTSimulation/RandomSampling.h"
+#include "PCG/pcg_random.hpp"
 
 #include <TRandom.h>
+#include <atomic>
 #include <climits>
 #include <vector>
 #include <numeric>
@@ -33,6 +36,19 @@ using Segmentation = o2::itsmft::SegmentationAlpide;
 using namespace o2::itsmft;
 // using namespace o2::base;
 
+namespace
+{
+// mix the value into the seed (splitmix64 finalizer), to derive the seeds of the random streams
+uint64_t mixSeed(uint64_t seed, uint64_t value)
+{
+  uint64_t z = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+constexpr uint64_t NoiseSeedTag = 0x6e6f697365; // separates the noise streams from the hits ones
+} // namespace
+
 //_______________________________________________________________________
 void Digitizer::init()
 {
@@ -102,6 +118,10 @@ void Digitizer::init()
   }
   mParams.print();
   mIRFirstSampledTF = o2::raw::HBFUtils::Instance().getFirstSampledTFIR();
+  if (!mRandomSeedSet) {
+    mRandomSeed = gRandom->GetSeed();
+  }
+  LOG(info) << "Digitizing with " << mNThreads << " threads, base seed of per-chip random streams: " << mRandomSeed;
 }
 
 auto Digitizer::getChipResponse(int chipID)
@@ -133,15 +153,54 @@ void Digitizer::process(const std::vector<Hit>* hits, int evID, int srcID)
   }
 
   int nHits = hits->size();
-  std::vector<int> hitIdx(nHits);
-  std::iota(std::begin(hitIdx), std::end(hitIdx), 0);
-  // sort hits to improve memory access
-  std::sort(hitIdx.begin(), hitIdx.end(),
-            [hits](auto lhs, auto rhs) {
-              return (*hits)[lhs].GetDetectorID() < (*hits)[rhs].GetDetectorID();
-            });
-  for (int i : hitIdx) {
-    processHit((*hits)[i], mROFrameMax, evID, srcID);
+  mHitIdx.resize(nHits);
+  std::iota(std::begin(mHitIdx), std::end(mHitIdx), 0);
+  // bucket the hits by chip, keeping their order within the chip
+  std::stable_sort(mHitIdx.begin(), mHitIdx.end(),
+                   [hits](auto lhs, auto rhs) {
+                     return (*hits)[lhs].GetDetectorID() < (*hits)[rhs].GetDetectorID();
+                   });
+  int nChipsHit = 0;
+  for (int i = 0; i < nHits; i++) {
+    int chipID = (*hits)[mHitIdx[i]].GetDetectorID();
+    if (!nChipsHit || mChipHits[nChipsHit - 1].chipID != chipID) {
+      if (nChipsHit == int(mChipHits.size())) {
+        mChipHits.emplace_back();
+      }
+      auto& work = mChipHits[nChipsHit++];
+      work.chipID = chipID;
+      work.first = i;
+      work.roFrameMax = 0;
+      work.eventROFrameMin = 0xffffffff;
+      work.eventROFrameMax = 0;
+      work.extra.clear();
+    }
+    mChipHits[nChipsHit - 1].last = i + 1;
+  }
+
+  // the chips are independent: digitize them in parallel, each with its own random stream defined
+  // by the chip, event and source, such that the result does not depend on the number of threads
+  const uint64_t eventSeed = mixSeed(mixSeed(mRandomSeed, evID), srcID);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ic = 0; ic < nChipsHit; ic++) {
+    auto& work = mChipHits[ic];
+    pcg32 rng(eventSeed, work.chipID);
+    for (int i = work.first; i < work.last; i++) {
+      processHit((*hits)[mHitIdx[i]], work, rng, evID, srcID);
+    }
+  }
+
+  // merge the bookkeeping of the chips and register the extra contributions in the shared buffers
+  for (int ic = 0; ic < nChipsHit; ic++) {
+    const auto& work = mChipHits[ic];
+    mROFrameMax = std::max(mROFrameMax, work.roFrameMax);
+    mEventROFrameMin = std::min(mEventROFrameMin, work.eventROFrameMin);
+    mEventROFrameMax = std::max(mEventROFrameMax, work.eventROFrameMax);
+    for (const auto& contr : work.extra) {
+      addExtraContribution(contr);
+    }
   }
   // in the triggered mode store digits after every MC event
   // TODO: in the real triggered mode this will not be needed, this is actually for the
@@ -204,12 +263,24 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
     rcROF.setROFrame(mROFrameMin);
     rcROF.setFirstEntry(mDigits->size()); // start of current ROF in digits
 
+    // the noise of every chip is drawn from the stream defined by the chip and the RO frame
+    const uint64_t noiseSeed = mixSeed(mixSeed(mRandomSeed, NoiseSeedTag), mROFrameMin);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNThreads)
+#endif
+    for (int ic = 0; ic < mNumberOfChips; ic++) {
+      auto& chip = mChips[ic];
+      if (!chip.isDisabled()) {
+        pcg32 rng(noiseSeed, ic);
+        chip.addNoise(mROFrameMin, mROFrameMin, &mParams, rng);
+      }
+    }
+
     auto& extra = *(mExtraBuff.front().get());
     for (auto& chip : mChips) {
       if (chip.isDisabled()) {
         continue;
       }
-      chip.addNoise(mROFrameMin, mROFrameMin, &mParams);
       auto& buffer = chip.getPreDigits();
       if (buffer.empty()) {
         continue;
@@ -253,7 +324,8 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
 }
 
 //_______________________________________________________________________
-void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID, int srcID)
+template <typename Rng>
+void Digitizer::processHit(const o2::itsmft::Hit& hit, ChipHits& work, Rng& rng, int evID, int srcID)
 {
   // convert single hit to digits
   int chipID = hit.GetDetectorID();
@@ -265,7 +337,7 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
   float timeInROF = hit.GetTime() * sec2ns;
   if (timeInROF > 20e3) {
     const int maxWarn = 10;
-    static int warnNo = 0;
+    static std::atomic<int> warnNo{0};
     if (warnNo < maxWarn) {
       LOG(warning) << "Ignoring hit with time_in_event = " << timeInROF << " ns"
                    << ((++warnNo < maxWarn) ? "" : " (suppressing further warnings)");
@@ -286,8 +358,8 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
   uint32_t roFrameRelMax = mParams.isContinuous() ? (timeInROF + tTot) * mParams.getROFrameLengthInv() : roFrameRel;
   int nFrames = roFrameRelMax + 1 - roFrameRel;
   uint32_t roFrameMax = mNewROFrame + roFrameRelMax;
-  if (roFrameMax > maxFr) {
-    maxFr = roFrameMax; // if signal extends beyond current maxFrame, increase the latter
+  if (roFrameMax > work.roFrameMax) {
+    work.roFrameMax = roFrameMax; // if signal extends beyond current maxFrame, increase the latter
   }
 
   // here we start stepping in the depth of the sensor to generate charge diffision
@@ -410,7 +482,8 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
       if (!nEleResp) {
         continue;
       }
-      int nEle = gRandom->Poisson(nElectrons * nEleResp); // total charge in given pixel
+      float nEleMean = nElectrons * nEleResp;
+      int nEle = random_sampling::poisson(rng, nEleMean); // total charge in given pixel
       // ignore charge which have no chance to fire the pixel
       if (nEle < mParams.getMinChargeToAccount()) {
         continue;
@@ -423,13 +496,13 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
         continue;
       }
       //
-      registerDigits(chip, roFrameAbs, timeInROF, nFrames, rowIS, colIS, nEle, lbl);
+      registerDigits(chip, work, roFrameAbs, timeInROF, nFrames, rowIS, colIS, nEle, lbl);
     }
   }
 }
 
 //________________________________________________________________________________
-void Digitizer::registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, float tInROF, int nROF,
+void Digitizer::registerDigits(ChipDigitsContainer& chip, ChipHits& work, uint32_t roFrame, float tInROF, int nROF,
                                uint16_t row, uint16_t col, int nEle, o2::MCCompLabel& lbl)
 {
   // Register digits for given pixel, accounting for the possible signal contribution to
@@ -446,11 +519,11 @@ void Digitizer::registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, floa
     if (nEleROF < mParams.getMinChargeToAccount()) {
       continue;
     }
-    if (roFr > mEventROFrameMax) {
-      mEventROFrameMax = roFr;
+    if (roFr > work.eventROFrameMax) {
+      work.eventROFrameMax = roFr;
     }
-    if (roFr < mEventROFrameMin) {
-      mEventROFrameMin = roFr;
+    if (roFr < work.eventROFrameMin) {
+      work.eventROFrameMin = roFr;
     }
     auto key = chip.getOrderingKey(roFr, row, col);
     PreDigit* pd = chip.findDigit(key);
@@ -461,22 +534,25 @@ void Digitizer::registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, floa
       if (pd->labelRef.label == lbl) { // don't store the same label twice
         continue;
       }
-      ExtraDig* extra = getExtraDigBuffer(roFr);
-      int& nxt = pd->labelRef.next;
-      bool skip = false;
-      while (nxt >= 0) {
-        if ((*extra)[nxt].label == lbl) { // don't store the same label twice
-          skip = true;
-          break;
-        }
-        nxt = (*extra)[nxt].next;
-      }
-      if (skip) {
-        continue;
-      }
-      // new predigit will be added in the end of the chain
-      nxt = extra->size();
-      extra->emplace_back(lbl);
+      // the extra digits buffers are shared by all chips, the contribution is added after the parallel processing
+      work.extra.push_back({pd, roFr, lbl});
+    }
+  }
+}
+
+//________________________________________________________________________________
+void Digitizer::addExtraContribution(const ExtraContribution& contr)
+{
+  // add the label of the contribution to the chain of labels of the predigit
+  ExtraDig* extra = getExtraDigBuffer(contr.roFrame);
+  int& nxt = contr.preDigit->labelRef.next;
+  while (nxt >= 0) {
+    if ((*extra)[nxt].label == contr.label) { // don't store the same label twice
+      return;
     }
+    nxt = (*extra)[nxt].next;
   }
+  // new predigit will be added in the end of the chain
+  nxt = extra->size();
+  extra->emplace_back(contr.label);
 }
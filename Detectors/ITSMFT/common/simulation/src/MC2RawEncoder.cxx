@@ -13,6 +13,9 @@
 #include "CommonConstants/Triggers.h"
 #include "ITSMFTReconstruction/GBTLink.h"
 #include "Framework/Logger.h"
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::itsmft;
 using namespace o2::raw;
@@ -113,25 +116,67 @@ void MC2RawEncoder<Mapping>::digits2raw(gsl::span<const Digit> digits, const o2:
     curChipData->getData().emplace_back(&dig); // add new digit to the container
   }
 
-  // convert digits to alpide data in the per-cable buffers
+  // convert digits to alpide data in the per-cable buffers, RUs are independent and may be processed in parallel
+  if (int(mCoders.size()) < mNThreads) {
+    mCoders.resize(mNThreads);
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iru = int(mRUSWMin); iru <= int(mRUSWMax); iru++) {
+#ifdef WITH_OPENMP
+    auto& coder = mCoders[omp_get_thread_num()];
+#else
+    auto& coder = mCoders[0];
+#endif
+    convertRU(*getRUDecode(iru), coder);
+  }
+
+  // flush the links to the writer, in the order of the RUs
+  mPayloads.clear();
+  for (int iru = int(mRUSWMin); iru <= int(mRUSWMax); iru++) {
+    const auto& ru = *getRUDecode(iru);
+    for (int il = 0; il < RUDecodeData::MaxLinksPerRU; il++) {
+      auto link = getGBTLink(ru.links[il]);
+      if (link) {
+        auto& payload = mPayloads.emplace_back();
+        payload.subspec = RDHUtils::getSubSpec(link->cruID, link->idInCRU, link->endPointID, link->feeID);
+        payload.data = gsl::span((char*)link->data.data(), link->data.getSize());
+      }
+    }
+  }
+  mWriter.addData(mCurrIR, mPayloads);
   for (int iru = int(mRUSWMin); iru <= int(mRUSWMax); iru++) {
-    auto& ru = *getRUDecode(iru);
-    uint16_t next2Proc = 0, nchTot = mMAP.getNChipsOnRUType(ru.ruInfo->ruType);
-    for (int ich = 0; ich < ru.nChipsFired; ich++) {
-      auto& chipData = ru.chipsData[ich];
-      convertEmptyChips(next2Proc, chipData.getChipID(), ru); // if needed store EmptyChip flags for the empty chips
-      next2Proc = chipData.getChipID() + 1;
-      convertChip(chipData, ru);
-      chipData.clear();
+    const auto& ru = *getRUDecode(iru);
+    for (int il = 0; il < RUDecodeData::MaxLinksPerRU; il++) {
+      auto link = getGBTLink(ru.links[il]);
+      if (link) {
+        link->data.clear();
+      }
     }
-    convertEmptyChips(next2Proc, nchTot, ru); // if needed store EmptyChip flags
-    fillGBTLinks(ru);                         // flush per-lane buffers to link buffers
   }
 }
 
 //___________________________________________________________________________________
 template <class Mapping>
-void MC2RawEncoder<Mapping>::convertChip(ChipPixelData& chipData, RUDecodeData& ru)
+void MC2RawEncoder<Mapping>::convertRU(RUDecodeData& ru, Coder& coder)
+{
+  ///< convert the fired chips of single RU and fill its links
+  uint16_t next2Proc = 0, nchTot = mMAP.getNChipsOnRUType(ru.ruInfo->ruType);
+  for (int ich = 0; ich < ru.nChipsFired; ich++) {
+    auto& chipData = ru.chipsData[ich];
+    convertEmptyChips(next2Proc, chipData.getChipID(), ru, coder); // if needed store EmptyChip flags for the empty chips
+    next2Proc = chipData.getChipID() + 1;
+    convertChip(chipData, ru, coder);
+    chipData.clear();
+  }
+  convertEmptyChips(next2Proc, nchTot, ru, coder); // if needed store EmptyChip flags
+  fillGBTLinks(ru);                                // flush per-lane buffers to link buffers
+}
+
+//___________________________________________________________________________________
+template <class Mapping>
+void MC2RawEncoder<Mapping>::convertChip(ChipPixelData& chipData, RUDecodeData& ru, Coder& coder)
 {
   ///< convert digits of single chip to Alpide format.
   const auto& chip = *mMAP.getChipOnRUInfo(ru.ruInfo->ruType, chipData.getChipID());
@@ -142,19 +187,19 @@ void MC2RawEncoder<Mapping>::convertChip(ChipPixelData& chipData, RUDecodeData&
               return (lhs.getRow() < rhs.getRow()) ? true : ((lhs.getRow() > rhs.getRow()) ? false : (lhs.getCol() < rhs.getCol()));
             });
   ru.cableData[chip.cableHWPos].ensureFreeCapacity(40 * (2 + pixels.size())); // make sure buffer has enough capacity
-  mCoder.encodeChip(ru.cableData[chip.cableHWPos], chipData, chip.chipOnModuleHW, mCurrIR.bc);
+  coder.encodeChip(ru.cableData[chip.cableHWPos], chipData, chip.chipOnModuleHW, mCurrIR.bc);
 }
 
 //______________________________________________________
 template <class Mapping>
-void MC2RawEncoder<Mapping>::convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru)
+void MC2RawEncoder<Mapping>::convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru, Coder& coder)
 {
   // add empty chip words to respective cable's buffers for all chips of the current RU container
   for (int chipIDSW = fromChip; chipIDSW < uptoChip; chipIDSW++) { // flag chips w/o data
     const auto& chip = *mMAP.getChipOnRUInfo(ru.ruInfo->ruType, chipIDSW);
     ru.cableHWID[chip.cableHWPos] = chip.cableHW; // register the cable HW ID
     ru.cableData[chip.cableHWPos].ensureFreeCapacity(100);
-    mCoder.addEmptyChip(ru.cableData[chip.cableHWPos], chip.chipOnModuleHW, mCurrIR.bc);
+    coder.addEmptyChip(ru.cableData[chip.cableHWPos], chip.chipOnModuleHW, mCurrIR.bc);
   }
 }
 
@@ -220,11 +265,7 @@ void MC2RawEncoder<Mapping>::fillGBTLinks(RUDecodeData& ru)
     gbtTrailer.packetDone = true;                                // RS CURRENTLY NOT USED
     link->data.addFast(gbtTrailer.getW8(), link->wordLength);    // write GBT trailer for the last packet
     LOGF(debug, "Filled %s with %d GBT words", link->describe(), nPayLoadWordsNeeded + 3);
-
-    // flush to writer
-    mWriter.addData(link->feeID, link->cruID, link->idInCRU, link->endPointID, mCurrIR, gsl::span((char*)link->data.data(), link->data.getSize()));
-    link->data.clear();
-    //
+    // the link data is flushed to the writer together with all other links
   } // loop over links of RU
   ru.clear();
 }
@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITSMFT DigitizerThreads
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <memory>
+#include "ITSMFTSimulation/Digitizer.h"
+#include "ITSMFTSimulation/DPLDigitizerParam.h"
+#include "ITSMFTSimulation/Hit.h"
+#include "ITSMFTBase/DPLAlpideParam.h"
+#include "ITSBase/GeometryTGeo.h"
+#include "DetectorsBase/GeometryManager.h"
+#include "DetectorsCommonDataFormats/DetectorNameConf.h"
+#include "DataFormatsITSMFT/Digit.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "CommonConstants/LHCConstants.h"
+#include <TFile.h>
+#include <TTree.h>
+
+using namespace o2::itsmft;
+
+namespace
+{
+// the hits and the geometry are produced by the o2sim_G3 test in the same working directory
+const char* SimPrefix = "o2simG3";
+
+struct DigitizerOutput {
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> rofs;
+  o2::dataformats::MCTruthContainer<o2::MCCompLabel> labels;
+};
+
+void digitize(const std::vector<std::vector<Hit>>& events, int nThreads, DigitizerOutput& out)
+{
+  auto& dopt = DPLDigitizerParam<o2::detectors::DetID::ITS>::Instance();
+  auto& aopt = DPLAlpideParam<o2::detectors::DetID::ITS>::Instance();
+  Digitizer digitizer;
+  auto& digipar = digitizer.getParams();
+  auto frameNS = aopt.roFrameLengthInBC * o2::constants::lhc::LHCBunchSpacingNS;
+  digipar.setContinuous(true);
+  digipar.setROFrameLengthInBC(aopt.roFrameLengthInBC);
+  digipar.setROFrameLength(frameNS);
+  digipar.setStrobeDelay(aopt.strobeDelay);
+  digipar.setStrobeLength(aopt.strobeLengthCont > 0 ? aopt.strobeLengthCont : frameNS - aopt.strobeDelay);
+  digipar.getSignalShape().setParameters(dopt.strobeFlatTop, dopt.strobeMaxRiseTime, dopt.strobeQRiseTime0);
+  digipar.setChargeThreshold(dopt.chargeThreshold);
+  digipar.setNoisePerPixel(dopt.noisePerPixel);
+  digipar.setTimeOffset(dopt.timeOffset);
+  digipar.setNSimSteps(dopt.nSimSteps);
+
+  digitizer.setGeometry(o2::its::GeometryTGeo::Instance());
+  digitizer.setNThreads(nThreads);
+  digitizer.setRandomSeed(0x5eed);
+  digitizer.setDigits(&out.digits);
+  digitizer.setROFRecords(&out.rofs);
+  digitizer.setMCLabels(&out.labels);
+  digitizer.init();
+
+  // the events are piled up in the same RO frames to have several contributions per pixel
+  o2::InteractionTimeRecord irt(o2::InteractionRecord(0, 1), 0.);
+  for (size_t ev = 0; ev < events.size(); ev++) {
+    irt.bc += 10;
+    irt.timeInBCNS = 0.;
+    digitizer.setEventTime(irt);
+    digitizer.process(&events[ev], ev, 0);
+  }
+  digitizer.fillOutputContainer();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(DigitizerThreads_test)
+{
+  o2::base::GeometryManager::loadGeometry(SimPrefix, false, false);
+  auto geom = o2::its::GeometryTGeo::Instance();
+  geom->fillMatrixCache(o2::math_utils::bit2Mask(o2::math_utils::TransformType::L2G));
+
+  TFile hitFile(o2::base::DetectorNameConf::getHitsFileName(o2::detectors::DetID::ITS, SimPrefix).c_str());
+  auto hitTree = (TTree*)hitFile.Get("o2sim");
+  BOOST_REQUIRE(hitTree);
+  std::vector<Hit>* hits = nullptr;
+  hitTree->SetBranchAddress("ITSHit", &hits);
+  std::vector<std::vector<Hit>> events;
+  size_t nHits = 0;
+  for (int ev = 0; ev < hitTree->GetEntries(); ev++) {
+    hitTree->GetEntry(ev);
+    events.push_back(*hits);
+    nHits += hits->size();
+  }
+  BOOST_REQUIRE(nHits > 0);
+
+  DigitizerOutput serial, parallel;
+  digitize(events, 1, serial);
+  digitize(events, 4, parallel);
+
+  BOOST_REQUIRE(!serial.digits.empty());
+  BOOST_REQUIRE_EQUAL(serial.rofs.size(), parallel.rofs.size());
+  for (size_t i = 0; i < serial.rofs.size(); i++) {
+    BOOST_CHECK_EQUAL(serial.rofs[i].getROFrame(), parallel.rofs[i].getROFrame());
+    BOOST_CHECK_EQUAL(serial.rofs[i].getFirstEntry(), parallel.rofs[i].getFirstEntry());
+    BOOST_CHECK_EQUAL(serial.rofs[i].getNEntries(), parallel.rofs[i].getNEntries());
+  }
+  BOOST_REQUIRE_EQUAL(serial.digits.size(), parallel.digits.size());
+  BOOST_REQUIRE_EQUAL(serial.labels.getIndexedSize(), parallel.labels.getIndexedSize());
+  BOOST_REQUIRE_EQUAL(serial.labels.getNElements(), parallel.labels.getNElements());
+  for (size_t i = 0; i < serial.digits.size(); i++) {
+    const auto &ds = serial.digits[i], &dp = parallel.digits[i];
+    BOOST_CHECK_EQUAL(ds.getChipIndex(), dp.getChipIndex());
+    BOOST_CHECK_EQUAL(ds.getRow(), dp.getRow());
+    BOOST_CHECK_EQUAL(ds.getColumn(), dp.getColumn());
+    BOOST_CHECK_EQUAL(ds.getCharge(), dp.getCharge());
+    auto ls = serial.labels.getLabels(i);
+    auto lp = parallel.labels.getLabels(i);
+    BOOST_REQUIRE_EQUAL(ls.size(), lp.size());
+    for (size_t j = 0; j < ls.size(); j++) {
+      BOOST_CHECK(ls[j] == lp[j]);
+    }
+  }
+}
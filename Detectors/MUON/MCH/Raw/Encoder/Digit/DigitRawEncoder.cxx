@@ -39,6 +39,10 @@ void setupRawFileWriter(o2::raw::RawFileWriter& fw, const std::set<LinkInfo>& li
 {
   fw.useRDHVersion(opt.rdhVersion);
   fw.setVerbosity(opt.rawFileWriterVerbosity);
+  fw.setNThreads(opt.nThreads);
+  if (opt.asyncWriteBufferMB > 0) {
+    fw.useAsyncWriting(size_t(opt.asyncWriteBufferMB) * 1024 * 1024);
+  }
 
   bool continuous = true;
   if (!opt.noGRP) {
@@ -60,6 +60,8 @@ int main(int argc, char* argv[])
       ("configKeyValues", po::value<std::string>()->default_value(""), "comma-separated configKeyValues")
       ("no-empty-hbf,e", po::value<bool>()->default_value(false), "do not create empty HBF pages (except for HBF starting TF)")
       ("raw-file-writer-verbosity,v", po::value<int>()->default_value(0), "verbosity level of the RawFileWriter")
+      ("nthreads,t", po::value<int>()->default_value(1), "number of threads filling the links")
+      ("async-write-buffer", po::value<int>()->default_value(0), "size in MB of the buffers for asynchronous writing of the raw files (0: synchronous)")
       ("hbfutils-config", po::value<std::string>()->default_value(std::string(o2::base::NameConf::DIGITIZATIONCONFIGFILE)), "config file for HBFUtils (or none)")
       ("rdh-version,r", po::value<int>()->default_value(o2::raw::RDHUtils::getVersion<o2::header::RAWDataHeader>()), "RDH version to use")
       ("verbosity,v",po::value<std::string>()->default_value("verylow"), "(fair)logger verbosity");
@@ -119,6 +121,8 @@ int main(int argc, char* argv[])
   opts.dummyElecMap = vm["dummy-elecmap"].as<bool>();
   opts.rawFileWriterVerbosity = vm["raw-file-writer-verbosity"].as<int>();
   opts.rdhVersion = vm["rdh-version"].as<int>();
+  opts.nThreads = vm["nthreads"].as<int>();
+  opts.asyncWriteBufferMB = vm["async-write-buffer"].as<int>();
 
   o2::mch::raw::DigitRawEncoder dre(opts);
 
@@ -47,6 +47,8 @@ struct DigitRawEncoderOptions {
   bool writeHB = true;                          // write Heatbeat headers at start of time frame
   int rawFileWriterVerbosity = 0;               // verbosity of the RawFileWriter
   int rdhVersion = 6;                           // RDH version to use
+  int nThreads = 1;                             // number of threads filling the links
+  int asyncWriteBufferMB = 0;                   // size of the asynchronous writing buffers in MB (0: synchronous)
 };
 
 class DigitRawEncoder
@@ -123,8 +123,9 @@ void paginate(o2::raw::RawFileWriter& rawFileWriter,
     });
 
   std::map<o2::InteractionRecord, std::set<LinkInfo>> filled;
+  std::map<o2::InteractionRecord, std::vector<o2::raw::RawFileWriter::LinkPayload>> payloads;
 
-  // fill output buffer with actual data
+  // collect the actual data, the links of the same interaction record are added at once
   for (auto r : dataBlockRefs) {
     auto& b = r.block;
     auto& h = b.header;
@@ -133,11 +134,11 @@ void paginate(o2::raw::RawFileWriter& rawFileWriter,
     if (!li.has_value()) {
       throw std::runtime_error(fmt::format("Could not get fee,cru,link,endpoint for solarId {}", solarId));
     }
-    filled[o2::InteractionRecord{h.bc, h.orbit}].insert(li.value());
-    rawFileWriter.addData(rdhFromLinkInfo(li.value()),
-                          {h.bc, h.orbit},
-                          gsl::span<char>(const_cast<char*>(reinterpret_cast<const char*>(&b.payload[0])),
-                                          b.payload.size()));
+    o2::InteractionRecord ir{h.bc, h.orbit};
+    filled[ir].insert(li.value());
+    auto& payload = payloads[ir].emplace_back();
+    payload.subspec = o2::raw::RDHUtils::getSubSpec(li->cruId, li->linkId, li->endPoint, li->feeId);
+    payload.data = gsl::span<char>(const_cast<char*>(reinterpret_cast<const char*>(&b.payload[0])), b.payload.size());
   }
 
   // loop over the used interaction records and ensure that we call
@@ -151,9 +152,13 @@ void paginate(o2::raw::RawFileWriter& rawFileWriter,
     std::set<LinkInfo> addDataNotAlreadyCalled;
     std::set_difference(links.begin(), links.end(), filledLinks.begin(), filledLinks.end(),
                         std::inserter(addDataNotAlreadyCalled, addDataNotAlreadyCalled.end()));
+    auto& irPayloads = payloads[ir];
     for (auto li : addDataNotAlreadyCalled) {
-      rawFileWriter.addData(rdhFromLinkInfo(li), ir, nothing);
+      auto& payload = irPayloads.emplace_back();
+      payload.subspec = o2::raw::RDHUtils::getSubSpec(li.cruId, li.linkId, li.endPoint, li.feeId);
+      payload.data = nothing;
     }
+    rawFileWriter.addData(ir, irPayloads);
   }
 }
 
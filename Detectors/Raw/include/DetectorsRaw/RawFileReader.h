@@ -54,6 +54,9 @@ struct ReaderInp {
   uint32_t maxTF = 0xffffffff;
   bool partPerSP = true;
   bool cache = false;
+  bool mapFiles = false;
+  bool zeroCopy = false;
+  std::string indexFile{};
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
   bool sup0xccdb = false;
@@ -211,13 +214,17 @@ class RawFileReader
     size_t readNextSuperPage(char* buff, const PartStat* pstat = nullptr);
     size_t skipNextHBF();
     size_t skipNextTF();
+    size_t skipNextSuperPage(const PartStat* pstat = nullptr);
 
     bool rewindToTF(uint32_t tf);
     void print(bool verbose = false, const std::string& pref = "") const;
     std::string describe() const;
 
    private:
+    int getNextSuperPageEnd(size_t& sz, const PartStat* pstat) const;
+
     RawFileReader* reader = nullptr; //!
+    friend class RawFileReader;
   };
 
   //=====================================================================================
@@ -272,6 +279,16 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  bool getMapFiles() const { return mMapFiles; }
+  void setMapFiles(bool v) { mMapFiles = v; }
+  const char* getBlockData(const LinkBlock& bl) const { return mMapFiles ? mMappedFiles[bl.fileID].data + bl.offset : nullptr; }
+  const char* getFileData(int fileID) const { return mMapFiles ? mMappedFiles[fileID].data : nullptr; }
+  size_t getFileSize(int fileID) const { return mMapFiles ? mMappedFiles[fileID].size : 0; }
+
+  const std::string& getIndexFile() const { return mIndexFile; }
+  void setIndexFile(const std::string& s) { mIndexFile = s; }
+  bool getIndexUsed() const { return mIndexUsed; } // were the preprocessing results taken from the index file at init?
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -292,6 +309,12 @@ class RawFileReader
  private:
   int getLinkLocalID(const RDHAny& rdh, int fileID);
   bool preprocessFile(int ifl);
+  bool readFromFile(int fileID, size_t offset, size_t size, char* buff);
+  bool mapFiles();
+  void unmapFiles();
+  bool loadIndex();
+  bool saveIndex() const;
+  std::string indexSignature() const;
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -303,6 +326,12 @@ class RawFileReader
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  struct MappedFile {
+    char* data = nullptr;
+    size_t size = 0;
+  };
+  std::vector<MappedFile> mMappedFiles;                                 //! memory-mapped input files
+  std::string mIndexFile;                                               //! optional file to store / reuse the preprocessing results
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
   bool mInitDone = false;
   bool mEmpty = true;
@@ -320,6 +349,8 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMapFiles = false;                                           //! memory-map input files instead of reading them via fread
+  bool mIndexUsed = false;                                          //! preprocessing results were loaded from the index file
   bool mStopProcessing = false;                                     //! stop processing after error
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
@@ -23,6 +23,7 @@
 #include <string>
 #include <string_view>
 #include <functional>
+#include <memory>
 #include <mutex>
 
 #include <Rtypes.h>
@@ -54,9 +55,12 @@ class RawFileWriter
   ///=====================================================================================
   /// output file handler with its own lock
   struct OutputFile {
+    struct AsyncWriter;
     FILE* handler = nullptr;
     std::mutex fileMtx;
+    std::unique_ptr<AsyncWriter> asyncWriter; // background writer, if asynchronous writing was requested
     OutputFile() = default;
+    ~OutputFile();
     OutputFile(const OutputFile& src) : handler(src.handler) {}
     OutputFile& operator=(const OutputFile& src)
     {
@@ -66,6 +70,17 @@ class RawFileWriter
       return *this;
     }
     void write(const char* data, size_t size);
+    void useAsyncWriting(size_t bufferSize);
+    void close();
+  };
+  ///=====================================================================================
+  /// payload of a single link, for adding the data of many links at once
+  struct LinkPayload {
+    LinkSubSpec_t subspec = 0;
+    gsl::span<char> data;
+    bool preformatted = false;
+    uint32_t trigger = 0;
+    uint32_t detField = 0;
   };
   ///=====================================================================================
   struct PayloadCache {
@@ -96,6 +111,8 @@ class RawFileWriter
     std::string fileName{};          // file name associated with this link
     std::vector<char> buffer;        // buffer to accumulate superpage data
     RawFileWriter* writer = nullptr; // pointer on the parent writer
+    std::vector<char> deferred;      // superpages flushed by the parallel addData, written afterwards in link order
+    bool deferWrite = false;         // flushed superpages go to the deferred buffer
 
     PayloadCache cacheBuffer;         // used for caching in case of async. data input
     std::unique_ptr<TTree> cacheTree; // tree to store the cache
@@ -107,6 +124,7 @@ class RawFileWriter
     LinkData(const LinkData& src);            // due to the mutex...
     LinkData& operator=(const LinkData& src); // due to the mutex...
     void close(const IR& ir);
+    void writeDeferred();
     void print() const;
     void addData(const IR& ir, const gsl::span<char> data, bool preformatted = false, uint32_t trigger = 0, uint32_t detField = 0);
     RDHAny* getLastRDH() { return lastRDHoffset < 0 ? nullptr : reinterpret_cast<RDHAny*>(&buffer[lastRDHoffset]); }
@@ -214,6 +232,17 @@ class RawFileWriter
     addData(RDHUtils::getFEEID(rdh), RDHUtils::getCRUID(rdh), RDHUtils::getLinkID(rdh), RDHUtils::getEndPointID(rdh), ir, data, trigger);
   }
 
+  /// add the payloads of many links for the same IR, equivalent to addData called for each of them in order.
+  /// Different links are filled in parallel by setNThreads() threads: the detector call-backs must be thread-safe then
+  void addData(const IR& ir, gsl::span<const LinkPayload> payloads);
+
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  /// write the superpages to the files via per-file background threads, with 2 aligned buffers of given size per file
+  void useAsyncWriting(size_t bufferSize = 8 * 1024 * 1024);
+  bool isAsyncWriting() const { return mAsyncBufferSize > 0; }
+
   void setContinuousReadout() { mROMode = Continuous; }
   void setTriggeredReadout()
   {
@@ -394,6 +423,7 @@ class RawFileWriter
 
  private:
   void fillFromCache();
+  LinkData* checkAddData(LinkSubSpec_t sspec, const IR& ir, const gsl::span<char> data, bool preformatted, uint32_t trigger, uint32_t detField);
 
   enum RoMode_t { NotSet,
                   Continuous,
@@ -420,6 +450,8 @@ class RawFileWriter
   bool mUseRDHStop = true;                                                // detector uses STOP in RDH
   bool mCRUDetector = true;                                               // Detector readout via CRU ( RORC if false)
   bool mApplyCarryOverToLastPage = false;                                 // call CarryOver method also for last chunk and overwrite modified trailer
+  int mNThreads = 1;                                                      // number of threads filling the links in parallel
+  size_t mAsyncBufferSize = 0;                                            // size of the buffers of the asynchronous file writers (0: synchronous fwrite)
 
   //>> caching --------------
   bool mCachingStage = false; // signal that current data should be cached
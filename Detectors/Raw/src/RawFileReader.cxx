@@ -20,6 +20,7 @@
 #include <memory>
 #include <sstream>
 #include <iostream>
+#include <type_traits>
 #include "DetectorsRaw/RawFileReader.h"
 #include "Headers/DAQID.h"
 #include "CommonConstants/Triggers.h"
@@ -30,6 +31,10 @@
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
 #include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace o2::raw;
 namespace o2h = o2::header;
@@ -134,8 +139,7 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
     if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
     } else {
-      auto fl = reader->mFiles[blc.fileID];
-      if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
+      if (!reader->readFromFile(blc.fileID, blc.offset, blc.size, buff + sz)) {
         LOGF(error, "Failed to read for the %s a bloc:", describe());
         blc.print();
         error = true;
@@ -265,9 +269,32 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
     return sz;
   }
-  int ibl = nextBlock2Read, nbl = blocks.size();
-  auto tfID = blocks[nextBlock2Read].tfID;
+  int ibl = getNextSuperPageEnd(sz, pstat);
   bool error = false;
+  if (sz) {
+    if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
+      memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
+    } else {
+      if (!reader->readFromFile(blocks[nextBlock2Read].fileID, blocks[nextBlock2Read].offset, sz, buff)) {
+        LOGF(error, "Failed to read for the %s a bloc:", describe());
+        blocks[nextBlock2Read].print();
+        error = true;
+      } else if (reader->mCacheData) { // cache after 1st reading
+        blocks[nextBlock2Read].dataCache = std::make_unique<char[]>(sz);
+        memcpy(blocks[nextBlock2Read].dataCache.get(), buff, sz);
+      }
+    }
+  }
+  nextBlock2Read = ibl;
+  return error ? 0 : sz; // in case of the error we ignore the data
+}
+
+//____________________________________________
+int RawFileReader::LinkData::getNextSuperPageEnd(size_t& sz, const RawFileReader::PartStat* pstat) const
+{
+  // block following the next superpage and the size of the latter, its blocks are contiguous in a single file
+  int ibl = nextBlock2Read, nbl = blocks.size();
+  sz = 0;
   if (pstat) { // info is provided, use it derictly
     sz = pstat->size;
     ibl += pstat->nBlocks;
@@ -284,23 +311,19 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
       sz += blc.size;
     }
   }
-  if (sz) {
-    if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
-      memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
-    } else {
-      auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
-      if (fseek(fl, blocks[nextBlock2Read].offset, SEEK_SET) || fread(buff, 1, sz, fl) != sz) {
-        LOGF(error, "Failed to read for the %s a bloc:", describe());
-        blocks[nextBlock2Read].print();
-        error = true;
-      } else if (reader->mCacheData) { // cache after 1st reading
-        blocks[nextBlock2Read].dataCache = std::make_unique<char[]>(sz);
-        memcpy(blocks[nextBlock2Read].dataCache.get(), buff, sz);
-      }
-    }
+  return ibl;
+}
+
+//____________________________________________
+size_t RawFileReader::LinkData::skipNextSuperPage(const RawFileReader::PartStat* pstat)
+{
+  // skip next superpage, its data are the returned number of bytes from the beginning of the current block
+  size_t sz = 0;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return sz;
   }
-  nextBlock2Read = ibl;
-  return error ? 0 : sz; // in case of the error we ignore the data
+  nextBlock2Read = getNextSuperPageEnd(sz, pstat);
+  return sz;
 }
 
 //____________________________________________
@@ -573,23 +596,39 @@ int RawFileReader::getLinkLocalID(const RDHAny& rdh, int fileID)
 bool RawFileReader::preprocessFile(int ifl)
 {
   // preprocess file, check RDH data, build statistics
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(mBufferSize);
+  std::unique_ptr<char[]> buffer;
+  const char* chunk = nullptr;
   FILE* fl = mFiles[ifl];
   mCurrentFileID = ifl;
   LinkSpec_t specPrev = 0xffffffffffffffff;
   int lIDPrev = -1;
   mMultiLinkFile = false;
-  fseek(fl, 0L, SEEK_END);
-  const auto fileSize = ftell(fl);
-  rewind(fl);
+  long int fileSize = 0;
+  if (mMapFiles) {
+    fileSize = mMappedFiles[ifl].size;
+  } else {
+    buffer = std::make_unique<char[]>(mBufferSize);
+    fseek(fl, 0L, SEEK_END);
+    fileSize = ftell(fl);
+    rewind(fl);
+  }
+  // get next chunk to scan: for the mapped file this is everything which is left
+  auto readChunk = [&]() -> long int {
+    if (mMapFiles) {
+      chunk = mMappedFiles[ifl].data + mPosInFile;
+      return fileSize - mPosInFile >= long(sizeof(RDHUtils::RDHAny)) ? fileSize - mPosInFile : 0;
+    }
+    chunk = buffer.get();
+    return fread(buffer.get(), 1, mBufferSize, fl);
+  };
   long int nr = 0;
   mPosInFile = 0;
   size_t nRDHread = 0, boffs;
   bool readMore = true;
-  while (readMore && (nr = fread(buffer.get(), 1, mBufferSize, fl))) {
+  while (readMore && (nr = readChunk())) {
     boffs = 0;
     while (1) {
-      auto& rdh = *reinterpret_cast<RDHUtils::RDHAny*>(&buffer[boffs]);
+      auto& rdh = *reinterpret_cast<const RDHUtils::RDHAny*>(&chunk[boffs]);
       if ((mPosInFile + RDHUtils::getOffsetToNext(rdh)) > fileSize) {
         LOGP(warning, "File {} truncated current file pos {} + offsetToNext {} > fileSize {}", ifl, mPosInFile, RDHUtils::getOffsetToNext(rdh), fileSize);
         readMore = false;
@@ -631,7 +670,7 @@ bool RawFileReader::preprocessFile(int ifl)
       mPosInFile += RDHUtils::getOffsetToNext(rdh);
       lIDPrev = lID;
       if (boffs + sizeof(RDHUtils::RDHAny) >= nr) {
-        if (fseek(fl, mPosInFile, SEEK_SET)) {
+        if (!mMapFiles && fseek(fl, mPosInFile, SEEK_SET)) {
           readMore = false;
           break;
         }
@@ -644,6 +683,260 @@ bool RawFileReader::preprocessFile(int ifl)
   return nRDHread > 0;
 }
 
+//_____________________________________________________________________
+bool RawFileReader::readFromFile(int fileID, size_t offset, size_t size, char* buff)
+{
+  // read data block from the file or copy it from its memory-mapped image
+  if (mMapFiles) {
+    const auto& mf = mMappedFiles[fileID];
+    if (offset + size > mf.size) {
+      return false;
+    }
+    memcpy(buff, mf.data + offset, size);
+    return true;
+  }
+  auto fl = mFiles[fileID];
+  return !fseek(fl, offset, SEEK_SET) && fread(buff, 1, size, fl) == size;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::mapFiles()
+{
+  // memory-map all input files in read-only mode
+  unmapFiles();
+  for (auto fl : mFiles) {
+    int fd = fileno(fl);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      return false;
+    }
+    auto& mf = mMappedFiles.emplace_back();
+    mf.size = st.st_size;
+    if (mf.size) {
+      void* ptr = mmap(nullptr, mf.size, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        mf.size = 0;
+        return false;
+      }
+      madvise(ptr, mf.size, MADV_SEQUENTIAL);
+      mf.data = reinterpret_cast<char*>(ptr);
+    }
+  }
+  return true;
+}
+
+//_____________________________________________________________________
+void RawFileReader::unmapFiles()
+{
+  for (auto& mf : mMappedFiles) {
+    if (mf.data) {
+      munmap(mf.data, mf.size);
+    }
+  }
+  mMappedFiles.clear();
+}
+
+namespace
+{
+constexpr uint64_t IndexMagic = 0x5844495741523230; // "02RAWIDX"
+constexpr uint32_t IndexVersion = 1;
+
+template <typename T>
+void writePOD(std::ostream& os, const T& v)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+void readPOD(std::istream& is, T& v)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  is.read(reinterpret_cast<char*>(&v), sizeof(T));
+}
+
+// size in the index of a block and of a TF start entry
+constexpr size_t IndexBlockSize = sizeof(RawFileReader::LinkBlock::offset) + sizeof(RawFileReader::LinkBlock::size) + sizeof(RawFileReader::LinkBlock::tfID) +
+                                  sizeof(RawFileReader::LinkBlock::ir) + sizeof(RawFileReader::LinkBlock::fileID) + sizeof(RawFileReader::LinkBlock::flags);
+constexpr size_t IndexTFStartSize = sizeof(std::pair<int, uint32_t>::first_type) + sizeof(std::pair<int, uint32_t>::second_type);
+} // namespace
+
+//_____________________________________________________________________
+std::string RawFileReader::indexSignature() const
+{
+  // signature of the input: file names, sizes and modification times, data specs, and the settings affecting the preprocessing
+  const auto& hbu = HBFUtils::Instance();
+  std::stringstream ss;
+  ss << hbu.orbitFirst << ' ' << hbu.bcFirst << ' ' << hbu.nHBFPerTF << ' ' << mMaxTFToRead << ' ' << mPreferCalculatedTFStart << ' ' << mCheckErrors;
+  for (size_t i = 0; i < mFileNames.size(); i++) {
+    const auto& fn = mFileNames[i];
+    struct stat st;
+    if (stat(fn.c_str(), &st) != 0) {
+      return {};
+    }
+    ss << '|' << fn << ' ' << st.st_size << ' ' << st.st_mtime << ' ' << std::get<0>(mDataSpecs[i]).as<std::string>()
+       << ' ' << std::get<1>(mDataSpecs[i]).as<std::string>() << ' ' << int(std::get<2>(mDataSpecs[i]));
+  }
+  return ss.str();
+}
+
+//_____________________________________________________________________
+bool RawFileReader::saveIndex() const
+{
+  // store the results of the preprocessing to be reused for the same input
+  auto signature = indexSignature();
+  std::ofstream os(mIndexFile, std::ios::binary | std::ios::trunc);
+  if (signature.empty() || !os.good()) {
+    LOG(warning) << "Failed to store raw data index to " << mIndexFile;
+    return false;
+  }
+  writePOD(os, IndexMagic);
+  writePOD(os, IndexVersion);
+  writePOD(os, uint32_t(signature.size()));
+  os.write(signature.data(), signature.size());
+  writePOD(os, uint32_t(mLinksData.size()));
+  for (const auto& lnk : mLinksData) {
+    writePOD(os, lnk.rdhl);
+    writePOD(os, lnk.irOfSOX);
+    writePOD(os, lnk.spec);
+    writePOD(os, lnk.subspec);
+    writePOD(os, lnk.nTimeFrames);
+    writePOD(os, lnk.nHBFrames);
+    writePOD(os, lnk.nSPages);
+    writePOD(os, lnk.nCRUPages);
+    writePOD(os, lnk.cruDetector);
+    writePOD(os, lnk.continuousRO);
+    writePOD(os, lnk.origin);
+    writePOD(os, lnk.description);
+    writePOD(os, lnk.nErrors);
+    writePOD(os, uint32_t(lnk.blocks.size()));
+    for (const auto& bl : lnk.blocks) {
+      writePOD(os, bl.offset);
+      writePOD(os, bl.size);
+      writePOD(os, bl.tfID);
+      writePOD(os, bl.ir);
+      writePOD(os, bl.fileID);
+      writePOD(os, bl.flags);
+    }
+    writePOD(os, uint32_t(lnk.tfStartBlock.size()));
+    for (const auto& tfs : lnk.tfStartBlock) {
+      writePOD(os, tfs.first);
+      writePOD(os, tfs.second);
+    }
+  }
+  if (!os.good()) {
+    LOG(warning) << "Failed to store raw data index to " << mIndexFile;
+    return false;
+  }
+  LOGP(info, "Stored raw data index for {} links to {}", mLinksData.size(), mIndexFile);
+  return true;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::loadIndex()
+{
+  // load results of the preprocessing from the index file, if it matches the input
+  if (mFirstTFAutodetect == FirstTFDetection::Pending) {
+    LOG(info) << "Raw data index cannot be used with TF start autodetection, preprocessing input";
+    return false;
+  }
+  std::ifstream is(mIndexFile, std::ios::binary | std::ios::ate);
+  if (!is.good()) {
+    return false;
+  }
+  // the counts read from the index are checked against the bytes left in it
+  const size_t indexSize = is.tellg();
+  is.seekg(0);
+  auto bytesLeft = [&is, indexSize]() -> size_t {
+    auto pos = is.tellg();
+    return pos < 0 || size_t(pos) > indexSize ? 0 : indexSize - size_t(pos);
+  };
+  uint64_t magic = 0;
+  uint32_t version = 0, n = 0;
+  readPOD(is, magic);
+  readPOD(is, version);
+  readPOD(is, n);
+  if (!is.good() || magic != IndexMagic || version != IndexVersion || n > bytesLeft()) {
+    LOG(warning) << "Ignoring invalid raw data index " << mIndexFile;
+    return false;
+  }
+  std::string signature(n, '\0');
+  is.read(signature.data(), n);
+  if (signature != indexSignature()) {
+    LOG(info) << "Raw data index " << mIndexFile << " does not match the input, preprocessing input";
+    return false;
+  }
+  std::vector<size_t> fileSizes;
+  for (const auto& fn : mFileNames) {
+    struct stat st;
+    fileSizes.push_back(stat(fn.c_str(), &st) == 0 ? st.st_size : 0);
+  }
+  std::vector<LinkData> links;
+  readPOD(is, n);
+  if (!is.good() || size_t(n) * sizeof(LinkData::spec) > bytesLeft()) {
+    n = 0;
+    is.setstate(std::ios::failbit);
+  }
+  for (uint32_t il = 0; il < n && is.good(); il++) {
+    auto& lnk = links.emplace_back();
+    readPOD(is, lnk.rdhl);
+    readPOD(is, lnk.irOfSOX);
+    readPOD(is, lnk.spec);
+    readPOD(is, lnk.subspec);
+    readPOD(is, lnk.nTimeFrames);
+    readPOD(is, lnk.nHBFrames);
+    readPOD(is, lnk.nSPages);
+    readPOD(is, lnk.nCRUPages);
+    readPOD(is, lnk.cruDetector);
+    readPOD(is, lnk.continuousRO);
+    readPOD(is, lnk.origin);
+    readPOD(is, lnk.description);
+    readPOD(is, lnk.nErrors);
+    uint32_t nb = 0;
+    readPOD(is, nb);
+    if (!is.good() || size_t(nb) * IndexBlockSize > bytesLeft()) {
+      is.setstate(std::ios::failbit);
+      break;
+    }
+    lnk.blocks.resize(nb);
+    for (auto& bl : lnk.blocks) {
+      readPOD(is, bl.offset);
+      readPOD(is, bl.size);
+      readPOD(is, bl.tfID);
+      readPOD(is, bl.ir);
+      readPOD(is, bl.fileID);
+      readPOD(is, bl.flags);
+      // the blocks must lie within the input files
+      if (bl.fileID >= mFileNames.size() || bl.offset + bl.size > fileSizes[bl.fileID]) {
+        is.setstate(std::ios::failbit);
+        break;
+      }
+    }
+    readPOD(is, nb);
+    if (!is.good() || size_t(nb) * IndexTFStartSize > bytesLeft()) {
+      is.setstate(std::ios::failbit);
+      break;
+    }
+    lnk.tfStartBlock.resize(nb);
+    for (auto& tfs : lnk.tfStartBlock) {
+      readPOD(is, tfs.first);
+      readPOD(is, tfs.second);
+    }
+  }
+  if (!is.good() || bytesLeft() != 0) {
+    LOG(warning) << "Failed to read raw data index " << mIndexFile << ", preprocessing input";
+    return false;
+  }
+  mLinksData = std::move(links);
+  mLinkEntries.clear();
+  for (int il = 0; il < int(mLinksData.size()); il++) {
+    mLinksData[il].reader = this;
+    mLinkEntries[mLinksData[il].spec] = il;
+  }
+  LOGP(info, "Loaded raw data index for {} links from {}", mLinksData.size(), mIndexFile);
+  return true;
+}
+
 //_____________________________________________________________________
 void RawFileReader::printStat(bool verbose) const
 {
@@ -662,6 +955,7 @@ void RawFileReader::clear()
   mLinkEntries.clear();
   mOrderedIDs.clear();
   mLinksData.clear();
+  unmapFiles();
   for (auto fl : mFiles) {
     fclose(fl);
   }
@@ -722,16 +1016,33 @@ bool RawFileReader::init()
     LOGF(info, "at most %u TF will be processed", mMaxTFToRead);
   }
 
+  if (mMapFiles && !mapFiles()) {
+    LOG(error) << "Failed to memory-map input files";
+    return false;
+  }
+  if (mMapFiles && mCacheData) {
+    LOG(info) << "Data caching is not needed for memory-mapped files, disabling it";
+    mCacheData = false;
+  }
+
   int nf = mFiles.size();
   mEmpty = true;
-  for (int i = 0; i < nf; i++) {
-    if (preprocessFile(i)) {
-      mEmpty = false;
+  mIndexUsed = !mIndexFile.empty() && loadIndex();
+  if (mIndexUsed) {
+    mEmpty = mLinksData.empty();
+  } else {
+    for (int i = 0; i < nf; i++) {
+      if (preprocessFile(i)) {
+        mEmpty = false;
+      }
+    }
+    if (mStopProcessing) {
+      LOG(error) << "Abandoning processing due to corrupted data";
+      return false;
+    }
+    if (!mIndexFile.empty()) {
+      saveIndex();
     }
-  }
-  if (mStopProcessing) {
-    LOG(error) << "Abandoning processing due to corrupted data";
-    return false;
   }
   mOrderedIDs.resize(mLinksData.size());
   for (int i = mLinksData.size(); i--;) {
@@ -38,6 +38,7 @@
 #include <fairmq/Device.h>
 #include <fairmq/Message.h>
 #include <fairmq/Parts.h>
+#include <fairmq/UnmanagedRegion.h>
 
 #include <unistd.h>
 #include <algorithm>
@@ -72,6 +73,7 @@ class RawReaderSpecs : public o2f::Task
 
  private:
   void processDropTF(const std::string& drops);
+  fair::mq::UnmanagedRegionPtr& getFileRegion(int fileID, fair::mq::TransportFactory& factory);
 
   int mLoop = 0;                  // once last TF reached, loop while mLoop>=0
   uint32_t mTFCounter = 0;        // TFId accumulator (accounts for looping)
@@ -87,21 +89,29 @@ class RawReaderSpecs : public o2f::Task
   size_t mSentSize = 0;
   size_t mSentMessages = 0;
   bool mPartPerSP = true;                                          // fill part per superpage
+  bool mZeroCopy = false;                                          // send superpages from shm regions holding the input files
   bool mSup0xccdb = false;                                         // suppress explicit FLP/DISTSUBTIMEFRAME/0xccdb output
   std::string mRawChannelName = "";                                // name of optional non-DPL channel
   std::unique_ptr<o2::raw::RawFileReader> mReader;                 // matching engine
   std::unordered_map<std::string, std::pair<int, int>> mDropTFMap; // allows to drop certain fraction of TFs
+  std::vector<fair::mq::UnmanagedRegionPtr> mFileRegions;         // zero-copy mode: image of every input file
   TStopwatch mTimer;
 };
 
 //___________________________________________________________
 RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
-  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize, rinp.onlyDet)), mRawChannelName(rinp.rawChannelConfig), mPreferCalcTF(rinp.preferCalcTF), mMinSHM(rinp.minSHM)
+  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mZeroCopy(rinp.zeroCopy), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize, rinp.onlyDet)), mRawChannelName(rinp.rawChannelConfig), mPreferCalcTF(rinp.preferCalcTF), mMinSHM(rinp.minSHM)
 {
   mReader->setCheckErrors(rinp.errMap);
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMapFiles(rinp.mapFiles || rinp.zeroCopy);
+  if (mZeroCopy && !mPartPerSP) {
+    LOG(warning) << "Zero-copy mode needs parts per superpage, the data will be copied";
+    mZeroCopy = false;
+  }
+  mReader->setIndexFile(rinp.indexFile);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
   LOG(info) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
@@ -142,6 +152,24 @@ void RawReaderSpecs::processDropTF(const std::string& dropTF)
   }
 }
 
+//___________________________________________________________
+fair::mq::UnmanagedRegionPtr& RawReaderSpecs::getFileRegion(int fileID, fair::mq::TransportFactory& factory)
+{
+  // shm region with the image of the input file, filled at 1st use and kept for all loops:
+  // FairMQ creates the backing file of a region itself, hence the copy of the mapped raw file
+  if (fileID >= int(mFileRegions.size())) {
+    mFileRegions.resize(fileID + 1);
+  }
+  auto& region = mFileRegions[fileID];
+  if (!region) {
+    auto size = mReader->getFileSize(fileID);
+    region = factory.CreateUnmanagedRegion(size, [](const std::vector<fair::mq::RegionBlock>&) {}); // nothing to release, the region lives until the end
+    memcpy(region->GetData(), mReader->getFileData(fileID), size);
+    LOG(info) << "Copied " << size << " bytes of input file " << fileID << " to shared memory region";
+  }
+  return region;
+}
+
 //___________________________________________________________
 void RawReaderSpecs::init(o2f::InitContext& ic)
 {
@@ -295,8 +323,17 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
       hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
       auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      fair::mq::MessagePtr plMessage;
+      size_t bread = 0;
+      if (mZeroCopy) { // point to the superpage in the region holding the file
+        const auto& block = link.blocks[link.nextBlock2Read];
+        auto& region = getFileRegion(block.fileID, *fmqFactory);
+        plMessage = fmqFactory->CreateMessage(region, reinterpret_cast<char*>(region->GetData()) + block.offset, hdrTmpl.payloadSize, nullptr);
+        bread = link.skipNextSuperPage(&partsSP[hdrTmpl.splitPayloadIndex]);
+      } else {
+        plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+        bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      }
       if (bread != hdrTmpl.payloadSize) {
         LOG(error) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
                    << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
@@ -18,6 +18,12 @@
 #include <sstream>
 #include <functional>
 #include <cassert>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <thread>
 #include "CommonUtils/NameConf.h"
 #include "DetectorsRaw/RawFileWriter.h"
 #include "DetectorsRaw/HBFUtils.h"
@@ -65,8 +71,7 @@ void RawFileWriter::close()
   // close all files
   for (auto& flh : mFName2File) {
     LOG(info) << "Closing output file " << flh.first;
-    fclose(flh.second.handler);
-    flh.second.handler = nullptr;
+    flh.second.close();
   }
   mFName2File.clear();
   if (mDetLazyCheck.completeCount) {
@@ -145,6 +150,9 @@ RawFileWriter::LinkData& RawFileWriter::registerLink(uint16_t fee, uint16_t cru,
       LOG(error) << "Failed to open output file " << outFileName;
       throw std::runtime_error(std::string("cannot open link output file ") + outFileName);
     }
+    if (mAsyncBufferSize) {
+      file.useAsyncWriting(mAsyncBufferSize);
+    }
   }
   if (!linkData.fileName.empty()) { // this link was already declared and associated with a file
     if (linkData.fileName == outFileName) {
@@ -181,6 +189,84 @@ void RawFileWriter::addData(uint16_t feeid, uint16_t cru, uint8_t lnk, uint8_t e
 {
   // add payload to relevant links
   auto sspec = RDHUtils::getSubSpec(cru, lnk, endpoint, feeid);
+  auto link = checkAddData(sspec, ir, data, preformatted, trigger, detField);
+  if (link) {
+    link->addData(ir, data, preformatted, trigger, detField);
+  }
+}
+
+//_____________________________________________________________________
+void RawFileWriter::addData(const IR& ir, gsl::span<const LinkPayload> payloads)
+{
+  // add payloads of many links for the same IR: the checks and the bookkeeping are done serially,
+  // the formatting of the links (and the flushing of their superpages) in parallel
+  std::vector<std::pair<LinkData*, int>> toAdd;
+  toAdd.reserve(payloads.size());
+  for (int i = 0; i < int(payloads.size()); i++) {
+    const auto& pl = payloads[i];
+    auto link = checkAddData(pl.subspec, ir, pl.data, pl.preformatted, pl.trigger, pl.detField);
+    if (link) {
+      toAdd.emplace_back(link, i);
+    }
+  }
+  if (mNThreads < 2 || mCachingStage || toAdd.size() < 2) {
+    for (const auto& [link, i] : toAdd) {
+      link->addData(ir, payloads[i].data, payloads[i].preformatted, payloads[i].trigger, payloads[i].detField);
+    }
+    return;
+  }
+  // payloads of the same link must be added in the order they were provided
+  std::stable_sort(toAdd.begin(), toAdd.end(), [](const auto& a, const auto& b) { return a.first->subspec < b.first->subspec; });
+  std::vector<int> groupStart;
+  for (int i = 0; i < int(toAdd.size()); i++) {
+    if (!i || toAdd[i].first != toAdd[i - 1].first) {
+      groupStart.push_back(i);
+    }
+  }
+  groupStart.push_back(toAdd.size());
+  const int nGroups = groupStart.size() - 1;
+  // the superpages flushed meanwhile are kept by the links and written afterwards, in the order of the
+  // first payload of each link, such that the files do not depend on the thread scheduling
+  std::vector<int> writeOrder(nGroups);
+  for (int ig = 0; ig < nGroups; ig++) {
+    writeOrder[ig] = ig;
+    toAdd[groupStart[ig]].first->deferWrite = true;
+  }
+  std::sort(writeOrder.begin(), writeOrder.end(), [&](int a, int b) { return toAdd[groupStart[a]].second < toAdd[groupStart[b]].second; });
+  std::exception_ptr error;
+  std::mutex errorMtx;
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ig = 0; ig < nGroups; ig++) {
+    try {
+      for (int i = groupStart[ig]; i < groupStart[ig + 1]; i++) {
+        const auto& pl = payloads[toAdd[i].second];
+        toAdd[i].first->addData(ir, pl.data, pl.preformatted, pl.trigger, pl.detField);
+      }
+    } catch (...) { // exceptions cannot leave the parallel region
+      std::lock_guard<std::mutex> lock(errorMtx);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  for (int ig : writeOrder) {
+    auto link = toAdd[groupStart[ig]].first;
+    link->deferWrite = false;
+    if (!error) {
+      link->writeDeferred();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+//_____________________________________________________________________
+RawFileWriter::LinkData* RawFileWriter::checkAddData(LinkSubSpec_t sspec, const IR& ir, const gsl::span<char> data, bool preformatted, uint32_t trigger, uint32_t detField)
+{
+  // validate the payload for the link, update the global bookkeeping and return the link to fill (nullptr if data must be discarded)
   auto& link = getLinkWithSubSpec(sspec);
   if (mVerbosity > 10) {
     LOGP(info, "addData for {}  on IR BCid:{} Orbit: {}, payload: {}, preformatted: {}, trigger: {}, detField: {}", link.describe(), ir.bc, ir.orbit, data.size(), preformatted, trigger, detField);
@@ -191,14 +277,14 @@ void RawFileWriter::addData(uint16_t feeid, uint16_t cru, uint8_t lnk, uint8_t e
   }
   if (ir < mHBFUtils.getFirstSampledTFIR()) {
     LOG(warning) << "provided " << ir << " precedes first sampled TF " << mHBFUtils.getFirstSampledTFIR() << " | discarding data for " << link.describe();
-    return;
+    return nullptr;
   }
   if (link.discardData || ir.orbit - mHBFUtils.orbitFirst >= mHBFUtils.maxNOrbits) {
     if (!link.discardData) {
       link.discardData = true;
       LOG(info) << "Orbit " << ir.orbit << ": max. allowed orbit " << mHBFUtils.orbitFirst + mHBFUtils.maxNOrbits - 1 << " exceeded, " << link.describe() << " will discard further data";
     }
-    return;
+    return nullptr;
   }
   if (ir < mFirstIRAdded) {
     mHBFUtils.checkConsistency(); // done only once
@@ -208,7 +294,17 @@ void RawFileWriter::addData(uint16_t feeid, uint16_t cru, uint8_t lnk, uint8_t e
     mDetLazyCheck.completeLinks(this, ir); // make sure that all links for previously called IR got their addData call
     mDetLazyCheck.acknowledge(sspec, ir, preformatted, trigger, detField);
   }
-  link.addData(ir, data, preformatted, trigger, detField);
+  return &link;
+}
+
+//_____________________________________________________________________
+void RawFileWriter::useAsyncWriting(size_t bufferSize)
+{
+  // delegate writing of the superpages to per-file threads
+  mAsyncBufferSize = bufferSize;
+  for (auto& flh : mFName2File) {
+    flh.second.useAsyncWriting(mAsyncBufferSize);
+  }
 }
 
 //_____________________________________________________________________
@@ -602,7 +698,11 @@ void RawFileWriter::LinkData::flushSuperPage(bool keepLastPage)
   if (writer->mVerbosity) {
     LOGF(info, "Flushing super page of %u bytes for %s", pgSize, describe());
   }
-  writer->mFName2File.find(fileName)->second.write(buffer.data(), pgSize);
+  if (deferWrite) {
+    deferred.insert(deferred.end(), buffer.data(), buffer.data() + pgSize);
+  } else {
+    writer->mFName2File.find(fileName)->second.write(buffer.data(), pgSize);
+  }
   auto toMove = buffer.size() - pgSize;
   if (toMove) { // is there something left in the buffer, move it to the beginning of the buffer
     if (toMove > pgSize) {
@@ -618,6 +718,16 @@ void RawFileWriter::LinkData::flushSuperPage(bool keepLastPage)
   }
 }
 
+//___________________________________________________________________________________
+void RawFileWriter::LinkData::writeDeferred()
+{
+  // write the superpages flushed while the writing was deferred
+  if (!deferred.empty()) {
+    writer->mFName2File.find(fileName)->second.write(deferred.data(), deferred.size());
+    deferred.clear();
+  }
+}
+
 //___________________________________________________________________________________
 void RawFileWriter::LinkData::close(const IR& irf)
 {
@@ -709,11 +819,157 @@ size_t RawFileWriter::LinkData::pushBack(const char* ptr, size_t sz, bool keepLa
 
 //================================================
 
+//____________________________________________
+/// Writer thread of the output file: the superpages are copied to large aligned buffers,
+/// which are written to the file in the background while the other buffer is being filled
+struct RawFileWriter::OutputFile::AsyncWriter {
+  static constexpr size_t Alignment = 4096;
+  static constexpr int NBuffers = 2;
+  struct AlignedFree {
+    void operator()(char* p) const { std::free(p); }
+  };
+  using Buffer = std::unique_ptr<char[], AlignedFree>;
+
+  AsyncWriter(FILE* f, size_t bufferSize) : file(f), capacity(std::max(Alignment, (bufferSize + Alignment - 1) / Alignment * Alignment))
+  {
+    setvbuf(file, nullptr, _IONBF, 0); // the buffering is done here
+    for (int i = 0; i < NBuffers; i++) {
+      buffers.emplace_back(static_cast<char*>(std::aligned_alloc(Alignment, capacity)));
+      if (!buffers.back()) {
+        throw std::bad_alloc();
+      }
+      freeBuffers.push_back(i);
+    }
+    thread = std::thread([this]() { run(); });
+  }
+
+  ~AsyncWriter() { finish(); }
+
+  /// copy the data to the current buffer, submitting it for writing when it is full
+  void write(const char* data, size_t size)
+  {
+    while (size) {
+      if (current < 0) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return !freeBuffers.empty(); });
+        if (failed) {
+          throw std::runtime_error("failed to write raw data to the output file");
+        }
+        current = freeBuffers.back();
+        freeBuffers.pop_back();
+      }
+      auto n = std::min(size, capacity - filled);
+      memcpy(buffers[current].get() + filled, data, n);
+      filled += n;
+      data += n;
+      size -= n;
+      if (filled == capacity) {
+        submit();
+      }
+    }
+  }
+
+  /// write out everything and stop the thread, return false if some data could not be written
+  bool finish()
+  {
+    if (!thread.joinable()) {
+      return !failed;
+    }
+    if (current >= 0) {
+      submit();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cv.notify_all();
+    thread.join();
+    return !failed;
+  }
+
+  void submit()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      toWrite.emplace_back(current, filled);
+    }
+    current = -1;
+    filled = 0;
+    cv.notify_all();
+  }
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      cv.wait(lock, [this]() { return stop || !toWrite.empty(); });
+      if (toWrite.empty()) {
+        break; // stop requested and nothing left to write
+      }
+      auto [id, size] = toWrite.front();
+      toWrite.pop_front();
+      lock.unlock();
+      if (fwrite(buffers[id].get(), 1, size, file) != size) {
+        failed = true;
+      }
+      lock.lock();
+      freeBuffers.push_back(id);
+      cv.notify_all();
+    }
+  }
+
+  FILE* file = nullptr;
+  size_t capacity = 0;
+  std::vector<Buffer> buffers;
+  std::vector<int> freeBuffers;               // buffers which can be filled
+  std::deque<std::pair<int, size_t>> toWrite; // filled buffers and their size, in the order of filling
+  int current = -1;                           // buffer being filled by the producer
+  size_t filled = 0;                          // bytes in the current buffer
+  bool stop = false;
+  bool failed = false;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::thread thread;
+};
+
+//____________________________________________
+RawFileWriter::OutputFile::~OutputFile() = default;
+
 //____________________________________________
 void RawFileWriter::OutputFile::write(const char* data, size_t sz)
 {
   std::lock_guard<std::mutex> lock(fileMtx);
-  fwrite(data, 1, sz, handler); // flush to file
+  if (asyncWriter) {
+    asyncWriter->write(data, sz);
+  } else {
+    if (fwrite(data, 1, sz, handler) != sz) { // flush to file
+      throw std::runtime_error("failed to write raw data to the output file");
+    }
+  }
+}
+
+//____________________________________________
+void RawFileWriter::OutputFile::useAsyncWriting(size_t bufferSize)
+{
+  std::lock_guard<std::mutex> lock(fileMtx);
+  if (handler && !asyncWriter && bufferSize) {
+    asyncWriter = std::make_unique<AsyncWriter>(handler, bufferSize);
+  }
+}
+
+//____________________________________________
+void RawFileWriter::OutputFile::close()
+{
+  std::lock_guard<std::mutex> lock(fileMtx);
+  bool written = !asyncWriter || asyncWriter->finish(); // writes pending data
+  asyncWriter.reset();
+  if (handler) {
+    fclose(handler);
+    handler = nullptr;
+  }
+  if (!written) {
+    throw std::runtime_error("failed to write raw data to the output file");
+  }
 }
 
 //____________________________________________
@@ -13,9 +13,11 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <TRandom.h>
 #include <boost/test/unit_test.hpp>
 #include "SimulationDataFormat/InteractionSampler.h"
@@ -58,6 +60,7 @@ struct TestRawWriter { // simple class to create detector payload for multiple l
 
   RawFileWriter writer{"TST"};
   std::string configName = "rawConf.cfg";
+  bool addPerIR = false; // add the payloads of all links of the IR at once
 
   //_________________________________________________________________
   TestRawWriter(o2::header::DataOrigin origin = "TST", bool isCRU = true, const std::string& cfg = "rawConf.cfg") : writer(origin, isCRU), configName(cfg) {}
@@ -100,26 +103,39 @@ struct TestRawWriter { // simple class to create detector payload for multiple l
     irSampler.generateCollisionTimes(irs);
 
     std::vector<char> buffer;
+    std::vector<std::vector<char>> linkBuffers(NCRU * NLinkPerCRU);
+    std::vector<RawFileWriter::LinkPayload> payloads;
     int feeIDShift = writer.isCRUDetector() ? 8 : 9;
 
     // create payload for every interaction and push it to writer
     for (const auto& ir : irs) {
       int nCRU2Fill = writer.isCRUDetector() ? NCRU - 1 : NCRU; // in CRU mode we will fill 1 special CRU with preformatted data
+      payloads.clear();
       for (int icru = 0; icru < nCRU2Fill; icru++) {
         // we will create non-0 payload for all but 1st link of every CRU, the writer should take care
         // of creating empty HBFs for the links w/o data
         for (int il = 0; il < NLinkPerCRU; il++) {
-          buffer.clear();
+          auto& buff = linkBuffers[icru * NLinkPerCRU + il];
+          buff.clear();
           int nGBT = gRandom->Poisson(RDHUtils::MAXCRUPage / RDHUtils::GBTWord128 * (il));
           if (nGBT) {
-            buffer.resize((nGBT + 2) * RDHUtils::GBTWord128, icru * NLinkPerCRU + il); // reserve 16B words accounting for the Header and Trailer
-            std::memcpy(buffer.data(), PLHeader.c_str(), RDHUtils::GBTWord128);
-            std::memcpy(buffer.data() + buffer.size() - RDHUtils::GBTWord128, PLTrailer.c_str(), RDHUtils::GBTWord128);
+            buff.resize((nGBT + 2) * RDHUtils::GBTWord128, icru * NLinkPerCRU + il); // reserve 16B words accounting for the Header and Trailer
+            std::memcpy(buff.data(), PLHeader.c_str(), RDHUtils::GBTWord128);
+            std::memcpy(buff.data() + buff.size() - RDHUtils::GBTWord128, PLTrailer.c_str(), RDHUtils::GBTWord128);
             // we don't care here about the content of the payload, except the presence of header and trailer
           }
-          writer.addData((icru << feeIDShift) + il, icru, il, 0, ir, buffer);
+          if (addPerIR) {
+            auto& payload = payloads.emplace_back();
+            payload.subspec = RDHUtils::getSubSpec(icru, il, 0, (icru << feeIDShift) + il);
+            payload.data = buff;
+          } else {
+            writer.addData((icru << feeIDShift) + il, icru, il, 0, ir, buff);
+          }
         }
       }
+      if (addPerIR) {
+        writer.addData(ir, payloads);
+      }
     }
     if (writer.isCRUDetector()) {
       // fill special CRU with preformatted pages
@@ -159,7 +175,7 @@ struct TestRawWriter { // simple class to create detector payload for multiple l
   {
     // how we want to split the large payloads. The data is the full payload which was sent for writing and
     // it is already equiped with header and trailer
-    static int verboseCount = 0;
+    static std::atomic<int> verboseCount{0}; // may be called concurrently for different links
 
     if (maxSize <= RDHUtils::GBTWord128) { // do not carry over trailer or header only
       return 0;
@@ -189,6 +205,10 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
 
   std::unique_ptr<RawFileReader> reader;
   std::string confName;
+  std::string indexFile; // optional index of the preprocessing results
+  bool mapFiles = false; // memory-map input files
+  // checks to perform, ErrNoSuperPageForTF makes no sense for superpages not interleaved by others
+  uint32_t errCheck = 0xffffffff ^ (0x1 << RawFileReader::ErrNoSuperPageForTF);
 
   //_________________________________________________________________
   TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg") : confName(cfg) {}
@@ -197,9 +217,9 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
   void init()
   {
     reader = std::make_unique<RawFileReader>(confName); // init from configuration file
-    uint32_t errCheck = 0xffffffff;
-    errCheck ^= 0x1 << RawFileReader::ErrNoSuperPageForTF; // makes no sense for superpages not interleaved by others
     reader->setCheckErrors(errCheck);
+    reader->setMapFiles(mapFiles);
+    reader->setIndexFile(indexFile);
     reader->init();
   }
 
@@ -318,6 +338,20 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
   dr.run(); // read back and check
 }
 
+BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU_Parallel)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT_par.cfg"}; // same as above, but the links are filled in parallel and the files written asynchronously
+  dw.init();
+  dw.addPerIR = true;
+  dw.writer.setNThreads(4);
+  dw.writer.useAsyncWriting(1024 * 1024);
+  dw.run(); // write output
+  //
+  TestRawReader dr{"TST", "test_raw_conf_GBT_par.cfg"};
+  dr.init();
+  dr.run(); // read back and check
+}
+
 BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
 {
   TestRawWriter dw{"TST", false, "test_raw_conf_DDL.cfg"}; // this is RORC detector with origin TST
@@ -329,4 +363,53 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
   dr.run(); // read back and check
 }
 
+BOOST_AUTO_TEST_CASE(RawReaderWriter_MapIndex)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT_idx.cfg"}; // CRU detector, files are read memory-mapped and via the preprocessing index
+  dw.init();
+  dw.run(); // write output
+  //
+  const std::string indexFile = "test_raw_conf_GBT_idx.idx";
+  std::filesystem::remove(indexFile);
+  TestRawReader dr0{"TST", "test_raw_conf_GBT_idx.cfg"};
+  dr0.mapFiles = true;
+  dr0.indexFile = indexFile;
+  dr0.init();
+  BOOST_CHECK(!dr0.reader->getIndexUsed()); // index is created
+  BOOST_CHECK(std::filesystem::exists(indexFile));
+  dr0.run(); // read back and check
+  //
+  TestRawReader dr1{"TST", "test_raw_conf_GBT_idx.cfg"};
+  dr1.indexFile = indexFile;
+  dr1.init();
+  BOOST_CHECK(dr1.reader->getIndexUsed()); // index is reused
+  BOOST_CHECK(dr1.reader->getNLinks() == dr0.reader->getNLinks());
+  BOOST_CHECK(dr1.reader->getNTimeFrames() == dr0.reader->getNTimeFrames());
+  for (int il = 0; il < dr0.reader->getNLinks(); il++) {
+    const auto &lnk0 = dr0.reader->getLink(il), &lnk1 = dr1.reader->getLink(il);
+    BOOST_CHECK(lnk0.spec == lnk1.spec);
+    BOOST_CHECK(lnk0.blocks.size() == lnk1.blocks.size());
+    BOOST_CHECK(lnk0.tfStartBlock == lnk1.tfStartBlock);
+    for (size_t ib = 0; ib < std::min(lnk0.blocks.size(), lnk1.blocks.size()); ib++) {
+      BOOST_CHECK(lnk0.blocks[ib].offset == lnk1.blocks[ib].offset && lnk0.blocks[ib].size == lnk1.blocks[ib].size && lnk0.blocks[ib].tfID == lnk1.blocks[ib].tfID);
+    }
+  }
+  dr1.run(); // read back and check, now without memory-mapping
+  //
+  TestRawReader dr2{"TST", "test_raw_conf_GBT_idx.cfg"};
+  dr2.indexFile = indexFile;
+  dr2.errCheck ^= 0x1 << RawFileReader::ErrWrongNumberOfTF;
+  dr2.init();
+  BOOST_CHECK(!dr2.reader->getIndexUsed()); // different error checks invalidate the index
+  dr2.run();
+  //
+  std::filesystem::resize_file(indexFile, std::filesystem::file_size(indexFile) / 2); // truncated index must be rejected
+  TestRawReader dr3{"TST", "test_raw_conf_GBT_idx.cfg"};
+  dr3.indexFile = indexFile;
+  dr3.init();
+  BOOST_CHECK(!dr3.reader->getIndexUsed());
+  dr3.run();
+  std::filesystem::remove(indexFile);
+}
+
 } // namespace o2
@@ -16,10 +16,12 @@
 #include <Rtypes.h>
 #include <unordered_map>
 #include <deque>
+#include <algorithm>
 #include <numeric>
 #include "Framework/Logger.h"
 #include "DetectorsDCS/DataPointCompositeObject.h"
 #include "DetectorsDCS/DataPointIdentifier.h"
+#include "DetectorsDCS/DataPointIndex.h"
 #include "DetectorsDCS/DataPointValue.h"
 #include "DetectorsDCS/DeliveryType.h"
 #include "CCDB/CcdbObjectInfo.h"
@@ -134,18 +136,13 @@ class TOFDCSProcessor
 
   bool areAllDPsFilled()
   {
-    for (auto& it : mPids) {
-      if (!it.second) {
-        return false;
-      }
-    }
-    return true;
+    return std::all_of(mPidProcessed.begin(), mPidProcessed.end(), [](bool processed) { return processed; });
   }
 
  private:
   std::unordered_map<DPID, TOFDCSinfo> mTOFDCS;                // this is the object that will go to the CCDB
-  std::unordered_map<DPID, bool> mPids;                        // contains all PIDs for the processor, the bool
-                                                               // will be true if the DP was processed at least once
+  o2::dcs::DataPointIndex mPids;                               // perfect-hash index of all PIDs for the processor
+  std::vector<bool> mPidProcessed;                             // per PID slot, true if the DP was processed at least once
   std::unordered_map<DPID, std::vector<DPVAL>> mDpsdoublesmap; // this is the map that will hold the DPs for the
                                                                // double type (voltages and currents)
 
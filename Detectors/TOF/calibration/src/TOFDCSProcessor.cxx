@@ -47,8 +47,9 @@ void TOFDCSProcessor::init(const std::vector<DPID>& pids)
   // fill the array of the DPIDs that will be used by TOF
   // pids should be provided by CCDB
 
-  for (const auto& it : pids) {
-    mPids[it] = false;
+  mPids.build(pids);
+  mPidProcessed.assign(mPids.size(), false);
+  for (const auto& it : mPids.keys()) {
     mTOFDCS[it].makeEmpty();
   }
 
@@ -74,12 +75,13 @@ int TOFDCSProcessor::process(const gsl::span<const DPCOM> dps)
     for (auto& it : dps) {
       mapin[it.id] = it.data;
     }
-    for (auto& it : mPids) {
-      const auto& el = mapin.find(it.first);
+    for (size_t slot = 0; slot < mPids.size(); slot++) {
+      const auto& dpid = mPids[slot];
+      const auto& el = mapin.find(dpid);
       if (el == mapin.end()) {
-        LOG(debug) << "DP " << it.first << " not found in map";
+        LOG(debug) << "DP " << dpid << " not found in map";
       } else {
-        LOG(debug) << "DP " << it.first << " found in map";
+        LOG(debug) << "DP " << dpid << " found in map";
       }
     }
   }
@@ -90,13 +92,13 @@ int TOFDCSProcessor::process(const gsl::span<const DPCOM> dps)
   // now we process all DPs, one by one
   for (const auto& it : dps) {
     // we process only the DPs defined in the configuration
-    const auto& el = mPids.find(it.id);
-    if (el == mPids.end()) {
+    const auto slot = mPids.find(it.id);
+    if (slot == o2::dcs::DataPointIndex::NotFound) {
       LOG(info) << "DP " << it.id << " not found in TOFDCSProcessor, we will not process it";
       continue;
     }
     processDP(it);
-    mPids[it.id] = true;
+    mPidProcessed[slot] = true;
   }
 
   if (mUpdateFeacStatus) {
@@ -337,17 +339,18 @@ void TOFDCSProcessor::updateDPsCCDB()
     double double_value;
   } converter0, converter1;
 
-  for (auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPids.size(); slot++) {
+    const auto& dpid = mPids[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      auto& tofdcs = mTOFDCS[it.first];
-      if (it.second) {     // we processed the DP at least 1x
+      auto& tofdcs = mTOFDCS[dpid];
+      if (mPidProcessed[slot]) { // we processed the DP at least 1x
         if (mVerboseDP) {
-          LOG(info) << "Processing DP " << it.first.get_alias();
+          LOG(info) << "Processing DP " << dpid.get_alias();
         }
-        it.second = false; // reset for the next period
+        mPidProcessed[slot] = false; // reset for the next period
         tofdcs.updated = true;
-        auto& dpvect = mDpsdoublesmap[it.first];
+        auto& dpvect = mDpsdoublesmap[dpid];
         tofdcs.firstValue.first = dpvect[0].get_epoch_time();
         converter0.raw_data = dpvect[0].payload_pt1;
         tofdcs.firstValue.second = converter0.double_value;
@@ -413,18 +416,19 @@ void TOFDCSProcessor::updateDPsCCDB()
         tofdcs.updated = false;
       }
       if (mVerboseDP) {
-        LOG(info) << "PID " << it.first.get_alias() << " was updated to:";
+        LOG(info) << "PID " << dpid.get_alias() << " was updated to:";
         tofdcs.print();
       }
     }
   }
   if (mVerboseDP) {
     LOG(info) << "Printing object to be sent to CCDB";
-    for (auto& it : mPids) {
-      const auto& type = it.first.get_type();
+    for (size_t slot = 0; slot < mPids.size(); slot++) {
+      const auto& dpid = mPids[slot];
+      const auto& type = dpid.get_type();
       if (type == o2::dcs::DPVAL_DOUBLE) {
-        LOG(info) << "PID = " << it.first.get_alias();
-        auto& tofdcs = mTOFDCS[it.first];
+        LOG(info) << "PID = " << dpid.get_alias();
+        auto& tofdcs = mTOFDCS[dpid];
         tofdcs.print();
       }
     }
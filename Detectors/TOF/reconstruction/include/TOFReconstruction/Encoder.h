@@ -49,6 +49,7 @@ class Encoder
   void encodeTRM(const std::vector<Digit>& summary, Int_t icrate, Int_t itrm, int& istart); // return next trm index
 
   bool flush(int icrate);
+  void flushAll(); // flush all crates at once, the links are filled in parallel by the writer
   bool close();
   void setVerbose(bool val) { mVerbose = val; };
 
@@ -97,6 +98,8 @@ class Encoder
 
   bool mOldFormat = false;
 
+  std::vector<o2::raw::RawFileWriter::LinkPayload> mPayloads; //! payloads of the crates for the writer
+
   // temporary variable for encoding
   int mEventCounter;         //!
   o2::InteractionRecord mIR; //!
@@ -122,6 +122,24 @@ bool Encoder::flush(int icrate)
   return false;
 }
 
+void Encoder::flushAll()
+{
+  mPayloads.clear();
+  for (int icrate = 0; icrate < 72; icrate++) {
+    int nbyte = getSize(mStart[icrate], mUnion[icrate]);
+    if (nbyte) {
+      if (mCrateOn[icrate]) {
+        auto& payload = mPayloads.emplace_back();
+        payload.subspec = RDHUtils::getSubSpec(Geo::getCRUid(icrate), Geo::getCRUlink(icrate), Geo::getCRUendpoint(icrate), Geo::getFEEid(icrate));
+        payload.data = gsl::span(mBuffer[icrate], nbyte);
+      }
+      mIntegratedAllBytes += nbyte;
+    }
+    mUnion[icrate] = mStart[icrate];
+  }
+  mFileWriter.addData(mIR, mPayloads);
+}
+
 bool Encoder::close()
 {
   mFileWriter.close();
@@ -395,9 +413,7 @@ bool Encoder::encode(std::vector<std::vector<o2::tof::Digit>> digitWindow, int t
 
   mIR.bc = bcFirstWin;
 
-  for (int i = 0; i < 72; i++) {
-    flush(i);
-  }
+  flushAll();
 
   mStartRun = false;
 
@@ -41,6 +41,8 @@ class RawWriter : public Task
   std::string mOutDirName;  // read from workflow
   std::string mFileFor;     // output granularity
   bool mOldFormat = false;  // encode with old format (zeros in word 2 and 3)
+  int mNThreads = 1;        // number of threads filling the links
+  int mAsyncBufferMB = 0;   // size of the asynchronous writing buffers in MB (0: synchronous)
 };
 
 /// create a processor spec
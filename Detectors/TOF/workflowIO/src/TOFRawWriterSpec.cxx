@@ -38,6 +38,8 @@ void RawWriter::init(InitContext& ic)
   mOutDirName = ic.options().get<std::string>("tof-raw-outdir");
   mFileFor = ic.options().get<std::string>("file-for");
   mOldFormat = ic.options().get<bool>("use-old-format");
+  mNThreads = ic.options().get<int>("nthreads");
+  mAsyncBufferMB = ic.options().get<int>("async-write-buffer");
   LOG(debug) << "Raw output file: " << mOutFileName.c_str();
 
   // if needed, create output directory
@@ -67,6 +69,10 @@ void RawWriter::run(ProcessingContext& pc)
     encoder.setEncoderCRUZEROES();
   }
 
+  encoder.getWriter().setNThreads(mNThreads);
+  if (mAsyncBufferMB > 0) {
+    encoder.getWriter().useAsyncWriting(size_t(mAsyncBufferMB) * 1024 * 1024);
+  }
   encoder.open(mOutFileName, mOutDirName, mFileFor);
   encoder.alloc(cache);
 
@@ -128,7 +134,9 @@ DataProcessorSpec getTOFRawWriterSpec()
       {"tof-raw-outfile", VariantType::String, "tof.raw", {"Name of the output file"}},
       {"tof-raw-outdir", VariantType::String, ".", {"Name of the output dir"}},
       {"file-for", VariantType::String, "cruendpoint", {"Single file per: all,cruendpoint,link"}},
-      {"use-old-format", VariantType::Bool, rdhDefaultVersion < 7, {"expecting zeroes in words 2 and 3 of the CRU payload"}}}};
+      {"use-old-format", VariantType::Bool, rdhDefaultVersion < 7, {"expecting zeroes in words 2 and 3 of the CRU payload"}},
+      {"nthreads", VariantType::Int, 1, {"number of threads filling the links"}},
+      {"async-write-buffer", VariantType::Int, 0, {"size in MB of the buffers for asynchronous writing of the raw files (0: synchronous)"}}}};
 }
 } // namespace tof
 } // namespace o2
@@ -29,6 +29,7 @@
 #include "Riostream.h"
 #include <fairlogger/Logger.h>
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <iomanip>
@@ -94,6 +95,44 @@ BOOST_AUTO_TEST_CASE(FastTransform_test1)
   BOOST_CHECK(fabs(maxDy) < 1.e-5);
 }
 
+/// @brief Test 2 row-batched transformations give the same results as the cluster-by-cluster ones
+BOOST_AUTO_TEST_CASE(FastTransform_test_row)
+{
+  std::unique_ptr<TPCFastTransform> fastTransformPtr(TPCFastTransformHelperO2::instance()->create(0));
+  TPCFastTransform& fastTransform = *fastTransformPtr;
+  const TPCFastTransformGeo& geo = fastTransform.getGeometry();
+  fastTransform.setApplyCorrectionOn();
+
+  const float maxTimeBin = 1000.f;
+  double maxDiff = 0.;
+  for (int slice = 0; slice < geo.getNumberOfSlices(); slice += 7) {
+    for (int row = 0; row < geo.getNumberOfRows(); row += 5) {
+      std::vector<float> pad, time;
+      for (float p = 0; p <= geo.getRowInfo(row).maxPad; p += 2.7f) {
+        for (float t = 0; t < 500.f; t += 97.f) {
+          pad.push_back(p);
+          time.push_back(t);
+        }
+      }
+      const int n = pad.size();
+      std::vector<float> x(n), y(n), z(n), xTF(n), yTF(n), zTF(n), xInv(n);
+      fastTransform.TransformRow(slice, row, n, pad.data(), time.data(), x.data(), y.data(), z.data());
+      fastTransform.TransformInTimeFrameRow(slice, row, n, pad.data(), time.data(), xTF.data(), yTF.data(), zTF.data(), maxTimeBin);
+      fastTransform.InverseTransformYZtoXRow(slice, row, n, y.data(), z.data(), xInv.data());
+      for (int i = 0; i < n; i++) {
+        float x0, y0, z0, x1, y1, z1, x2;
+        fastTransform.Transform(slice, row, pad[i], time[i], x0, y0, z0);
+        fastTransform.TransformInTimeFrame(slice, row, pad[i], time[i], x1, y1, z1, maxTimeBin);
+        fastTransform.InverseTransformYZtoX(slice, row, y0, z0, x2);
+        maxDiff = std::max({maxDiff, (double)fabs(x[i] - x0), (double)fabs(y[i] - y0), (double)fabs(z[i] - z0)});
+        maxDiff = std::max({maxDiff, (double)fabs(xTF[i] - x1), (double)fabs(yTF[i] - y1), (double)fabs(zTF[i] - z1)});
+        maxDiff = std::max(maxDiff, (double)fabs(xInv[i] - x2));
+      }
+    }
+  }
+  BOOST_CHECK_MESSAGE(maxDiff < 1.e-4, "row-batched transformation differs from the cluster one by " << maxDiff << " cm");
+}
+
 #ifdef XXX
 BOOST_AUTO_TEST_CASE(FastTransform_test_setSpaceChargeCorrection)
 {
@@ -95,7 +95,7 @@ struct ProcessAttributes {
 void convert(DigitArray& inputDigits, ProcessAttributes* processAttributes, o2::raw::RawFileWriter& writer);
 #include "DetectorsRaw/HBFUtils.h"
 void convertDigitsToZSfinal(std::string_view digitsFile, std::string_view outputPath, std::string_view fileFor,
-                            bool sectorBySector, uint32_t rdhV, uint32_t zsV, bool stopPage, bool padding, bool createParentDir)
+                            bool sectorBySector, uint32_t rdhV, uint32_t zsV, bool stopPage, bool padding, bool createParentDir, int asyncBufferMB)
 {
   // ===| open file and get tree |==============================================
   std::unique_ptr<TFile> o2simDigits(TFile::Open(digitsFile.data()));
@@ -166,6 +166,10 @@ void convertDigitsToZSfinal(std::string_view digitsFile, std::string_view output
     writer.useCaching();
   }
   writer.doLazinessCheck(false); // LazinessCheck is not thread-safe
+  // sectors are already encoded in parallel, move also the file writing off the encoding threads
+  if (asyncBufferMB > 0) {
+    writer.useAsyncWriting(size_t(asyncBufferMB) * 1024 * 1024);
+  }
 
   // ===| set up branch addresses |=============================================
   std::vector<Digit>* vDigitsPerSectorCollection[Sector::MAXSECTOR] = {nullptr}; // container that keeps Digits per sector
@@ -264,6 +268,7 @@ int main(int argc, char** argv)
     add_option("file-for,f", bpo::value<std::string>()->default_value("sector"), "single file per: link,sector,cruendpoint,all");
     add_option("stop-page,p", bpo::value<bool>()->default_value(false)->implicit_value(true), "HBF stop on separate CRU page");
     add_option("padding", bpo::value<bool>()->default_value(false)->implicit_value(true), "Pad all pages to 8kb");
+    add_option("async-write-buffer", bpo::value<int>()->default_value(0), "size in MB of the buffers for asynchronous writing of the raw files (0: synchronous)");
     uint32_t defRDH = o2::raw::RDHUtils::getVersion<o2::header::RAWDataHeader>();
     add_option("hbfutils-config,u", bpo::value<std::string>()->default_value(std::string(o2::base::NameConf::DIGITIZATIONCONFIGFILE)), "config file for HBFUtils (or none)");
     add_option("rdh-version,r", bpo::value<uint32_t>()->default_value(defRDH), "RDH version to use");
@@ -303,7 +308,8 @@ int main(int argc, char** argv)
     vm["zs-version"].as<uint32_t>(),
     vm["stop-page"].as<bool>(),
     vm["padding"].as<bool>(),
-    !vm.count("no-parent-directories"));
+    !vm.count("no-parent-directories"),
+    vm["async-write-buffer"].as<int>());
 
   o2::raw::HBFUtils::Instance().print();
 
@@ -15,6 +15,7 @@
 #include "Framework/Logger.h"
 #include "DetectorsDCS/DataPointCompositeObject.h"
 #include "DetectorsDCS/DataPointIdentifier.h"
+#include "DetectorsDCS/DataPointIndex.h"
 #include "DetectorsDCS/DataPointValue.h"
 #include "DetectorsDCS/DeliveryType.h"
 #include "CCDB/CcdbObjectInfo.h"
@@ -55,7 +56,7 @@ class DCSProcessor
 
   // processing methods
   int process(const gsl::span<const DPCOM> dps);
-  int processDP(const DPCOM& dpcom);
+  int processDP(const DPCOM& dpcom, int slot);
   int processFlags(uint64_t flag, const char* pid);
 
   // these functions prepare the CCDB objects
@@ -75,7 +76,7 @@ class DCSProcessor
   CcdbObjectInfo& getccdbCurrentsDPsInfo() { return mCcdbCurrentsDPsInfo; }
   CcdbObjectInfo& getccdbEnvDPsInfo() { return mCcdbEnvDPsInfo; }
   CcdbObjectInfo& getccdbRunDPsInfo() { return mCcdbRunDPsInfo; }
-  const std::unordered_map<DPID, TRDDCSMinMaxMeanInfo>& getTRDGasDPsInfo() const { return mTRDDCSGas; }
+  const std::unordered_map<DPID, TRDDCSMinMaxMeanInfo>& getTRDGasDPsInfo() const { return mTRDDCSGasCCDB; }
   const std::unordered_map<DPID, float>& getTRDVoltagesDPsInfo() const { return mTRDDCSVoltages; }
   const std::unordered_map<DPID, TRDDCSMinMaxMeanInfo>& getTRDCurrentsDPsInfo() const { return mTRDDCSCurrents; }
   const std::unordered_map<DPID, TRDDCSMinMaxMeanInfo>& getTRDEnvDPsInfo() const { return mTRDDCSEnv; }
@@ -97,7 +98,7 @@ class DCSProcessor
 
  private:
   // the CCDB objects
-  std::unordered_map<DPID, TRDDCSMinMaxMeanInfo> mTRDDCSGas;      ///< gas DPs (CO2, O2, H20 and from the chromatograph CO2, N2, Xe)
+  std::unordered_map<DPID, TRDDCSMinMaxMeanInfo> mTRDDCSGasCCDB;  ///< gas DPs (CO2, O2, H20 and from the chromatograph CO2, N2, Xe)
   std::unordered_map<DPID, TRDDCSMinMaxMeanInfo> mTRDDCSCurrents; ///< anode and drift currents
   std::unordered_map<DPID, float> mTRDDCSVoltages;                ///< anode and drift voltages
   std::unordered_map<DPID, TRDDCSMinMaxMeanInfo> mTRDDCSEnv;      ///< environment parameters (temperatures, pressures)
@@ -110,8 +111,10 @@ class DCSProcessor
   // I don't think the FED ENV temperature is needed at analysis level at any point in time so I am leaving it out for now
 
   // helper variables
-  std::unordered_map<DPID, bool> mPids;                 ///< flag for each DP whether it has been processed at least once
-  std::unordered_map<DPID, uint64_t> mLastDPTimeStamps; ///< for each DP keep here the time stamp of the DP processed last
+  o2::dcs::DataPointIndex mPidIndex;            ///< perfect-hash index of the configured DPs, the slots index the vectors below
+  std::vector<bool> mPidProcessed;              ///< flag for each DP whether it has been processed at least once
+  std::vector<uint64_t> mLastDPTimeStamps;      ///< for each DP keep here the time stamp of the DP processed last
+  std::vector<TRDDCSMinMaxMeanInfo> mTRDDCSGas; ///< gas DPs being accumulated (non-gas slots stay empty)
   CcdbObjectInfo mCcdbGasDPsInfo;
   CcdbObjectInfo mCcdbVoltagesDPsInfo;
   CcdbObjectInfo mCcdbCurrentsDPsInfo;
@@ -26,10 +26,10 @@ void DCSProcessor::init(const std::vector<DPID>& pids)
   // fill the array of the DPIDs that will be used by TRD
   // pids should be provided by CCDB
 
-  for (const auto& it : pids) {
-    mPids[it] = false;
-    mLastDPTimeStamps[it] = 0;
-  }
+  mPidIndex.build(pids);
+  mPidProcessed.assign(mPidIndex.size(), false);
+  mLastDPTimeStamps.assign(mPidIndex.size(), 0);
+  mTRDDCSGas.assign(mPidIndex.size(), TRDDCSMinMaxMeanInfo());
 }
 
 //__________________________________________________________________
@@ -49,12 +49,13 @@ int DCSProcessor::process(const gsl::span<const DPCOM> dps)
       mapin[it.id] = it.data;
     }
 
-    for (auto& it : mPids) {
-      const auto& el = mapin.find(it.first);
+    for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+      const auto& dpid = mPidIndex[slot];
+      const auto& el = mapin.find(dpid);
       if (el == mapin.end()) {
-        LOG(info) << "DP " << it.first << " not found in map";
+        LOG(info) << "DP " << dpid << " not found in map";
       } else {
-        LOG(info) << "DP " << it.first << " found in map";
+        LOG(info) << "DP " << dpid << " found in map";
       }
     }
   }
@@ -62,15 +63,15 @@ int DCSProcessor::process(const gsl::span<const DPCOM> dps)
   // now we process all DPs, one by one
   for (const auto& it : dps) {
     // we process only the DPs defined in the configuration
-    const auto& el = mPids.find(it.id);
-    if (el == mPids.end()) {
+    const auto slot = mPidIndex.find(it.id);
+    if (slot == o2::dcs::DataPointIndex::NotFound) {
       if (mVerbosity > 1) {
         LOG(info) << "DP " << it.id << " not found in DCSProcessor, we will not process it";
       }
       continue;
     }
-    processDP(it);
-    mPids[it.id] = true;
+    processDP(it, slot);
+    mPidProcessed[slot] = true;
   }
 
   return 0;
@@ -78,10 +79,10 @@ int DCSProcessor::process(const gsl::span<const DPCOM> dps)
 
 //__________________________________________________________________
 
-int DCSProcessor::processDP(const DPCOM& dpcom)
+int DCSProcessor::processDP(const DPCOM& dpcom, int slot)
 {
 
-  // processing single DP
+  // processing single DP, slot is its index in mPidIndex
 
   auto& dpid = dpcom.id;
   const auto& type = dpid.get_type();
@@ -105,11 +106,11 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
           mGasStartTS = mCurrentTS;
           mGasStartTSset = true;
         }
-        auto& dpInfoGas = mTRDDCSGas[dpid];
-        if (dpInfoGas.nPoints == 0 || etime != mLastDPTimeStamps[dpid]) {
+        auto& dpInfoGas = mTRDDCSGas[slot];
+        if (dpInfoGas.nPoints == 0 || etime != mLastDPTimeStamps[slot]) {
           // only add data point in case it was not already read before
           dpInfoGas.addPoint(o2::dcs::getValue<double>(dpcom), etime);
-          mLastDPTimeStamps[dpid] = etime;
+          mLastDPTimeStamps[slot] = etime;
         }
       }
 
@@ -120,10 +121,10 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
           mCurrentsStartTSSet = true;
         }
         auto& dpInfoCurrents = mTRDDCSCurrents[dpid];
-        if (dpInfoCurrents.nPoints == 0 || etime != mLastDPTimeStamps[dpid]) {
+        if (dpInfoCurrents.nPoints == 0 || etime != mLastDPTimeStamps[slot]) {
           // only add data point in case it was not already read before
           dpInfoCurrents.addPoint(o2::dcs::getValue<double>(dpcom), etime);
-          mLastDPTimeStamps[dpid] = etime;
+          mLastDPTimeStamps[slot] = etime;
         }
       }
 
@@ -134,7 +135,7 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
           mVoltagesStartTSSet = true;
         }
         auto& dpInfoVoltages = mTRDDCSVoltages[dpid];
-        if (etime != mLastDPTimeStamps[dpid]) {
+        if (etime != mLastDPTimeStamps[slot]) {
           int chamberId = getChamberIdFromAlias(dpid.get_alias());
           if (mVoltageSet.test(chamberId)) {
             if (std::fabs(dpInfoVoltages - o2::dcs::getValue<double>(dpcom)) > 1.f) {
@@ -145,7 +146,7 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
             }
           }
           dpInfoVoltages = o2::dcs::getValue<double>(dpcom);
-          mLastDPTimeStamps[dpid] = etime;
+          mLastDPTimeStamps[slot] = etime;
           mVoltageSet.set(chamberId);
         }
       }
@@ -157,10 +158,10 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
           mEnvStartTSSet = true;
         }
         auto& dpInfoEnv = mTRDDCSEnv[dpid];
-        if (dpInfoEnv.nPoints == 0 || etime != mLastDPTimeStamps[dpid]) {
+        if (dpInfoEnv.nPoints == 0 || etime != mLastDPTimeStamps[slot]) {
           // only add data point in case it was not already read before
           dpInfoEnv.addPoint(o2::dcs::getValue<double>(dpcom), etime);
-          mLastDPTimeStamps[dpid] = etime;
+          mLastDPTimeStamps[slot] = etime;
         }
       }
     }
@@ -171,7 +172,7 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
           mRunStartTSSet = true;
         }
         auto& runNumber = mTRDDCSRun[dpid];
-        if (mPids[dpid] && runNumber != o2::dcs::getValue<int32_t>(dpcom)) {
+        if (mPidProcessed[slot] && runNumber != o2::dcs::getValue<int32_t>(dpcom)) {
           LOGF(info, "Run number has already been processed and the new one %i differs from the old one %i", runNumber, o2::dcs::getValue<int32_t>(dpcom));
           mShouldUpdateRun = true;
           mRunEndTS = mCurrentTS;
@@ -184,7 +185,7 @@ int DCSProcessor::processDP(const DPCOM& dpcom)
           mRunStartTSSet = true;
         }
         auto& runType = mTRDDCSRun[dpid];
-        if (mPids[dpid] && runType != o2::dcs::getValue<int32_t>(dpcom)) {
+        if (mPidProcessed[slot] && runType != o2::dcs::getValue<int32_t>(dpcom)) {
           LOGF(info, "Run type has already been processed and the new one %i differs from the old one %i", runType, o2::dcs::getValue<int32_t>(dpcom));
           mShouldUpdateRun = true;
           mRunEndTS = mCurrentTS;
@@ -285,23 +286,31 @@ bool DCSProcessor::updateGasDPsCCDB()
 
   bool retVal = false; // set to 'true' in case at least one DP for gas has been processed
 
-  for (const auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "trd_gas") != nullptr) {
-        if (it.second == true) { // we processed the DP at least 1x
+      if (std::strstr(dpid.get_alias(), "trd_gas") != nullptr) {
+        if (mPidProcessed[slot]) { // we processed the DP at least 1x
           retVal = true;
         }
         if (mVerbosity > 0) {
-          LOG(info) << "PID = " << it.first.get_alias();
-          mTRDDCSGas[it.first].print();
+          LOG(info) << "PID = " << dpid.get_alias();
+          mTRDDCSGas[slot].print();
         }
       }
     }
   }
   std::map<std::string, std::string> md;
   md["responsible"] = "Ole Schmidt";
-  o2::calibration::Utils::prepareCCDBobjectInfo(mTRDDCSGas, mCcdbGasDPsInfo, "TRD/Calib/DCSDPsGas", md, mGasStartTS, mGasStartTS + 3 * o2::ccdb::CcdbObjectInfo::DAY);
+  // the CCDB object contains the gas DPs seen since the last update
+  mTRDDCSGasCCDB.clear();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    if (mTRDDCSGas[slot].nPoints > 0) {
+      mTRDDCSGasCCDB.emplace(mPidIndex[slot], mTRDDCSGas[slot]);
+    }
+  }
+  o2::calibration::Utils::prepareCCDBobjectInfo(mTRDDCSGasCCDB, mCcdbGasDPsInfo, "TRD/Calib/DCSDPsGas", md, mGasStartTS, mGasStartTS + 3 * o2::ccdb::CcdbObjectInfo::DAY);
 
   return retVal;
 }
@@ -313,16 +322,17 @@ bool DCSProcessor::updateCurrentsDPsCCDB()
 
   bool retVal = false; // set to 'true' in case at least one DP has been processed
 
-  for (const auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "Imon") != nullptr) {
-        if (it.second == true) { // we processed the DP at least 1x
+      if (std::strstr(dpid.get_alias(), "Imon") != nullptr) {
+        if (mPidProcessed[slot]) { // we processed the DP at least 1x
           retVal = true;
         }
         if (mVerbosity > 1) {
-          LOG(info) << "PID = " << it.first.get_alias();
-          mTRDDCSCurrents[it.first].print();
+          LOG(info) << "PID = " << dpid.get_alias();
+          mTRDDCSCurrents[dpid].print();
         }
       }
     }
@@ -341,15 +351,16 @@ bool DCSProcessor::updateVoltagesDPsCCDB()
 
   bool retVal = false; // set to 'true' in case at least one DP has been processed
 
-  for (const auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "Umon") != nullptr) {
-        if (it.second == true) { // we processed the DP at least 1x
+      if (std::strstr(dpid.get_alias(), "Umon") != nullptr) {
+        if (mPidProcessed[slot]) { // we processed the DP at least 1x
           retVal = true;
         }
         if (mVerbosity > 1) {
-          LOG(info) << "PID = " << it.first.get_alias() << " Value = " << mTRDDCSVoltages[it.first];
+          LOG(info) << "PID = " << dpid.get_alias() << " Value = " << mTRDDCSVoltages[dpid];
         }
       }
     }
@@ -368,16 +379,17 @@ bool DCSProcessor::updateEnvDPsCCDB()
 
   bool retVal = false; // set to 'true' in case at least one DP for env has been processed
 
-  for (const auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "trd_aliEnv") != nullptr) {
-        if (it.second == true) { // we processed the DP at least 1x
+      if (std::strstr(dpid.get_alias(), "trd_aliEnv") != nullptr) {
+        if (mPidProcessed[slot]) { // we processed the DP at least 1x
           retVal = true;
         }
         if (mVerbosity > 0) {
-          LOG(info) << "PID = " << it.first.get_alias();
-          mTRDDCSEnv[it.first].print();
+          LOG(info) << "PID = " << dpid.get_alias();
+          mTRDDCSEnv[dpid].print();
         }
       }
     }
@@ -396,15 +408,16 @@ bool DCSProcessor::updateRunDPsCCDB()
 
   bool retVal = false; // set to 'true' in case at least one DP for run has been processed
 
-  for (const auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "trd_run") != nullptr) {
-        if (it.second == true) { // we processed the DP at least 1x
+      if (std::strstr(dpid.get_alias(), "trd_run") != nullptr) {
+        if (mPidProcessed[slot]) { // we processed the DP at least 1x
           retVal = true;
         }
         if (mVerbosity > 0) {
-          LOG(info) << "PID = " << it.first.get_alias() << ". Value = " << mTRDDCSRun[it.first];
+          LOG(info) << "PID = " << dpid.get_alias() << ". Value = " << mTRDDCSRun[dpid];
         }
       }
     }
@@ -421,11 +434,12 @@ void DCSProcessor::clearCurrentsDPsInfo()
   mTRDDCSCurrents.clear();
   mCurrentsStartTSSet = false;
   // reset the 'processed' flags for the currents DPs
-  for (auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "Imon") != nullptr) {
-        it.second = false;
+      if (std::strstr(dpid.get_alias(), "Imon") != nullptr) {
+        mPidProcessed[slot] = false;
       }
     }
   }
@@ -438,11 +452,12 @@ void DCSProcessor::clearVoltagesDPsInfo()
   mVoltageSet.reset();
   mShouldUpdateVoltages = false;
   // reset the 'processed' flags for the voltages DPs
-  for (auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "Umon") != nullptr) {
-        it.second = false;
+      if (std::strstr(dpid.get_alias(), "Umon") != nullptr) {
+        mPidProcessed[slot] = false;
       }
     }
   }
@@ -451,15 +466,17 @@ void DCSProcessor::clearVoltagesDPsInfo()
 void DCSProcessor::clearGasDPsInfo()
 {
   // reset the data and the gas CCDB object itself
-  mTRDDCSGas.clear();
+  mTRDDCSGas.assign(mPidIndex.size(), TRDDCSMinMaxMeanInfo());
+  mTRDDCSGasCCDB.clear();
   mGasStartTSset = false; // the next object will be valid from the first processed time stamp
 
   // reset the 'processed' flags for the gas DPs
-  for (auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "trd_gas") != nullptr) {
-        it.second = false;
+      if (std::strstr(dpid.get_alias(), "trd_gas") != nullptr) {
+        mPidProcessed[slot] = false;
       }
     }
   }
@@ -470,11 +487,12 @@ void DCSProcessor::clearEnvDPsInfo()
   mTRDDCSEnv.clear();
   mEnvStartTSSet = false;
   // reset the 'processed' flags for the gas DPs
-  for (auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "trd_aliEnv") != nullptr) {
-        it.second = false;
+      if (std::strstr(dpid.get_alias(), "trd_aliEnv") != nullptr) {
+        mPidProcessed[slot] = false;
       }
     }
   }
@@ -486,11 +504,12 @@ void DCSProcessor::clearRunDPsInfo()
   mRunStartTSSet = false;
   mShouldUpdateRun = false;
   // reset the 'processed' flags for the gas DPs
-  for (auto& it : mPids) {
-    const auto& type = it.first.get_type();
+  for (size_t slot = 0; slot < mPidIndex.size(); slot++) {
+    const auto& dpid = mPidIndex[slot];
+    const auto& type = dpid.get_type();
     if (type == o2::dcs::DPVAL_DOUBLE) {
-      if (std::strstr(it.first.get_alias(), "trd_run") != nullptr) {
-        it.second = false;
+      if (std::strstr(dpid.get_alias(), "trd_run") != nullptr) {
+        mPidProcessed[slot] = false;
       }
     }
   }
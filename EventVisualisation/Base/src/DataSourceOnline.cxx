@@ -29,7 +29,7 @@ namespace o2
 {
 namespace event_visualisation
 {
-std::vector<std::string> DataSourceOnline::sourceFilextensions = {".json", ".root"};
+std::vector<std::string> DataSourceOnline::sourceFilextensions = {".json", ".root", ".eveb"};
 
 std::vector<std::pair<VisualisationEvent, EVisualisationGroup>> DataSourceOnline::getVisualisationList(int no, float minTime, float maxTime, float range)
 {
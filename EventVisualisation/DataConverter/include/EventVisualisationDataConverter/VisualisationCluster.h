@@ -38,6 +38,7 @@ class VisualisationCluster
 {
   friend class VisualisationEventJSONSerializer;
   friend class VisualisationEventROOTSerializer;
+  friend class VisualisationEventBinarySerializer;
 
  public:
   // Default constructor
@@ -0,0 +1,70 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    VisualisationEventBinarySerializer.h
+/// \brief   compact columnar binary serialization
+///
+
+#ifndef O2EVE_VISUALISATIONEVENTBINARYSERIALIZER_H
+#define O2EVE_VISUALISATIONEVENTBINARYSERIALIZER_H
+
+#include "EventVisualisationDataConverter/VisualisationEventSerializer.h"
+#include "EventVisualisationDataConverter/VisualisationTrack.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace event_visualisation
+{
+
+/// Compact columnar binary format (".eveb")
+///
+/// The file starts with a fixed header followed by a table of section offsets,
+/// so that each column block (tracks, polyline points, clusters, calorimeters)
+/// can be located without parsing the preceding ones. All coordinates are
+/// quantised to int16 with a step of kCoordinateStep (stored in the header);
+/// times, angles and energies are kept as floats.
+class VisualisationEventBinarySerializer : public VisualisationEventSerializer
+{
+ public:
+  static constexpr uint32_t kMagic = 0x42455645; // "EVEB"
+  static constexpr uint16_t kVersion = 1;
+  static constexpr float kCoordinateStep = 0.1f; // cm per quantisation unit
+
+  enum Section : int {
+    Header,        // run and workflow metadata
+    Tracks,        // per-track scalar columns and point/cluster offsets
+    TrackPoints,   // quantised polyline points of all tracks
+    TrackClusters, // quantised clusters attached to tracks
+    Clusters,      // standalone clusters
+    Calorimeters,  // calorimeter towers
+    NSections
+  };
+
+  bool fromFile(VisualisationEvent& event, std::string fileName) override;
+  void toFile(const VisualisationEvent& event, std::string fileName) override;
+  ~VisualisationEventBinarySerializer() override = default;
+
+  static int16_t quantise(float v, float step = kCoordinateStep);
+  static float dequantise(int16_t v, float step = kCoordinateStep) { return v * step; }
+
+ private:
+  static void writeEvent(const VisualisationEvent& event, std::vector<char>& out);
+  static bool readEvent(VisualisationEvent& event, const std::vector<char>& in);
+};
+
+} // namespace event_visualisation
+} // namespace o2
+
+#endif // O2EVE_VISUALISATIONEVENTBINARYSERIALIZER_H
@@ -0,0 +1,499 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   VisualisationEventBinarySerializer.cxx
+/// \brief  compact columnar binary serialization
+
+#include "EventVisualisationDataConverter/VisualisationEventBinarySerializer.h"
+#include <fairlogger/Logger.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+namespace o2
+{
+namespace event_visualisation
+{
+
+namespace
+{
+template <typename T>
+void put(std::vector<char>& out, const T& value)
+{
+  const char* p = reinterpret_cast<const char*>(&value);
+  out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+void putColumn(std::vector<char>& out, const std::vector<T>& column)
+{
+  put<uint32_t>(out, column.size());
+  const char* p = reinterpret_cast<const char*>(column.data());
+  out.insert(out.end(), p, p + column.size() * sizeof(T));
+}
+
+void putString(std::vector<char>& out, const std::string& value)
+{
+  put<uint32_t>(out, value.size());
+  out.insert(out.end(), value.begin(), value.end());
+}
+
+/// strings are stored as a column of end offsets followed by the concatenated characters
+void putStrings(std::vector<char>& out, const std::vector<const std::string*>& values)
+{
+  std::vector<uint32_t> ends;
+  std::string chars;
+  ends.reserve(values.size());
+  for (const auto* v : values) {
+    chars += *v;
+    ends.push_back(chars.size());
+  }
+  putColumn(out, ends);
+  putString(out, chars);
+}
+
+float noNaN(float v) { return std::isnan(v) ? 0.f : v; }
+
+class Reader
+{
+ public:
+  Reader(const std::vector<char>& in) : mBegin(in.data()), mPos(in.data()), mEnd(in.data() + in.size()) {}
+
+  bool seek(uint64_t offset)
+  {
+    if (offset > uint64_t(mEnd - mBegin)) {
+      return mOk = false;
+    }
+    mPos = mBegin + offset;
+    return true;
+  }
+
+  template <typename T>
+  T get()
+  {
+    T value{};
+    if (!mOk || mEnd - mPos < (std::ptrdiff_t)sizeof(T)) {
+      mOk = false;
+      return value;
+    }
+    std::memcpy(&value, mPos, sizeof(T));
+    mPos += sizeof(T);
+    return value;
+  }
+
+  template <typename T>
+  bool getColumn(std::vector<T>& column, size_t expected = std::numeric_limits<size_t>::max())
+  {
+    auto n = get<uint32_t>();
+    if (!mOk || (expected != std::numeric_limits<size_t>::max() && n != expected) || uint64_t(mEnd - mPos) < uint64_t(n) * sizeof(T)) {
+      return mOk = false;
+    }
+    column.resize(n);
+    std::memcpy(column.data(), mPos, n * sizeof(T));
+    mPos += n * sizeof(T);
+    return true;
+  }
+
+  bool getString(std::string& value)
+  {
+    auto n = get<uint32_t>();
+    if (!mOk || uint64_t(mEnd - mPos) < n) {
+      return mOk = false;
+    }
+    value.assign(mPos, n);
+    mPos += n;
+    return true;
+  }
+
+  bool getStrings(std::vector<std::string>& values, size_t expected)
+  {
+    std::vector<uint32_t> ends;
+    std::string chars;
+    if (!getColumn(ends, expected) || !getString(chars)) {
+      return false;
+    }
+    values.resize(ends.size());
+    uint32_t begin = 0;
+    for (size_t i = 0; i < ends.size(); i++) {
+      if (ends[i] < begin || ends[i] > chars.size()) {
+        return mOk = false;
+      }
+      values[i].assign(chars, begin, ends[i] - begin);
+      begin = ends[i];
+    }
+    return true;
+  }
+
+  bool ok() const { return mOk; }
+
+ private:
+  const char* mBegin;
+  const char* mPos;
+  const char* mEnd;
+  bool mOk = true;
+};
+
+struct QuantisedXYZ {
+  std::vector<int16_t> x, y, z;
+
+  void reserve(size_t n)
+  {
+    x.reserve(n);
+    y.reserve(n);
+    z.reserve(n);
+  }
+  void push(float vx, float vy, float vz)
+  {
+    x.push_back(VisualisationEventBinarySerializer::quantise(vx));
+    y.push_back(VisualisationEventBinarySerializer::quantise(vy));
+    z.push_back(VisualisationEventBinarySerializer::quantise(vz));
+  }
+  void write(std::vector<char>& out) const
+  {
+    putColumn(out, x);
+    putColumn(out, y);
+    putColumn(out, z);
+  }
+  bool read(Reader& in, size_t expected = std::numeric_limits<size_t>::max())
+  {
+    return in.getColumn(x, expected) && in.getColumn(y, x.size()) && in.getColumn(z, x.size());
+  }
+};
+} // namespace
+
+int16_t VisualisationEventBinarySerializer::quantise(float v, float step)
+{
+  if (std::isnan(v)) {
+    return 0;
+  }
+  float q = std::round(v / step);
+  q = std::clamp(q, float(std::numeric_limits<int16_t>::min()), float(std::numeric_limits<int16_t>::max()));
+  return static_cast<int16_t>(q);
+}
+
+void VisualisationEventBinarySerializer::writeEvent(const VisualisationEvent& event, std::vector<char>& out)
+{
+  out.clear();
+  put(out, kMagic);
+  put(out, kVersion);
+  put<uint16_t>(out, NSections);
+  put(out, kCoordinateStep);
+  const size_t offsetTable = out.size();
+  for (int s = 0; s < NSections; s++) {
+    put<uint64_t>(out, 0);
+  }
+  auto markSection = [&](Section s) {
+    uint64_t pos = out.size();
+    std::memcpy(out.data() + offsetTable + s * sizeof(uint64_t), &pos, sizeof(pos));
+  };
+
+  markSection(Header);
+  put<uint32_t>(out, event.mRunNumber);
+  put<int32_t>(out, event.mRunType);
+  put<int32_t>(out, event.mClMask);
+  put<int32_t>(out, event.mTrkMask);
+  put<uint32_t>(out, event.mTfCounter);
+  put<uint32_t>(out, event.mFirstTForbit);
+  put<uint64_t>(out, event.mPrimaryVertex);
+  putString(out, event.mCollisionTime);
+  putString(out, event.mEveVersion);
+  putString(out, event.mWorkflowParameters);
+
+  // tracks: one column per property, polyline points and clusters addressed by prefix offsets
+  const auto tracks = event.getTracksSpan();
+  const size_t nTracks = tracks.size();
+  std::vector<float> time(nTracks), theta(nTracks), phi(nTracks), eta(nTracks);
+  std::vector<int8_t> charge(nTracks);
+  std::vector<int32_t> pid(nTracks);
+  std::vector<uint8_t> source(nTracks);
+  std::vector<uint32_t> pointOffsets(nTracks + 1, 0), clusterOffsets(nTracks + 1, 0);
+  std::vector<const std::string*> gids(nTracks);
+  QuantisedXYZ start;
+  start.reserve(nTracks);
+  for (size_t i = 0; i < nTracks; i++) {
+    const auto& track = tracks[i];
+    time[i] = noNaN(track.mTime);
+    charge[i] = track.mCharge;
+    theta[i] = noNaN(track.mTheta);
+    phi[i] = noNaN(track.mPhi);
+    eta[i] = noNaN(track.mEta);
+    pid[i] = track.mPID;
+    source[i] = track.mSource;
+    gids[i] = &track.mGID;
+    start.push(track.mStartCoordinates[0], track.mStartCoordinates[1], track.mStartCoordinates[2]);
+    pointOffsets[i + 1] = pointOffsets[i] + track.getPointCount();
+    clusterOffsets[i + 1] = clusterOffsets[i] + track.getClusterCount();
+  }
+  markSection(Tracks);
+  put<uint32_t>(out, nTracks);
+  putColumn(out, time);
+  putColumn(out, charge);
+  putColumn(out, theta);
+  putColumn(out, phi);
+  putColumn(out, eta);
+  putColumn(out, pid);
+  putColumn(out, source);
+  start.write(out);
+  putColumn(out, pointOffsets);
+  putColumn(out, clusterOffsets);
+  putStrings(out, gids);
+
+  QuantisedXYZ points, trackClusters;
+  points.reserve(pointOffsets.back());
+  trackClusters.reserve(clusterOffsets.back());
+  for (const auto& track : tracks) {
+    for (size_t i = 0; i < track.getPointCount(); i++) {
+      points.push(track.mPolyX[i], track.mPolyY[i], track.mPolyZ[i]);
+    }
+    for (const auto& cluster : track.getClustersSpan()) {
+      trackClusters.push(cluster.X(), cluster.Y(), cluster.Z());
+    }
+  }
+  markSection(TrackPoints);
+  points.write(out);
+  markSection(TrackClusters);
+  trackClusters.write(out);
+
+  const auto clusters = event.getClustersSpan();
+  QuantisedXYZ clusterXYZ;
+  clusterXYZ.reserve(clusters.size());
+  std::vector<float> clusterTime;
+  std::vector<uint8_t> clusterSource;
+  clusterTime.reserve(clusters.size());
+  clusterSource.reserve(clusters.size());
+  for (const auto& cluster : clusters) {
+    clusterXYZ.push(cluster.X(), cluster.Y(), cluster.Z());
+    clusterTime.push_back(noNaN(cluster.Time()));
+    clusterSource.push_back(cluster.getSource());
+  }
+  markSection(Clusters);
+  clusterXYZ.write(out);
+  putColumn(out, clusterTime);
+  putColumn(out, clusterSource);
+
+  const auto calos = event.getCalorimetersSpan();
+  const size_t nCalo = calos.size();
+  std::vector<uint8_t> caloSource(nCalo);
+  std::vector<float> caloTime(nCalo), caloEnergy(nCalo), caloEta(nCalo), caloPhi(nCalo);
+  std::vector<int32_t> caloPID(nCalo);
+  std::vector<const std::string*> caloGID(nCalo);
+  for (size_t i = 0; i < nCalo; i++) {
+    const auto& calo = calos[i];
+    caloSource[i] = calo.mSource;
+    caloTime[i] = noNaN(calo.mTime);
+    caloEnergy[i] = noNaN(calo.mEnergy);
+    caloEta[i] = noNaN(calo.mEta);
+    caloPhi[i] = noNaN(calo.mPhi);
+    caloPID[i] = calo.mPID;
+    caloGID[i] = &calo.mGID;
+  }
+  markSection(Calorimeters);
+  putColumn(out, caloSource);
+  putColumn(out, caloTime);
+  putColumn(out, caloEnergy);
+  putColumn(out, caloEta);
+  putColumn(out, caloPhi);
+  putColumn(out, caloPID);
+  putStrings(out, caloGID);
+}
+
+bool VisualisationEventBinarySerializer::readEvent(VisualisationEvent& event, const std::vector<char>& in)
+{
+  Reader reader(in);
+  if (reader.get<uint32_t>() != kMagic) {
+    LOG(error) << "VisualisationEventBinarySerializer: not an eveb file";
+    return false;
+  }
+  auto version = reader.get<uint16_t>();
+  if (version != kVersion) {
+    LOG(error) << "VisualisationEventBinarySerializer: unsupported version " << version;
+    return false;
+  }
+  auto nSections = reader.get<uint16_t>();
+  const float step = reader.get<float>();
+  if (!reader.ok() || nSections < NSections || !(step > 0.f)) {
+    return false;
+  }
+  uint64_t offsets[NSections];
+  for (int s = 0; s < nSections; s++) {
+    auto offset = reader.get<uint64_t>();
+    if (s < NSections) {
+      offsets[s] = offset;
+    }
+  }
+
+  reader.seek(offsets[Header]);
+  event.setRunNumber(reader.get<uint32_t>());
+  event.setRunType(static_cast<parameters::GRPECS::RunType>(reader.get<int32_t>()));
+  event.setClMask(reader.get<int32_t>());
+  event.setTrkMask(reader.get<int32_t>());
+  event.setTfCounter(reader.get<uint32_t>());
+  event.setFirstTForbit(reader.get<uint32_t>());
+  event.mPrimaryVertex = reader.get<uint64_t>();
+  reader.getString(event.mCollisionTime);
+  reader.getString(event.mEveVersion);
+  reader.getString(event.mWorkflowParameters);
+
+  reader.seek(offsets[Tracks]);
+  const size_t nTracks = reader.get<uint32_t>();
+  std::vector<float> time, theta, phi, eta;
+  std::vector<int8_t> charge;
+  std::vector<int32_t> pid;
+  std::vector<uint8_t> source;
+  std::vector<uint32_t> pointOffsets, clusterOffsets;
+  std::vector<std::string> gids;
+  QuantisedXYZ start, points, trackClusters;
+  reader.getColumn(time, nTracks);
+  reader.getColumn(charge, nTracks);
+  reader.getColumn(theta, nTracks);
+  reader.getColumn(phi, nTracks);
+  reader.getColumn(eta, nTracks);
+  reader.getColumn(pid, nTracks);
+  reader.getColumn(source, nTracks);
+  start.read(reader, nTracks);
+  reader.getColumn(pointOffsets, nTracks + 1);
+  reader.getColumn(clusterOffsets, nTracks + 1);
+  reader.getStrings(gids, nTracks);
+  reader.seek(offsets[TrackPoints]);
+  points.read(reader, pointOffsets.empty() ? 0 : pointOffsets.back());
+  reader.seek(offsets[TrackClusters]);
+  trackClusters.read(reader, clusterOffsets.empty() ? 0 : clusterOffsets.back());
+  if (!reader.ok()) {
+    LOG(error) << "VisualisationEventBinarySerializer: corrupted track section";
+    return false;
+  }
+  for (size_t i = 0; i < nTracks; i++) {
+    if (pointOffsets[i] > pointOffsets[i + 1] || clusterOffsets[i] > clusterOffsets[i + 1]) {
+      LOG(error) << "VisualisationEventBinarySerializer: corrupted track offsets";
+      return false;
+    }
+  }
+
+  event.mTracks.reserve(nTracks);
+  for (size_t i = 0; i < nTracks; i++) {
+    VisualisationTrack track;
+    track.mTime = time[i];
+    track.mCharge = charge[i];
+    track.mTheta = theta[i];
+    track.mPhi = phi[i];
+    track.mEta = eta[i];
+    track.mPID = pid[i];
+    track.mGID = std::move(gids[i]);
+    track.mSource = (o2::dataformats::GlobalTrackID::Source)source[i];
+    const float xyz[3] = {dequantise(start.x[i], step), dequantise(start.y[i], step), dequantise(start.z[i], step)};
+    track.addStartCoordinates(xyz);
+    const auto nPoints = pointOffsets[i + 1] - pointOffsets[i];
+    track.mPolyX.reserve(nPoints);
+    track.mPolyY.reserve(nPoints);
+    track.mPolyZ.reserve(nPoints);
+    for (auto p = pointOffsets[i]; p < pointOffsets[i + 1]; p++) {
+      track.addPolyPoint(dequantise(points.x[p], step), dequantise(points.y[p], step), dequantise(points.z[p], step));
+    }
+    track.mClusters.reserve(clusterOffsets[i + 1] - clusterOffsets[i]);
+    for (auto c = clusterOffsets[i]; c < clusterOffsets[i + 1]; c++) {
+      float pos[3] = {dequantise(trackClusters.x[c], step), dequantise(trackClusters.y[c], step), dequantise(trackClusters.z[c], step)};
+      VisualisationCluster cluster(pos, track.mTime);
+      cluster.mSource = track.mSource;
+      track.mClusters.emplace_back(cluster);
+    }
+    event.mTracks.emplace_back(std::move(track));
+  }
+
+  reader.seek(offsets[Clusters]);
+  QuantisedXYZ clusterXYZ;
+  std::vector<float> clusterTime;
+  std::vector<uint8_t> clusterSource;
+  clusterXYZ.read(reader);
+  reader.getColumn(clusterTime, clusterXYZ.x.size());
+  reader.getColumn(clusterSource, clusterXYZ.x.size());
+  if (!reader.ok()) {
+    LOG(error) << "VisualisationEventBinarySerializer: corrupted cluster section";
+    return false;
+  }
+  event.mClusters.reserve(clusterTime.size());
+  for (size_t i = 0; i < clusterTime.size(); i++) {
+    float pos[3] = {dequantise(clusterXYZ.x[i], step), dequantise(clusterXYZ.y[i], step), dequantise(clusterXYZ.z[i], step)};
+    VisualisationCluster cluster(pos, clusterTime[i]);
+    cluster.mSource = (o2::dataformats::GlobalTrackID::Source)clusterSource[i];
+    event.mClusters.emplace_back(cluster);
+  }
+
+  reader.seek(offsets[Calorimeters]);
+  std::vector<uint8_t> caloSource;
+  std::vector<float> caloTime, caloEnergy, caloEta, caloPhi;
+  std::vector<int32_t> caloPID;
+  std::vector<std::string> caloGID;
+  reader.getColumn(caloSource);
+  const size_t nCalo = caloSource.size();
+  reader.getColumn(caloTime, nCalo);
+  reader.getColumn(caloEnergy, nCalo);
+  reader.getColumn(caloEta, nCalo);
+  reader.getColumn(caloPhi, nCalo);
+  reader.getColumn(caloPID, nCalo);
+  reader.getStrings(caloGID, nCalo);
+  if (!reader.ok()) {
+    LOG(error) << "VisualisationEventBinarySerializer: corrupted calorimeter section";
+    return false;
+  }
+  event.mCalo.reserve(nCalo);
+  for (size_t i = 0; i < nCalo; i++) {
+    VisualisationCalo calorimeter;
+    calorimeter.mSource = (o2::dataformats::GlobalTrackID::Source)caloSource[i];
+    calorimeter.mTime = caloTime[i];
+    calorimeter.mEnergy = caloEnergy[i];
+    calorimeter.mEta = caloEta[i];
+    calorimeter.mPhi = caloPhi[i];
+    calorimeter.mPID = caloPID[i];
+    calorimeter.mGID = std::move(caloGID[i]);
+    event.mCalo.emplace_back(calorimeter);
+  }
+  return true;
+}
+
+void VisualisationEventBinarySerializer::toFile(const VisualisationEvent& event, std::string fileName)
+{
+  std::vector<char> buffer;
+  writeEvent(event, buffer);
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  out.write(buffer.data(), buffer.size());
+  if (!out) {
+    LOG(error) << "VisualisationEventBinarySerializer: failed to write " << fileName;
+  }
+}
+
+bool VisualisationEventBinarySerializer::fromFile(VisualisationEvent& event, std::string fileName)
+{
+  LOG(info) << "VisualisationEventBinarySerializer <- " << fileName;
+  event.mTracks.clear();
+  event.mClusters.clear();
+  event.mCalo.clear();
+
+  std::ifstream in(fileName, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::vector<char> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (!readEvent(event, buffer)) {
+    event.mTracks.clear();
+    event.mClusters.clear();
+    event.mCalo.clear();
+    return false;
+  }
+  event.afterLoading();
+  return true;
+}
+
+} // namespace event_visualisation
+} // namespace o2
@@ -0,0 +1,152 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   testVisualisationEventBinarySerializer.cxx
+/// \brief  round trip of the compact binary (.eveb) serialization
+
+#define BOOST_TEST_MODULE Test EventVisualisation BinarySerializer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "EventVisualisationDataConverter/VisualisationEventBinarySerializer.h"
+#include "EventVisualisationDataConverter/VisualisationEvent.h"
+#include <cmath>
+#include <filesystem>
+#include <limits>
+
+using namespace o2::event_visualisation;
+using GID = o2::dataformats::GlobalTrackID;
+
+namespace
+{
+constexpr float kTolerance = 0.1f; // 1 mm, the quantisation step of the coordinates
+
+std::string tmpFile(const char* name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(BinarySerializer_roundtrip)
+{
+  VisualisationEvent event;
+  event.setRunNumber(529403);
+  event.setTfCounter(17);
+  event.setFirstTForbit(123456);
+
+  for (int t = 0; t < 3; t++) {
+    VisualisationTrack::VisualisationTrackVO vo;
+    vo.time = 10.f * t + 0.25f;
+    vo.charge = t % 2 ? -1 : 1;
+    vo.PID = 211 * (t + 1);
+    vo.startXYZ[0] = 0.013f * t;
+    vo.startXYZ[1] = -0.027f * t;
+    vo.startXYZ[2] = 1.234f * t;
+    vo.phi = 0.5f + t;
+    vo.theta = 1.1f;
+    vo.eta = 0.3f - t;
+    vo.gid = "ITS-TPC/" + std::to_string(t);
+    vo.source = GID::ITSTPC;
+    auto track = event.addTrack(vo);
+    for (int p = 0; p < 5 * (t + 1); p++) {
+      track->addPolyPoint(1.03f * p, -2.71f * p + t, 14.5f * p - 250.f);
+    }
+    for (int c = 0; c < t + 1; c++) {
+      event.addCluster(3.33f * c + 1.f, -0.77f * c, 42.42f + c, vo.time);
+    }
+  }
+
+  for (int c = 0; c < 2; c++) {
+    VisualisationCalo::VisualisationCaloVO vo;
+    vo.time = 1.5f * c;
+    vo.energy = 2.75f + c;
+    vo.phi = 0.1f * c;
+    vo.eta = c ? std::numeric_limits<float>::quiet_NaN() : -0.45f;
+    vo.PID = 22;
+    vo.gid = "EMC/" + std::to_string(c);
+    vo.source = GID::EMC;
+    event.addCalo(vo);
+  }
+
+  VisualisationEventBinarySerializer serializer;
+  const auto fileName = tmpFile("testVisualisationEventBinarySerializer.eveb");
+  serializer.toFile(event, fileName);
+  VisualisationEvent loaded;
+  BOOST_REQUIRE(serializer.fromFile(loaded, fileName));
+  std::filesystem::remove(fileName);
+
+  BOOST_CHECK_EQUAL(loaded.getRunNumber(), event.getRunNumber());
+  BOOST_CHECK_EQUAL(loaded.getTfCounter(), event.getTfCounter());
+  BOOST_CHECK_EQUAL(loaded.getFirstTForbit(), event.getFirstTForbit());
+
+  BOOST_REQUIRE_EQUAL(loaded.getTrackCount(), event.getTrackCount());
+  for (size_t t = 0; t < event.getTrackCount(); t++) {
+    const auto& in = event.getTrack(t);
+    const auto& out = loaded.getTrack(t);
+    BOOST_CHECK_EQUAL(out.getTime(), in.getTime());
+    BOOST_CHECK_EQUAL(out.getCharge(), in.getCharge());
+    BOOST_CHECK_EQUAL(out.getPID(), in.getPID());
+    BOOST_CHECK_EQUAL(out.getPhi(), in.getPhi());
+    BOOST_CHECK_EQUAL(out.getTheta(), in.getTheta());
+    BOOST_CHECK_EQUAL(out.getGIDAsString(), in.getGIDAsString());
+    BOOST_CHECK_EQUAL(int(out.getSource()), int(in.getSource()));
+    for (int i = 0; i < 3; i++) {
+      BOOST_CHECK_SMALL(out.getStartCoordinates()[i] - in.getStartCoordinates()[i], kTolerance);
+    }
+    BOOST_REQUIRE_EQUAL(out.getPointCount(), in.getPointCount());
+    for (size_t p = 0; p < in.getPointCount(); p++) {
+      for (int i = 0; i < 3; i++) {
+        BOOST_CHECK_SMALL(out.getPoint(p)[i] - in.getPoint(p)[i], kTolerance);
+      }
+    }
+    BOOST_REQUIRE_EQUAL(out.getClusterCount(), in.getClusterCount());
+    for (size_t c = 0; c < in.getClusterCount(); c++) {
+      BOOST_CHECK_SMALL(out.getCluster(c).X() - in.getCluster(c).X(), kTolerance);
+      BOOST_CHECK_SMALL(out.getCluster(c).Y() - in.getCluster(c).Y(), kTolerance);
+      BOOST_CHECK_SMALL(out.getCluster(c).Z() - in.getCluster(c).Z(), kTolerance);
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(loaded.getCaloCount(), event.getCaloCount());
+  const auto inCalo = event.getCalorimetersSpan();
+  const auto outCalo = loaded.getCalorimetersSpan();
+  for (size_t c = 0; c < inCalo.size(); c++) {
+    BOOST_CHECK_EQUAL(outCalo[c].getTime(), inCalo[c].getTime());
+    BOOST_CHECK_EQUAL(outCalo[c].getEnergy(), inCalo[c].getEnergy());
+    BOOST_CHECK_EQUAL(outCalo[c].getPhi(), inCalo[c].getPhi());
+    BOOST_CHECK_EQUAL(outCalo[c].getPID(), inCalo[c].getPID());
+    BOOST_CHECK_EQUAL(outCalo[c].getGIDAsString(), inCalo[c].getGIDAsString());
+    BOOST_CHECK_EQUAL(int(outCalo[c].getSource()), int(inCalo[c].getSource()));
+    if (std::isnan(inCalo[c].getEta())) {
+      BOOST_CHECK_EQUAL(outCalo[c].getEta(), 0.f); // NaN is stored as 0, as for the tracks
+    } else {
+      BOOST_CHECK_EQUAL(outCalo[c].getEta(), inCalo[c].getEta());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BinarySerializer_rejects_truncated)
+{
+  VisualisationEvent event;
+  VisualisationTrack::VisualisationTrackVO vo;
+  vo.startXYZ[0] = vo.startXYZ[1] = vo.startXYZ[2] = 0.f;
+  vo.source = GID::ITS;
+  event.addTrack(vo)->addPolyPoint(1.f, 2.f, 3.f);
+
+  VisualisationEventBinarySerializer serializer;
+  const auto fileName = tmpFile("testVisualisationEventBinarySerializerTruncated.eveb");
+  serializer.toFile(event, fileName);
+  std::filesystem::resize_file(fileName, std::filesystem::file_size(fileName) / 2);
+  VisualisationEvent loaded;
+  BOOST_CHECK(!serializer.fromFile(loaded, fileName));
+  BOOST_CHECK_EQUAL(loaded.getTrackCount(), 0);
+  std::filesystem::remove(fileName);
+}
@@ -76,6 +76,15 @@ class EveWorkflowHelper
     float maxZ;
   };
 
+  /// track whose polyline is computed later, in parallel with the others
+  struct PendingPolyline {
+    std::size_t trackIndex;
+    o2::track::TrackPar track;
+    PropagationRange range;
+    float maxStep;
+    float dz;
+  };
+
   static constexpr EveWorkflowHelper::PropagationRange prITS = {1.f, 40.f, -74.f, 74.f};
   static constexpr EveWorkflowHelper::PropagationRange prTPC = {85.f, 240.f, -260.f, 260.f};
   static constexpr EveWorkflowHelper::PropagationRange prTRD = {-1.f, 372.f, -375.f, 375.f};
@@ -177,7 +186,13 @@ class EveWorkflowHelper
   void drawPoint(float x, float y, float z, float trackTime) { mEvent.addCluster(x, y, z, trackTime); }
   void prepareITSClusters(const o2::itsmft::TopologyDictionary* dict); // fills mITSClustersArray
   void prepareMFTClusters(const o2::itsmft::TopologyDictionary* dict); // fills mMFTClustersArray
-  void clear() { mEvent.clear(); }
+  void propagatePendingTracks(); // computes polylines of tracks queued by addTrackToEvent
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  void clear()
+  {
+    mEvent.clear();
+    mPendingPolylines.clear();
+  }
 
   GID::Source detectorMapToGIDSource(uint8_t dm);
   o2::mch::TrackParam forwardTrackToMCHTrack(const o2::track::TrackParFwd& track);
@@ -207,6 +222,8 @@ class EveWorkflowHelper
   void setRecoContainer(const o2::globaltracking::RecoContainer* rc) { mRecoCont = rc; }
   TracksSet mTrackSet;
   o2::event_visualisation::VisualisationEvent mEvent;
+  std::vector<PendingPolyline> mPendingPolylines; /// tracks waiting for polyline propagation
+  int mNThreads = 1;                              /// threads used for polyline propagation
   std::unordered_map<GID, std::size_t> mTotalDataTypes;
   std::unordered_set<GID> mTotalAcceptedDataTypes;
   std::unordered_map<std::size_t, std::vector<GID>> mPrimaryVertexTrackGIDs;
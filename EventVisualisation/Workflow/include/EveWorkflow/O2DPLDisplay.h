@@ -85,13 +85,14 @@ class O2DPLDisplaySpec : public o2::framework::Task
   EveWorkflowHelper::Bracket mTimeBracket; // [min, max] range in TF time for the filter
   EveWorkflowHelper::Bracket mEtaBracket;  // [min, max] eta range for the TPC tracks removal
   std::string mJsonPath;                   // folder where files are stored
-  std::string mExt;                        // extension of created files (".json" or ".root")
+  std::string mExt;                        // extension of created files (".json", ".root" or ".eveb")
   std::chrono::milliseconds mTimeInterval; // minimal interval between files in milliseconds
   int mNumberOfFiles;                      // maximum number of files in folder - newer replaces older
   int mNumberOfTracks;                     // maximum number of track in single file (0 means no limit)
   bool mTrackSorting;                      // perform sorting tracks by track time before applying filters
   int mOnlyNthEvent;                       // process only every nth event.
   int mMaxPrimaryVertices;                 // max number of primary vertices to draw per time frame
+  int mNThreads = 1;                       // number of threads used for track propagation
   bool mPrimaryVertexTriggers;             // instead of drawing vertices with tracks (and maybe calorimeter triggers), draw vertices with calorimeter triggers (and maybe tracks)
   float mPrimaryVertexMinZ;                // minimum z position of the primary vertex
   float mPrimaryVertexMaxZ;                // maximum z position of the primary vertex
@@ -438,12 +438,14 @@ void EveWorkflowHelper::draw(std::size_t primaryVertexIdx, bool sortTracks)
       }
     }
   }
+  propagatePendingTracks();
 }
 
 void EveWorkflowHelper::save(const std::string& jsonPath, const std::string& ext, int numberOfFiles,
                              o2::dataformats::GlobalTrackID::mask_t trkMask, o2::dataformats::GlobalTrackID::mask_t clMask,
                              o2::header::DataHeader::RunNumberType runNumber, o2::framework::DataProcessingHeader::CreationTime creation)
 {
+  propagatePendingTracks();
   mEvent.setEveVersion(o2_eve_version);
   mEvent.setRunNumber(runNumber);
   std::time_t timeStamp = std::time(nullptr);
@@ -514,15 +516,15 @@ void EveWorkflowHelper::addTrackToEvent(const o2::track::TrackPar& tr, GID gid,
   if (source == GID::NSources) {
     source = (o2::dataformats::GlobalTrackID::Source)gid.getSource();
   }
-  auto vTrack = mEvent.addTrack({.time = trackTime,
-                                 .charge = tr.getCharge(),
-                                 .PID = tr.getPID(),
-                                 .startXYZ = {tr.getX(), tr.getY(), tr.getZ()},
-                                 .phi = tr.getPhi(),
-                                 .theta = tr.getTheta(),
-                                 .eta = tr.getEta(),
-                                 .gid = gid.asString(),
-                                 .source = source});
+  mEvent.addTrack({.time = trackTime,
+                  .charge = tr.getCharge(),
+                  .PID = tr.getPID(),
+                  .startXYZ = {tr.getX(), tr.getY(), tr.getZ()},
+                  .phi = tr.getPhi(),
+                  .theta = tr.getTheta(),
+                  .eta = tr.getEta(),
+                  .gid = gid.asString(),
+                  .source = source});
 
   const auto it = propagationRanges.find(source);
 
@@ -532,13 +534,31 @@ void EveWorkflowHelper::addTrackToEvent(const o2::track::TrackPar& tr, GID gid,
     return;
   }
 
-  const auto& prange = it->second;
+  // propagation is deferred to propagatePendingTracks, which runs it for all tracks in parallel
+  mPendingPolylines.push_back({mEvent.getTrackCount() - 1, tr, it->second, maxStep, dz});
+}
 
-  auto pnts = getTrackPoints(tr, prange.minR, prange.maxR, maxStep, prange.minZ, prange.maxZ);
+void EveWorkflowHelper::propagatePendingTracks()
+{
+  const auto nTracks = mPendingPolylines.size();
+  std::vector<std::vector<PNT>> polylines(nTracks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (std::size_t i = 0; i < nTracks; i++) {
+    const auto& pending = mPendingPolylines[i];
+    const auto& prange = pending.range;
+    polylines[i] = getTrackPoints(pending.track, prange.minR, prange.maxR, pending.maxStep, prange.minZ, prange.maxZ);
+  }
 
-  for (size_t ip = 0; ip < pnts.size(); ip++) {
-    vTrack->addPolyPoint(pnts[ip][0], pnts[ip][1], pnts[ip][2] + dz);
+  for (std::size_t i = 0; i < nTracks; i++) {
+    auto& vTrack = mEvent.getTrack(mPendingPolylines[i].trackIndex);
+    const auto dz = mPendingPolylines[i].dz;
+    for (const auto& pnt : polylines[i]) {
+      vTrack.addPolyPoint(pnt[0], pnt[1], pnt[2] + dz);
+    }
   }
+  mPendingPolylines.clear();
 }
 
 void EveWorkflowHelper::prepareITSClusters(const o2::itsmft::TopologyDictionary* dict)
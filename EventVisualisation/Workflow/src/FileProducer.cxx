@@ -52,7 +52,7 @@ std::string FileProducer::newFileName() const
                             fmt::arg("pid", pid),
                             fmt::arg("timestamp", millisec_since_epoch),
                             fmt::arg("ext", this->mExt));
-  std::vector<std::string> ext = {".json", ".root"};
+  std::vector<std::string> ext = {".json", ".root", ".eveb"};
   DirectoryLoader::reduceNumberOfFiles(this->mPath, DirectoryLoader::load(this->mPath, "_", ext), this->mFilesInFolder);
 
   return this->mPath + "/" + result;
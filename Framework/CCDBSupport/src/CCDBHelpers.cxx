@@ -22,11 +22,126 @@
 #include <typeinfo>
 #include <TError.h>
 #include <TMemFile.h>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 namespace o2::framework
 {
 
+/// Validity checks of the conditions done ahead of the TF for which they are due, on a thread of its
+/// own with its own CCDB APIs, so that the fetcher does not wait for them. A check done for the
+/// timestamp predicted for a TF replaces the check at that TF if the server confirmed the object in
+/// possession and the actual timestamp is within the validity of that object as well.
+struct CCDBLookAhead {
+  struct Check {
+    o2::ccdb::CcdbApi const* api = nullptr; ///< API of the fetcher the object is loaded with
+    std::string path;
+    std::map<std::string, std::string> metadata;
+    std::string etag;
+    int64_t timestamp = 0; ///< predicted timestamp of the TF
+    int64_t dueTF = 0;     ///< TF for which the check is due
+  };
+  struct Result {
+    std::string etag;
+    int64_t timestamp = 0;
+    int64_t dueTF = 0;
+    bool unchanged = false; ///< the server confirmed the object in possession
+  };
+
+  CCDBLookAhead(std::unordered_map<std::string, o2::ccdb::CcdbApi> const& apis, std::string const& defaultHost,
+                std::string const& createdNotAfter, std::string const& createdNotBefore)
+    : mCreatedNotAfter{createdNotAfter}, mCreatedNotBefore{createdNotBefore}
+  {
+    for (auto& [host, api] : apis) {
+      mAPIs[&api].init(host.empty() ? defaultHost : host);
+    }
+    mThread = std::thread([this]() { run(); });
+  }
+
+  ~CCDBLookAhead()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mCondition.notify_one();
+    mThread.join();
+  }
+
+  /// queue the check unless it was already scheduled for the same TF
+  void schedule(Check&& check)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto& scheduled = mScheduledTF[check.path];
+      if (scheduled == check.dueTF) {
+        return;
+      }
+      scheduled = check.dueTF;
+      mPending.push_back(std::move(check));
+    }
+    mCondition.notify_one();
+  }
+
+  /// true if the check done ahead for the due TF confirmed the object with the etag valid in [validFrom, validUntil) at timestamp
+  bool confirmed(std::string const& path, std::string const& etag, int64_t lastCheckedTF, int64_t validFrom, int64_t validUntil, int64_t timestamp)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto entry = mResults.find(path);
+    if (entry == mResults.end()) {
+      return false;
+    }
+    auto result = std::move(entry->second);
+    mResults.erase(entry);
+    auto isValid = [validFrom, validUntil](int64_t ts) { return validFrom <= ts && ts < validUntil; };
+    return result.unchanged && result.etag == etag && result.dueTF > lastCheckedTF && isValid(result.timestamp) && isValid(timestamp);
+  }
+
+ private:
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+      mCondition.wait(lock, [this]() { return mStop || !mPending.empty(); });
+      if (mStop) {
+        return;
+      }
+      auto checks = std::move(mPending);
+      mPending.clear();
+      lock.unlock();
+      std::vector<o2::pmr::vector<char>> blobs(checks.size());
+      std::vector<std::map<std::string, std::string>> headers(checks.size());
+      std::unordered_map<o2::ccdb::CcdbApi const*, std::vector<o2::ccdb::CcdbApi::RequestContext>> batches;
+      for (size_t i = 0; i < checks.size(); i++) {
+        auto& check = checks[i];
+        batches[check.api].push_back({&blobs[i], check.path, &check.metadata, check.timestamp, &headers[i], check.etag, mCreatedNotAfter, mCreatedNotBefore});
+      }
+      for (auto& [api, requests] : batches) {
+        mAPIs[api].vectoredLoadFileToMemory(requests);
+      }
+      lock.lock();
+      for (size_t i = 0; i < checks.size(); i++) {
+        LOGP(debug, "Validity of {} checked ahead for timestamp {} (TF {})", checks[i].path, checks[i].timestamp, checks[i].dueTF);
+        mResults[checks[i].path] = Result{checks[i].etag, checks[i].timestamp, checks[i].dueTF, headers[i].count("Error") == 0 && blobs[i].empty()};
+      }
+    }
+  }
+
+  std::unordered_map<o2::ccdb::CcdbApi const*, o2::ccdb::CcdbApi> mAPIs; ///< own API for every API of the fetcher
+  std::string mCreatedNotAfter;
+  std::string mCreatedNotBefore;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::vector<Check> mPending;
+  std::unordered_map<std::string, int64_t> mScheduledTF;
+  std::unordered_map<std::string, Result> mResults;
+  bool mStop = false;
+  std::thread mThread;
+};
+
 struct CCDBFetcherHelper {
   struct CCDBCacheInfo {
     std::string etag;
@@ -35,6 +150,8 @@ struct CCDBFetcherHelper {
     size_t minSize = -1ULL;
     size_t maxSize = 0;
     int lastCheckedTF = 0;
+    int64_t validFrom = -1; // validity of the cached object, if provided by the server
+    int64_t validUntil = -1;
   };
 
   struct RemapMatcher {
@@ -56,6 +173,11 @@ struct CCDBFetcherHelper {
   int queryPeriodGlo = 1;
   int queryPeriodFactor = 1;
   int64_t timeToleranceMS = 5000;
+  int lookAheadTFs = 0; // validity checks done this number of TFs ahead, 0 if disabled
+  std::unique_ptr<CCDBLookAhead> lookAhead;
+  int64_t lastTimestamp = -1; // timestamp and counter of the last TF, to predict the next timestamps
+  uint32_t lastTFCounter = 0;
+  double msPerTF = 0;
 
   o2::ccdb::CcdbApi& getAPI(const std::string& path)
   {
@@ -179,49 +301,82 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
                        DataTakingContext& dtc,
                        DataAllocator& allocator) -> void
 {
+  // The objects due for a validity check are requested all together, with one batch per backend,
+  // the replies are then processed in the order of the routes
+  struct RouteFetch {
+    Output output;
+    std::string path = "";
+    std::map<std::string, std::string> metadata;
+    std::map<std::string, std::string> headers;
+    std::string etag = "";
+    int chRate = 0;
+    o2::ccdb::CcdbApi const* api = nullptr;
+    std::optional<o2::pmr::vector<char>> v; // only for the objects being loaded
+  };
   std::string ccdbMetadataPrefix = "ccdb-metadata-";
-  int objCnt = -1;
+  if (helper->lastTimestamp >= 0 && timingInfo.tfCounter > helper->lastTFCounter && timestamp > helper->lastTimestamp) {
+    helper->msPerTF = double(timestamp - helper->lastTimestamp) / (timingInfo.tfCounter - helper->lastTFCounter);
+  }
+  helper->lastTimestamp = timestamp;
+  helper->lastTFCounter = timingInfo.tfCounter;
+
+  std::vector<RouteFetch> fetches;
+  fetches.reserve(helper->routes.size()); // the requests refer to the elements
+  std::unordered_map<o2::ccdb::CcdbApi const*, std::vector<o2::ccdb::CcdbApi::RequestContext>> batches;
   for (auto& route : helper->routes) {
     LOGP(debug, "Fetching object for route {}", DataSpecUtils::describe(route.matcher));
-    objCnt++;
     auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
-    Output output{concrete.origin, concrete.description, concrete.subSpec, route.matcher.lifetime};
-    auto&& v = allocator.makeVector<char>(output);
-    std::map<std::string, std::string> metadata;
-    std::map<std::string, std::string> headers;
-    std::string path = "";
-    std::string etag = "";
-    int chRate = helper->queryPeriodGlo;
+    auto& fetch = fetches.emplace_back(RouteFetch{Output{concrete.origin, concrete.description, concrete.subSpec, route.matcher.lifetime}});
+    fetch.chRate = helper->queryPeriodGlo;
     bool checkValidity = false;
     for (auto& meta : route.matcher.metadata) {
       if (meta.name == "ccdb-path") {
-        path = meta.defaultValue.get<std::string>();
+        fetch.path = meta.defaultValue.get<std::string>();
       } else if (meta.name == "ccdb-run-dependent" && meta.defaultValue.get<bool>() == true) {
-        metadata["runNumber"] = dtc.runNumber;
+        fetch.metadata["runNumber"] = dtc.runNumber;
       } else if (isPrefix(ccdbMetadataPrefix, meta.name)) {
         std::string key = meta.name.substr(ccdbMetadataPrefix.size());
         auto value = meta.defaultValue.get<std::string>();
         LOGP(debug, "Adding metadata {}: {} to the request", key, value);
-        metadata[key] = value;
+        fetch.metadata[key] = value;
       } else if (meta.name == "ccdb-query-rate") {
-        chRate = meta.defaultValue.get<int>() * helper->queryPeriodFactor;
+        fetch.chRate = meta.defaultValue.get<int>() * helper->queryPeriodFactor;
       }
     }
-    const auto url2uuid = helper->mapURL2UUID.find(path);
+    const auto url2uuid = helper->mapURL2UUID.find(fetch.path);
     if (url2uuid != helper->mapURL2UUID.end()) {
-      etag = url2uuid->second.etag;
-      checkValidity = int(timingInfo.tfCounter - url2uuid->second.lastCheckedTF) >= chRate;
+      fetch.etag = url2uuid->second.etag;
+      checkValidity = int(timingInfo.tfCounter - url2uuid->second.lastCheckedTF) >= fetch.chRate;
     } else {
       checkValidity = true; // never skip check if the cache is empty
     }
 
-    LOGP(debug, "checkValidity is {} for tfID {} of {}", checkValidity, timingInfo.tfCounter, path);
+    LOGP(debug, "checkValidity is {} for tfID {} of {}", checkValidity, timingInfo.tfCounter, fetch.path);
 
-    const auto& api = helper->getAPI(path);
-    if (checkValidity && (!api.isSnapshotMode() || etag.empty())) { // in the snapshot mode the object needs to be fetched only once
-      LOGP(detail, "Loading {} for timestamp {}", path, timestamp);
-      api.loadFileToMemory(v, path, metadata, timestamp, &headers, etag, helper->createdNotAfter, helper->createdNotBefore);
-      if ((headers.count("Error") != 0) || (etag.empty() && v.empty())) {
+    fetch.api = &helper->getAPI(fetch.path);
+    if (!checkValidity || (fetch.api->isSnapshotMode() && !fetch.etag.empty())) { // in the snapshot mode the object needs to be fetched only once
+      continue;
+    }
+    if (helper->lookAhead && url2uuid != helper->mapURL2UUID.end() &&
+        helper->lookAhead->confirmed(fetch.path, fetch.etag, url2uuid->second.lastCheckedTF, url2uuid->second.validFrom, url2uuid->second.validUntil, timestamp)) {
+      LOGP(debug, "Validity of {} for timestamp {} was checked ahead", fetch.path, timestamp);
+      url2uuid->second.lastCheckedTF = timingInfo.tfCounter;
+      continue;
+    }
+    LOGP(detail, "Loading {} for timestamp {}", fetch.path, timestamp);
+    fetch.v.emplace(allocator.makeVector<char>(fetch.output));
+    batches[fetch.api].push_back({&*fetch.v, fetch.path, &fetch.metadata, timestamp, &fetch.headers, fetch.etag, helper->createdNotAfter, helper->createdNotBefore});
+  }
+  for (auto& [api, requests] : batches) {
+    api->vectoredLoadFileToMemory(requests);
+  }
+
+  for (auto& fetch : fetches) {
+    auto& path = fetch.path;
+    auto& headers = fetch.headers;
+    if (fetch.v) {
+      auto& v = *fetch.v;
+      if ((headers.count("Error") != 0) || (fetch.etag.empty() && v.empty())) {
         LOGP(fatal, "Unable to find object {}/{}", path, timestamp);
         // FIXME: I should send a dummy message.
         continue;
@@ -230,24 +385,21 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
       if (headers.find("default") != headers.end()) {
         LOGP(detail, "******** Default entry used for {} ********", path);
       }
-      helper->mapURL2UUID[path].lastCheckedTF = timingInfo.tfCounter;
-      if (etag.empty()) {
-        helper->mapURL2UUID[path].etag = headers["ETag"]; // update uuid
-        helper->mapURL2UUID[path].cacheMiss++;
-        helper->mapURL2UUID[path].minSize = std::min(v.size(), helper->mapURL2UUID[path].minSize);
-        helper->mapURL2UUID[path].maxSize = std::max(v.size(), helper->mapURL2UUID[path].maxSize);
-        auto cacheId = allocator.adoptContainer(output, std::move(v), DataAllocator::CacheStrategy::Always, header::gSerializationMethodCCDB);
-        helper->mapURL2DPLCache[path] = cacheId;
-        LOGP(debug, "Caching {} for {} (DPL id {})", path, headers["ETag"], cacheId.value);
-        continue;
-      }
-      if (v.size()) { // but should be overridden by fresh object
+      auto& cacheInfo = helper->mapURL2UUID[path];
+      cacheInfo.lastCheckedTF = timingInfo.tfCounter;
+      if (fetch.etag.empty() || v.size()) { // new object, or the cached one is overridden by a fresh object
         // somewhere here pruneFromCache should be called
-        helper->mapURL2UUID[path].etag = headers["ETag"]; // update uuid
-        helper->mapURL2UUID[path].cacheMiss++;
-        helper->mapURL2UUID[path].minSize = std::min(v.size(), helper->mapURL2UUID[path].minSize);
-        helper->mapURL2UUID[path].maxSize = std::max(v.size(), helper->mapURL2UUID[path].maxSize);
-        auto cacheId = allocator.adoptContainer(output, std::move(v), DataAllocator::CacheStrategy::Always, header::gSerializationMethodCCDB);
+        cacheInfo.etag = headers["ETag"]; // update uuid
+        cacheInfo.cacheMiss++;
+        cacheInfo.minSize = std::min(v.size(), cacheInfo.minSize);
+        cacheInfo.maxSize = std::max(v.size(), cacheInfo.maxSize);
+        try {
+          cacheInfo.validFrom = std::stol(headers["Valid-From"]);
+          cacheInfo.validUntil = std::stol(headers["Valid-Until"]);
+        } catch (std::exception const&) {
+          cacheInfo.validFrom = cacheInfo.validUntil = -1;
+        }
+        auto cacheId = allocator.adoptContainer(fetch.output, std::move(v), DataAllocator::CacheStrategy::Always, header::gSerializationMethodCCDB);
         helper->mapURL2DPLCache[path] = cacheId;
         LOGP(debug, "Caching {} for {} (DPL id {})", path, headers["ETag"], cacheId.value);
         // one could modify the    adoptContainer to take optional old cacheID to clean:
@@ -259,8 +411,28 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
     auto cacheId = helper->mapURL2DPLCache[path];
     LOGP(debug, "Reusing {} for {}", cacheId.value, path);
     helper->mapURL2UUID[path].cacheHit++;
-    allocator.adoptFromCache(output, cacheId, header::gSerializationMethodCCDB);
-    // the outputBuffer was not used, can we destroy it?
+    allocator.adoptFromCache(fetch.output, cacheId, header::gSerializationMethodCCDB);
+  }
+
+  // schedule the checks falling due in the next TFs, for the timestamps extrapolated from the last TFs
+  if (!helper->lookAhead || helper->msPerTF <= 0) {
+    return;
+  }
+  for (auto& fetch : fetches) {
+    auto entry = helper->mapURL2UUID.find(fetch.path);
+    if (entry == helper->mapURL2UUID.end() || fetch.api->isSnapshotMode() || entry->second.validUntil < 0) {
+      continue;
+    }
+    int64_t dueTF = int64_t(entry->second.lastCheckedTF) + fetch.chRate;
+    int64_t ahead = dueTF - timingInfo.tfCounter;
+    if (ahead <= 0 || ahead > helper->lookAheadTFs) {
+      continue;
+    }
+    int64_t predicted = timestamp + int64_t(ahead * helper->msPerTF);
+    if (predicted < entry->second.validFrom || predicted >= entry->second.validUntil) {
+      continue; // a new object will be needed anyway
+    }
+    helper->lookAhead->schedule({fetch.api, fetch.path, fetch.metadata, entry->second.etag, predicted, dueTF});
   }
 };
 
@@ -294,6 +466,11 @@ AlgorithmSpec CCDBHelpers::fetchFromCCDB()
       }
       helper->createdNotBefore = std::to_string(options.get<int64_t>("condition-not-before"));
       helper->createdNotAfter = std::to_string(options.get<int64_t>("condition-not-after"));
+      helper->lookAheadTFs = options.get<int>("condition-lookahead");
+      if (helper->lookAheadTFs > 0) {
+        helper->lookAhead = std::make_unique<CCDBLookAhead>(helper->apis, defHost, helper->createdNotAfter, helper->createdNotBefore);
+        LOGP(info, "Validity checks done up to {} TFs ahead", helper->lookAheadTFs);
+      }
 
       for (auto &route : spec.outputs) {
         if (route.matcher.lifetime != Lifetime::Condition) {
@@ -17,9 +17,12 @@
 #include "Framework/RuntimeError.h"
 #include <arrow/table.h>
 
+#include <algorithm>
+#include <array>
 #include <iterator>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace o2::soa
 {
@@ -1410,6 +1413,223 @@ auto tripleCombinations(const T2& table)
   return CombinationsGenerator<CombinationsStrictlyUpperIndexPolicy<T2, T2, T2>>(CombinationsStrictlyUpperIndexPolicy(table, table, table));
 }
 
+/// Structure-of-arrays copy of selected columns of a group of rows (e.g. the
+/// tracks of one collision, or all rows of one bin). Each column is stored
+/// contiguously, so that pair kernels reading get<C>()[i] can be vectorised
+/// across rows instead of going through the row iterators one pair at a time.
+template <typename... Cs>
+struct ColumnTile {
+  static_assert((std::is_arithmetic_v<typename Cs::type> && ...), "ColumnTile: only arithmetic columns are supported");
+  using columns_t = framework::pack<Cs...>;
+
+  template <typename T>
+  void fill(T const& table)
+  {
+    clear();
+    reserve(table.size());
+    for (auto row = table.begin(); row != table.end(); ++row) {
+      push(row);
+    }
+  }
+
+  /// gather the given rows of the table (indices as produced by groupTable)
+  template <typename T>
+  void fill(T const& table, gsl::span<const BinningIndex> rows)
+  {
+    clear();
+    reserve(rows.size());
+    auto row = table.begin();
+    for (auto& r : rows) {
+      row.setCursor(r.index);
+      push(row);
+    }
+  }
+
+  template <typename C>
+  gsl::span<const typename C::type> get() const
+  {
+    constexpr auto idx = framework::has_type_at_v<C>(columns_t{});
+    return std::get<idx>(mColumns);
+  }
+
+  /// global index of the i-th row of the tile in its table
+  int64_t globalIndex(std::size_t i) const { return mGlobalIndices[i]; }
+  std::size_t size() const { return mGlobalIndices.size(); }
+
+  void clear()
+  {
+    mGlobalIndices.clear();
+    std::apply([](auto&... columns) { (columns.clear(), ...); }, mColumns);
+  }
+
+  void reserve(std::size_t n)
+  {
+    mGlobalIndices.reserve(n);
+    std::apply([n](auto&... columns) { (columns.reserve(n), ...); }, mColumns);
+  }
+
+ private:
+  template <typename R>
+  void push(R& row)
+  {
+    mGlobalIndices.push_back(row.globalIndex());
+    pushColumns(row, std::index_sequence_for<Cs...>{});
+  }
+
+  template <typename R, std::size_t... Is>
+  void pushColumns(R& row, std::index_sequence<Is...>)
+  {
+    (std::get<Is>(mColumns).push_back(columnValue<framework::pack_element_t<Is, columns_t>>(row)), ...);
+  }
+
+  template <typename C, typename R>
+  static typename C::type columnValue(R& row)
+  {
+    using decayed = std::decay_t<C>;
+    if constexpr (decayed::persistent::value) {
+      return *static_cast<decayed const&>(row).getIterator();
+    } else if constexpr (o2::soa::is_dynamic_t<decayed>()) {
+      return row.template getDynamicColumn<decayed>();
+    } else {
+      return row.template getId<decayed>();
+    }
+  }
+
+  std::tuple<std::vector<typename Cs::type>...> mColumns;
+  std::vector<int64_t> mGlobalIndices;
+};
+
+/// Which pairs (i, j) of two tiles are visited by the pair kernels
+enum class PairMode {
+  Full,         // all ordered pairs
+  Upper,        // i <= j, for a tile paired with itself
+  StrictlyUpper // i < j, for a tile paired with itself
+};
+
+namespace pair_helpers
+{
+/// Pairs are processed in tiles of TileSize x TileSize, so that the predicate
+/// mask of one tile stays in L1 and the inner loops have a fixed, short trip count.
+constexpr std::size_t TileSize = 64;
+
+/// Visit pairs (i, jRange(i).first <= j < jRange(i).second), tile by tile.
+/// With a predicate, it is first evaluated for the whole tile into a mask in a
+/// branch-free loop, and the kernel is only called for the selected pairs.
+template <typename JRange, typename K, typename P>
+void tiledPairLoop(std::size_t nI, std::size_t nJ, JRange const& jRange, K& kernel, P& predicate)
+{
+  constexpr bool hasPredicate = !std::is_same_v<std::decay_t<P>, std::nullptr_t>;
+  std::array<uint8_t, TileSize * TileSize> mask;
+  for (std::size_t i0 = 0; i0 < nI; i0 += TileSize) {
+    const auto i1 = std::min(nI, i0 + TileSize);
+    for (std::size_t j0 = 0; j0 < nJ; j0 += TileSize) {
+      const auto j1 = std::min(nJ, j0 + TileSize);
+      if constexpr (hasPredicate) {
+        uint8_t any = 0;
+        for (auto i = i0; i < i1; i++) {
+          const auto range = jRange(i);
+          const auto jBegin = std::max(range.first, j0), jEnd = std::min(range.second, j1);
+          uint8_t* row = &mask[(i - i0) * TileSize];
+          for (auto j = jBegin; j < jEnd; j++) {
+            const uint8_t selected = predicate(i, j) ? 1 : 0;
+            row[j - j0] = selected;
+            any |= selected;
+          }
+        }
+        if (!any) {
+          continue;
+        }
+        for (auto i = i0; i < i1; i++) {
+          const auto range = jRange(i);
+          const auto jBegin = std::max(range.first, j0), jEnd = std::min(range.second, j1);
+          const uint8_t* row = &mask[(i - i0) * TileSize];
+          for (auto j = jBegin; j < jEnd; j++) {
+            if (row[j - j0]) {
+              kernel(i, j);
+            }
+          }
+        }
+      } else {
+        for (auto i = i0; i < i1; i++) {
+          const auto range = jRange(i);
+          const auto jBegin = std::max(range.first, j0), jEnd = std::min(range.second, j1);
+          for (auto j = jBegin; j < jEnd; j++) {
+            kernel(i, j);
+          }
+        }
+      }
+    }
+  }
+}
+} // namespace pair_helpers
+
+/// Run kernel(i, j) over pairs of rows of two tiles (e.g. the tracks of two
+/// mixed collisions), with an optional predicate(i, j) selecting the pairs.
+/// The kernel and the predicate read the tile columns through spans captured
+/// from ColumnTile::get, so that they are inlined into the tile loops.
+/// The order in which pairs are visited is unspecified.
+template <typename TA, typename TB, typename K, typename P = std::nullptr_t>
+void pairKernel(TA const& a, TB const& b, PairMode mode, K&& kernel, P&& predicate = nullptr)
+{
+  const std::size_t nB = b.size();
+  auto jRange = [mode, nB](std::size_t i) -> std::pair<std::size_t, std::size_t> {
+    switch (mode) {
+      case PairMode::Upper:
+        return {i, nB};
+      case PairMode::StrictlyUpper:
+        return {i + 1, nB};
+      default:
+        return {0, nB};
+    }
+  };
+  pair_helpers::tiledPairLoop(a.size(), nB, jRange, kernel, predicate);
+}
+
+/// Tile version of the block combinations of a table with itself
+/// (CombinationsBlock{Full,Upper,StrictlyUpper}SameIndexPolicy for pairs):
+/// rows are binned with the binning policy, the columns Cs... of each bin are
+/// gathered into a ColumnTile and kernel(tile, i, j) (and predicate(tile, i, j),
+/// if given) are called for all pairs of rows of the bin that are at most
+/// categoryNeighbours apart.
+template <typename... Cs, typename BP, typename T1, typename T, typename K, typename P = std::nullptr_t>
+void blockPairKernel(const BP& binningPolicy, int categoryNeighbours, const T1& outsider, const T& table, PairMode mode, K&& kernel, P&& predicate = nullptr)
+{
+  constexpr bool hasPredicate = !std::is_same_v<std::decay_t<P>, std::nullptr_t>;
+  const int minCatSize = mode == PairMode::StrictlyUpper ? 2 : 1;
+  if (categoryNeighbours + 1 < minCatSize || table.size() == 0) {
+    return;
+  }
+  auto groupedIndices = groupTable(table, binningPolicy, minCatSize, outsider);
+
+  const std::size_t window = categoryNeighbours;
+  ColumnTile<Cs...> tile;
+  for (auto catBegin = groupedIndices.begin(); catBegin != groupedIndices.end();) {
+    auto catEnd = std::upper_bound(catBegin, groupedIndices.end(), *catBegin, sameCategory);
+    tile.fill(table, gsl::span<const BinningIndex>(&*catBegin, std::distance(catBegin, catEnd)));
+    const std::size_t n = tile.size();
+    auto jRange = [mode, n, window](std::size_t i) -> std::pair<std::size_t, std::size_t> {
+      const auto last = std::min(n, i + window + 1);
+      switch (mode) {
+        case PairMode::Upper:
+          return {i, last};
+        case PairMode::StrictlyUpper:
+          return {i + 1, last};
+        default:
+          return {i > window ? i - window : 0, last};
+      }
+    };
+    auto tileKernel = [&kernel, &tile](std::size_t i, std::size_t j) { kernel(tile, i, j); };
+    if constexpr (hasPredicate) {
+      auto tilePredicate = [&predicate, &tile](std::size_t i, std::size_t j) { return predicate(tile, i, j); };
+      pair_helpers::tiledPairLoop(n, n, jRange, tileKernel, tilePredicate);
+    } else {
+      std::nullptr_t noPredicate = nullptr;
+      pair_helpers::tiledPairLoop(n, n, jRange, tileKernel, noPredicate);
+    }
+    catBegin = catEnd;
+  }
+}
+
 } // namespace o2::soa
 
 #endif // O2_FRAMEWORK_ASOAHELPERS_H_
@@ -12,6 +12,7 @@
 #define o2_framework_AnalysisHelpers_H_DEFINED
 
 #include "Framework/DataAllocator.h"
+#include "Framework/ExpressionHelpers.h"
 #include "Framework/Traits.h"
 #include "Framework/TableBuilder.h"
 #include "Framework/AnalysisDataModel.h"
@@ -502,9 +503,8 @@ struct Partition {
       } else {
         throw std::runtime_error("Partition filter does not match declared table type");
       }
-    }
-    if (gfilter == nullptr) {
-      gfilter = framework::expressions::createFilter(schema, framework::expressions::makeCondition(tree));
+      nfilter = std::make_shared<expressions::NativeFilter>();
+      nfilter->addConjunct(ops, tree);
     }
   }
 
@@ -517,7 +517,7 @@ struct Partition {
   {
     intializeCaches(table.asArrowTable()->schema());
     if (dataframeChanged) {
-      mFiltered = getTableFromFilter(table, soa::selectionToVector(framework::expressions::createSelection(table.asArrowTable(), gfilter)));
+      mFiltered = getTableFromFilter(table, soa::selectionToVector(framework::expressions::createSelection(table.asArrowTable(), nfilter)));
       dataframeChanged = false;
     }
   }
@@ -558,7 +558,7 @@ struct Partition {
   expressions::Filter filter;
   std::unique_ptr<o2::soa::Filtered<T>> mFiltered = nullptr;
   gandiva::NodePtr tree = nullptr;
-  gandiva::FilterPtr gfilter = nullptr;
+  expressions::NativeFilterPtr nfilter = nullptr;
   bool dataframeChanged = true;
 
   using iterator = typename o2::soa::Filtered<T>::iterator;
@@ -264,8 +264,9 @@ struct OutputManager<HistogramRegistry> {
     return true;
   }
 
-  static bool finalize(ProcessingContext&, HistogramRegistry&)
+  static bool finalize(ProcessingContext&, HistogramRegistry& what)
   {
+    what.flush();
     return true;
   }
 
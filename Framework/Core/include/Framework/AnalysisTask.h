@@ -245,11 +245,15 @@ struct AnalysisDataProcessorBuilder {
   static auto extractFilteredFromRecord(InputRecord& record, ExpressionInfo& info, pack<Os...> const&)
   {
     auto table = o2::soa::ArrowHelpers::joinTables(std::vector<std::shared_ptr<arrow::Table>>{extractTableFromRecord<Os>(record)...});
-    if (info.tree != nullptr && info.filter == nullptr) {
+    if (info.tree != nullptr && info.native == nullptr && info.filter == nullptr) {
       info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
     }
-    if (info.tree != nullptr && info.filter != nullptr && info.resetSelection == true) {
-      info.selection = framework::expressions::createSelection(table, info.filter);
+    if (info.tree != nullptr && info.resetSelection == true) {
+      if (info.native != nullptr) {
+        info.selection = framework::expressions::createSelection(table, info.native);
+      } else {
+        info.selection = framework::expressions::createSelection(table, info.filter);
+      }
       info.resetSelection = false;
     }
     if constexpr (!o2::soa::is_smallgroups_v<std::decay_t<T>>) {
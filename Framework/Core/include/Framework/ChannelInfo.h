@@ -58,6 +58,8 @@ struct InputChannelInfo {
   /// We start with false since we assume there is no
   /// backpressure to start with.
   bool backpressureNotified = false;
+  /// When the current backpressure started, in ns as per uv_hrtime().
+  uint64_t backpressureStart = 0;
   ChannelIndex id = {-1};
   /// Wether its a normal channel or one which
   ChannelAccountingType channelType = ChannelAccountingType::DPL;
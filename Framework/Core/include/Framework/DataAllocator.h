@@ -310,13 +310,14 @@ class DataAllocator
   template <typename T>
   void snapshot(const Output& spec, T const& object)
   {
-    auto& proxy = mRegistry.get<MessageContext>().proxy();
+    auto& context = mRegistry.get<MessageContext>();
+    auto& proxy = context.proxy();
     fair::mq::MessagePtr payloadMessage;
     auto serializationType = o2::header::gSerializationMethodNone;
     RouteIndex routeIndex = matchDataHeader(spec, mRegistry.get<TimingInfo>().timeslice);
     if constexpr (is_messageable<T>::value == true) {
       // Serialize a snapshot of a trivially copyable, non-polymorphic object,
-      payloadMessage = proxy.createOutputMessage(routeIndex, sizeof(T));
+      payloadMessage = context.createMessage(routeIndex, 0, sizeof(T));
       memcpy(payloadMessage->GetData(), &object, sizeof(T));
 
       serializationType = o2::header::gSerializationMethodNone;
@@ -329,7 +330,7 @@ class DataAllocator
         // reference object
         constexpr auto elementSizeInBytes = sizeof(ElementType);
         auto sizeInBytes = elementSizeInBytes * object.size();
-        payloadMessage = proxy.createOutputMessage(routeIndex, sizeInBytes);
+        payloadMessage = context.createMessage(routeIndex, 0, sizeInBytes);
 
         if constexpr (std::is_pointer<typename T::value_type>::value == false) {
           // vector of elements
@@ -410,6 +411,12 @@ class DataAllocator
   void snapshot(const Output& spec, const char* payload, size_t payloadSize,
                 o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
 
+  /// Send the payload of an existing message (e.g. an input) to the output without copying it.
+  /// The new message refers to the same buffer (see fair::mq::Message::Copy), only a new
+  /// header is created. Falls back to a copy when the transports of the two messages differ.
+  void forward(const Output& spec, fair::mq::Message const& payload,
+               o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
+
   /// make an object of type T and route to output specified by OutputRef
   /// The object is owned by the framework, returned reference can be used to fill the object.
   ///
@@ -436,9 +443,21 @@ class DataAllocator
   o2::pmr::FairMQMemoryResource* getMemoryResource(const Output& spec)
   {
     auto& timingInfo = mRegistry.get<TimingInfo>();
-    auto& proxy = mRegistry.get<FairMQDeviceProxy>();
     RouteIndex routeIndex = matchDataHeader(spec, timingInfo.timeslice);
-    return *proxy.getOutputTransport(routeIndex);
+    return mRegistry.get<MessageContext>().getOutputResource(routeIndex);
+  }
+
+  /// Allocate the payloads of the outputs matching @a spec from the arena of the device
+  /// rather than creating a transport message for each of them: the small outputs of
+  /// a timeslice are carved from a few large regions, released in bulk once all their
+  /// messages are gone (see o2::pmr::ArenaMemoryResource). Applies to make, snapshot and
+  /// makeVector of all the streams of the device, hence to be selected once in the init
+  /// callback, e.g. with DataAllocator{ic.services()}.useArena(...).
+  void useArena(const Output& spec, bool use = true);
+
+  void useArena(OutputRef&& ref, bool use = true)
+  {
+    useArena(getOutputByBind(std::move(ref)), use);
   }
 
   // make a stl (pmr) vector
@@ -543,8 +562,7 @@ DataAllocator::CacheId DataAllocator::adoptContainer(const Output& spec, Contain
   auto routeIndex = matchDataHeader(spec, timingInfo.timeslice);
 
   auto& context = mRegistry.get<MessageContext>();
-  auto* transport = mRegistry.get<FairMQDeviceProxy>().getOutputTransport(routeIndex);
-  fair::mq::MessagePtr payloadMessage = o2::pmr::getMessage(std::forward<ContainerT>(container), *transport);
+  fair::mq::MessagePtr payloadMessage = o2::pmr::getMessage(std::forward<ContainerT>(container), context.getOutputResource(routeIndex));
   fair::mq::MessagePtr headerMessage = headerMessageFromOutput(spec, routeIndex,         //
                                                                method,                   //
                                                                payloadMessage->GetSize() //
@@ -122,6 +122,13 @@ struct DataProcessorContext {
   bool isSink = false;
   bool balancingInputs = true;
 
+  /// Set when the device has more than one processing stream, to hand the processing
+  /// callback to the thread pool. See DataProcessingDevice::scheduleProcessing.
+  std::function<void(std::function<void()> process, std::function<void()> complete)> scheduleProcessing;
+  /// Number of scheduled completions not invoked yet, i.e. of timeslices whose outputs
+  /// were not sent yet. Only accessed from the main loop.
+  size_t pendingCompletions = 0;
+
   std::function<void(o2::framework::RuntimeErrorRef e, InputRecord& record)> errorHandling;
   std::function<void(o2::framework::RuntimeErrorRef e)> initErrorHandling;
 };
@@ -31,6 +31,8 @@
 #include <fairmq/Device.h>
 #include <fairmq/Parts.h>
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <uv.h>
@@ -66,6 +68,12 @@ struct TaskStreamInfo {
   uv_work_t task;
   /// Wether or not this task is running
   bool running = false;
+  /// The device owning the stream
+  DataProcessingDevice* device = nullptr;
+  /// The processing callback handed to the thread pool, if any
+  std::function<void()> process;
+  /// Wether or not the processing callback returned
+  bool processed = false;
 };
 
 struct DeviceConfigurationHelpers {
@@ -92,6 +100,13 @@ class DataProcessingDevice : public fair::mq::Device
   static void handleData(ServiceRegistryRef, InputChannelInfo&);
   static bool tryDispatchComputation(ServiceRegistryRef ref, std::vector<DataRelayer::RecordAction>& completed);
 
+  /// Hand @a process to the thread pool, using the stream currently dispatching,
+  /// and invoke @a complete on the main loop once it is done. If @a process is empty,
+  /// only @a complete is queued. The completions happen in the order of scheduling.
+  void scheduleProcessing(std::function<void()> process, std::function<void()> complete);
+  /// Invoke, in scheduling order, the completions whose processing is done
+  void runCompletions();
+
  protected:
   void error(const char* msg);
   void fillContext(DataProcessorContext& context, DeviceContext& deviceContext);
@@ -116,6 +131,12 @@ class DataProcessingDevice : public fair::mq::Device
   bool mWasActive = false;                                       /// Whether or not the device was active at last iteration.
   std::vector<uv_work_t> mHandles;                               /// Handles to use to schedule work.
   std::vector<TaskStreamInfo> mStreams;                          /// Information about the task running in the associated mHandle.
+  int mDispatchingStream = -1;                                   /// The stream currently dispatching on the main loop.
+  struct PendingCompletion {
+    std::function<void()> complete;
+    TaskStreamInfo* stream = nullptr; ///< The stream doing the processing, if any
+  };
+  std::deque<PendingCompletion> mPendingCompletions; /// Completions not invoked yet, in scheduling order.
   /// Handle to wake up the main loop from other threads
   /// e.g. when FairMQ notifies some callback in an asynchronous way
   uv_async_t* mAwakeHandle = nullptr;
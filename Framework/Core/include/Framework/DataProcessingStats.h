@@ -13,6 +13,7 @@
 
 #include "DeviceState.h"
 #include "Framework/ServiceSpec.h"
+#include "Framework/TimesliceTracing.h"
 #include <atomic>
 #include <cstdint>
 #include <array>
@@ -63,6 +64,8 @@ enum struct ProcessingStatsId : short {
   RESOURCES_MISSING,
   RESOURCES_INSUFFICIENT,
   RESOURCES_SATISFACTORY,
+  /// Quantiles of the latency of each TimeslicePhase, see DataProcessingStats::PHASE_LATENCY_QUANTILES
+  PHASE_LATENCY_BASE = 256,
   AVAILABLE_MANAGED_SHM_BASE = 512,
 };
 
@@ -74,6 +77,8 @@ struct DataProcessingStats {
   constexpr static ServiceKind service_kind = ServiceKind::Global;
   constexpr static unsigned short MAX_METRICS = 1 << 15;
   constexpr static short MAX_CMDS = 64;
+  /// Quantiles of the phase latencies published as metrics, 1 meaning the maximum
+  constexpr static std::array<double, 3> PHASE_LATENCY_QUANTILES = {0.5, 0.99, 1.};
 
   enum struct Op : char {
     Nop,               /// No operation
@@ -190,6 +195,12 @@ struct DataProcessingStats {
   // This is the mutex to protect the queue of commands.
   std::mutex mMutex;
 
+  /// Latency histograms and trace of the phases of the timeslices.
+  TimesliceTracing tracing;
+  /// Publish the quantiles of the phase latencies recorded since the last
+  /// invocation, if at least minInterval milliseconds have passed.
+  void updatePhaseLatencies(int64_t minInterval);
+
   // Function to retrieve an aritrary base for the realtime clock.
   std::function<void(int64_t& base, int64_t& offset)> getRealtimeBase;
   // Function to retrieve the timestamp from the value returned by getRealtimeBase.
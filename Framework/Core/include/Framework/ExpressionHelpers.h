@@ -12,6 +12,7 @@
 #define O2_FRAMEWORK_EXPRESSIONS_HELPERS_H_
 #include "Framework/Expressions.h"
 
+#include <string>
 #include <vector>
 #include <iosfwd>
 #include <fmt/format.h>
@@ -88,6 +89,63 @@ struct NodeRecord {
     return this->node_ptr != rhs.node_ptr;
   }
 };
+
+/// Filter evaluated by kernels compiled ahead of time, directly on the arrow
+/// column buffers. Each operation of the sequence is mapped to a kernel
+/// instantiated for its operand type, so that no code is generated at run time.
+/// Sequences with operations or types without a native kernel, and tables with
+/// null entries, are evaluated with a gandiva filter instead, which is compiled
+/// only when it is needed for the first time.
+class NativeFilter
+{
+ public:
+  /// add an operation sequence, combined with logical 'and' with the previous
+  /// ones; tree is the equivalent gandiva expression, used for the fallback
+  void addConjunct(Operations const& opSpecs, gandiva::NodePtr tree);
+  /// true if all the conjuncts have native kernels
+  bool isNative() const { return mNative; }
+  /// create the selection of the rows of the table passing the filter
+  gandiva::Selection evaluate(std::shared_ptr<arrow::Table> const& table);
+
+  /// operand of a native operation
+  struct Operand {
+    enum Kind { None,
+                Register,
+                Literal,
+                Column };
+    Kind kind = None;
+    size_t index = 0;
+    atype::type type = atype::NA;
+    LiteralNode::var_t literal;
+  };
+
+  /// native operation, reading operands converted to operandType
+  struct Instruction {
+    BasicOp op;
+    atype::type type = atype::NA;
+    atype::type operandType = atype::NA;
+    Operand left;
+    Operand right;
+    Operand condition;
+    size_t result = 0;
+  };
+
+  struct Program {
+    std::vector<Instruction> instructions; // in evaluation order
+    size_t nRegisters = 0;
+  };
+
+ private:
+  bool lower(Operations const& opSpecs, Program& program);
+  bool evaluateNative(arrow::Table const& table, gandiva::SelectionVector& selection) const;
+
+  std::vector<Program> mPrograms;
+  std::vector<std::string> mColumnNames;
+  std::vector<atype::type> mColumnTypes;
+  bool mNative = true;
+  gandiva::NodePtr mTree = nullptr;
+  gandiva::FilterPtr mFallback = nullptr;
+};
 } // namespace o2::framework::expressions
 
 #endif // O2_FRAMEWORK_EXPRESSIONS_HELPERS_H_
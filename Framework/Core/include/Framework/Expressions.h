@@ -48,6 +48,12 @@ using Selection = std::shared_ptr<gandiva::SelectionVector>;
 using FilterPtr = std::shared_ptr<gandiva::Filter>;
 } // namespace gandiva
 
+namespace o2::framework::expressions
+{
+class NativeFilter;
+using NativeFilterPtr = std::shared_ptr<NativeFilter>;
+} // namespace o2::framework::expressions
+
 using atype = arrow::Type;
 struct ExpressionInfo {
   int argumentIndex;
@@ -56,6 +62,7 @@ struct ExpressionInfo {
   gandiva::SchemaPtr schema;
   gandiva::NodePtr tree;
   gandiva::FilterPtr filter;
+  o2::framework::expressions::NativeFilterPtr native;
   gandiva::Selection selection;
   bool resetSelection = false;
 };
@@ -437,6 +444,8 @@ using Projector = Filter;
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, Filter const& expression);
 /// Function for creating gandiva selection from prepared gandiva expressions tree
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Filter> const& gfilter);
+/// Function for creating gandiva selection with a native filter
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, NativeFilterPtr const& nfilter);
 
 struct ColumnOperationSpec;
 using Operations = std::vector<ColumnOperationSpec>;
@@ -455,6 +464,9 @@ std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
 /// Function to create gandiva filter from operation sequence
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               Operations const& opSpecs);
+/// Function to create native filter from operation sequence, falling back to gandiva when needed
+NativeFilterPtr createNativeFilter(gandiva::SchemaPtr const& Schema,
+                                   Operations const& opSpecs);
 /// Function to create gandiva projector from operation sequence
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Operations const& opSpecs,
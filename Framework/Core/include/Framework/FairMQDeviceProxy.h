@@ -90,6 +90,14 @@ class FairMQDeviceProxy
 
   [[nodiscard]] bool newStateRequested() const { return mStateChangeCallback(); }
 
+  /// Select the output routes whose payloads are carved from the arena of their transport,
+  /// see o2::pmr::ArenaMemoryResource. Shared by all the streams of the device, to be done in init.
+  void useArena(RouteIndex routeIndex, bool use = true);
+  [[nodiscard]] bool usesArena(RouteIndex routeIndex) const
+  {
+    return routeIndex.value >= 0 && size_t(routeIndex.value) < mArenaRoutes.size() && mArenaRoutes[routeIndex.value];
+  }
+
  private:
   std::vector<OutputRoute> mOutputs;
   std::vector<RouteState> mOutputRoutes;
@@ -107,6 +115,7 @@ class FairMQDeviceProxy
   std::vector<ForwardChannelState> mForwardChannelStates;
 
   std::function<bool()> mStateChangeCallback;
+  std::vector<bool> mArenaRoutes;
 };
 
 } // namespace o2::framework
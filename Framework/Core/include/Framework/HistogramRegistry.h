@@ -26,7 +26,9 @@
 #include <TDataMember.h>
 #include <TDataType.h>
 
+#include <array>
 #include <deque>
+#include <vector>
 
 class TList;
 
@@ -34,6 +36,27 @@ class TList;
 
 namespace o2::framework
 {
+//**************************************************************************************************
+/**
+ * Entries of a 1-3 dimensional histogram collected for deferred filling. Coordinates and weights are stored in structure-of-arrays form.
+ */
+//**************************************************************************************************
+struct HistFillBuffer {
+  std::array<std::vector<double>, 3> coordinates{};
+  std::vector<double> weights{}; // only used for weighted fills
+  std::vector<uint32_t> bins{};  // scratch space for the bin indices
+  bool weighted{};
+
+  size_t size() const { return coordinates[0].size(); }
+  void clear()
+  {
+    for (auto& c : coordinates) {
+      c.clear();
+    }
+    weights.clear();
+  }
+};
+
 //**************************************************************************************************
 /**
  * Static helper class to fill root histograms of any type. Contains functionality to fill once per call or a whole (filtered) table at once.
@@ -48,6 +71,9 @@ struct HistFiller {
   template <typename... Cs, typename R, typename T>
   static void fillHistAny(std::shared_ptr<R> hist, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // fill the buffered entries into a TH1, TH2 or TH3 (nDim) with the same result as filling them one by one
+  static void fillHistBuffered(TH1* hist, int nDim, HistFillBuffer& buffer);
+
   // function that returns rough estimate for the size of a histogram in MB
   template <typename T>
   static double getSize(std::shared_ptr<T> hist, double fillFraction = 1.);
@@ -129,6 +155,13 @@ class HistogramRegistry
   template <typename... Cs, typename T>
   void fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // enable deferred filling of 1-3 dimensional histograms: entries are collected in buffers of the given capacity
+  // and filled in bulk when the buffer is full, at the end of each data frame or when the histogram is accessed
+  void setBufferedFilling(uint32_t capacity = 4096);
+
+  // fill all buffered entries into the histograms
+  void flush();
+
   // get rough estimate for size of histogram stored in registry
   double getSize(const HistName& histName, double fillFraction = 1.);
 
@@ -156,6 +189,13 @@ class HistogramRegistry
   template <typename T>
   uint32_t getHistIndex(const T& histName);
 
+  // add an entry to the fill buffer of the histogram at position idx
+  template <int nDim, typename... Ts>
+  void bufferEntry(uint32_t idx, const Ts&... positionAndWeight);
+
+  // fill the buffered entries of the histogram at position idx
+  void flush(uint32_t idx);
+
   constexpr uint32_t imask(uint32_t i) const
   {
     return i & REGISTRY_BITMASK;
@@ -183,6 +223,10 @@ class HistogramRegistry
   static constexpr uint32_t MAX_REGISTRY_SIZE{REGISTRY_BITMASK + 1};
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey{};
   std::array<HistPtr, MAX_REGISTRY_SIZE> mRegistryValue{};
+
+  // buffers for deferred filling, indexed like the histograms
+  uint32_t mFillBufferCapacity{};
+  std::vector<HistFillBuffer> mFillBuffers{};
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -360,7 +404,9 @@ std::shared_ptr<T> HistogramRegistry::add(char const* const name, char const* co
 template <typename T>
 std::shared_ptr<T> HistogramRegistry::get(const HistName& histName)
 {
-  if (auto histPtr = std::get_if<std::shared_ptr<T>>(&mRegistryValue[getHistIndex(histName)])) {
+  const auto idx = getHistIndex(histName);
+  flush(idx);
+  if (auto histPtr = std::get_if<std::shared_ptr<T>>(&mRegistryValue[idx])) {
     return *histPtr;
   } else {
     throw runtime_error_f(R"(Histogram type specified in get<>(HIST("%s")) does not match the actual type of the histogram!)", histName.str);
@@ -409,13 +455,60 @@ uint32_t HistogramRegistry::getHistIndex(const T& histName)
 template <typename... Ts>
 void HistogramRegistry::fill(const HistName& histName, Ts&&... positionAndWeight)
 {
-  std::visit([&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); }, mRegistryValue[getHistIndex(histName)]);
+  const auto idx = getHistIndex(histName);
+  std::visit([this, idx, &positionAndWeight...](auto&& hist) {
+    using H = typename std::decay_t<decltype(hist)>::element_type;
+    constexpr int nArgs = sizeof...(Ts);
+    constexpr int nDim = std::is_same_v<TH1, H> ? 1 : std::is_same_v<TH2, H> ? 2 : std::is_same_v<TH3, H> ? 3 : 0;
+    if constexpr (nDim > 0 && (nArgs == nDim || nArgs == nDim + 1)) {
+      if (mFillBufferCapacity > 0) {
+        bufferEntry<nDim>(idx, positionAndWeight...);
+        return;
+      }
+    }
+    if (mFillBufferCapacity > 0) {
+      flush(idx); // keep the order of the entries filled directly and the buffered ones
+    }
+    HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...);
+  },
+             mRegistryValue[idx]);
 }
 
 template <typename... Cs, typename T>
 void HistogramRegistry::fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter)
 {
-  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[getHistIndex(histName)]);
+  const auto idx = getHistIndex(histName);
+  flush(idx);
+  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[idx]);
+}
+
+template <int nDim, typename... Ts>
+void HistogramRegistry::bufferEntry(uint32_t idx, const Ts&... positionAndWeight)
+{
+  constexpr bool weighted = sizeof...(Ts) > nDim;
+  auto& buffer = mFillBuffers[idx];
+  if (buffer.size() >= mFillBufferCapacity || (buffer.size() > 0 && buffer.weighted != weighted)) {
+    flush(idx);
+  }
+  buffer.weighted = weighted;
+  if (buffer.coordinates[0].capacity() == 0) {
+    // allocate only for the histograms actually filled through the buffer
+    for (int d = 0; d < nDim; ++d) {
+      buffer.coordinates[d].reserve(mFillBufferCapacity);
+    }
+  }
+  if constexpr (weighted) {
+    if (buffer.weights.capacity() == 0) {
+      buffer.weights.reserve(mFillBufferCapacity);
+    }
+  }
+  const double values[] = {static_cast<double>(positionAndWeight)...};
+  for (int d = 0; d < nDim; ++d) {
+    buffer.coordinates[d].push_back(values[d]);
+  }
+  if constexpr (weighted) {
+    buffer.weights.push_back(values[nDim]);
+  }
 }
 
 } // namespace o2::framework
@@ -32,6 +32,7 @@
 #include <cstring>
 #include <cassert>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 
 #include <fairmq/FwdDecls.h>
@@ -346,7 +347,8 @@ class InputRecord
                          (is_messageable<PointerLessValueT>::value ||
                           has_root_dictionary<PointerLessValueT>::value ||
                           (is_specialization_v<PointerLessValueT, std::vector> && has_messageable_value_type<PointerLessValueT>::value) ||
-                          (has_root_dictionary_mapped_type<PointerLessValueT>::value))) {
+                          (has_root_dictionary_mapped_type<PointerLessValueT>::value) ||
+                          is_flat_object<PointerLessValueT>::value)) {
       // extract a messageable type or object with ROOT dictionary by pointer
       // return unique_ptr to message content with custom deleter
       using ValueT = PointerLessValueT;
@@ -379,14 +381,34 @@ class InputRecord
         // explicitely specify serialization method to ROOT-serialized because type T
         // is messageable and a different method would be deduced in DataRefUtils
         // return type with owning Deleter instance, forwarding to default_deleter
-        std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<ROOTSerialized<ValueT>>(ref).release());
-        return result;
+        if constexpr (!is_flat_object<ValueT>::value || has_root_dictionary<ValueT>::value) {
+          std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<ROOTSerialized<ValueT>>(ref).release());
+          return result;
+        } else {
+          throw runtime_error("Attempt to extract a flat object without ROOT dictionary from a ROOT serialized message");
+        }
       } else if (method == o2::header::gSerializationMethodCCDB) {
         // This is to support deserialising objects from CCDB. Contrary to what happens for
         // other objects, those objects are most likely long lived, so we
         // keep around an instance of the associated object and deserialise it only when
         // it's updated.
         // FIXME: add ability to apply callbacks to deserialised objects.
+        // Flat objects shipped as flat images are copied from the message with a
+        // pointer fix-up instead of the deserialisation. The payload is not modified,
+        // it may be shared with other consumers.
+        auto decode = [&ref]() -> ValueT* {
+          if constexpr (is_flat_object<ValueT>::value) {
+            auto size = DataRefUtils::getPayloadSize(ref);
+            if (ValueT::template isFlatImage<ValueT>(ref.payload, size)) {
+              return ValueT::template cloneFlatImage<ValueT>(ref.payload, size);
+            }
+          }
+          if constexpr (!is_flat_object<ValueT>::value || has_root_dictionary<ValueT>::value) {
+            return DataRefUtils::as<CCDBSerialized<ValueT>>(ref).release();
+          } else {
+            throw runtime_error("CCDB payload of a flat object without ROOT dictionary is not a flat image");
+          }
+        };
         auto id = ObjectCache::Id::fromRef(ref);
         ConcreteDataMatcher matcher{header->dataOrigin, header->dataDescription, header->subSpecification};
         // If the matcher does not have an entry in the cache, deserialise it
@@ -394,33 +416,50 @@ class InputRecord
         auto path = fmt::format("{}", DataSpecUtils::describe(matcher));
         LOGP(debug, "{}", path);
         auto& cache = mRegistry.get<ObjectCache>();
-        auto& callbacks = mRegistry.get<CallbackService>();
-        auto cacheEntry = cache.matcherToId.find(path);
-        if (cacheEntry == cache.matcherToId.end()) {
-          cache.matcherToId.insert(std::make_pair(path, id));
-          std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<CCDBSerialized<ValueT>>(ref).release(), false);
-          void* obj = (void*)result.get();
-          callbacks.call<CallbackService::Id::CCDBDeserialised>((ConcreteDataMatcher&)matcher, (void*)obj);
-          cache.idToObject[id] = obj;
-          LOGP(info, "Caching in {} ptr to {} ({})", id.value, path, obj);
-          return result;
+        std::shared_ptr<void> obj;
+        bool deserialised = false;
+        {
+          // The processing of different streams can run concurrently
+          std::lock_guard<std::mutex> lock(cache.mutex);
+          auto cacheEntry = cache.matcherToId.find(path);
+          if (cacheEntry != cache.matcherToId.end() && cacheEntry->second.value == id.value) {
+            // The id in the cache is the same, let's simply return it.
+            obj = cache.idToObject[id];
+            LOGP(debug, "Returning cached entry {} for {} ({})", id.value, path, obj.get());
+          } else if (auto old = cache.replaced.find(id); old != cache.replaced.end() && (obj = old->second.lock())) {
+            // A timeslice still being processed holds the object of this payload,
+            // e.g. with several streams while the condition is updated.
+            LOGP(debug, "Returning replaced entry {} for {} ({})", id.value, path, obj.get());
+          } else {
+            obj = std::shared_ptr<std::remove_const_t<ValueT>>(const_cast<std::remove_const_t<ValueT>*>(decode()));
+            deserialised = true;
+            cache.idToObject[id] = obj;
+            if (cacheEntry == cache.matcherToId.end()) {
+              cache.matcherToId.insert(std::make_pair(path, id));
+              LOGP(info, "Caching in {} ptr to {} ({})", id.value, path, obj.get());
+            } else {
+              // The id in the cache is different. The old object is destroyed once the
+              // timeslices which received it are done.
+              auto& oldId = cacheEntry->second;
+              auto oldObj = cache.idToObject.find(oldId);
+              if (oldObj != cache.idToObject.end()) {
+                cache.replaced[oldId] = oldObj->second;
+                cache.idToObject.erase(oldObj);
+              }
+              for (auto it = cache.replaced.begin(); it != cache.replaced.end();) {
+                it = it->second.expired() ? cache.replaced.erase(it) : std::next(it);
+              }
+              LOGP(info, "Replacing cached entry {} with {} for {} ({})", oldId.value, id.value, path, obj.get());
+              oldId.value = id.value;
+            }
+          }
         }
-        auto& oldId = cacheEntry->second;
-        // The id in the cache is the same, let's simply return it.
-        if (oldId.value == id.value) {
-          std::unique_ptr<ValueT const, Deleter<ValueT const>> result((ValueT const*)cache.idToObject[id], false);
-          LOGP(debug, "Returning cached entry {} for {} ({})", id.value, path, (void*)result.get());
-          return result;
+        // Keep the object until this record, i.e. the processing of the timeslice, is done.
+        mCachedObjects.push_back(obj);
+        if (deserialised) {
+          mRegistry.get<CallbackService>().call<CallbackService::Id::CCDBDeserialised>((ConcreteDataMatcher&)matcher, obj.get());
         }
-        // The id in the cache is different. Let's destroy the old cached entry
-        // and create a new one.
-        delete reinterpret_cast<ValueT*>(cache.idToObject[oldId]);
-        std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<CCDBSerialized<ValueT>>(ref).release(), false);
-        void* obj = (void*)result.get();
-        callbacks.call<CallbackService::Id::CCDBDeserialised>((ConcreteDataMatcher&)matcher, (void*)obj);
-        cache.idToObject[id] = obj;
-        LOGP(info, "Replacing cached entry {} with {} for {} ({})", oldId.value, id.value, path, obj);
-        oldId.value = id.value;
+        std::unique_ptr<ValueT const, Deleter<ValueT const>> result((ValueT const*)obj.get(), false);
         return result;
       } else {
         throw runtime_error("Attempt to extract object from message with unsupported serialization type");
@@ -664,6 +703,8 @@ class InputRecord
   ServiceRegistryRef mRegistry;
   std::vector<InputRoute> const& mInputsSchema;
   InputSpan& mSpan;
+  /// Objects of the ObjectCache returned by this record, kept alive as long as the record
+  mutable std::vector<std::shared_ptr<void>> mCachedObjects;
 };
 
 } // namespace o2::framework
@@ -12,6 +12,7 @@
 #define O2_FRAMEWORK_INPUTSPAN_H_
 
 #include "Framework/DataRef.h"
+#include <fairmq/FwdDecls.h>
 #include <functional>
 
 extern template class std::function<o2::framework::DataRef(size_t)>;
@@ -48,6 +49,14 @@ class InputSpan
   /// @a size is the number of elements in the span.
   InputSpan(std::function<DataRef(size_t, size_t)> getter, std::function<size_t(size_t)> nofPartsGetter, size_t size);
 
+  /// @a getter is the mapping between an element of the span referred by
+  /// index and the buffer associated.
+  /// @nofPartsGetter is the getter for the number of parts associated with an index
+  /// @payloadMessageGetter gives access to the message holding the payload of a part
+  /// @a size is the number of elements in the span.
+  InputSpan(std::function<DataRef(size_t, size_t)> getter, std::function<size_t(size_t)> nofPartsGetter,
+            std::function<fair::mq::Message const*(size_t, size_t)> payloadMessageGetter, size_t size);
+
   /// @a i-th element of the InputSpan
   [[nodiscard]] DataRef get(size_t i, size_t partidx = 0) const
   {
@@ -66,6 +75,17 @@ class InputSpan
     return mNofPartsGetter(i);
   }
 
+  /// The message holding the payload of part @a partidx of the @a i-th element,
+  /// nullptr if the underlying store does not provide messages or there is no payload.
+  /// Can be used to forward the payload without copying it.
+  [[nodiscard]] fair::mq::Message const* payloadMessage(size_t i, size_t partidx = 0) const
+  {
+    if (!mPayloadMessageGetter || i >= mSize) {
+      return nullptr;
+    }
+    return mPayloadMessageGetter(i, partidx);
+  }
+
   /// Number of elements in the InputSpan
   [[nodiscard]] size_t size() const
   {
@@ -236,6 +256,7 @@ class InputSpan
  private:
   std::function<DataRef(size_t, size_t)> mGetter;
   std::function<size_t(size_t)> mNofPartsGetter;
+  std::function<fair::mq::Message const*(size_t, size_t)> mPayloadMessageGetter;
   size_t mSize;
 };
 
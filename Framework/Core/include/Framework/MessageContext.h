@@ -23,12 +23,14 @@
 #include "Headers/DataHeader.h"
 #include "Headers/Stack.h"
 #include "MemoryResources/MemoryResources.h"
+#include "MemoryResources/ArenaMemoryResource.h"
 
 #include <fairmq/Message.h>
 #include <fairmq/Parts.h>
 
 #include <cassert>
 #include <functional>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -261,7 +263,7 @@ class MessageContext
         // the transport factory
         mFactory{context->proxy().getOutputTransport(routeIndex)},
         // the memory resource takes ownership of the message
-        mResource{mFactory ? AlignedMemoryResource(mFactory->GetMemoryResource()) : AlignedMemoryResource(nullptr)},
+        mResource{mFactory ? AlignedMemoryResource(context->getOutputResource(routeIndex)) : AlignedMemoryResource(nullptr)},
         // create the vector with apropriate underlying memory resource for the message
         mData{std::forward<Args>(args)..., pmr::polymorphic_allocator<value_type>(&mResource)}
     {
@@ -524,6 +526,17 @@ class MessageContext
   fair::mq::MessagePtr createMessage(RouteIndex routeIndex, int index, size_t size);
   fair::mq::MessagePtr createMessage(RouteIndex routeIndex, int index, void* data, size_t size, fair::mq::FreeFn* ffn, void* hint);
 
+  /// the payloads of the route are carved from the arena of its transport instead of creating
+  /// a message for each of them, see FairMQDeviceProxy::useArena
+  [[nodiscard]] bool usesArena(RouteIndex routeIndex) const;
+  /// size of the regions of the arenas created from now on
+  void setArenaRegionSize(size_t size)
+  {
+    mArenaRegionSize = size;
+  }
+  /// the memory resource providing the payloads of the route
+  o2::pmr::FairMQMemoryResource* getOutputResource(RouteIndex routeIndex);
+
   /// return the headers of the 1st (from the end) matching message checking first in mMessages then in mScheduledMessages
   o2::header::DataHeader* findMessageHeader(const Output& spec);
   o2::header::Stack* findMessageHeaderStack(const Output& spec);
@@ -533,6 +546,10 @@ class MessageContext
 
  private:
   FairMQDeviceProxy& mProxy;
+  /// Arenas of the output transports, created on first use. Declared before the messages
+  /// which may still refer to them.
+  std::unordered_map<fair::mq::TransportFactory*, std::unique_ptr<o2::pmr::ArenaMemoryResource>> mArenas;
+  size_t mArenaRegionSize = o2::pmr::ArenaMemoryResource::DefaultRegionSize;
   Messages mMessages;
   Messages mScheduledMessages;
   bool mDidDispatch = false;
@@ -12,6 +12,8 @@
 #define O2_FRAMEWORK_OBJECTCACHE_H_
 
 #include "Framework/DataRef.h"
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace o2::framework
@@ -45,7 +47,14 @@ struct ObjectCache {
   std::unordered_map<std::string, Id> matcherToId;
   /// A map from a CacheId (which is the void* ptr of the previous map).
   /// to an actual (type erased) pointer to the deserialised object.
-  std::unordered_map<Id, void*, Id::hash_fn> idToObject;
+  /// The InputRecords which received the object share its ownership.
+  std::unordered_map<Id, std::shared_ptr<void>, Id::hash_fn> idToObject;
+  /// Objects replaced by a newer payload. They stay alive as long as the InputRecord
+  /// of a timeslice being processed holds them, and its message keeps the payload,
+  /// so that the address used as id cannot be reused meanwhile.
+  std::unordered_map<Id, std::weak_ptr<void>, Id::hash_fn> replaced;
+  /// Protects the cache when several streams process concurrently
+  std::mutex mutex;
 };
 
 } // namespace o2::framework
@@ -59,6 +59,10 @@ struct StreamContext {
   // Notice that in such a case all the services will be created upfront, so
   // the callback will be called for all of them.
   std::vector<ServiceStartStreamHandle> preStartStreamHandles;
+
+  /// Wether or not the processing of a timeslice handed to the thread pool by
+  /// this stream is still ongoing, in which case the stream cannot dispatch more.
+  bool processingInFlight = false;
 };
 
 } // namespace o2::framework
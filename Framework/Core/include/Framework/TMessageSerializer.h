@@ -48,6 +48,28 @@ class FairTMessage : public TMessage
   static void free(void* /*data*/, void* hint);
 };
 
+/// A TMessage which streams directly into the memory of a fair::mq::Message.
+/// Whenever ROOT needs to expand the buffer, the message is rebuilt with
+/// the new size, so that the serialized object is written only once in the
+/// (possibly shared) memory owned by the transport.
+class FairOutputTMessage : public FairTMessage
+{
+ public:
+  FairOutputTMessage(fair::mq::Message& msg, size_t initialSize = 4096);
+  ~FairOutputTMessage() override;
+  // set the used size of the message to the actual serialized length
+  void finalise();
+
+ private:
+  // ROOT realloc hook, which has no user data: the message being expanded is
+  // the one of the FairOutputTMessage currently active in the calling thread.
+  static char* reallocMessage(char* oldData, size_t newSize, size_t oldSize);
+
+  fair::mq::Message& mMessage;
+  FairOutputTMessage* mPrevious = nullptr;
+  static thread_local FairOutputTMessage* sActive;
+};
+
 struct TMessageSerializer {
   using StreamerList = std::vector<TVirtualStreamerInfo*>;
   using CompressionLevel = int;
@@ -175,12 +197,11 @@ inline void TMessageSerializer::Serialize(fair::mq::Message& msg, const TObject*
                                           TMessageSerializer::CacheStreamers streamers,
                                           TMessageSerializer::CompressionLevel compressionLevel)
 {
-  std::unique_ptr<FairTMessage> tm = std::make_unique<FairTMessage>(kMESS_OBJECT);
+  FairOutputTMessage tm(msg);
 
-  serialize(*tm, input, input->Class(), streamers, compressionLevel);
+  serialize(tm, input, input->Class(), streamers, compressionLevel);
 
-  msg.Rebuild(tm->Buffer(), tm->BufferSize(), FairTMessage::free, tm.get());
-  tm.release();
+  tm.finalise();
 }
 
 template <typename T>
@@ -189,12 +210,11 @@ inline void TMessageSerializer::Serialize(fair::mq::Message& msg, const T* input
                                           TMessageSerializer::CacheStreamers streamers, //
                                           TMessageSerializer::CompressionLevel compressionLevel)
 {
-  std::unique_ptr<FairTMessage> tm = std::make_unique<FairTMessage>(kMESS_OBJECT);
+  FairOutputTMessage tm(msg);
 
-  serialize(*tm, input, cl, streamers, compressionLevel);
+  serialize(tm, input, cl, streamers, compressionLevel);
 
-  msg.Rebuild(tm->Buffer(), tm->BufferSize(), FairTMessage::free, tm.get());
-  tm.release();
+  tm.finalise();
 }
 
 template <typename T>
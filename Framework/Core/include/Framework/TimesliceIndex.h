@@ -20,6 +20,7 @@
 #include "Framework/ChannelInfo.h"
 
 #include <cstdint>
+#include <set>
 #include <vector>
 #include <algorithm>
 
@@ -131,6 +132,12 @@ class TimesliceIndex
   [[nodiscard]] OldestInputInfo getOldestPossibleInput() const;
   [[nodiscard]] OldestOutputInfo getOldestPossibleOutput() const;
   OldestOutputInfo updateOldestPossibleOutput();
+  /// The inputs of @a timeslice were consumed, but its outputs are not sent yet
+  /// (e.g. because it is processed by another stream), so the oldest possible
+  /// output cannot go past it until markProcessed is called.
+  void markInFlight(TimesliceId timeslice);
+  /// The outputs of @a timeslice, previously marked in flight, were sent.
+  void markProcessed(TimesliceId timeslice);
   [[nodiscard]] InputChannelInfo const& getChannelInfo(ChannelIndex channel) const;
 
  private:
@@ -155,6 +162,8 @@ class TimesliceIndex
   /// By default we use -1, which means that we don't have any.
   OldestInputInfo mOldestPossibleInput = {};
   OldestOutputInfo mOldestPossibleOutput = {};
+  /// Timeslices consumed whose outputs are not sent yet.
+  std::multiset<size_t> mInFlight;
 
   /// What to do in case of backpressure
   BackpressureOp mBackpressurePolicy = BackpressureOp::Wait;
@@ -0,0 +1,157 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_TIMESLICETRACING_H_
+#define O2_FRAMEWORK_TIMESLICETRACING_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// The phases a timeslice goes through in a device.
+enum struct TimeslicePhase : int {
+  Receive,      /// Validating and relaying a batch of incoming messages
+  RelayWait,    /// From the first input of a timeslice being relayed to the timeslice being complete
+  Completion,   /// From the timeslice being complete to the start of the processing callback
+  Callback,     /// The processing callback, including the services pre / post processing
+  Send,         /// Sending the outputs, including the blocking on downstream devices
+  Backpressure, /// An input channel being backpressured by the relayer
+  Count
+};
+
+/// Snapshot of a LatencyHistogram, which can be accumulated and queried.
+struct LatencySnapshot {
+  static constexpr int SubBits = 4;
+  static constexpr int SubBuckets = 1 << SubBits;
+  static constexpr int NBuckets = (64 - SubBits + 1) * SubBuckets;
+
+  /// Bucket of a value: exact below SubBuckets, then SubBuckets buckets per power of two,
+  /// i.e. a relative precision better than 1 / SubBuckets over the whole range.
+  static int bucket(uint64_t value)
+  {
+    if (value < SubBuckets) {
+      return value;
+    }
+    int shift = 63 - __builtin_clzll(value) - SubBits;
+    return (shift + 1) * SubBuckets + int((value >> shift) - SubBuckets);
+  }
+  /// Smallest value falling in the bucket
+  static uint64_t lowerBound(int bucket)
+  {
+    if (bucket < SubBuckets) {
+      return bucket;
+    }
+    int shift = bucket / SubBuckets - 1;
+    return uint64_t(SubBuckets + bucket % SubBuckets) << shift;
+  }
+  /// Largest value falling in the bucket
+  static uint64_t upperBound(int bucket) { return bucket + 1 < NBuckets ? lowerBound(bucket + 1) - 1 : UINT64_MAX; }
+
+  /// Value below which the fraction q of the entries is, up to the bucket precision
+  uint64_t quantile(double q) const;
+  void add(LatencySnapshot const& other);
+
+  std::array<uint64_t, NBuckets> counts = {};
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+};
+
+/// HDR-style latency histogram with log-linear buckets. The entries can be
+/// recorded concurrently from any thread, drain() takes them out for publishing.
+struct LatencyHistogram {
+  void record(uint64_t value)
+  {
+    counts[LatencySnapshot::bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    auto previous = max.load(std::memory_order_relaxed);
+    while (previous < value && !max.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+  }
+  /// Move the entries recorded so far to the snapshot and reset the histogram
+  LatencySnapshot drain();
+
+  std::array<std::atomic<uint64_t>, LatencySnapshot::NBuckets> counts = {};
+  std::atomic<uint64_t> count = 0;
+  std::atomic<uint64_t> sum = 0;
+  std::atomic<uint64_t> max = 0;
+};
+
+/// Latency histograms for the phases of the timeslices processed by a device,
+/// with an optional per timeslice trace. The trace is dumped in the Chrome trace
+/// event format with the timestamps in microseconds since epoch, so that the
+/// dumps of different devices can be merged to follow a timeslice through
+/// the topology and find the critical path.
+/// The durations are in nanoseconds, measured with uv_hrtime(), the histograms in microseconds.
+struct TimesliceTracing {
+  static constexpr size_t DefaultTraceCapacity = 1 << 20;
+
+  /// Name of the phase, as used in the metrics and in the trace
+  static char const* phaseName(TimeslicePhase phase);
+
+  /// Record a phase of the given timeslice between start and end, -1 if the timeslice is not known
+  void record(TimeslicePhase phase, size_t timeslice, uint64_t start, uint64_t end);
+  /// Follow the timeslices from their first relayed input to their dispatching, to record
+  /// the relay wait and the completion. Otherwise the calls below do nothing.
+  void enableRelayWait() { mRelayWaitEnabled = true; }
+  bool relayWaitEnabled() const { return mRelayWaitEnabled; }
+  /// The first input of the timeslice was relayed at the given time
+  void inputRelayed(size_t timeslice, uint64_t when);
+  /// The timeslice was found complete at the given time, records the relay wait
+  void timesliceReady(size_t timeslice, uint64_t when);
+  /// The processing callback of the timeslice starts at the given time, records the completion
+  void timesliceDispatched(size_t timeslice, uint64_t when);
+  /// The inputs of the timeslice were dropped by the relayer, it will not complete
+  void timesliceDropped(size_t timeslice);
+  /// Forget the timeslices older than the oldest possible output, which can not be pending anymore
+  void pruneBefore(size_t oldestPossibleTimeslice);
+
+  /// Keep the trace of the timeslices, to be dumped to the given file. Up to capacity
+  /// phases are kept, the following ones are dropped.
+  void enableTrace(std::string const& device, std::string const& fileName, size_t capacity = DefaultTraceCapacity);
+  /// Write the trace, if enabled, and restart it empty. Returns false on failure
+  bool dumpTrace();
+
+  std::array<LatencyHistogram, (int)TimeslicePhase::Count> histograms;
+  /// Last time the histograms were drained for publishing, in ns
+  std::atomic<uint64_t> lastDrained = 0;
+
+ private:
+  struct TraceEvent {
+    size_t timeslice;
+    uint64_t start;
+    uint64_t end;
+    TimeslicePhase phase;
+  };
+
+  std::mutex mMutex;
+  bool mRelayWaitEnabled = false;
+  std::map<size_t, uint64_t> mFirstInput; ///< time of the first relayed input per pending timeslice
+  std::map<size_t, uint64_t> mReady;      ///< time at which the timeslice was found complete
+  bool mTraceEnabled = false;
+  size_t mTraceCapacity = 0;
+  size_t mTraceDropped = 0;
+  std::vector<TraceEvent> mTrace;
+  std::string mDevice;
+  std::string mTraceFile;
+  int64_t mEpochOffset = 0; ///< to convert uv_hrtime() to ns since epoch
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_TIMESLICETRACING_H_
@@ -147,6 +147,23 @@ class has_root_dictionary<T, typename std::enable_if<is_container<T>::value>::ty
 {
 };
 
+// Detect whether a class is a flat object (o2::gpu::FlatObject) which can be
+// copied from a flat image, i.e. without ROOT deserialisation.
+// The member detector looks for the 'cloneFlatImage<T>()' static template method.
+template <typename T, typename _ = void>
+struct is_flat_object : std::false_type {
+};
+
+template <typename T>
+struct is_flat_object<
+  T,
+  std::conditional_t<
+    false,
+    class_member_checker<
+      decltype(T::template cloneFlatImage<T>(std::declval<char const*>(), size_t{0}))>,
+    void>> : public std::true_type {
+};
+
 // Detect whether a class is a ROOT class implementing SetOwner
 // This member detector idiom is implemented using SFINAE idiom to look for
 // a 'SetOwner()' method.
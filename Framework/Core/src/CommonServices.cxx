@@ -654,6 +654,8 @@ auto flushMetrics(ServiceRegistryRef registry, DataProcessingStats& stats) -> vo
   auto& monitoring = registry.get<Monitoring>();
   auto& relayer = registry.get<DataRelayer>();
 
+  // The latency quantiles are computed over the same interval they are published at
+  stats.updatePhaseLatencies(5000);
   // Send all the relevant metrics for the relayer to update the GUI
   stats.flushChangedMetrics([&monitoring](DataProcessingStats::MetricSpec const& spec, int64_t timestamp, int64_t value) mutable -> void {
     // convert timestamp to a time_point
@@ -920,6 +922,31 @@ o2::framework::ServiceSpec CommonServices::dataProcessingStats()
         stats->registerMetric(metric);
       }
 
+      // The relay wait and the completion need a per message bookkeeping of the pending timeslices,
+      // only done online when the timeslices are traced.
+      bool relayWaitLatency = arrowAndResourceLimitingMetrics || getenv("DPL_TIMESLICE_TRACE");
+      if (relayWaitLatency) {
+        stats->tracing.enableRelayWait();
+      }
+      // Quantiles of the latency of each phase of the timeslices, in microseconds
+      auto const& quantiles = DataProcessingStats::PHASE_LATENCY_QUANTILES;
+      for (int pi = 0; pi < (int)TimeslicePhase::Count; ++pi) {
+        bool needsRelayWait = pi == (int)TimeslicePhase::RelayWait || pi == (int)TimeslicePhase::Completion;
+        for (size_t qi = 0; qi < quantiles.size(); ++qi) {
+          auto phase = TimesliceTracing::phaseName((TimeslicePhase)pi);
+          stats->registerMetric(MetricSpec{.name = quantiles[qi] < 1 ? fmt::format("latency/{}/p{}_us", phase, (int)(quantiles[qi] * 100)) : fmt::format("latency/{}/max_us", phase),
+                                           .enabled = relayWaitLatency || !needsRelayWait,
+                                           .metricId = (int)(static_cast<int>(ProcessingStatsId::PHASE_LATENCY_BASE) + pi * quantiles.size() + qi),
+                                           .kind = Kind::UInt64,
+                                           .minPublishInterval = quickUpdateInterval});
+        }
+      }
+      // Per timeslice trace, which can be merged with the ones of the other devices
+      if (getenv("DPL_TIMESLICE_TRACE")) {
+        auto& spec = services.get<DeviceSpec const>();
+        stats->tracing.enableTrace(spec.id, fmt::format("{}/{}-timeslice-trace.json", getenv("DPL_TIMESLICE_TRACE"), spec.id));
+      }
+
       return ServiceHandle{TypeIdHelpers::uniqueId<DataProcessingStats>(), stats};
     },
     .configure = noConfiguration(),
@@ -946,6 +973,9 @@ o2::framework::ServiceSpec CommonServices::dataProcessingStats()
     .postDispatching = [](ProcessingContext& context, void* service) {
       auto* stats = (DataProcessingStats*)service;
       flushMetrics(context.services(), *stats); },
+    .stop = [](ServiceRegistryRef, void* service) {
+      auto* stats = (DataProcessingStats*)service;
+      stats->tracing.dumpTrace(); },
     .preLoop = [](ServiceRegistryRef ref, void* service) {
       auto* stats = (DataProcessingStats*)service;
       flushMetrics(ref, *stats); },
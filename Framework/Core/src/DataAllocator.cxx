@@ -19,6 +19,7 @@
 #include "Framework/FairMQResizableBuffer.h"
 #include "Framework/DataProcessingContext.h"
 #include "Framework/DeviceSpec.h"
+#include "Framework/FairMQDeviceProxy.h"
 #include "Headers/Stack.h"
 
 #include <fairmq/Device.h>
@@ -274,16 +275,36 @@ void DataAllocator::adopt(const Output& spec, std::shared_ptr<arrow::Table> ptr)
 void DataAllocator::snapshot(const Output& spec, const char* payload, size_t payloadSize,
                              o2::header::SerializationMethod serializationMethod)
 {
-  auto& proxy = mRegistry.get<FairMQDeviceProxy>();
+  auto& context = mRegistry.get<MessageContext>();
   auto& timingInfo = mRegistry.get<TimingInfo>();
 
   RouteIndex routeIndex = matchDataHeader(spec, timingInfo.timeslice);
-  fair::mq::MessagePtr payloadMessage(proxy.createOutputMessage(routeIndex, payloadSize));
+  fair::mq::MessagePtr payloadMessage(context.createMessage(routeIndex, 0, payloadSize));
   memcpy(payloadMessage->GetData(), payload, payloadSize);
 
   addPartToContext(std::move(payloadMessage), spec, serializationMethod);
 }
 
+void DataAllocator::forward(const Output& spec, fair::mq::Message const& payload,
+                            o2::header::SerializationMethod serializationMethod)
+{
+  auto& proxy = mRegistry.get<FairMQDeviceProxy>();
+  auto& timingInfo = mRegistry.get<TimingInfo>();
+
+  RouteIndex routeIndex = matchDataHeader(spec, timingInfo.timeslice);
+  fair::mq::MessagePtr payloadMessage;
+  if (payload.GetType() == proxy.getOutputTransport(routeIndex)->GetType()) {
+    // refcounted, the buffer is released when the last reference is gone
+    payloadMessage = proxy.createOutputMessage(routeIndex);
+    payloadMessage->Copy(payload);
+  } else {
+    payloadMessage = proxy.createOutputMessage(routeIndex, payload.GetSize());
+    memcpy(payloadMessage->GetData(), payload.GetData(), payload.GetSize());
+  }
+
+  addPartToContext(std::move(payloadMessage), spec, serializationMethod);
+}
+
 Output DataAllocator::getOutputByBind(OutputRef&& ref)
 {
   if (ref.label.empty()) {
@@ -305,6 +326,23 @@ Output DataAllocator::getOutputByBind(OutputRef&& ref)
   O2_BUILTIN_UNREACHABLE();
 }
 
+void DataAllocator::useArena(const Output& spec, bool use)
+{
+  auto& allowedOutputRoutes = mRegistry.get<DeviceSpec const>().outputs;
+  auto& proxy = mRegistry.get<FairMQDeviceProxy>();
+  bool matched = false;
+  for (auto ri = 0; ri < allowedOutputRoutes.size(); ++ri) {
+    if (DataSpecUtils::match(allowedOutputRoutes[ri].matcher, spec.origin, spec.description, spec.subSpec)) {
+      proxy.useArena(RouteIndex{ri}, use);
+      matched = true;
+    }
+  }
+  if (!matched) {
+    throw runtime_error_f("Worker is not authorised to create message with origin(%s) description(%s) subSpec(%d)",
+                          spec.origin.as<std::string>().c_str(), spec.description.as<std::string>().c_str(), spec.subSpec);
+  }
+}
+
 bool DataAllocator::isAllowed(Output const& query)
 {
   auto& allowedOutputRoutes = mRegistry.get<DeviceSpec const>().outputs;
@@ -74,6 +74,7 @@
 #include <vector>
 #include <numeric>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <uv.h>
 #include <execinfo.h>
@@ -174,9 +175,22 @@ DataProcessingDevice::DataProcessingDevice(RunningDeviceRef running, ServiceRegi
 
   this->SubscribeToStateChange("dpl", stateWatcher);
 
-  // One task for now.
-  mStreams.resize(1);
-  mHandles.resize(1);
+  // Number of timeslices which can be processed concurrently by this device.
+  // Each stream gets its own set of Stream services, while Global / Serial
+  // ones (e.g. geometry, CCDB objects, magnetic field) are shared.
+  auto nStreams = std::max(1, std::stoi(GetConfig()->GetProperty<std::string>("dpl-streams", "1")));
+  if (nStreams > 1) {
+    // libuv sizes its threadpool from UV_THREADPOOL_SIZE (default 4) when it is first
+    // used, possibly before this point, so the driver sets it in the environment of the
+    // device (see DeviceSpecHelpers::prepareArguments). Changing it here would have no effect.
+    auto poolSize = getenv("UV_THREADPOOL_SIZE") ? std::stoi(getenv("UV_THREADPOOL_SIZE")) : 4;
+    if (poolSize < nStreams) {
+      LOGP(warn, "UV_THREADPOOL_SIZE={} is smaller than the {} processing streams, they will not all run concurrently", poolSize, nStreams);
+    }
+    LOGP(info, "Device configured with {} concurrent processing streams", nStreams);
+  }
+  mStreams.resize(nStreams);
+  mHandles.resize(nStreams);
 
   ServiceRegistryRef ref{mServiceRegistry};
   mAwakeHandle = (uv_async_t*)malloc(sizeof(uv_async_t));
@@ -198,9 +212,26 @@ DataProcessingDevice::DataProcessingDevice(RunningDeviceRef running, ServiceRegi
   });
 }
 
-// Callback to execute the processing. Notice how the data is
-// is a vector of DataProcessorContext so that we can index the correct
-// one with the thread id. For the moment we simply use the first one.
+// Runs on the thread pool the processing callback handed over by a stream.
+void run_offloaded(uv_work_t* handle)
+{
+  ZoneScopedN("run_offloaded");
+  auto* task = (TaskStreamInfo*)handle->data;
+  task->process();
+}
+
+// Back on the main loop once the offloaded processing is done. The completion
+// of the stream waits for the ones scheduled before it.
+void offloaded_completion(uv_work_t* handle, int status)
+{
+  auto* task = (TaskStreamInfo*)handle->data;
+  task->processed = true;
+  task->device->runCompletions();
+}
+
+// Callback to prepare the inputs and dispatch the computations. This always
+// runs on the main loop, only the processing callbacks themselves are handed
+// to the thread pool when the device has more than one stream.
 void run_callback(uv_work_t* handle)
 {
   ZoneScopedN("run_callback");
@@ -1012,6 +1043,12 @@ void DataProcessingDevice::fillContext(DataProcessorContext& context, DeviceCont
 
   // The policy is now allowed to state the default.
   context.balancingInputs = spec.completionPolicy.balanceChannels;
+  // With more than one stream, the processing callbacks are handed to the thread pool.
+  if (mStreams.size() > 1) {
+    context.scheduleProcessing = [this](std::function<void()> process, std::function<void()> complete) {
+      this->scheduleProcessing(std::move(process), std::move(complete));
+    };
+  }
   // This is needed because the internal injected dummy sink should not
   // try to balance inputs unless the rate limiting is requested.
   if (enableRateLimiting == false && spec.name == "internal-dpl-injected-dummy-sink") {
@@ -1252,13 +1289,15 @@ void DataProcessingDevice::Run()
         ref.get<DataRelayer>();
         // Get the current timeslice for the slot.
         auto& variables = ref.get<TimesliceIndex>().getVariablesForSlot(slot);
-        VariableContextHelpers::getTimeslice(variables);
+        auto timeslice = VariableContextHelpers::getTimeslice(variables);
+        ref.get<DataProcessingStats>().tracing.timesliceDropped(timeslice.value);
         forwardInputs(registry, slot, dropped, oldestOutputInfo, false, true);
       };
       auto& relayer = ref.get<DataRelayer>();
       relayer.prunePending(onDrop);
       auto& queue = ref.get<AsyncQueue>();
       auto oldestPossibleTimeslice = relayer.getOldestPossibleOutput();
+      ref.get<DataProcessingStats>().tracing.pruneBefore(oldestPossibleTimeslice.timeslice.value);
       AsyncQueueHelpers::run(queue, {oldestPossibleTimeslice.timeslice.value});
       if (shouldNotWait == false) {
         auto& dpContext = ref.get<DataProcessorContext>();
@@ -1341,13 +1380,16 @@ void DataProcessingDevice::Run()
         stream.id = streamRef;
         stream.running = true;
         stream.registry = &mServiceRegistry;
-#ifdef DPL_ENABLE_THREADING
-        stream.task.data = &handle;
-        uv_queue_work(state.loop, &stream.task, run_callback, run_completion);
-#else
+        stream.device = this;
+        // Receiving, relaying and dispatching always happen on the main loop.
+        // If the stream handed its processing to the thread pool, it is completed
+        // once the processing is done, see scheduleProcessing.
+        mDispatchingStream = streamRef.index;
         run_callback(&handle);
-        run_completion(&handle, 0);
-#endif
+        mDispatchingStream = -1;
+        if (!stream.process) {
+          run_completion(&handle, 0);
+        }
       } else {
         auto ref = ServiceRegistryRef{mServiceRegistry};
         ref.get<ComputingQuotaEvaluator>().handleExpired(reportExpiredOffer);
@@ -1358,6 +1400,10 @@ void DataProcessingDevice::Run()
     }
     FrameMark;
   }
+  // Make sure that no stream is still processing before we cleanup.
+  while (std::any_of(mStreams.begin(), mStreams.end(), [](TaskStreamInfo const& stream) { return stream.running; })) {
+    uv_run(state.loop, UV_RUN_ONCE);
+  }
   auto& spec = ref.get<DeviceSpec const>();
   /// Cleanup messages which are still pending on exit.
   for (size_t ci = 0; ci < spec.inputChannels.size(); ++ci) {
@@ -1526,6 +1572,47 @@ void DataProcessingDevice::doPrepare(ServiceRegistryRef ref)
   }
 }
 
+void DataProcessingDevice::scheduleProcessing(std::function<void()> process, std::function<void()> complete)
+{
+  ServiceRegistryRef ref{mServiceRegistry};
+  auto& context = ref.get<DataProcessorContext>();
+  context.pendingCompletions++;
+  if (!process) {
+    mPendingCompletions.push_back({std::move(complete), nullptr});
+    runCompletions();
+    return;
+  }
+  assert(mDispatchingStream != -1);
+  auto& stream = mStreams[mDispatchingStream];
+  stream.process = std::move(process);
+  stream.processed = false;
+  stream.task.data = &stream;
+  mPendingCompletions.push_back({std::move(complete), &stream});
+  uv_queue_work(ref.get<DeviceState>().loop, &stream.task, run_offloaded, offloaded_completion);
+}
+
+void DataProcessingDevice::runCompletions()
+{
+  ServiceRegistryRef ref{mServiceRegistry};
+  auto& context = ref.get<DataProcessorContext>();
+  while (mPendingCompletions.empty() == false) {
+    auto& pending = mPendingCompletions.front();
+    if (pending.stream && pending.stream->processed == false) {
+      return;
+    }
+    auto complete = std::move(pending.complete);
+    auto* stream = pending.stream;
+    mPendingCompletions.pop_front();
+    context.pendingCompletions--;
+    complete();
+    if (stream) {
+      stream->process = nullptr;
+      stream->processed = false;
+      run_completion(&stream->task, 0);
+    }
+  }
+}
+
 void DataProcessingDevice::doRun(ServiceRegistryRef ref)
 {
   auto& context = ref.get<DataProcessorContext>();
@@ -1569,6 +1656,12 @@ void DataProcessingDevice::doRun(ServiceRegistryRef ref)
     *context.wasActive = true;
   }
 
+  if (state.streaming == StreamingState::EndOfStreaming && context.pendingCompletions > 0) {
+    LOGP(detail, "We are in EndOfStreaming. Waiting for {} timeslices to complete.", context.pendingCompletions);
+    *context.wasActive = true;
+    return;
+  }
+
   if (state.streaming == StreamingState::EndOfStreaming) {
     LOGP(detail, "We are in EndOfStreaming. Flushing queues.");
     // We keep processing data until we are Idle.
@@ -1752,7 +1845,9 @@ void DataProcessingDevice::handleData(ServiceRegistryRef ref, InputChannelInfo&
     stats.updateStats({(int)ProcessingStatsId::ERROR_COUNT, DataProcessingStats::Op::Add, 1});
   };
 
-  auto handleValidMessages = [&info, ref, &reportError](std::vector<InputInfo> const& inputInfos) {
+  // The timeslice of the last relayed input, to attribute the receive phase
+  size_t receivedTimeslice = -1;
+  auto handleValidMessages = [&info, ref, &reportError, &receivedTimeslice](std::vector<InputInfo> const& inputInfos) {
     auto& relayer = ref.get<DataRelayer>();
     static WaitBackpressurePolicy policy;
     auto& parts = info.parts;
@@ -1801,7 +1896,8 @@ void DataProcessingDevice::handleData(ServiceRegistryRef ref, InputChannelInfo&
             ref.get<DataRelayer>();
             // Get the current timeslice for the slot.
             auto& variables = ref.get<TimesliceIndex>().getVariablesForSlot(slot);
-            VariableContextHelpers::getTimeslice(variables);
+            auto timeslice = VariableContextHelpers::getTimeslice(variables);
+            ref.get<DataProcessingStats>().tracing.timesliceDropped(timeslice.value);
             forwardInputs(ref, slot, dropped, oldestOutputInfo, false, true);
           };
           auto relayed = relayer.relay(parts.At(headerIndex)->GetData(),
@@ -1809,6 +1905,10 @@ void DataProcessingDevice::handleData(ServiceRegistryRef ref, InputChannelInfo&
                                        nMessages,
                                        nPayloadsPerHeader,
                                        onDrop);
+          if (relayed.type == DataRelayer::RelayChoice::Type::WillRelay) {
+            receivedTimeslice = relayed.timeslice.value;
+            ref.get<DataProcessingStats>().tracing.inputRelayed(receivedTimeslice, uv_hrtime());
+          }
           switch (relayed.type) {
             case DataRelayer::RelayChoice::Type::Backpressured:
               if (info.normalOpsNotified == true && info.backpressureNotified == false) {
@@ -1817,6 +1917,7 @@ void DataProcessingDevice::handleData(ServiceRegistryRef ref, InputChannelInfo&
                 monitoring.send(o2::monitoring::Metric{1, fmt::format("backpressure_{}", info.channel->GetName())});
                 info.backpressureNotified = true;
                 info.normalOpsNotified = false;
+                info.backpressureStart = uv_hrtime();
               }
               policy.backpressure(info);
               hasBackpressure = true;
@@ -1831,6 +1932,7 @@ void DataProcessingDevice::handleData(ServiceRegistryRef ref, InputChannelInfo&
                 monitoring.send(o2::monitoring::Metric{0, fmt::format("backpressure_{}", info.channel->GetName())});
                 info.normalOpsNotified = true;
                 info.backpressureNotified = false;
+                ref.get<DataProcessingStats>().tracing.record(TimeslicePhase::Backpressure, relayed.timeslice.value, info.backpressureStart, uv_hrtime());
               }
               break;
           }
@@ -1901,12 +2003,14 @@ void DataProcessingDevice::handleData(ServiceRegistryRef ref, InputChannelInfo&
   // messages). Notice also that we need to act diffently depending on the
   // actual CompletionOp we want to perform. In particular forwarding inputs
   // also gets rid of them from the cache.
+  uint64_t tStart = uv_hrtime();
   auto inputTypes = getInputTypes();
   if (bool(inputTypes) == false) {
     reportError("Parts should come in couples. Dropping it.");
     return;
   }
   handleValidMessages(*inputTypes);
+  ref.get<DataProcessingStats>().tracing.record(TimeslicePhase::Receive, receivedTimeslice, tStart, uv_hrtime());
   return;
 }
 
@@ -1964,11 +2068,16 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
   auto& context = ref.get<DataProcessorContext>();
   ZoneScopedN("DataProcessingDevice::tryDispatchComputation");
   LOGP(debug, "DataProcessingDevice::tryDispatchComputation");
-  // This is the actual hidden state for the outer loop. In case we decide we
-  // want to support multithreaded dispatching of operations, I can simply
-  // move these to some thread local store and the rest of the lambdas
-  // should work just fine.
-  std::vector<MessageSet> currentSetOfInputs;
+  // The processing of the timeslice was handed to the thread pool and this
+  // stream cannot dispatch anything else until it completes.
+  if (ref.get<StreamContext>().processingInFlight) {
+    return false;
+  }
+  // Outside of Streaming the processing is synchronous, and it must not overtake
+  // the timeslices still being processed on the thread pool.
+  if (context.pendingCompletions > 0 && ref.get<DeviceState>().streaming != StreamingState::Streaming) {
+    return false;
+  }
 
   // For the moment we have a simple "immediately dispatch" policy for stuff
   // in the cache. This could be controlled from the outside e.g. by waiting
@@ -1993,7 +2102,7 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
   };
 
   //
-  auto getInputSpan = [ref, &currentSetOfInputs](TimesliceSlot slot, bool consume = true) {
+  auto getInputSpan = [ref](TimesliceSlot slot, std::vector<MessageSet>& currentSetOfInputs, bool consume = true) {
     auto& relayer = ref.get<DataRelayer>();
     if (consume) {
       currentSetOfInputs = relayer.consumeAllInputsForTimeslice(slot);
@@ -2022,7 +2131,13 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
     auto nofPartsGetter = [&currentSetOfInputs](size_t i) -> size_t {
       return currentSetOfInputs[i].getNumberOfPairs();
     };
-    return InputSpan{getter, nofPartsGetter, currentSetOfInputs.size()};
+    auto payloadMessageGetter = [&currentSetOfInputs](size_t i, size_t partindex) -> fair::mq::Message const* {
+      if (currentSetOfInputs[i].getNumberOfPairs() > partindex) {
+        return currentSetOfInputs[i].associatedPayload(partindex).get();
+      }
+      return nullptr;
+    };
+    return InputSpan{getter, nofPartsGetter, payloadMessageGetter, currentSetOfInputs.size()};
   };
 
   auto markInputsAsDone = [ref](TimesliceSlot slot) -> void {
@@ -2063,7 +2178,7 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
   // to avoid double counting them.
   // This was actually the easiest solution we could find for
   // O2-646.
-  auto cleanTimers = [&currentSetOfInputs](TimesliceSlot slot, InputRecord& record) {
+  auto cleanTimers = [](std::vector<MessageSet>& currentSetOfInputs, InputRecord& record) {
     assert(record.size() == currentSetOfInputs.size());
     for (size_t ii = 0, ie = record.size(); ii < ie; ++ii) {
       // assuming that for timer inputs we do have exactly one PartRef object
@@ -2116,8 +2231,15 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
     LOGP(debug, "No computations available for dispatching.");
     return false;
   }
+  auto& tracing = ref.get<DataProcessingStats>().tracing;
+  uint64_t tReady = uv_hrtime();
+  for (auto const& action : completed) {
+    if (action.op != CompletionPolicy::CompletionOp::Wait) {
+      tracing.timesliceReady(action.timeslice.value, tReady);
+    }
+  }
 
-  auto postUpdateStats = [ref](DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t tStart, uint64_t tStartMilli) {
+  auto postUpdateStats = [ref](DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t tStart, uint64_t tEnd, uint64_t tStartMilli) {
     auto& stats = ref.get<DataProcessingStats>();
     auto& states = ref.get<DataProcessingStates>();
     std::atomic_thread_fence(std::memory_order_release);
@@ -2129,7 +2251,7 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
     }
     buffer[record.size()] = 0;
     states.updateState({.id = short((int)ProcessingStateId::DATA_RELAYER_BASE + action.slot.index), (int)(record.size() + buffer - relayerSlotState), relayerSlotState});
-    uint64_t tEnd = uv_hrtime();
+    stats.tracing.record(TimeslicePhase::Callback, action.timeslice.value, tStart, tEnd);
     stats.updateStats({(int)ProcessingStatsId::LAST_ELAPSED_TIME_MS, DataProcessingStats::Op::Set, (int64_t)(tEnd - tStart)});
     // The time interval is in seconds while tEnd - tStart is in nanoseconds, so we divide by 1000000 to get the fraction in ms/s.
     stats.updateStats({(short)ProcessingStatsId::CPU_USAGE_FRACTION, DataProcessingStats::Op::CumulativeRate, (int64_t)(tEnd - tStart) / 1000000});
@@ -2163,6 +2285,20 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
 
   auto& dpContext = ref.get<DataProcessorContext>();
   auto& streamContext = ref.get<StreamContext>();
+  // What an action needs once dispatched. This must outlive the dispatching
+  // when the processing is handed to the thread pool.
+  struct DispatchedAction {
+    std::vector<MessageSet> inputs;
+    std::optional<InputSpan> span;
+    std::optional<InputRecord> record;
+    std::optional<ProcessingContext> processContext;
+    bool quitRequested = false;
+    /// No processing callback, the device goes idle once the action completes
+    bool noProcessing = false;
+    /// Error raised by the processing, reported on the main loop
+    std::optional<RuntimeErrorRef> error;
+    uint64_t tEnd = 0;
+  };
   for (auto action : getReadyActions()) {
     LOGP(debug, "  Begin action");
     if (action.op == CompletionPolicy::CompletionOp::Wait) {
@@ -2182,12 +2318,14 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
     prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
     bool shouldConsume = action.op == CompletionPolicy::CompletionOp::Consume ||
                          action.op == CompletionPolicy::CompletionOp::Discard;
-    InputSpan span = getInputSpan(action.slot, shouldConsume);
+    auto dispatched = std::make_shared<DispatchedAction>();
+    auto& currentSetOfInputs = dispatched->inputs;
+    auto& span = dispatched->span.emplace(getInputSpan(action.slot, currentSetOfInputs, shouldConsume));
     auto& spec = ref.get<DeviceSpec const>();
-    InputRecord record{spec.inputs,
-                       span,
-                       *context.registry};
-    ProcessingContext processContext{record, ref, ref.get<DataAllocator>()};
+    auto& record = dispatched->record.emplace(spec.inputs,
+                                              span,
+                                              *context.registry);
+    auto& processContext = dispatched->processContext.emplace(record, ref, ref.get<DataAllocator>());
     {
       ZoneScopedN("service pre processing");
       // Notice this should be thread safe and reentrant
@@ -2199,8 +2337,16 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
       LOGP(debug, "  - Action is to Discard");
       context.postDispatchingCallbacks(processContext);
       if (spec.forwards.empty() == false) {
-        auto& timesliceIndex = ref.get<TimesliceIndex>();
-        forwardInputs(ref, action.slot, currentSetOfInputs, timesliceIndex.getOldestPossibleOutput(), false);
+        tracing.timesliceDispatched(action.timeslice.value, uv_hrtime());
+        auto forward = [ref, dispatched, action]() {
+          auto& timesliceIndex = ref.get<TimesliceIndex>();
+          forwardInputs(ref, action.slot, dispatched->inputs, timesliceIndex.getOldestPossibleOutput(), false);
+        };
+        if (context.scheduleProcessing) {
+          context.scheduleProcessing(nullptr, forward);
+        } else {
+          forward();
+        }
         continue;
       }
     }
@@ -2220,47 +2366,135 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
 
     uint64_t tStart = uv_hrtime();
     uint64_t tStartMilli = TimingHelpers::getRealtimeSinceEpochStandalone();
+    tracing.timesliceDispatched(action.timeslice.value, tStart);
     preUpdateStats(action, record, tStart);
 
     static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
 
-    auto runNoCatch = [&context, ref, &processContext](DataRelayer::RecordAction& action) mutable {
-      auto& state = ref.get<DeviceState>();
+    // The processing itself, which runs on the thread pool when the device has
+    // more than one stream. It must not touch the DeviceState, owned by the main loop.
+    dispatched->quitRequested = state.quitRequested;
+    auto runNoCatch = [&context, ref, dispatched](DataRelayer::RecordAction& action) mutable {
       auto& spec = ref.get<DeviceSpec const>();
       auto& streamContext = ref.get<StreamContext>();
       auto& dpContext = ref.get<DataProcessorContext>();
-      if (state.quitRequested == false) {
-        {
-          ZoneScopedN("service post processing");
-          // Callbacks from services
-          dpContext.preProcessingCallbacks(processContext);
-          streamContext.preProcessingCallbacks(processContext);
-          dpContext.preProcessingCallbacks(processContext);
-          // Callbacks from users
-          ref.get<CallbackService>().call<CallbackService::Id::PreProcessing>(o2::framework::ServiceRegistryRef{ref}, (int)action.op);
+      auto& processContext = *dispatched->processContext;
+      if (dispatched->quitRequested) {
+        return;
+      }
+      {
+        ZoneScopedN("service post processing");
+        // Callbacks from services
+        dpContext.preProcessingCallbacks(processContext);
+        streamContext.preProcessingCallbacks(processContext);
+        dpContext.preProcessingCallbacks(processContext);
+        // Callbacks from users
+        ref.get<CallbackService>().call<CallbackService::Id::PreProcessing>(o2::framework::ServiceRegistryRef{ref}, (int)action.op);
+      }
+      if (context.statefulProcess) {
+        ZoneScopedN("statefull process");
+        (context.statefulProcess)(processContext);
+      } else if (context.statelessProcess) {
+        ZoneScopedN("stateless process");
+        (context.statelessProcess)(processContext);
+      } else {
+        dispatched->noProcessing = true;
+      }
+
+      // Notify the sink we just consumed some timeframe data
+      if (context.isSink && action.op == CompletionPolicy::CompletionOp::Consume) {
+        auto& allocator = ref.get<DataAllocator>();
+        allocator.make<int>(OutputRef{"dpl-summary", compile_time_hash(spec.name.c_str())}, 1);
+      }
+    };
+
+    // The post processing of services and users, which sends the outputs.
+    // This always runs on the main loop, in the order of the dispatching.
+    auto runPostNoCatch = [ref, dispatched](DataRelayer::RecordAction& action) mutable {
+      if (dispatched->quitRequested) {
+        return;
+      }
+      auto& streamContext = ref.get<StreamContext>();
+      auto& dpContext = ref.get<DataProcessorContext>();
+      auto& processContext = *dispatched->processContext;
+      ZoneScopedN("service post processing");
+      ref.get<CallbackService>().call<CallbackService::Id::PostProcessing>(o2::framework::ServiceRegistryRef{ref}, (int)action.op);
+      dpContext.postProcessingCallbacks(processContext);
+      streamContext.postProcessingCallbacks(processContext);
+    };
+
+    // Returns the error raised by the callback, if any. The errors are reported
+    // by the completion, on the main loop.
+    auto runCatching = [](auto& callback, DataRelayer::RecordAction& action) -> std::optional<RuntimeErrorRef> {
+      if (noCatch) {
+        try {
+          callback(action);
+        } catch (o2::framework::RuntimeErrorRef e) {
+          return e;
         }
-        if (context.statefulProcess) {
-          ZoneScopedN("statefull process");
-          (context.statefulProcess)(processContext);
-        } else if (context.statelessProcess) {
-          ZoneScopedN("stateless process");
-          (context.statelessProcess)(processContext);
-        } else {
-          state.streaming = StreamingState::Idle;
+      } else {
+        try {
+          callback(action);
+        } catch (std::exception& ex) {
+          /// Convert a standard exception to a RuntimeErrorRef
+          /// Notice how this will lose the backtrace information
+          /// and report the exception coming from here.
+          return runtime_error(ex.what());
+        } catch (o2::framework::RuntimeErrorRef e) {
+          return e;
         }
+      }
+      return std::nullopt;
+    };
+    auto reportError = [&context](std::optional<RuntimeErrorRef> const& error, InputRecord& record) {
+      if (error) {
+        ZoneScopedN("error handling");
+        (context.errorHandling)(*error, record);
+      }
+    };
 
-        // Notify the sink we just consumed some timeframe data
-        if (context.isSink && action.op == CompletionPolicy::CompletionOp::Consume) {
-          auto& allocator = ref.get<DataAllocator>();
-          allocator.make<int>(OutputRef{"dpl-summary", compile_time_hash(spec.name.c_str())}, 1);
-        }
+    // With more than one stream, the processing is handed to the thread pool.
+    // Receiving, relaying and sending stay on the main loop.
+    bool offloaded = context.scheduleProcessing && state.streaming == StreamingState::Streaming;
 
-        {
-          ZoneScopedN("service post processing");
-          ref.get<CallbackService>().call<CallbackService::Id::PostProcessing>(o2::framework::ServiceRegistryRef{ref}, (int)action.op);
-          dpContext.postProcessingCallbacks(processContext);
-          streamContext.postProcessingCallbacks(processContext);
-        }
+    auto process = [dispatched, action, runNoCatch, runCatching]() mutable {
+      dispatched->error = runCatching(runNoCatch, action);
+      dispatched->tEnd = uv_hrtime();
+    };
+
+    auto complete = [=, &context]() mutable {
+      auto& record = *dispatched->record;
+      auto& processContext = *dispatched->processContext;
+      if (offloaded) {
+        ref.get<StreamContext>().processingInFlight = false;
+      }
+      reportError(dispatched->error, record);
+      if (dispatched->noProcessing) {
+        ref.get<DeviceState>().streaming = StreamingState::Idle;
+      }
+      reportError(runCatching(runPostNoCatch, action), record);
+      postUpdateStats(action, record, tStart, dispatched->tEnd, tStartMilli);
+      // We forward inputs only when we consume them. If we simply Process them,
+      // we keep them for next message arriving.
+      if (action.op == CompletionPolicy::CompletionOp::Consume) {
+        context.postDispatchingCallbacks(processContext);
+        ref.get<CallbackService>().call<CallbackService::Id::DataConsumed>(o2::framework::ServiceRegistryRef{ref});
+      }
+      if ((context.canForwardEarly == false) && hasForwards && consumeSomething) {
+        LOGP(debug, "Late forwarding");
+        auto& timesliceIndex = ref.get<TimesliceIndex>();
+        forwardInputs(ref, action.slot, dispatched->inputs, timesliceIndex.getOldestPossibleOutput(), false, action.op == CompletionPolicy::CompletionOp::Consume);
+      }
+      if (offloaded) {
+        ref.get<TimesliceIndex>().markProcessed(action.timeslice);
+      }
+      context.postForwardingCallbacks(processContext);
+      if (action.op == CompletionPolicy::CompletionOp::Consume) {
+#ifdef TRACY_ENABLE
+        cleanupRecord(record);
+#endif
+      } else if (action.op == CompletionPolicy::CompletionOp::Process) {
+        cleanTimers(dispatched->inputs, record);
       }
     };
 
@@ -2268,57 +2502,29 @@ bool DataProcessingDevice::tryDispatchComputation(ServiceRegistryRef ref, std::v
       state.severityStack.push_back((int)fair::Logger::GetConsoleSeverity());
       fair::Logger::SetConsoleSeverity(fair::Severity::trace);
     }
-    if (noCatch) {
-      try {
-        runNoCatch(action);
-      } catch (o2::framework::RuntimeErrorRef e) {
-        ZoneScopedN("error handling");
-        (context.errorHandling)(e, record);
-      }
+    if (offloaded) {
+      // The outputs cannot be considered done before they are sent. The
+      // completions, and therefore the outputs, follow the order of the dispatching.
+      ref.get<TimesliceIndex>().markInFlight(action.timeslice);
+      streamContext.processingInFlight = true;
+      context.scheduleProcessing(std::move(process), std::move(complete));
     } else {
-      try {
-        runNoCatch(action);
-      } catch (std::exception& ex) {
-        ZoneScopedN("error handling");
-        /// Convert a standard exception to a RuntimeErrorRef
-        /// Notice how this will lose the backtrace information
-        /// and report the exception coming from here.
-        auto e = runtime_error(ex.what());
-        (context.errorHandling)(e, record);
-      } catch (o2::framework::RuntimeErrorRef e) {
-        ZoneScopedN("error handling");
-        (context.errorHandling)(e, record);
-      }
+      process();
     }
     if (state.severityStack.empty() == false) {
       fair::Logger::SetConsoleSeverity((fair::Severity)state.severityStack.back());
       state.severityStack.pop_back();
     }
-
-    postUpdateStats(action, record, tStart, tStartMilli);
-    // We forward inputs only when we consume them. If we simply Process them,
-    // we keep them for next message arriving.
-    if (action.op == CompletionPolicy::CompletionOp::Consume) {
-      context.postDispatchingCallbacks(processContext);
-      ref.get<CallbackService>().call<CallbackService::Id::DataConsumed>(o2::framework::ServiceRegistryRef{ref});
-    }
-    if ((context.canForwardEarly == false) && hasForwards && consumeSomething) {
-      LOGP(debug, "Late forwarding");
-      auto& timesliceIndex = ref.get<TimesliceIndex>();
-      forwardInputs(ref, action.slot, currentSetOfInputs, timesliceIndex.getOldestPossibleOutput(), false, action.op == CompletionPolicy::CompletionOp::Consume);
-    }
-    context.postForwardingCallbacks(processContext);
-    if (action.op == CompletionPolicy::CompletionOp::Consume) {
-#ifdef TRACY_ENABLE
-      cleanupRecord(record);
-#endif
-    } else if (action.op == CompletionPolicy::CompletionOp::Process) {
-      cleanTimers(action.slot, record);
+    if (offloaded) {
+      // This stream is busy until its processing completes.
+      return true;
     }
+    complete();
   }
 
-  // We now broadcast the end of stream if it was requested
-  if (state.streaming == StreamingState::EndOfStreaming) {
+  // We now broadcast the end of stream if it was requested, once the
+  // outputs of the timeslices still being processed are sent.
+  if (state.streaming == StreamingState::EndOfStreaming && context.pendingCompletions == 0) {
     LOGP(detail, "Broadcasting end of stream");
     for (auto& channel : spec.outputChannels) {
       auto& rawDevice = ref.get<RawDeviceService>();
@@ -248,6 +248,26 @@ void DataProcessingStats::flushChangedMetrics(std::function<void(DataProcessingS
   LOGP(debug, "Publishing invoked {} times / s, {} metrics published / s", (int)averageInvocations, (int)averagePublishing);
 }
 
+void DataProcessingStats::updatePhaseLatencies(int64_t minInterval)
+{
+  // Only one thread drains the histograms in a given interval.
+  uint64_t now = uv_hrtime();
+  uint64_t last = tracing.lastDrained.load(std::memory_order_relaxed);
+  if (now < last + minInterval * 1000000 || !tracing.lastDrained.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+    return;
+  }
+  for (int pi = 0; pi < (int)TimeslicePhase::Count; ++pi) {
+    auto snapshot = tracing.histograms[pi].drain();
+    if (snapshot.count == 0) {
+      continue;
+    }
+    for (size_t qi = 0; qi < PHASE_LATENCY_QUANTILES.size(); ++qi) {
+      auto id = (unsigned short)((int)ProcessingStatsId::PHASE_LATENCY_BASE + pi * PHASE_LATENCY_QUANTILES.size() + qi);
+      updateStats({id, Op::Set, (int64_t)snapshot.quantile(PHASE_LATENCY_QUANTILES[qi])});
+    }
+  }
+}
+
 void DataProcessingStats::registerMetric(MetricSpec const& spec)
 {
   if (spec.name.size() == 0) {
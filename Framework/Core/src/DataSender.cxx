@@ -23,6 +23,9 @@
 #include "Framework/DataProcessingContext.h"
 #include "Framework/O2DataModelHelpers.h"
 #include "Framework/DataProcessingStates.h"
+#include "Framework/DataProcessingStats.h"
+#include "Framework/DataProcessingHeader.h"
+#include <uv.h>
 
 using namespace o2::monitoring;
 
@@ -107,7 +110,10 @@ void DataSender::send(fair::mq::Parts& parts, ChannelIndex channelIndex)
   auto& dataProcessorContext = mRegistry.get<DataProcessorContext>();
   dataProcessorContext.preSendingMessagesCallbacks(mRegistry, parts, channelIndex);
   auto& info = mProxy.getOutputChannelInfo(channelIndex);
+  auto* dph = parts.Size() ? o2::header::get<DataProcessingHeader*>(parts.At(0)->GetData()) : nullptr;
+  uint64_t tStart = uv_hrtime();
   info.policy->send(parts, channelIndex, mRegistry);
+  mRegistry.get<DataProcessingStats>().tracing.record(TimeslicePhase::Send, dph ? dph->startTime : -1, tStart, uv_hrtime());
 }
 
 void DataSender::reset()
@@ -1446,6 +1446,7 @@ void DeviceSpecHelpers::prepareArguments(bool defaultQuiet, bool defaultStopped,
         realOdesc.add_options()("exit-transition-timeout", bpo::value<std::string>());
         realOdesc.add_options()("expected-region-callbacks", bpo::value<std::string>());
         realOdesc.add_options()("timeframes-rate-limit", bpo::value<std::string>());
+        realOdesc.add_options()("dpl-streams", bpo::value<std::string>());
         realOdesc.add_options()("environment", bpo::value<std::string>());
         realOdesc.add_options()("stacktrace-on-signal", bpo::value<std::string>());
         realOdesc.add_options()("post-fork-command", bpo::value<std::string>());
@@ -1574,6 +1575,18 @@ void DeviceSpecHelpers::prepareArguments(bool defaultQuiet, bool defaultStopped,
       updateDeviceArguments(std::string("--resources-monitoring"), std::to_string(spec.resourceMonitoringInterval));
     }
 
+    // The processing of the streams runs on the libuv threadpool, which is sized from
+    // UV_THREADPOOL_SIZE the first time it is used, i.e. it must be in the environment
+    // of the device from the start.
+    if (auto streams = uniqueDeviceArgs.find("--dpl-streams"); streams != uniqueDeviceArgs.end()) {
+      auto nStreams = std::atoi(streams->second.c_str());
+      bool poolSizeSet = std::any_of(tmpEnv.begin(), tmpEnv.end(), [](std::string const& env) { return env.rfind("UV_THREADPOOL_SIZE=", 0) == 0; });
+      char const* poolSize = getenv("UV_THREADPOOL_SIZE");
+      if (nStreams > 1 && !poolSizeSet && (poolSize == nullptr || std::atoi(poolSize) < nStreams)) {
+        tmpEnv.push_back(fmt::format("UV_THREADPOOL_SIZE={}", std::max(nStreams, 4)));
+      }
+    }
+
     // We create the final option list, depending on the channels
     // which are present in a device.
     for (auto& arg : tmpArgs) {
@@ -1628,6 +1641,7 @@ boost::program_options::options_description DeviceSpecHelpers::getForwardedDevic
     ("exit-transition-timeout", bpo::value<std::string>(), "timeout before switching to READY state")                                                                //
     ("expected-region-callbacks", bpo::value<std::string>(), "region callbacks to expect before starting")                                                           //
     ("timeframes-rate-limit", bpo::value<std::string>()->default_value("0"), "how many timeframes can be in fly")                                                    //
+    ("dpl-streams", bpo::value<std::string>(), "how many timeslices can be processed concurrently by each device")                                                   //
     ("shm-monitor", bpo::value<std::string>(), "whether to use the shared memory monitor")                                                                           //
     ("channel-prefix", bpo::value<std::string>()->default_value(""), "prefix to use for multiplexing multiple workflows in the same session")                        //
     ("bad-alloc-max-attempts", bpo::value<std::string>()->default_value("1"), "throw after n attempts to alloc shm")                                                 //
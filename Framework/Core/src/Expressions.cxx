@@ -545,7 +545,7 @@ gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, s
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table,
                                    Filter const& expression)
 {
-  return createSelection(table, createFilter(table->schema(), createOperations(std::move(expression))));
+  return createSelection(table, createNativeFilter(table->schema(), createOperations(std::move(expression))));
 }
 
 auto createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector)
@@ -752,6 +752,10 @@ void updateExpressionInfos(expressions::Filter const& filter, std::vector<Expres
       } else {
         info.tree = tree;
       }
+      if (info.native == nullptr) {
+        info.native = std::make_shared<NativeFilter>();
+      }
+      info.native->addConjunct(ops, tree);
     }
   }
 }
@@ -171,6 +171,14 @@ fair::mq::TransportFactory* FairMQDeviceProxy::getOutputTransport(RouteIndex ind
   return transport;
 }
 
+void FairMQDeviceProxy::useArena(RouteIndex routeIndex, bool use)
+{
+  if (size_t(routeIndex.value) >= mArenaRoutes.size()) {
+    mArenaRoutes.resize(routeIndex.value + 1, false);
+  }
+  mArenaRoutes[routeIndex.value] = use;
+}
+
 fair::mq::TransportFactory* FairMQDeviceProxy::getInputTransport(RouteIndex index) const
 {
   auto transport = getInputChannel(getInputChannelIndex(index))->Transport();
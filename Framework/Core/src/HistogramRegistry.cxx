@@ -123,6 +123,7 @@ HistPtr HistogramRegistry::add(const std::string& name, char const* const title,
 // store a copy of an existing histogram (or group of histograms) under a different name
 void HistogramRegistry::addClone(const std::string& source, const std::string& target)
 {
+  flush();
   auto doInsertClone = [&](const auto& sharedPtr) {
     if (!sharedPtr.get()) {
       return;
@@ -274,6 +275,7 @@ void HistogramRegistry::print(bool showAxisDetails)
 // create output structure will be propagated to file-sink
 TList* HistogramRegistry::operator*()
 {
+  flush();
   TList* list = new TList();
   list->SetName(mName.data());
 
@@ -330,6 +332,156 @@ TList* HistogramRegistry::operator*()
   return list;
 }
 
+void HistogramRegistry::setBufferedFilling(uint32_t capacity)
+{
+  flush();
+  mFillBufferCapacity = capacity;
+  // the storage of the buffers is reserved at the first buffered fill of the TH1, TH2 or TH3 in the slot
+  mFillBuffers.clear();
+  mFillBuffers.resize(capacity > 0 ? MAX_REGISTRY_SIZE : 0);
+}
+
+void HistogramRegistry::flush()
+{
+  for (auto i = 0u; i < mFillBuffers.size(); ++i) {
+    flush(i);
+  }
+}
+
+void HistogramRegistry::flush(uint32_t idx)
+{
+  if (mFillBuffers.empty() || mFillBuffers[idx].size() == 0) {
+    return;
+  }
+  std::visit([&](auto&& hist) {
+    using H = typename std::decay_t<decltype(hist)>::element_type;
+    if constexpr (std::is_same_v<TH1, H>) {
+      HistFiller::fillHistBuffered(hist.get(), 1, mFillBuffers[idx]);
+    } else if constexpr (std::is_same_v<TH2, H>) {
+      HistFiller::fillHistBuffered(hist.get(), 2, mFillBuffers[idx]);
+    } else if constexpr (std::is_same_v<TH3, H>) {
+      HistFiller::fillHistBuffered(hist.get(), 3, mFillBuffers[idx]);
+    }
+  },
+             mRegistryValue[idx]);
+  mFillBuffers[idx].clear();
+}
+
+namespace
+{
+// fill the entries one by one
+void fillEntries(TH1* hist, int nDim, HistFillBuffer const& buffer)
+{
+  auto const& c = buffer.coordinates;
+  for (auto i = 0u; i < buffer.size(); ++i) {
+    switch (nDim) {
+      case 1:
+        buffer.weighted ? hist->Fill(c[0][i], buffer.weights[i]) : hist->Fill(c[0][i]);
+        break;
+      case 2:
+        buffer.weighted ? static_cast<TH2*>(hist)->Fill(c[0][i], c[1][i], buffer.weights[i]) : static_cast<TH2*>(hist)->Fill(c[0][i], c[1][i]);
+        break;
+      default:
+        buffer.weighted ? static_cast<TH3*>(hist)->Fill(c[0][i], c[1][i], c[2][i], buffer.weights[i]) : static_cast<TH3*>(hist)->Fill(c[0][i], c[1][i], c[2][i]);
+        break;
+    }
+  }
+}
+} // namespace
+
+// The bin index of fixed-width, non-extendable axes is computed for all the buffered entries at once with the same expression as
+// TAxis::FindBin. Bin contents, errors and statistics are then updated in the order of the entries with the same operations as
+// TH1::Fill, TH2::Fill and TH3::Fill. All other cases are filled entry by entry.
+void HistFiller::fillHistBuffered(TH1* hist, int nDim, HistFillBuffer& buffer)
+{
+  const auto n = buffer.size();
+  std::array<TAxis*, 3> axes{hist->GetXaxis(), hist->GetYaxis(), hist->GetZaxis()};
+  bool binned = hist->GetBuffer() == nullptr && !hist->InheritsFrom(TProfile::Class());
+  for (int d = 0; d < nDim; ++d) {
+    binned &= axes[d]->GetXbins()->fN == 0 && !axes[d]->CanExtend() && !axes[d]->TestBit(TAxis::kAxisRange);
+  }
+  std::array<double, 11> stats{};
+  if (binned) {
+    hist->GetStats(stats.data());
+    // TH1::GetStats recomputes the statistics from the bin contents instead of returning the running sums in this case
+    binned = !(hist->GetEntries() > 0 && stats[0] == 0);
+  }
+  if (!binned) {
+    fillEntries(hist, nDim, buffer);
+    return;
+  }
+
+  // global bin index, with the highest bit flagging under- and overflows
+  constexpr uint32_t OutOfRange = 1u << 31;
+  auto& bins = buffer.bins;
+  bins.assign(n, 0);
+  uint32_t stride = 1;
+  for (int d = 0; d < nDim; ++d) {
+    const int nBins = axes[d]->GetNbins();
+    const double xMin = axes[d]->GetXmin();
+    const double xMax = axes[d]->GetXmax();
+    const double* x = buffer.coordinates[d].data();
+    uint32_t* bin = bins.data();
+    for (size_t i = 0; i < n; ++i) {
+      const bool below = x[i] < xMin;
+      const bool above = !(x[i] < xMax); // also catches NaN
+      const double t = (below || above) ? 0. : nBins * (x[i] - xMin) / (xMax - xMin);
+      const uint32_t b = below ? 0 : (above ? nBins + 1 : 1 + int(t));
+      bin[i] = (bin[i] + b * stride) | ((below || above) ? OutOfRange : 0u);
+    }
+    stride *= nBins + 2;
+  }
+
+  const bool statOverflows = hist->GetStatOverflowsBehaviour();
+  const double entries = hist->GetEntries();
+  const double* w = buffer.weighted ? buffer.weights.data() : nullptr;
+  auto const& c = buffer.coordinates;
+  double* sumw2 = hist->GetSumw2N() ? hist->GetSumw2()->GetArray() : nullptr;
+  for (size_t i = 0; i < n; ++i) {
+    const int bin = bins[i] & ~OutOfRange;
+    const double z = w ? w[i] : 1.;
+    if (w) {
+      if (!sumw2 && z != 1. && !hist->TestBit(TH1::kIsNotW)) {
+        hist->SetEntries(entries + i + 1);
+        hist->Sumw2();
+        sumw2 = hist->GetSumw2()->GetArray();
+      }
+      if (sumw2) {
+        sumw2[bin] += z * z;
+      }
+      hist->AddBinContent(bin, z);
+    } else {
+      hist->AddBinContent(bin);
+      if (sumw2) {
+        ++sumw2[bin];
+      }
+    }
+    if ((bins[i] & OutOfRange) && !statOverflows) {
+      continue;
+    }
+    const double x = c[0][i];
+    stats[0] += z;
+    stats[1] += z * z;
+    stats[2] += z * x;
+    stats[3] += z * x * x;
+    if (nDim > 1) {
+      const double y = c[1][i];
+      stats[4] += z * y;
+      stats[5] += z * y * y;
+      stats[6] += z * x * y;
+      if (nDim > 2) {
+        const double t = c[2][i];
+        stats[7] += z * t;
+        stats[8] += z * t * t;
+        stats[9] += z * x * t;
+        stats[10] += z * y * t;
+      }
+    }
+  }
+  hist->PutStats(stats.data());
+  hist->SetEntries(entries + n);
+}
+
 // helper function to create resp. find the subList defined by path
 TList* HistogramRegistry::getSubList(TList* list, std::deque<std::string>& path)
 {
@@ -19,6 +19,9 @@ namespace o2::framework
 
 fair::mq::MessagePtr MessageContext::createMessage(RouteIndex routeIndex, int index, size_t size)
 {
+  if (usesArena(routeIndex)) {
+    return static_cast<o2::pmr::ArenaMemoryResource*>(getOutputResource(routeIndex))->createMessage(size);
+  }
   auto* transport = mProxy.getOutputTransport(routeIndex);
   return transport->CreateMessage(size, fair::mq::Alignment{64});
 }
@@ -29,6 +32,24 @@ fair::mq::MessagePtr MessageContext::createMessage(RouteIndex routeIndex, int in
   return transport->CreateMessage(data, size, ffn, hint);
 }
 
+bool MessageContext::usesArena(RouteIndex routeIndex) const
+{
+  return mProxy.usesArena(routeIndex);
+}
+
+o2::pmr::FairMQMemoryResource* MessageContext::getOutputResource(RouteIndex routeIndex)
+{
+  auto* transport = mProxy.getOutputTransport(routeIndex);
+  if (!usesArena(routeIndex) || transport == nullptr) {
+    return transport ? transport->GetMemoryResource() : nullptr;
+  }
+  auto& arena = mArenas[transport];
+  if (!arena) {
+    arena = std::make_unique<o2::pmr::ArenaMemoryResource>(transport, mArenaRegionSize);
+  }
+  return arena.get();
+}
+
 o2::header::DataHeader* MessageContext::findMessageHeader(const Output& spec)
 {
   for (auto it = mMessages.rbegin(); it != mMessages.rend(); ++it) {
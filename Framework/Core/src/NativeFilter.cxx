@@ -0,0 +1,585 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ExpressionHelpers.h"
+#include "Framework/RuntimeError.h"
+#include "arrow/table.h"
+#include "gandiva/tree_expr_builder.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace o2::framework::expressions
+{
+namespace
+{
+/// rows evaluated at once, so that the intermediate results stay in cache
+constexpr int64_t BatchSize = 1024;
+
+template <typename T>
+struct TypeTag {
+  using type = T;
+};
+
+template <typename F>
+bool dispatch(atype::type t, F&& f)
+{
+  switch (t) {
+    case atype::BOOL:
+      f(TypeTag<bool>{});
+      return true;
+    case atype::UINT8:
+      f(TypeTag<uint8_t>{});
+      return true;
+    case atype::INT8:
+      f(TypeTag<int8_t>{});
+      return true;
+    case atype::UINT16:
+      f(TypeTag<uint16_t>{});
+      return true;
+    case atype::INT16:
+      f(TypeTag<int16_t>{});
+      return true;
+    case atype::UINT32:
+      f(TypeTag<uint32_t>{});
+      return true;
+    case atype::INT32:
+      f(TypeTag<int32_t>{});
+      return true;
+    case atype::UINT64:
+      f(TypeTag<uint64_t>{});
+      return true;
+    case atype::INT64:
+      f(TypeTag<int64_t>{});
+      return true;
+    case atype::FLOAT:
+      f(TypeTag<float>{});
+      return true;
+    case atype::DOUBLE:
+      f(TypeTag<double>{});
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isIntegral(atype::type t)
+{
+  return (t == atype::UINT8) || (t == atype::INT8) || (t == atype::UINT16) || (t == atype::INT16) || (t == atype::UINT32) || (t == atype::INT32) || (t == atype::UINT64) || (t == atype::INT64);
+}
+
+bool isFloating(atype::type t)
+{
+  return (t == atype::FLOAT) || (t == atype::DOUBLE);
+}
+
+/// type in which two operands are compared, following the promotion rules of createOperations
+atype::type commonType(atype::type t1, atype::type t2)
+{
+  if (t1 == t2) {
+    return t1;
+  }
+  if (isIntegral(t1) && isIntegral(t2)) {
+    return std::max(t1, t2);
+  }
+  if ((isIntegral(t1) || isFloating(t1)) && (isIntegral(t2) || isFloating(t2))) {
+    return (t1 == atype::DOUBLE || t2 == atype::DOUBLE) ? atype::DOUBLE : atype::FLOAT;
+  }
+  return atype::NA;
+}
+
+/// integer arithmetic wraps around, as in gandiva
+template <typename T, typename F>
+inline T wrapping(T a, T b, F&& f)
+{
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<decltype(a + 0)>; // avoid the promotion of short types to int
+    return static_cast<T>(f(static_cast<U>(a), static_cast<U>(b)));
+  } else {
+    return f(a, b);
+  }
+}
+
+/// per-evaluation state: registers for the intermediate results and the column buffers of the current slice
+class Machine
+{
+ public:
+  explicit Machine(size_t nColumns) : mColumns(nColumns, nullptr), mColumnScratch(nColumns)
+  {
+    for (auto& s : mScratch) {
+      s = makeBuffer();
+    }
+  }
+
+  void setColumn(size_t i, std::shared_ptr<arrow::ArrayData> const& data, int64_t offset, int64_t n)
+  {
+    if (data->type->id() == atype::BOOL) {
+      // booleans are bit-packed in arrow, unpack them once per slice
+      if (mColumnScratch[i] == nullptr) {
+        mColumnScratch[i] = makeBuffer();
+      }
+      auto* bits = data->buffers[1]->data();
+      auto* out = reinterpret_cast<bool*>(mColumnScratch[i].get());
+      const auto first = data->offset + offset;
+      for (int64_t r = 0; r < n; ++r) {
+        out[r] = (bits[(first + r) >> 3] >> ((first + r) & 7)) & 1;
+      }
+      mColumns[i] = out;
+    } else {
+      dispatch(data->type->id(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        mColumns[i] = reinterpret_cast<const T*>(data->buffers[1]->data()) + data->offset + offset;
+      });
+    }
+  }
+
+  /// evaluate the program on the current slice, the result is in register 0
+  const bool* run(NativeFilter::Program const& program, int64_t n)
+  {
+    while (mRegisters.size() < program.nRegisters) {
+      mRegisters.push_back(makeBuffer());
+    }
+    for (auto const& instruction : program.instructions) {
+      execute(instruction, n);
+    }
+    return reinterpret_cast<const bool*>(mRegisters[0].get());
+  }
+
+ private:
+  using Buffer = std::unique_ptr<uint64_t[]>;
+  static Buffer makeBuffer() { return std::make_unique<uint64_t[]>(BatchSize); }
+
+  template <typename T>
+  T* reg(size_t i)
+  {
+    return reinterpret_cast<T*>(mRegisters[i].get());
+  }
+
+  template <typename T>
+  const T* fetch(NativeFilter::Operand const& operand, int slot, int64_t n)
+  {
+    auto* scratch = reinterpret_cast<T*>(mScratch[slot].get());
+    if (operand.kind == NativeFilter::Operand::Literal) {
+      T value = std::visit([](auto v) { return static_cast<T>(v); }, operand.literal);
+      std::fill_n(scratch, n, value);
+      return scratch;
+    }
+    const void* source = operand.kind == NativeFilter::Operand::Register ? static_cast<const void*>(mRegisters[operand.index].get()) : mColumns[operand.index];
+    if (operand.type == atype::BOOL ? std::is_same_v<T, bool> : (operand.type == selectArrowType<T>() && !std::is_same_v<T, bool>)) {
+      return static_cast<const T*>(source);
+    }
+    dispatch(operand.type, [&](auto tag) {
+      using S = typename decltype(tag)::type;
+      auto* s = static_cast<const S*>(source);
+      for (int64_t r = 0; r < n; ++r) {
+        scratch[r] = static_cast<T>(s[r]);
+      }
+    });
+    return scratch;
+  }
+
+  template <typename T, typename R, typename F>
+  void binary(NativeFilter::Instruction const& instruction, int64_t n, F&& f)
+  {
+    const T* a = fetch<T>(instruction.left, 0, n);
+    const T* b = fetch<T>(instruction.right, 1, n);
+    R* out = reg<R>(instruction.result);
+    for (int64_t r = 0; r < n; ++r) {
+      out[r] = f(a[r], b[r]);
+    }
+  }
+
+  template <typename T, typename F>
+  void unary(NativeFilter::Instruction const& instruction, int64_t n, F&& f)
+  {
+    const T* a = fetch<T>(instruction.left, 0, n);
+    T* out = reg<T>(instruction.result);
+    for (int64_t r = 0; r < n; ++r) {
+      out[r] = f(a[r]);
+    }
+  }
+
+  void execute(NativeFilter::Instruction const& instruction, int64_t n)
+  {
+    switch (instruction.op) {
+      case BasicOp::LogicalAnd:
+        binary<bool, bool>(instruction, n, [](bool a, bool b) { return a & b; });
+        return;
+      case BasicOp::LogicalOr:
+        binary<bool, bool>(instruction, n, [](bool a, bool b) { return a | b; });
+        return;
+      case BasicOp::LessThan:
+      case BasicOp::LessThanOrEqual:
+      case BasicOp::GreaterThan:
+      case BasicOp::GreaterThanOrEqual:
+      case BasicOp::Equal:
+      case BasicOp::NotEqual:
+        dispatch(instruction.operandType, [&](auto tag) { compare<typename decltype(tag)::type>(instruction, n); });
+        return;
+      case BasicOp::Conditional:
+        dispatch(instruction.type, [&](auto tag) {
+          using T = typename decltype(tag)::type;
+          const bool* c = fetch<bool>(instruction.condition, 2, n);
+          const T* a = fetch<T>(instruction.left, 0, n);
+          const T* b = fetch<T>(instruction.right, 1, n);
+          T* out = reg<T>(instruction.result);
+          for (int64_t r = 0; r < n; ++r) {
+            out[r] = c[r] ? a[r] : b[r];
+          }
+        });
+        return;
+      default:
+        dispatch(instruction.type, [&](auto tag) { arithmetic<typename decltype(tag)::type>(instruction, n); });
+        return;
+    }
+  }
+
+  template <typename T>
+  void compare(NativeFilter::Instruction const& instruction, int64_t n)
+  {
+    switch (instruction.op) {
+      case BasicOp::LessThan:
+        binary<T, bool>(instruction, n, [](T a, T b) { return a < b; });
+        break;
+      case BasicOp::LessThanOrEqual:
+        binary<T, bool>(instruction, n, [](T a, T b) { return a <= b; });
+        break;
+      case BasicOp::GreaterThan:
+        binary<T, bool>(instruction, n, [](T a, T b) { return a > b; });
+        break;
+      case BasicOp::GreaterThanOrEqual:
+        binary<T, bool>(instruction, n, [](T a, T b) { return a >= b; });
+        break;
+      case BasicOp::Equal:
+        binary<T, bool>(instruction, n, [](T a, T b) { return a == b; });
+        break;
+      case BasicOp::NotEqual:
+        binary<T, bool>(instruction, n, [](T a, T b) { return a != b; });
+        break;
+      default:
+        break;
+    }
+  }
+
+  template <typename T>
+  void arithmetic(NativeFilter::Instruction const& instruction, int64_t n)
+  {
+    if constexpr (!std::is_same_v<T, bool>) {
+      switch (instruction.op) {
+        case BasicOp::Addition:
+          binary<T, T>(instruction, n, [](T a, T b) { return wrapping(a, b, [](auto x, auto y) { return x + y; }); });
+          return;
+        case BasicOp::Subtraction:
+          binary<T, T>(instruction, n, [](T a, T b) { return wrapping(a, b, [](auto x, auto y) { return x - y; }); });
+          return;
+        case BasicOp::Multiplication:
+          binary<T, T>(instruction, n, [](T a, T b) { return wrapping(a, b, [](auto x, auto y) { return x * y; }); });
+          return;
+        default:
+          break;
+      }
+      if constexpr (std::is_integral_v<T>) {
+        switch (instruction.op) {
+          case BasicOp::BitwiseAnd:
+            binary<T, T>(instruction, n, [](T a, T b) { return static_cast<T>(a & b); });
+            return;
+          case BasicOp::BitwiseOr:
+            binary<T, T>(instruction, n, [](T a, T b) { return static_cast<T>(a | b); });
+            return;
+          case BasicOp::BitwiseXor:
+            binary<T, T>(instruction, n, [](T a, T b) { return static_cast<T>(a ^ b); });
+            return;
+          default:
+            return;
+        }
+      } else {
+        switch (instruction.op) {
+          case BasicOp::Division:
+            binary<T, T>(instruction, n, [](T a, T b) { return a / b; });
+            return;
+          case BasicOp::Atan2:
+            binary<T, T>(instruction, n, [](T a, T b) { return std::atan2(a, b); });
+            return;
+          case BasicOp::Power:
+            binary<T, T>(instruction, n, [](T a, T b) { return std::pow(a, b); });
+            return;
+          case BasicOp::Sqrt:
+            unary<T>(instruction, n, [](T a) { return std::sqrt(a); });
+            return;
+          case BasicOp::Exp:
+            unary<T>(instruction, n, [](T a) { return std::exp(a); });
+            return;
+          case BasicOp::Log:
+            unary<T>(instruction, n, [](T a) { return std::log(a); });
+            return;
+          case BasicOp::Log10:
+            unary<T>(instruction, n, [](T a) { return std::log10(a); });
+            return;
+          case BasicOp::Sin:
+            unary<T>(instruction, n, [](T a) { return std::sin(a); });
+            return;
+          case BasicOp::Cos:
+            unary<T>(instruction, n, [](T a) { return std::cos(a); });
+            return;
+          case BasicOp::Tan:
+            unary<T>(instruction, n, [](T a) { return std::tan(a); });
+            return;
+          case BasicOp::Asin:
+            unary<T>(instruction, n, [](T a) { return std::asin(a); });
+            return;
+          case BasicOp::Acos:
+            unary<T>(instruction, n, [](T a) { return std::acos(a); });
+            return;
+          case BasicOp::Atan:
+            unary<T>(instruction, n, [](T a) { return std::atan(a); });
+            return;
+          case BasicOp::Abs:
+            unary<T>(instruction, n, [](T a) { return std::abs(a); });
+            return;
+          case BasicOp::Round:
+            unary<T>(instruction, n, [](T a) { return std::round(a); });
+            return;
+          default:
+            return;
+        }
+      }
+    }
+  }
+
+  std::vector<Buffer> mRegisters;
+  std::array<Buffer, 3> mScratch;
+  std::vector<const void*> mColumns;
+  std::vector<Buffer> mColumnScratch;
+};
+} // namespace
+
+bool NativeFilter::lower(Operations const& opSpecs, Program& program)
+{
+  auto makeOperand = [this, &program](DatumSpec const& spec, Operand& operand) {
+    switch (spec.datum.index()) {
+      case 0:
+        operand.kind = Operand::None;
+        return true;
+      case 1:
+        operand.kind = Operand::Register;
+        operand.index = std::get<size_t>(spec.datum);
+        program.nRegisters = std::max(program.nRegisters, operand.index + 1);
+        break;
+      case 2:
+        operand.kind = Operand::Literal;
+        operand.literal = std::get<LiteralNode::var_t>(spec.datum);
+        break;
+      case 3: {
+        operand.kind = Operand::Column;
+        auto const& name = std::get<std::string>(spec.datum);
+        auto it = std::find(mColumnNames.begin(), mColumnNames.end(), name);
+        if (it == mColumnNames.end()) {
+          mColumnNames.push_back(name);
+          mColumnTypes.push_back(spec.type);
+          it = mColumnNames.end() - 1;
+        } else if (mColumnTypes[it - mColumnNames.begin()] != spec.type) {
+          return false;
+        }
+        operand.index = it - mColumnNames.begin();
+        break;
+      }
+      default:
+        return false;
+    }
+    operand.type = spec.type;
+    return spec.type == atype::BOOL || isIntegral(spec.type) || isFloating(spec.type);
+  };
+
+  bool hasRoot = false;
+  // the operations are stored parents first, so they are evaluated in reverse order
+  for (auto it = opSpecs.rbegin(); it != opSpecs.rend(); ++it) {
+    Instruction instruction;
+    instruction.op = it->op;
+    instruction.type = it->type;
+    if (!makeOperand(it->left, instruction.left) || !makeOperand(it->right, instruction.right) || !makeOperand(it->condition, instruction.condition)) {
+      return false;
+    }
+    instruction.result = std::get<size_t>(it->result.datum);
+    program.nRegisters = std::max(program.nRegisters, instruction.result + 1);
+    auto const lt = instruction.left.type;
+    auto const rt = instruction.right.type;
+    switch (it->op) {
+      case BasicOp::LogicalAnd:
+      case BasicOp::LogicalOr:
+        if (lt != atype::BOOL || rt != atype::BOOL) {
+          return false;
+        }
+        instruction.operandType = atype::BOOL;
+        break;
+      case BasicOp::LessThan:
+      case BasicOp::LessThanOrEqual:
+      case BasicOp::GreaterThan:
+      case BasicOp::GreaterThanOrEqual:
+      case BasicOp::Equal:
+      case BasicOp::NotEqual:
+        instruction.operandType = commonType(lt, rt);
+        if (instruction.operandType == atype::NA || instruction.right.kind == Operand::None) {
+          return false;
+        }
+        break;
+      case BasicOp::Addition:
+      case BasicOp::Subtraction:
+      case BasicOp::Multiplication:
+        if (!isIntegral(instruction.type) && !isFloating(instruction.type)) {
+          return false;
+        }
+        instruction.operandType = instruction.type;
+        break;
+      case BasicOp::BitwiseAnd:
+      case BasicOp::BitwiseOr:
+      case BasicOp::BitwiseXor:
+        if (!isIntegral(instruction.type)) {
+          return false;
+        }
+        instruction.operandType = instruction.type;
+        break;
+      case BasicOp::Division: // integer division by zero is an error in gandiva
+      case BasicOp::Atan2:
+      case BasicOp::Power:
+      case BasicOp::Sqrt:
+      case BasicOp::Exp:
+      case BasicOp::Log:
+      case BasicOp::Log10:
+      case BasicOp::Sin:
+      case BasicOp::Cos:
+      case BasicOp::Tan:
+      case BasicOp::Asin:
+      case BasicOp::Acos:
+      case BasicOp::Atan:
+      case BasicOp::Abs:
+      case BasicOp::Round:
+        if (!isFloating(instruction.type)) {
+          return false;
+        }
+        instruction.operandType = instruction.type;
+        break;
+      case BasicOp::Conditional:
+        if (instruction.condition.type != atype::BOOL || instruction.type == atype::NA) {
+          return false;
+        }
+        instruction.operandType = instruction.type;
+        break;
+      default:
+        return false;
+    }
+    if (instruction.result == 0) {
+      if (instruction.type != atype::BOOL) {
+        return false;
+      }
+      hasRoot = true;
+    }
+    program.instructions.push_back(std::move(instruction));
+  }
+  return hasRoot;
+}
+
+void NativeFilter::addConjunct(Operations const& opSpecs, gandiva::NodePtr tree)
+{
+  mTree = mTree == nullptr ? tree : gandiva::TreeExprBuilder::MakeAnd({mTree, tree});
+  mFallback = nullptr;
+  if (mNative) {
+    Program program;
+    mNative = lower(opSpecs, program);
+    mPrograms.push_back(std::move(program));
+  }
+}
+
+bool NativeFilter::evaluateNative(arrow::Table const& table, gandiva::SelectionVector& selection) const
+{
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (auto i = 0u; i < mColumnNames.size(); ++i) {
+    auto column = table.GetColumnByName(mColumnNames[i]);
+    if (column == nullptr || column->type()->id() != mColumnTypes[i] || column->null_count() != 0) {
+      return false;
+    }
+    columns.push_back(column);
+  }
+
+  Machine machine{columns.size()};
+  std::vector<int> chunks(columns.size(), 0);
+  std::vector<int64_t> positions(columns.size(), 0);
+  std::unique_ptr<bool[]> mask = std::make_unique<bool[]>(BatchSize);
+  auto* out = reinterpret_cast<int64_t*>(selection.GetBuffer().mutable_data());
+  int64_t nSelected = 0;
+
+  const auto nRows = table.num_rows();
+  for (int64_t start = 0; start < nRows;) {
+    // slice limited by the batch size and by the chunk boundaries of all the columns
+    int64_t n = std::min(BatchSize, nRows - start);
+    for (auto i = 0u; i < columns.size(); ++i) {
+      while (positions[i] == columns[i]->chunk(chunks[i])->length()) {
+        ++chunks[i];
+        positions[i] = 0;
+      }
+      n = std::min(n, columns[i]->chunk(chunks[i])->length() - positions[i]);
+    }
+    for (auto i = 0u; i < columns.size(); ++i) {
+      machine.setColumn(i, columns[i]->chunk(chunks[i])->data(), positions[i], n);
+      positions[i] += n;
+    }
+    for (auto p = 0u; p < mPrograms.size(); ++p) {
+      auto* result = machine.run(mPrograms[p], n);
+      if (p == 0) {
+        std::copy_n(result, n, mask.get());
+      } else {
+        for (int64_t r = 0; r < n; ++r) {
+          mask[r] &= result[r];
+        }
+      }
+    }
+    for (int64_t r = 0; r < n; ++r) {
+      out[nSelected] = start + r;
+      nSelected += mask[r];
+    }
+    start += n;
+  }
+  selection.SetNumSlots(nSelected);
+  return true;
+}
+
+gandiva::Selection NativeFilter::evaluate(std::shared_ptr<arrow::Table> const& table)
+{
+  if (mNative) {
+    gandiva::Selection selection;
+    auto s = gandiva::SelectionVector::MakeInt64(table->num_rows(), arrow::default_memory_pool(), &selection);
+    if (!s.ok()) {
+      throw runtime_error_f("Cannot allocate selection vector %s", s.ToString().c_str());
+    }
+    if (evaluateNative(*table, *selection)) {
+      return selection;
+    }
+  }
+  if (mFallback == nullptr) {
+    mFallback = createFilter(table->schema(), makeCondition(mTree));
+  }
+  return createSelection(table, mFallback);
+}
+
+NativeFilterPtr createNativeFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
+{
+  auto filter = std::make_shared<NativeFilter>();
+  filter->addConjunct(opSpecs, createExpressionTree(opSpecs, Schema));
+  return filter;
+}
+
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, NativeFilterPtr const& nfilter)
+{
+  return nfilter->evaluate(table);
+}
+} // namespace o2::framework::expressions
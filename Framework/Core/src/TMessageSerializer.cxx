@@ -9,7 +9,10 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include <Framework/TMessageSerializer.h>
+#include <fairmq/TransportFactory.h>
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <memory>
 
 using namespace o2::framework;
@@ -17,6 +20,52 @@ using namespace o2::framework;
 TMessageSerializer::StreamerList TMessageSerializer::sStreamers{};
 std::mutex TMessageSerializer::sStreamersLock{};
 
+thread_local FairOutputTMessage* FairOutputTMessage::sActive = nullptr;
+
+FairOutputTMessage::FairOutputTMessage(fair::mq::Message& msg, size_t initialSize)
+  : FairTMessage(kMESS_OBJECT),
+    mMessage{msg},
+    mPrevious{sActive}
+{
+  sActive = this;
+  if (mMessage.GetSize() < initialSize) {
+    mMessage.Rebuild(initialSize);
+  }
+  SetBuffer(mMessage.GetData(), mMessage.GetSize(), kFALSE, reallocMessage);
+  // SetBuffer rewinds the buffer, so we need to write again the
+  // placeholder for the length and the message type, like TMessage does.
+  UInt_t reserved = 0;
+  *this << reserved;
+  *this << What();
+}
+
+FairOutputTMessage::~FairOutputTMessage()
+{
+  sActive = mPrevious;
+}
+
+void FairOutputTMessage::finalise()
+{
+  mMessage.SetUsedSize(Length());
+}
+
+char* FairOutputTMessage::reallocMessage(char* oldData, size_t newSize, size_t oldSize)
+{
+  assert(sActive);
+  auto& msg = sActive->mMessage;
+  assert(oldData == msg.GetData());
+  if (newSize <= msg.GetSize()) {
+    return oldData;
+  }
+  // Keep the old payload alive with a (refcounted) shallow copy
+  // while the message is rebuilt with the new size.
+  auto oldMsg = msg.GetTransport()->CreateMessage();
+  oldMsg->Copy(msg);
+  msg.Rebuild(newSize);
+  std::memcpy(msg.GetData(), oldMsg->GetData(), oldSize);
+  return static_cast<char*>(msg.GetData());
+}
+
 void TMessageSerializer::loadSchema(gsl::span<std::byte> buffer)
 {
   std::unique_ptr<TObject> obj = deserialize(buffer);
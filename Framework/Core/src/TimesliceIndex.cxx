@@ -187,6 +187,12 @@ TimesliceIndex::OldestOutputInfo TimesliceIndex::updateOldestPossibleOutput()
       result.channel = {(int)-1};
     }
   }
+  if (mInFlight.empty() == false && *mInFlight.begin() < result.timeslice.value) {
+    changed = true;
+    result.timeslice = TimesliceId{*mInFlight.begin()};
+    result.slot = {(size_t)-1};
+    result.channel = {(int)-1};
+  }
   if (changed && mOldestPossibleOutput.timeslice.value != result.timeslice.value) {
     LOGP(debug, "Oldest possible output {} due to {} {}",
          result.timeslice.value,
@@ -200,6 +206,19 @@ TimesliceIndex::OldestOutputInfo TimesliceIndex::updateOldestPossibleOutput()
   return result;
 }
 
+void TimesliceIndex::markInFlight(TimesliceId timeslice)
+{
+  mInFlight.insert(timeslice.value);
+}
+
+void TimesliceIndex::markProcessed(TimesliceId timeslice)
+{
+  auto it = mInFlight.find(timeslice.value);
+  if (it != mInFlight.end()) {
+    mInFlight.erase(it);
+  }
+}
+
 InputChannelInfo const& TimesliceIndex::getChannelInfo(ChannelIndex channel) const
 {
   return mChannels[channel.value];
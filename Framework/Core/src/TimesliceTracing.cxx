@@ -0,0 +1,215 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/TimesliceTracing.h"
+#include "Framework/Logger.h"
+#include <uv.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+
+namespace o2::framework
+{
+
+uint64_t LatencySnapshot::quantile(double q) const
+{
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = std::max<uint64_t>(1, uint64_t(q * count + 0.5));
+  uint64_t seen = 0;
+  for (int bi = 0; bi < NBuckets; ++bi) {
+    seen += counts[bi];
+    if (seen >= rank) {
+      return std::min(upperBound(bi), max);
+    }
+  }
+  return max;
+}
+
+void LatencySnapshot::add(LatencySnapshot const& other)
+{
+  for (int bi = 0; bi < NBuckets; ++bi) {
+    counts[bi] += other.counts[bi];
+  }
+  count += other.count;
+  sum += other.sum;
+  max = std::max(max, other.max);
+}
+
+LatencySnapshot LatencyHistogram::drain()
+{
+  LatencySnapshot result;
+  for (int bi = 0; bi < LatencySnapshot::NBuckets; ++bi) {
+    result.counts[bi] = counts[bi].exchange(0, std::memory_order_relaxed);
+    result.count += result.counts[bi];
+  }
+  // count, sum and max may be off by the entries recorded while draining,
+  // the buckets are the reference.
+  count.store(0, std::memory_order_relaxed);
+  result.sum = sum.exchange(0, std::memory_order_relaxed);
+  result.max = max.exchange(0, std::memory_order_relaxed);
+  return result;
+}
+
+char const* TimesliceTracing::phaseName(TimeslicePhase phase)
+{
+  switch (phase) {
+    case TimeslicePhase::Receive:
+      return "receive";
+    case TimeslicePhase::RelayWait:
+      return "relay_wait";
+    case TimeslicePhase::Completion:
+      return "completion";
+    case TimeslicePhase::Callback:
+      return "callback";
+    case TimeslicePhase::Send:
+      return "send";
+    case TimeslicePhase::Backpressure:
+      return "backpressure";
+    default:
+      return "unknown";
+  }
+}
+
+void TimesliceTracing::record(TimeslicePhase phase, size_t timeslice, uint64_t start, uint64_t end)
+{
+  histograms[(int)phase].record(end > start ? (end - start) / 1000 : 0);
+  if (!mTraceEnabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mTrace.size() < mTraceCapacity) {
+    mTrace.push_back({timeslice, start, end, phase});
+  } else {
+    mTraceDropped++;
+  }
+}
+
+void TimesliceTracing::inputRelayed(size_t timeslice, uint64_t when)
+{
+  if (!mRelayWaitEnabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  // The pending timeslices are bounded by the relayer slots, as long as the dropped
+  // and the obsolete ones are removed. Keep a hard limit in case they are not.
+  constexpr size_t MaxPending = 1024;
+  if (mFirstInput.emplace(timeslice, when).second && mFirstInput.size() > MaxPending) {
+    mFirstInput.erase(mFirstInput.begin());
+  }
+}
+
+void TimesliceTracing::timesliceReady(size_t timeslice, uint64_t when)
+{
+  if (!mRelayWaitEnabled) {
+    return;
+  }
+  uint64_t first = 0;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mFirstInput.find(timeslice);
+    if (it == mFirstInput.end() || !mReady.emplace(timeslice, when).second) {
+      return;
+    }
+    first = it->second;
+  }
+  record(TimeslicePhase::RelayWait, timeslice, first, when);
+}
+
+void TimesliceTracing::timesliceDispatched(size_t timeslice, uint64_t when)
+{
+  if (!mRelayWaitEnabled) {
+    return;
+  }
+  uint64_t ready = 0;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFirstInput.erase(timeslice);
+    auto it = mReady.find(timeslice);
+    if (it == mReady.end()) {
+      return;
+    }
+    ready = it->second;
+    mReady.erase(it);
+  }
+  record(TimeslicePhase::Completion, timeslice, ready, when);
+}
+
+void TimesliceTracing::timesliceDropped(size_t timeslice)
+{
+  if (!mRelayWaitEnabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFirstInput.erase(timeslice);
+  mReady.erase(timeslice);
+}
+
+void TimesliceTracing::pruneBefore(size_t oldestPossibleTimeslice)
+{
+  if (!mRelayWaitEnabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto* pending : {&mFirstInput, &mReady}) {
+    pending->erase(pending->begin(), pending->lower_bound(oldestPossibleTimeslice));
+  }
+}
+
+void TimesliceTracing::enableTrace(std::string const& device, std::string const& fileName, size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  mEpochOffset = int64_t(now.tv_sec) * 1000000000 + now.tv_nsec - int64_t(uv_hrtime());
+  mDevice = device;
+  mTraceFile = fileName;
+  mTraceCapacity = capacity;
+  mTrace.reserve(std::min<size_t>(capacity, 1 << 16));
+  mTraceEnabled = true;
+}
+
+bool TimesliceTracing::dumpTrace()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!mTraceEnabled) {
+    return true;
+  }
+  FILE* f = fopen(mTraceFile.c_str(), "w");
+  if (!f) {
+    LOGP(error, "Unable to write the timeslice trace to {}", mTraceFile);
+    return false;
+  }
+  // One process per device, one thread per phase, the timeslice in the arguments,
+  // so that the traces of all the devices can be concatenated.
+  auto pid = getpid();
+  fmt::print(f, "{{\"traceEvents\":[\n{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"{}\"}}}}", pid, mDevice);
+  for (int pi = 0; pi < (int)TimeslicePhase::Count; ++pi) {
+    fmt::print(f, ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", pid, pi, phaseName((TimeslicePhase)pi));
+  }
+  for (auto& event : mTrace) {
+    fmt::print(f, ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"timeslice\":{}}}}}",
+               phaseName(event.phase), mDevice, pid, (int)event.phase, (int64_t(event.start) + mEpochOffset) / 1000.,
+               (event.end - event.start) / 1000., (int64_t)event.timeslice);
+  }
+  fmt::print(f, "\n],\"displayTimeUnit\":\"ms\"}}\n");
+  fclose(f);
+  LOGP(info, "Timeslice trace with {} phases written to {} ({} dropped)", mTrace.size(), mTraceFile, mTraceDropped);
+  // The next dump only has the phases recorded from now on
+  mTrace.clear();
+  mTraceDropped = 0;
+  return true;
+}
+
+} // namespace o2::framework
@@ -1400,3 +1400,106 @@ TEST_CASE("BlockCombinationsCounters")
     previousEvent = c0.index();
   }
 }
+
+TEST_CASE("PairKernels")
+{
+  TableBuilder builderA;
+  auto rowWriterA = builderA.persist<int32_t, int32_t, float>({"x", "y", "floatZ"});
+  rowWriterA(0, 0, 25, -6.0f);
+  rowWriterA(0, 1, 18, 0.0f);
+  rowWriterA(0, 2, 48, 8.0f);
+  rowWriterA(0, 3, 103, 2.0f);
+  rowWriterA(0, 4, 28, -6.0f);
+  rowWriterA(0, 5, 102, 2.0f);
+  rowWriterA(0, 6, 12, 0.0f);
+  rowWriterA(0, 7, 24, -7.0f);
+  rowWriterA(0, 8, 41, 8.0f);
+  rowWriterA(0, 9, 49, 8.0f);
+  auto tableA = builderA.finalize();
+  REQUIRE(tableA->num_rows() == 10);
+
+  using TestA = o2::soa::Table<o2::soa::Index<>, test::X, test::Y, test::FloatZ>;
+  TestA testA{tableA};
+
+  ColumnTile<test::X, test::Y, test::FloatZ> tile;
+  tile.fill(testA);
+  REQUIRE(tile.size() == 10);
+  REQUIRE(tile.get<test::X>()[3] == 3);
+  REQUIRE(tile.get<test::Y>()[3] == 103);
+  REQUIRE(tile.get<test::FloatZ>()[3] == 2.0f);
+  REQUIRE(tile.globalIndex(9) == 9);
+
+  // pairs of two tiles, with and without predicate
+  auto x = tile.get<test::X>();
+  auto y = tile.get<test::Y>();
+  using PairSet = std::vector<std::pair<int32_t, int32_t>>;
+  PairSet pairs;
+  pairKernel(tile, tile, PairMode::StrictlyUpper, [&](size_t i, size_t j) { pairs.emplace_back(x[i], x[j]); });
+  REQUIRE(pairs.size() == 45);
+  pairs.clear();
+  pairKernel(tile, tile, PairMode::Full, [&](size_t i, size_t j) { pairs.emplace_back(x[i], x[j]); }, [&](size_t i, size_t j) { return y[i] + y[j] > 150; });
+  PairSet expected;
+  for (int i = 0; i < 10; i++) {
+    for (int j = 0; j < 10; j++) {
+      if (y[i] + y[j] > 150) {
+        expected.emplace_back(i, j);
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  REQUIRE(pairs == expected);
+
+  // block pairs must be the same as the ones of the iterator-based block combinations
+  std::vector<double> yBins{VARIABLE_WIDTH, 0, 5, 10, 20, 30, 40, 50, 101};
+  std::vector<double> zBins{VARIABLE_WIDTH, -7.0, -5.0, -3.0, -1.0, 1.0, 3.0, 5.0, 7.0};
+  ColumnBinningPolicy<test::Y, test::FloatZ> pairBinning{{yBins, zBins}, false};
+
+  auto blockPairs = [&](PairMode mode, int neighbours) {
+    PairSet result;
+    blockPairKernel<test::X>(pairBinning, neighbours, -1, testA, mode, [&result](auto const& t, size_t i, size_t j) {
+      auto tx = t.template get<test::X>();
+      result.emplace_back(tx[i], tx[j]);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+
+  for (int neighbours : {1, 2}) {
+    expected.clear();
+    for (auto& [c0, c1] : combinations(CombinationsBlockFullIndexPolicy(pairBinning, neighbours, -1, testA, testA))) {
+      expected.emplace_back(c0.x(), c1.x());
+    }
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(blockPairs(PairMode::Full, neighbours) == expected);
+
+    expected.clear();
+    for (auto& [c0, c1] : combinations(CombinationsBlockUpperSameIndexPolicy(pairBinning, neighbours, -1, testA, testA))) {
+      expected.emplace_back(c0.x(), c1.x());
+    }
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(blockPairs(PairMode::Upper, neighbours) == expected);
+
+    expected.clear();
+    for (auto& [c0, c1] : combinations(CombinationsBlockStrictlyUpperSameIndexPolicy(pairBinning, neighbours, -1, testA, testA))) {
+      expected.emplace_back(c0.x(), c1.x());
+    }
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(blockPairs(PairMode::StrictlyUpper, neighbours) == expected);
+  }
+
+  // predicate on the tile columns: only pairs with close y
+  PairSet closePairs;
+  blockPairKernel<test::X, test::Y>(
+    pairBinning, 2, -1, testA, PairMode::StrictlyUpper,
+    [&closePairs](auto const& t, size_t i, size_t j) { closePairs.emplace_back(t.template get<test::X>()[i], t.template get<test::X>()[j]); },
+    [](auto const& t, size_t i, size_t j) { return std::abs(t.template get<test::Y>()[i] - t.template get<test::Y>()[j]) < 5; });
+  std::sort(closePairs.begin(), closePairs.end());
+  expected.clear();
+  for (auto& [c0, c1] : combinations(CombinationsBlockStrictlyUpperSameIndexPolicy(pairBinning, 2, -1, testA, testA))) {
+    if (std::abs(c0.y() - c1.y()) < 5) {
+      expected.emplace_back(c0.x(), c1.x());
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  REQUIRE(closePairs == expected);
+}
@@ -13,6 +13,7 @@
 #include "Framework/ExpressionHelpers.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AODReaderHelpers.h"
+#include "Framework/TableBuilder.h"
 #include <catch_amalgamated.hpp>
 #include <arrow/util/config.h>
 
@@ -267,3 +268,51 @@ TEST_CASE("TestConditionalExpressions")
   auto gandiva_filter2 = createFilter(schema2, gandiva_condition2);
   REQUIRE(gandiva_tree2->ToString() == "bool greater_than((float) fSigned1Pt, (const float) 0 raw(0)) && if (bool less_than(float absf((float) fEta), (const float) 1 raw(3f800000)) && if (bool less_than((float) fPt, (const float) 1 raw(3f800000))) { bool greater_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) } else { bool less_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) }) { bool greater_than(float absf((float) fX), (const float) 1 raw(3f800000)) } else { bool greater_than(float absf((float) fY), (const float) 1 raw(3f800000)) }");
 }
+
+TEST_CASE("TestNativeFilter")
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<int32_t, float, float, float, uint32_t, int8_t>({"fIndexCollisions", "fPt", "fEta", "fPhi", "fFlags", "fTPCNClsFindableMinusFound"});
+  for (int i = 0; i < 1000; ++i) {
+    rowWriter(0, i / 10, 0.01f * i, -1.5f + 0.003f * i, (i % 7) * 1.f, static_cast<uint32_t>(i % 5), static_cast<int8_t>(i % 11 - 5));
+  }
+  auto table = builder.finalize();
+
+  auto compare = [&table](Filter const& f, bool native) {
+    auto ops = createOperations(f);
+    auto nfilter = createNativeFilter(table->schema(), ops);
+    REQUIRE(nfilter->isNative() == native);
+    auto gfilter = createFilter(table->schema(), makeCondition(createExpressionTree(ops, table->schema())));
+    auto nsel = createSelection(table, nfilter);
+    auto gsel = createSelection(table, gfilter);
+    REQUIRE(nsel->GetNumSlots() == gsel->GetNumSlots());
+    for (auto i = 0; i < nsel->GetNumSlots(); ++i) {
+      REQUIRE(nsel->GetIndex(i) == gsel->GetIndex(i));
+    }
+    return nsel->GetNumSlots();
+  };
+
+  Filter f1 = (o2::aod::track::pt > 1.0f) && (nabs(o2::aod::track::eta) < 0.8f);
+  REQUIRE(compare(f1, true) > 0);
+  Filter f2 = ((o2::aod::track::flags & static_cast<uint32_t>(o2::aod::track::TPCrefit)) != 0u) || (o2::aod::track::tpcNClsFindableMinusFound > (int8_t)2);
+  REQUIRE(compare(f2, true) > 0);
+  Filter f3 = nabs(o2::aod::track::eta) < 1.0f && ifnode((o2::aod::track::pt < 3.0f), (o2::aod::track::phi > (float)(M_PI / 2.)), (o2::aod::track::phi < (float)(M_PI / 2.)));
+  REQUIRE(compare(f3, true) > 0);
+  Filter f4 = nsqrt(o2::aod::track::pt * o2::aod::track::pt + o2::aod::track::eta * o2::aod::track::eta) * 2.0 < 7.0;
+  REQUIRE(compare(f4, true) > 0);
+
+  // integer division has no native kernel and is evaluated by gandiva
+  Filter f5 = (o2::aod::track::collisionId / 2) == 1;
+  REQUIRE(compare(f5, false) > 0);
+
+  // conjuncts of the task filters
+  NativeFilter combined;
+  auto o1 = createOperations(f1);
+  auto o3 = createOperations(f3);
+  combined.addConjunct(o1, createExpressionTree(o1, table->schema()));
+  combined.addConjunct(o3, createExpressionTree(o3, table->schema()));
+  REQUIRE(combined.isNative());
+  auto csel = combined.evaluate(table);
+  Filter f13 = ((o2::aod::track::pt > 1.0f) && (nabs(o2::aod::track::eta) < 0.8f)) && (nabs(o2::aod::track::eta) < 1.0f && ifnode((o2::aod::track::pt < 3.0f), (o2::aod::track::phi > (float)(M_PI / 2.)), (o2::aod::track::phi < (float)(M_PI / 2.))));
+  REQUIRE(csel->GetNumSlots() == compare(f13, true));
+}
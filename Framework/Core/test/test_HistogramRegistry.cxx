@@ -11,6 +11,8 @@
 
 #include "Framework/HistogramRegistry.h"
 #include <catch_amalgamated.hpp>
+#include <array>
+#include <cmath>
 
 using namespace o2;
 using namespace o2::framework;
@@ -125,3 +127,64 @@ TEST_CASE("HistogramRegistryStepTHn")
 
   registry.print();
 }
+
+TEST_CASE("HistogramRegistryBufferedFill")
+{
+  auto makeRegistry = [](char const* name) {
+    std::vector<double> edges{-2.0, -1.0, 0.0, 0.5, 2.0}; // variable binning is filled entry by entry
+    return HistogramRegistry{
+      name, {
+              {"x", "x", {HistType::kTH1F, {{100, -2.0, 2.0}}}},                                       //
+              {"w", "w", {HistType::kTH1D, {{50, -2.0, 2.0}}}},                                        //
+              {"v", "v", {HistType::kTH1D, {{edges}}}},                                                  //
+              {"xy", "xy", {HistType::kTH2F, {{40, -1.0, 1.0}, {30, -2.0, 2.0}}}},                     //
+              {"xyz", "xyz", {HistType::kTH3D, {{10, -1.0, 1.0}, {10, -1.0, 1.0}, {10, -1.0, 1.0}}}} //
+            }                                                                                          //
+    };
+  };
+  HistogramRegistry direct = makeRegistry("direct");
+  HistogramRegistry buffered = makeRegistry("buffered");
+  buffered.setBufferedFilling(64);
+
+  auto fillBoth = [&](auto... args) {
+    direct.fill(args...);
+    buffered.fill(args...);
+  };
+  for (int i = 0; i < 1000; ++i) {
+    double x = std::sin(0.37 * i) * 2.5;
+    double y = std::cos(0.11 * i) * 2.5;
+    double z = std::sin(0.05 * i + 1.);
+    fillBoth(HIST("x"), x);
+    // weights become non-unit only later, such that Sumw2 is enabled in the middle of a buffer
+    fillBoth(HIST("w"), x, i < 100 ? 1. : 0.5 + 0.001 * i);
+    fillBoth(HIST("v"), x);
+    fillBoth(HIST("xy"), x, y);
+    fillBoth(HIST("xyz"), x, y, z, 0.3);
+  }
+  fillBoth(HIST("x"), std::nan(""));
+  fillBoth(HIST("xy"), 2.0f, -2.0f);
+
+  auto compare = [](TH1* a, TH1* b) {
+    REQUIRE(a->GetEntries() == b->GetEntries());
+    REQUIRE(a->GetSumw2N() == b->GetSumw2N());
+    for (int bin = 0; bin < a->GetNcells(); ++bin) {
+      REQUIRE(a->GetBinContent(bin) == b->GetBinContent(bin));
+      REQUIRE(a->GetBinError(bin) == b->GetBinError(bin));
+    }
+    std::array<double, 11> statsA{}, statsB{};
+    a->GetStats(statsA.data());
+    b->GetStats(statsB.data());
+    REQUIRE(statsA == statsB);
+  };
+  compare(direct.get<TH1>(HIST("x")).get(), buffered.get<TH1>(HIST("x")).get());
+  compare(direct.get<TH1>(HIST("w")).get(), buffered.get<TH1>(HIST("w")).get());
+  compare(direct.get<TH1>(HIST("v")).get(), buffered.get<TH1>(HIST("v")).get());
+  compare(direct.get<TH2>(HIST("xy")).get(), buffered.get<TH2>(HIST("xy")).get());
+  compare(direct.get<TH3>(HIST("xyz")).get(), buffered.get<TH3>(HIST("xyz")).get());
+
+  // entries are kept in the buffer until the histogram is accessed or the buffer is flushed
+  buffered.fill(HIST("x"), 0.5);
+  buffered.flush();
+  direct.fill(HIST("x"), 0.5);
+  compare(direct.get<TH1>(HIST("x")).get(), buffered.get<TH1>(HIST("x")).get());
+}
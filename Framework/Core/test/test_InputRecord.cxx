@@ -13,8 +13,13 @@
 #include "Framework/InputRecord.h"
 #include "Framework/InputSpan.h"
 #include "Framework/DataProcessingHeader.h"
+#include "Framework/ObjectCache.h"
+#include "Framework/CallbackService.h"
+#include "Framework/ServiceRegistryHelpers.h"
 #include "Headers/DataHeader.h"
 #include "Headers/Stack.h"
+#include <cstring>
+#include <optional>
 
 using namespace o2::framework;
 using DataHeader = o2::header::DataHeader;
@@ -159,6 +164,111 @@ TEST_CASE("TestInputRecord")
   REQUIRE(record.end().begin() == record.end().end());
 }
 
+namespace
+{
+// stand-in for a o2::gpu::FlatObject: the flat image is a tag followed by the values,
+// the copy made from it owns the values
+struct TestFlatObject {
+  std::vector<int> values;
+
+  static std::vector<char> createFlatImage(std::vector<int> const& values)
+  {
+    std::vector<char> image(4 + values.size() * sizeof(int));
+    memcpy(image.data(), "FLAT", 4);
+    memcpy(image.data() + 4, values.data(), values.size() * sizeof(int));
+    return image;
+  }
+  template <typename T>
+  static bool isFlatImage(const char* image, size_t size)
+  {
+    return size >= 4 && memcmp(image, "FLAT", 4) == 0;
+  }
+  template <typename T>
+  static T* cloneFlatImage(const char* image, size_t size)
+  {
+    auto* obj = new T;
+    obj->values.resize((size - 4) / sizeof(int));
+    memcpy(obj->values.data(), image + 4, obj->values.size() * sizeof(int));
+    return obj;
+  }
+};
+} // namespace
+
+TEST_CASE("TestInputRecordFlatImage")
+{
+  static_assert(is_flat_object<TestFlatObject>::value);
+  InputSpec spec{"flat", "TST", "FLAT", 0, Lifetime::Condition};
+  std::vector<InputRoute> schema = {InputRoute{spec, 0, "flat_source", 0, std::nullopt}};
+
+  ServiceRegistry registry;
+  ServiceRegistryRef ref{registry};
+  ObjectCache cache;
+  CallbackService callbacks;
+  ref.registerService(ServiceRegistryHelpers::handleForService<ObjectCache>(&cache));
+  ref.registerService(ServiceRegistryHelpers::handleForService<CallbackService, CallbackService, ServiceKind::Global>(&callbacks));
+  int nDeserialised = 0;
+  callbacks.set<CallbackService::Id::CCDBDeserialised>([&nDeserialised](ConcreteDataMatcher&, void*) { nDeserialised++; });
+
+  // CCDB messages carrying flat images, as received by a consumer of the condition
+  auto createMessage = [](std::vector<char> const& image, std::vector<std::unique_ptr<char[]>>& messages) {
+    DataHeader dh;
+    dh.dataOrigin = "TST";
+    dh.dataDescription = "FLAT";
+    dh.subSpecification = 0;
+    dh.payloadSerializationMethod = o2::header::gSerializationMethodCCDB;
+    dh.payloadSize = image.size();
+    Stack stack{dh, DataProcessingHeader{0, 1}};
+    messages.emplace_back(new char[stack.size()]);
+    memcpy(messages.back().get(), stack.data(), stack.size());
+    messages.emplace_back(new char[image.size()]);
+    memcpy(messages.back().get(), image.data(), image.size());
+  };
+  std::vector<std::unique_ptr<char[]>> messages;
+  auto image1 = TestFlatObject::createFlatImage({1, 2, 3});
+  auto image2 = TestFlatObject::createFlatImage({4, 5});
+  createMessage(image1, messages);
+  createMessage(image2, messages);
+
+  auto getSpan = [&](int message) {
+    return InputSpan{[&messages, message](size_t) { return DataRef{nullptr, messages[2 * message].get(), messages[2 * message + 1].get()}; }, 1};
+  };
+  auto getFromMessage = [&](int message) {
+    auto span = getSpan(message);
+    InputRecord record{schema, span, registry};
+    return record.get<TestFlatObject*>("flat").get();
+  };
+
+  // the object is copied from the image once and then served from the cache, the payload is untouched
+  auto const* obj = getFromMessage(0);
+  REQUIRE(obj->values == std::vector<int>{1, 2, 3});
+  REQUIRE(memcmp(messages[1].get(), image1.data(), image1.size()) == 0);
+  REQUIRE(getFromMessage(0) == obj);
+  REQUIRE(cache.idToObject.size() == 1);
+
+  // a new payload replaces the cached object
+  auto const* obj2 = getFromMessage(1);
+  REQUIRE(obj2->values == std::vector<int>{4, 5});
+  REQUIRE(memcmp(messages[3].get(), image2.data(), image2.size()) == 0);
+  REQUIRE(cache.idToObject.size() == 1);
+  REQUIRE(getFromMessage(1) == obj2);
+  REQUIRE(nDeserialised == 2);
+
+  // a record being processed keeps the object it received when it gets replaced,
+  // and the timeslices with the same payload get the same object meanwhile
+  auto span0 = getSpan(0);
+  std::optional<InputRecord> inFlight;
+  inFlight.emplace(schema, span0, registry);
+  auto const* pinned = inFlight->get<TestFlatObject*>("flat").get();
+  REQUIRE(nDeserialised == 3);
+  REQUIRE(getFromMessage(1) != pinned);
+  REQUIRE(nDeserialised == 4);
+  REQUIRE(pinned->values == std::vector<int>{1, 2, 3});
+  REQUIRE(getFromMessage(0) == pinned);
+  REQUIRE(nDeserialised == 4);
+  inFlight.reset();
+  REQUIRE(cache.replaced.begin()->second.expired());
+}
+
 // TODO:
 // - test all `get` implementations
 // - create a list of supported types and check that the API compiles
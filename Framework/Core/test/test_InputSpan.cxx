@@ -11,6 +11,8 @@
 
 #include "Framework/InputSpan.h"
 #include "Framework/DataRef.h"
+#include <fairmq/TransportFactory.h>
+#include <fairmq/Message.h>
 #include <vector>
 #include <string>
 #include <catch_amalgamated.hpp>
@@ -66,3 +68,36 @@ TEST_CASE("TestInputSpan")
     routeNo++;
   }
 }
+
+TEST_CASE("TestInputSpanPayloadMessage")
+{
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  std::vector<fair::mq::MessagePtr> payloads;
+  for (size_t i = 0; i < 2; ++i) {
+    payloads.emplace_back(transport->CreateMessage(1024));
+  }
+  std::string header = "header";
+
+  auto getter = [&](size_t i, size_t) {
+    return DataRef{nullptr, header.data(), static_cast<char const*>(payloads[i]->GetData()), payloads[i]->GetSize()};
+  };
+  auto nPartsGetter = [](size_t) -> size_t { return 1; };
+  auto payloadGetter = [&](size_t i, size_t part) -> fair::mq::Message const* {
+    return part == 0 ? payloads[i].get() : nullptr;
+  };
+
+  InputSpan plain{getter, nPartsGetter, payloads.size()};
+  REQUIRE(plain.payloadMessage(0) == nullptr);
+
+  InputSpan span{getter, nPartsGetter, payloadGetter, payloads.size()};
+  REQUIRE(span.payloadMessage(0) == payloads[0].get());
+  REQUIRE(span.payloadMessage(1) == payloads[1].get());
+  REQUIRE(span.payloadMessage(1, 1) == nullptr);
+  REQUIRE(span.payloadMessage(2) == nullptr);
+
+  // a refcounted copy shares the buffer of the original message
+  auto forwarded = transport->CreateMessage();
+  forwarded->Copy(*span.payloadMessage(1));
+  REQUIRE(forwarded->GetData() == payloads[1]->GetData());
+  REQUIRE(forwarded->GetSize() == payloads[1]->GetSize());
+}
@@ -12,6 +12,7 @@
 #include "Framework/TMessageSerializer.h"
 #include "Framework/RuntimeError.h"
 #include "TestClasses.h"
+#include <fairmq/TransportFactory.h>
 #include <catch_amalgamated.hpp>
 #include <catch_amalgamated.hpp>
 #include <utility>
@@ -73,6 +74,35 @@ TEST_CASE("TestTMessageSerializer")
                          ExceptionMatcher("can not convert serialized class TObjArray into target class TNamed"));
 }
 
+TEST_CASE("TestTMessageSerializer_IntoMessage")
+{
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  auto msg = transport->CreateMessage();
+
+  // enough entries to force the message to be expanded a few times
+  TObjArray array;
+  array.SetOwner();
+  for (int i = 0; i < 1000; ++i) {
+    array.Add(new TNamed(std::to_string(i).c_str(), "a title which takes some space in the buffer"));
+  }
+
+  TMessageSerializer::Serialize(*msg, &array);
+  REQUIRE(msg->GetSize() > 4096);
+
+  auto out = TMessageSerializer::deserialize(as_span(*msg));
+  auto* outarr = dynamic_cast<TObjArray*>(out.get());
+  REQUIRE(outarr != nullptr);
+  outarr->SetOwner();
+  REQUIRE(outarr->GetEntriesFast() == 1000);
+  REQUIRE(outarr->At(999)->GetName() == std::string("999"));
+
+  // must produce the same bytes as the intermediate TMessage
+  FairTMessage tm;
+  TMessageSerializer::serialize(tm, &array);
+  REQUIRE(msg->GetSize() == tm.Length());
+  REQUIRE(memcmp(msg->GetData(), tm.Buffer(), tm.Length()) == 0);
+}
+
 bool check_expected(RuntimeErrorRef const& ref)
 {
   auto& e = error_from_ref(ref);
@@ -159,4 +159,15 @@ TEST_CASE("TestOldestPossibleTimeslice")
   index.markAsInvalid({1});
   index.updateOldestPossibleOutput();
   REQUIRE(index.getOldestPossibleOutput().timeslice.value == 10);
+  // A timeslice consumed, but whose outputs were not sent yet, holds back the
+  // oldest possible output.
+  index.setOldestPossibleInput({12}, {0});
+  index.setOldestPossibleInput({12}, {1});
+  index.markInFlight({10});
+  index.markAsInvalid({0});
+  index.updateOldestPossibleOutput();
+  REQUIRE(index.getOldestPossibleOutput().timeslice.value == 10);
+  index.markProcessed({10});
+  index.updateOldestPossibleOutput();
+  REQUIRE(index.getOldestPossibleOutput().timeslice.value == 12);
 }
@@ -0,0 +1,146 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/TimesliceTracing.h"
+#include <catch_amalgamated.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace o2::framework;
+
+TEST_CASE("LatencyBuckets")
+{
+  uint64_t values[] = {0, 1, 15, 16, 17, 31, 32, 1000, 123456789, uint64_t(1) << 40, UINT64_MAX};
+  for (uint64_t value : values) {
+    int bucket = LatencySnapshot::bucket(value);
+    REQUIRE(bucket >= 0);
+    REQUIRE(bucket < LatencySnapshot::NBuckets);
+    REQUIRE(LatencySnapshot::lowerBound(bucket) <= value);
+    REQUIRE(LatencySnapshot::upperBound(bucket) >= value);
+    // Relative precision of the bucket
+    REQUIRE(LatencySnapshot::upperBound(bucket) - LatencySnapshot::lowerBound(bucket) <= value / LatencySnapshot::SubBuckets);
+  }
+  for (int bucket = 0; bucket < LatencySnapshot::NBuckets; ++bucket) {
+    REQUIRE(LatencySnapshot::bucket(LatencySnapshot::lowerBound(bucket)) == bucket);
+    REQUIRE(LatencySnapshot::bucket(LatencySnapshot::upperBound(bucket)) == bucket);
+  }
+}
+
+TEST_CASE("LatencyHistogram")
+{
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histogram.record(i);
+  }
+  auto snapshot = histogram.drain();
+  REQUIRE(snapshot.count == 1000);
+  REQUIRE(snapshot.sum == 500500);
+  REQUIRE(snapshot.max == 1000);
+  REQUIRE(snapshot.quantile(1.) == 1000);
+  auto median = snapshot.quantile(0.5);
+  REQUIRE(median >= 500);
+  REQUIRE(median <= 500 + 500 / LatencySnapshot::SubBuckets);
+  auto p99 = snapshot.quantile(0.99);
+  REQUIRE(p99 >= 990);
+  REQUIRE(p99 <= 1000);
+
+  // Draining resets the histogram
+  auto empty = histogram.drain();
+  REQUIRE(empty.count == 0);
+  REQUIRE(empty.max == 0);
+  REQUIRE(empty.quantile(0.5) == 0);
+
+  snapshot.add(snapshot);
+  REQUIRE(snapshot.count == 2000);
+  REQUIRE(snapshot.quantile(1.) == 1000);
+}
+
+TEST_CASE("TimesliceTracing")
+{
+  TimesliceTracing tracing;
+  auto& relayWait = tracing.histograms[(int)TimeslicePhase::RelayWait];
+  auto& completion = tracing.histograms[(int)TimeslicePhase::Completion];
+
+  // Nothing is followed unless asked for
+  tracing.inputRelayed(1, 1000000);
+  tracing.timesliceReady(1, 3000000);
+  tracing.timesliceDispatched(1, 5000000);
+  REQUIRE(relayWait.drain().count == 0);
+  REQUIRE(completion.drain().count == 0);
+
+  tracing.enableRelayWait();
+  tracing.inputRelayed(1, 1000000);
+  tracing.inputRelayed(1, 2000000); // Only the first input counts
+  tracing.timesliceReady(1, 3000000);
+  tracing.timesliceReady(1, 4000000); // Only the first time it is found complete counts
+  tracing.timesliceDispatched(1, 5000000);
+  // Not relayed, nothing is recorded
+  tracing.timesliceReady(2, 5000000);
+  tracing.timesliceDispatched(2, 6000000);
+
+  auto wait = relayWait.drain();
+  REQUIRE(wait.count == 1);
+  REQUIRE(wait.max == 2000);
+  auto dispatch = completion.drain();
+  REQUIRE(dispatch.count == 1);
+  REQUIRE(dispatch.max == 2000);
+
+  // Dropped timeslices and the ones older than the oldest possible output are forgotten
+  tracing.inputRelayed(3, 7000000);
+  tracing.inputRelayed(4, 7000000);
+  tracing.inputRelayed(5, 7000000);
+  tracing.timesliceDropped(3);
+  tracing.pruneBefore(5);
+  tracing.timesliceReady(3, 8000000);
+  tracing.timesliceReady(4, 8000000);
+  tracing.timesliceReady(5, 9000000);
+  wait = relayWait.drain();
+  REQUIRE(wait.count == 1);
+  REQUIRE(wait.max == 2000);
+
+  tracing.record(TimeslicePhase::Callback, 1, 10000, 5000);
+  auto callback = tracing.histograms[(int)TimeslicePhase::Callback].drain();
+  REQUIRE(callback.count == 1);
+  REQUIRE(callback.max == 0);
+}
+
+TEST_CASE("TimesliceTraceDump")
+{
+  auto fileName = (std::filesystem::temp_directory_path() / "test_TimesliceTracing.json").string();
+  auto countPhases = [&fileName]() {
+    std::ifstream in(fileName);
+    std::stringstream content;
+    content << in.rdbuf();
+    auto text = content.str();
+    int count = 0;
+    for (size_t pos = text.find("\"ph\":\"X\""); pos != std::string::npos; pos = text.find("\"ph\":\"X\"", pos + 1)) {
+      ++count;
+    }
+    return count;
+  };
+
+  TimesliceTracing tracing;
+  tracing.enableTrace("test", fileName, 2);
+  tracing.record(TimeslicePhase::Callback, 1, 1000, 2000);
+  tracing.record(TimeslicePhase::Callback, 2, 3000, 4000);
+  tracing.record(TimeslicePhase::Callback, 3, 5000, 6000); // Above capacity, dropped
+  REQUIRE(tracing.dumpTrace());
+  REQUIRE(countPhases() == 2);
+
+  // A dump only has what was recorded since the previous one
+  REQUIRE(tracing.dumpTrace());
+  REQUIRE(countPhases() == 0);
+  tracing.record(TimeslicePhase::Callback, 4, 7000, 8000);
+  REQUIRE(tracing.dumpTrace());
+  REQUIRE(countPhases() == 1);
+  std::filesystem::remove(fileName);
+}
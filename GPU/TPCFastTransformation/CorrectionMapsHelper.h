@@ -41,6 +41,11 @@ class CorrectionMapsHelper
     mCorrMap->Transform(slice, row, pad, time, x, y, z, vertexTime, mCorrMapRef, mLumiScale, mLumiScaleMode);
   }
 
+  GPUd() void TransformRow(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime = 0) const
+  {
+    mCorrMap->TransformRow(slice, row, n, pad, time, x, y, z, vertexTime, mCorrMapRef, mLumiScale, mLumiScaleMode);
+  }
+
   GPUd() void TransformXYZ(int slice, int row, float& x, float& y, float& z) const
   {
     mCorrMap->TransformXYZ(slice, row, x, y, z, mCorrMapRef, mLumiScale, mLumiScaleMode);
@@ -51,6 +56,11 @@ class CorrectionMapsHelper
     mCorrMap->InverseTransformYZtoX(slice, row, y, z, x, mCorrMapRef, mLumiScale, mLumiScaleMode);
   }
 
+  GPUd() void InverseTransformYZtoXRow(int slice, int row, int n, const float* y, const float* z, float* x) const
+  {
+    mCorrMap->InverseTransformYZtoXRow(slice, row, n, y, z, x, mCorrMapRef, mLumiScale, mLumiScaleMode);
+  }
+
   GPUd() void InverseTransformYZtoNominalYZ(int slice, int row, float y, float z, float& ny, float& nz) const
   {
     mCorrMap->InverseTransformYZtoNominalYZ(slice, row, y, z, ny, nz, mCorrMapRef, mLumiScale, mLumiScaleMode);
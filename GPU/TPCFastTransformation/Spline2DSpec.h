@@ -362,6 +362,72 @@ class Spline2DSpec<DataT, YdimT, 0>
     }
   }
 
+  /// Get interpolated values S(u1[i],u2[i]) for n points at once using spline parameters Parameters.
+  /// The values of the point i are stored at S[i * inpYdim].
+  /// The same math as interpolateU(), but the knot search is separated from the arithmetic
+  /// which runs in loops over the points, such that it can be vectorised by the compiler.
+  template <SafetyLevel SafeT = SafetyLevel::kSafe>
+  GPUd() void interpolateUbatch(int inpYdim, GPUgeneric() const DataT Parameters[], int n,
+                                GPUgeneric() const DataT u1[], GPUgeneric() const DataT u2[], GPUgeneric() DataT S[]) const
+  {
+    constexpr int BatchSize = 16;
+
+    const auto nYdimTmp = SplineUtil::getNdim<YdimT>(inpYdim);
+    const int nYdim = nYdimTmp.get();
+    const auto nYdim4 = nYdim * 4;
+    const int nu = mGridX1.getNumberOfKnots();
+
+    for (int i0 = 0; i0 < n; i0 += BatchSize) {
+      const int nb = (n - i0 < BatchSize) ? n - i0 : BatchSize;
+
+      int offset[BatchSize];
+      typename TBase::Knot knotU[BatchSize], knotV[BatchSize];
+      for (int i = 0; i < nb; i++) {
+        int iu = mGridX1.template getLeftKnotIndexForU<SafeT>(u1[i0 + i]);
+        int iv = mGridX2.template getLeftKnotIndexForU<SafeT>(u2[i0 + i]);
+        knotU[i] = mGridX1.template getKnot<SafetyLevel::kNotSafe>(iu);
+        knotV[i] = mGridX2.template getKnot<SafetyLevel::kNotSafe>(iv);
+        offset[i] = (nu * iv + iu) * nYdim4;
+      }
+
+      DataT a[8][BatchSize], b[8][BatchSize];
+      for (int i = 0; i < nb; i++) {
+        DataT dSl, dDl, dSr, dDr;
+        mGridX1.getUderivatives(knotU[i], u1[i0 + i], dSl, dDl, dSr, dDr);
+        DataT dSd, dDd, dSu, dDu;
+        mGridX2.getUderivatives(knotV[i], u2[i0 + i], dSd, dDd, dSu, dDu);
+        a[0][i] = dSl * dSd;
+        a[1][i] = dSl * dDd;
+        a[2][i] = dDl * dSd;
+        a[3][i] = dDl * dDd;
+        a[4][i] = dSr * dSd;
+        a[5][i] = dSr * dDd;
+        a[6][i] = dDr * dSd;
+        a[7][i] = dDr * dDd;
+        b[0][i] = dSl * dSu;
+        b[1][i] = dSl * dDu;
+        b[2][i] = dDl * dSu;
+        b[3][i] = dDl * dDu;
+        b[4][i] = dSr * dSu;
+        b[5][i] = dSr * dDu;
+        b[6][i] = dDr * dSu;
+        b[7][i] = dDr * dDu;
+      }
+
+      for (int i = 0; i < nb; i++) {
+        const DataT* A = Parameters + offset[i];
+        const DataT* B = A + nYdim4 * nu;
+        DataT* Si = S + (i0 + i) * nYdim;
+        for (int dim = 0; dim < nYdim; dim++) {
+          Si[dim] = 0;
+          for (int k = 0; k < 8; k++) {
+            Si[dim] += a[k][i] * A[nYdim * k + dim] + b[k][i] * B[nYdim * k + dim];
+          }
+        }
+      }
+    }
+  }
+
  protected:
   using TBase::mGridX1;
   using TBase::mGridX2;
@@ -438,6 +504,14 @@ class Spline2DSpec<DataT, YdimT, 1>
     TBase::template interpolateU<SafeT>(YdimT, Parameters, u1, u2, S);
   }
 
+  /// Get interpolated values for n points (u1[i],u2[i]) using spline parameters Parameters.
+  template <SafetyLevel SafeT = SafetyLevel::kSafe>
+  GPUd() void interpolateUbatch(GPUgeneric() const DataT Parameters[], int n,
+                                GPUgeneric() const DataT u1[], GPUgeneric() const DataT u2[], GPUgeneric() DataT S[/*n * nYdim*/]) const
+  {
+    TBase::template interpolateUbatch<SafeT>(YdimT, Parameters, n, u1, u2, S);
+  }
+
   /// Get interpolated value for an YdimT-dimensional S(u1,u2) using spline parameters Parameters.
   template <SafetyLevel SafeT = SafetyLevel::kSafe>
   GPUd() void interpolateUold(GPUgeneric() const DataT Parameters[],
@@ -454,6 +528,7 @@ class Spline2DSpec<DataT, YdimT, 1>
   using TBase::recreate;
 #endif
   using TBase::interpolateU;
+  using TBase::interpolateUbatch;
 };
 
 /// ==================================================================================================
@@ -510,6 +585,7 @@ class Spline2DSpec<DataT, YdimT, 2>
   ///  _______  Expert tools: interpolation with given nYdim and external Parameters _______
 
   using TBase::interpolateU;
+  using TBase::interpolateUbatch;
 };
 
 /// ==================================================================================================
@@ -160,6 +160,12 @@ class TPCFastSpaceChargeCorrection : public FlatObject
   /// inverse correction: Corrected U and V -> uncorrected U and V
   GPUd() void getCorrectionInvUV(int slice, int row, float corrU, float corrV, float& nomU, float& nomV) const;
 
+  /// getCorrection() for n points of the same row, the row spline is looked up once
+  GPUd() void getCorrections(int slice, int row, int n, const float* u, const float* v, float* dx, float* du, float* dv) const;
+
+  /// getCorrectionInvCorrectedX() for n points of the same row
+  GPUd() void getCorrectionsInvCorrectedX(int slice, int row, int n, const float* corrU, const float* corrV, float* corrX) const;
+
   /// maximal possible drift length of the active area
   GPUd() float getMaxDriftLength(int slice, int row, float pad) const;
 
@@ -362,6 +368,60 @@ GPUdi() void TPCFastSpaceChargeCorrection::getCorrectionInvCorrectedX(
   x = mGeo.getRowInfo(row).x + dx;
 }
 
+GPUdi() void TPCFastSpaceChargeCorrection::getCorrections(int slice, int row, int n, const float* u, const float* v, float* dx, float* du, float* dv) const
+{
+  /// the same as getCorrection() for every point, the points are processed in chunks:
+  /// the grid coordinates and the spline are evaluated in loops over the chunk
+  constexpr int BatchSize = 16;
+  const SliceRowInfo& info = getSliceRowInfo(slice, row);
+  const SplineType& spline = getSpline(slice, row);
+  const float* splineData = getSplineData(slice, row);
+  const float gridUmax = spline.getGridX1().getUmax();
+  const float gridVmax = spline.getGridX2().getUmax();
+  float su0 = 0., sv0 = 0.;
+  mGeo.convUVtoScaledUV(slice, row, 0., info.gridV0, su0, sv0);
+
+  for (int i0 = 0; i0 < n; i0 += BatchSize) {
+    const int nb = (n - i0 < BatchSize) ? n - i0 : BatchSize;
+    float gridU[BatchSize], gridV[BatchSize], dxuv[3 * BatchSize];
+    for (int i = 0; i < nb; i++) {
+      float gu = 0, gv = 0;
+      mGeo.convUVtoScaledUV(slice, row, u[i0 + i], v[i0 + i], gu, gv);
+      gv = (gv - sv0) / (1. - sv0);
+      gridU[i] = gu * gridUmax;
+      gridV[i] = gv * gridVmax;
+    }
+    spline.interpolateUbatch(splineData, nb, gridU, gridV, dxuv);
+    for (int i = 0; i < nb; i++) {
+      dx[i0 + i] = dxuv[3 * i];
+      du[i0 + i] = dxuv[3 * i + 1];
+      dv[i0 + i] = dxuv[3 * i + 2];
+    }
+  }
+}
+
+GPUdi() void TPCFastSpaceChargeCorrection::getCorrectionsInvCorrectedX(int slice, int row, int n, const float* corrU, const float* corrV, float* x) const
+{
+  constexpr int BatchSize = 16;
+  const SliceRowInfo& sliceRowInfo = getSliceRowInfo(slice, row);
+  const Spline2D<float, 1>& spline = reinterpret_cast<const Spline2D<float, 1>&>(getSpline(slice, row));
+  const float* splineData = getSplineData(slice, row, 1);
+  const float rowX = mGeo.getRowInfo(row).x;
+
+  for (int i0 = 0; i0 < n; i0 += BatchSize) {
+    const int nb = (n - i0 < BatchSize) ? n - i0 : BatchSize;
+    float gridU[BatchSize], gridV[BatchSize], dx[BatchSize];
+    for (int i = 0; i < nb; i++) {
+      gridU[i] = (corrU[i0 + i] - sliceRowInfo.gridCorrU0) * sliceRowInfo.scaleCorrUtoGrid;
+      gridV[i] = (corrV[i0 + i] - sliceRowInfo.gridCorrV0) * sliceRowInfo.scaleCorrVtoGrid;
+    }
+    spline.interpolateUbatch(splineData, nb, gridU, gridV, dx);
+    for (int i = 0; i < nb; i++) {
+      x[i0 + i] = rowX + dx[i];
+    }
+  }
+}
+
 GPUdi() void TPCFastSpaceChargeCorrection::getCorrectionInvUV(
   int slice, int row, float corrU, float corrV, float& nomU, float& nomV) const
 {
@@ -179,16 +179,25 @@ class TPCFastTransform : public FlatObject
   GPUd() void Transform(int slice, int row, float pad, float time, float& x, float& y, float& z, float vertexTime = 0, const TPCFastTransform* ref = nullptr, float scale = 0.f, int scaleMode = 0) const;
   GPUd() void TransformXYZ(int slice, int row, float& x, float& y, float& z, const TPCFastTransform* ref = nullptr, float scale = 0.f, int scaleMode = 0) const;
 
+  /// Transform() for n clusters of the same pad row, the row calibration is looked up once
+  GPUd() void TransformRow(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime = 0, const TPCFastTransform* ref = nullptr, float scale = 0.f, int scaleMode = 0) const;
+
   /// Transformation in the time frame
   GPUd() void TransformInTimeFrame(int slice, int row, float pad, float time, float& x, float& y, float& z, float maxTimeBin) const;
   GPUd() void TransformInTimeFrame(int slice, float time, float& z, float maxTimeBin) const;
 
+  /// TransformInTimeFrame() for n clusters of the same pad row
+  GPUd() void TransformInTimeFrameRow(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float maxTimeBin) const;
+
   /// Inverse transformation
   GPUd() void InverseTransformInTimeFrame(int slice, int row, float /*x*/, float y, float z, float& pad, float& time, float maxTimeBin) const;
 
   /// Inverse transformation: Transformed Y and Z -> transformed X
   GPUd() void InverseTransformYZtoX(int slice, int row, float y, float z, float& x, const TPCFastTransform* ref = nullptr, float scale = 0.f, int scaleMode = 0) const;
 
+  /// InverseTransformYZtoX() for n clusters of the same pad row
+  GPUd() void InverseTransformYZtoXRow(int slice, int row, int n, const float* y, const float* z, float* x, const TPCFastTransform* ref = nullptr, float scale = 0.f, int scaleMode = 0) const;
+
   /// Inverse transformation: Transformed Y and Z -> Y and Z, transformed w/o space charge correction
   GPUd() void InverseTransformYZtoNominalYZ(int slice, int row, float y, float z, float& ny, float& nz, const TPCFastTransform* ref = nullptr, float scale = 0.f, int scaleMode = 0) const;
 
@@ -571,6 +580,73 @@ GPUdi() void TPCFastTransform::Transform(int slice, int row, float pad, float ti
   z += dzTOF;
 }
 
+GPUdi() void TPCFastTransform::TransformRow(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float vertexTime, const TPCFastTransform* ref, float scale, int scaleMode) const
+{
+  /// The same as Transform() for every cluster. The clusters are processed in chunks,
+  /// the corrections of the chunk are evaluated at once by TPCFastSpaceChargeCorrection::getCorrections()
+
+  bool perCluster = false;
+#ifndef GPUCA_GPUCODE
+  perCluster = (mCorrectionSlow != nullptr);
+#endif
+  GPUCA_DEBUG_STREAMER_CHECK(perCluster = perCluster || o2::utils::DebugStreamer::checkStream(o2::utils::StreamFlags::streamFastTransform);)
+  if (perCluster) {
+    for (int i = 0; i < n; i++) {
+      Transform(slice, row, pad[i], time[i], x[i], y[i], z[i], vertexTime, ref, scale, scaleMode);
+    }
+    return;
+  }
+
+  constexpr int BatchSize = 16;
+  const bool applyCorrection = mApplyCorrection && scale >= 0.f;
+  const bool applyRef = applyCorrection && ref && scale > 0.f && (scaleMode == 0 || scaleMode == 1);
+  const float rowX = getGeometry().getRowInfo(row).x;
+
+  for (int i0 = 0; i0 < n; i0 += BatchSize) {
+    const int nb = (n - i0 < BatchSize) ? n - i0 : BatchSize;
+    float* xb = x + i0;
+    float* yb = y + i0;
+    float* zb = z + i0;
+    float u[BatchSize], v[BatchSize];
+    for (int i = 0; i < nb; i++) {
+      xb[i] = rowX;
+      convPadTimeToUV(slice, row, pad[i0 + i], time[i0 + i], u[i], v[i], vertexTime);
+    }
+    if (applyCorrection) {
+      float dx[BatchSize], du[BatchSize], dv[BatchSize];
+      mCorrection.getCorrections(slice, row, nb, u, v, dx, du, dv);
+      if (applyRef) {
+        float dxRef[BatchSize], duRef[BatchSize], dvRef[BatchSize];
+        ref->mCorrection.getCorrections(slice, row, nb, u, v, dxRef, duRef, dvRef);
+        if (scaleMode == 0) {
+          for (int i = 0; i < nb; i++) {
+            dx[i] = (dx[i] - dxRef[i]) * scale + dxRef[i];
+            du[i] = (du[i] - duRef[i]) * scale + duRef[i];
+            dv[i] = (dv[i] - dvRef[i]) * scale + dvRef[i];
+          }
+        } else {
+          for (int i = 0; i < nb; i++) {
+            dx[i] = dxRef[i] * scale + dx[i];
+            du[i] = duRef[i] * scale + du[i];
+            dv[i] = dvRef[i] * scale + dv[i];
+          }
+        }
+      }
+      for (int i = 0; i < nb; i++) {
+        xb[i] += dx[i];
+        u[i] += du[i];
+        v[i] += dv[i];
+      }
+    }
+    for (int i = 0; i < nb; i++) {
+      getGeometry().convUVtoLocal(slice, u[i], v[i], yb[i], zb[i]);
+      float dzTOF = 0;
+      getTOFcorrection(slice, row, xb[i], yb[i], zb[i], dzTOF);
+      zb[i] += dzTOF;
+    }
+  }
+}
+
 GPUdi() void TPCFastTransform::TransformInTimeFrame(int slice, float time, float& z, float maxTimeBin) const
 {
   float v = 0;
@@ -593,6 +669,18 @@ GPUdi() void TPCFastTransform::TransformInTimeFrame(int slice, int row, float pa
   getGeometry().convUVtoLocal(slice, u, v, y, z);
 }
 
+GPUdi() void TPCFastTransform::TransformInTimeFrameRow(int slice, int row, int n, const float* pad, const float* time, float* x, float* y, float* z, float maxTimeBin) const
+{
+  /// The same as TransformInTimeFrame() for every cluster
+  const float rowX = getGeometry().getRowInfo(row).x;
+  for (int i = 0; i < n; i++) {
+    x[i] = rowX;
+    float u = 0, v = 0;
+    convPadTimeToUVinTimeFrame(slice, row, pad[i], time[i], u, v, maxTimeBin);
+    getGeometry().convUVtoLocal(slice, u, v, y[i], z[i]);
+  }
+}
+
 GPUdi() void TPCFastTransform::InverseTransformInTimeFrame(int slice, int row, float /*x*/, float y, float z, float& pad, float& time, float maxTimeBin) const
 {
   /// Inverse transformation to TransformInTimeFrame
@@ -759,6 +847,45 @@ GPUdi() void TPCFastTransform::InverseTransformYZtoX(int slice, int row, float y
   })
 }
 
+GPUdi() void TPCFastTransform::InverseTransformYZtoXRow(int slice, int row, int n, const float* y, const float* z, float* x, const TPCFastTransform* ref, float scale, int scaleMode) const
+{
+  /// The same as InverseTransformYZtoX() for every cluster, the clusters are processed in chunks
+  GPUCA_DEBUG_STREAMER_CHECK(if (o2::utils::DebugStreamer::checkStream(o2::utils::StreamFlags::streamFastTransform)) {
+    for (int i = 0; i < n; i++) {
+      InverseTransformYZtoX(slice, row, y[i], z[i], x[i], ref, scale, scaleMode);
+    }
+    return;
+  })
+  if (scale < 0.f) {
+    return;
+  }
+  constexpr int BatchSize = 16;
+  const bool applyRef = ref && scale > 0.f && (scaleMode == 0 || scaleMode == 1);
+
+  for (int i0 = 0; i0 < n; i0 += BatchSize) {
+    const int nb = (n - i0 < BatchSize) ? n - i0 : BatchSize;
+    float* xb = x + i0;
+    float u[BatchSize], v[BatchSize];
+    for (int i = 0; i < nb; i++) {
+      getGeometry().convLocalToUV(slice, y[i0 + i], z[i0 + i], u[i], v[i]);
+    }
+    mCorrection.getCorrectionsInvCorrectedX(slice, row, nb, u, v, xb);
+    if (applyRef) {
+      float xr[BatchSize];
+      ref->mCorrection.getCorrectionsInvCorrectedX(slice, row, nb, u, v, xr);
+      if (scaleMode == 0) {
+        for (int i = 0; i < nb; i++) {
+          xb[i] = (xb[i] - xr[i]) * scale + xr[i];
+        }
+      } else {
+        for (int i = 0; i < nb; i++) {
+          xb[i] = xr[i] * scale + xb[i];
+        }
+      }
+    }
+  }
+}
+
 GPUdi() void TPCFastTransform::InverseTransformYZtoNominalYZ(int slice, int row, float y, float z, float& ny, float& nz, const TPCFastTransform* ref, float scale, int scaleMode) const
 {
   /// Transformation y,z -> x
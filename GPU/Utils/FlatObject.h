@@ -18,10 +18,15 @@
 #define ALICEOW_GPUCOMMON_TPCFASTTRANSFORMATION_FLATOBJECT_H
 
 #if !defined(GPUCA_GPUCODE_DEVICE)
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <cstring>
 #include <cassert>
+#include <typeinfo>
+#include <type_traits>
+#include <vector>
 #endif
 
 #include "GPUCommonDef.h"
@@ -114,6 +119,17 @@ namespace gpu
 ///   obj.setFutureBufferAddress( char* futureFlatBufferPtr );
 ///  before the transport. The object will be ready-to-use right after the porting.
 ///
+/// == Flat images.
+///
+/// A flat image is a binary blob with a small header, a bitwise copy of the object and its flat buffer.
+/// It can be shipped as-is (i.e. as a CCDB payload) and used without any ROOT streaming:
+///   std::vector<char> image = FlatObject::createFlatImage( obj );
+/// The receiver makes a bitwise copy of the object and its buffer and fixes up the pointers of the copy:
+///   T* obj = FlatObject::cloneFlatImage<T>( image, size );
+/// The image itself is never written (the pointers of flat sub-objects live in the buffer, an in-place fix-up
+/// would modify it), so it can be shared read-only, e.g. by processes mapping a shared memory message at different addresses.
+/// Each receiver therefore owns its copy: the image saves the ROOT streaming, not the memory of the copies.
+///
 
 #ifndef GPUCA_GPUCODE // code invisible on GPU
 
@@ -291,6 +307,38 @@ class FlatObject
   static T* readFromFile(TFile& inpf, const char* name);
 #endif
 
+#if !defined(GPUCA_GPUCODE) // code invisible on GPU
+
+  /// _______________  Flat images  _______________________________________________
+
+  /// Header of the flat image, followed by the object and its flat buffer
+  struct FlatImageHeader {
+    static constexpr char Magic[8] = {'O', '2', 'F', 'L', 'A', 'T', 'O', 'B'};
+    static constexpr unsigned int Version = 1;
+
+    char magic[8];           ///< image identifier
+    unsigned int version;    ///< image format version
+    unsigned int objectSize; ///< size of the object, guards against layout changes
+    uint64_t objectOffset;   ///< offset of the object in the image
+    uint64_t bufferOffset;   ///< offset of the flat buffer in the image
+    uint64_t bufferSize;     ///< size of the flat buffer
+    char typeName[64];       ///< (truncated) type name of the object
+  };
+
+  /// create a flat image of a child class object
+  template <class T>
+  static std::vector<char> createFlatImage(const T& obj);
+
+  /// tell if the memory holds a flat image of a child class T
+  template <class T>
+  static bool isFlatImage(const char* image, size_t size);
+
+  /// create a new object owning its buffer from the flat image, the image is not modified
+  template <class T>
+  static T* cloneFlatImage(const char* image, size_t size);
+
+#endif //! GPUCA_GPUCODE
+
 #if !defined(GPUCA_GPUCODE) // code invisible on GPU
 
   /// Test the flat object functionality for a child class T
@@ -516,6 +564,79 @@ inline T* FlatObject::readFromFile(TFile& inpf, const char* name)
 }
 #endif // GPUCA_GPUCODE || GPUCA_STANDALONE
 
+#if !defined(GPUCA_GPUCODE) // code invisible on GPU
+template <class T>
+inline std::vector<char> FlatObject::createFlatImage(const T& obj)
+{
+  /// Create a flat image: the header, the object with an external buffer and the buffer itself
+  static_assert(std::is_base_of<FlatObject, T>::value && !std::is_polymorphic<T>::value, "flat images need non-polymorphic flat objects");
+  assert(obj.isConstructed());
+
+  size_t objectOffset = alignSize(sizeof(FlatImageHeader), std::max(alignof(T), getClassAlignmentBytes()));
+  size_t bufferOffset = alignSize(objectOffset + sizeof(T), getBufferAlignmentBytes());
+  std::vector<char> image(bufferOffset + obj.getFlatBufferSize());
+
+  auto* header = new (image.data()) FlatImageHeader;
+  std::memcpy(header->magic, FlatImageHeader::Magic, sizeof(header->magic));
+  header->version = FlatImageHeader::Version;
+  header->objectSize = sizeof(T);
+  header->objectOffset = objectOffset;
+  header->bufferOffset = bufferOffset;
+  header->bufferSize = obj.getFlatBufferSize();
+  std::memset(header->typeName, 0, sizeof(header->typeName));
+  std::strncpy(header->typeName, typeid(T).name(), sizeof(header->typeName) - 1);
+
+  // the clone refers to the buffer in the image and owns nothing, its bits are the object image
+  T tmp;
+  tmp.cloneFromObject(obj, image.data() + bufferOffset);
+  std::memcpy(image.data() + objectOffset, (const void*)&tmp, sizeof(T));
+  return image;
+}
+
+template <class T>
+inline bool FlatObject::isFlatImage(const char* image, size_t size)
+{
+  /// Check the image header against the type T
+  if (!image || size < sizeof(FlatImageHeader) || std::memcmp(image, FlatImageHeader::Magic, sizeof(FlatImageHeader::Magic))) {
+    return false;
+  }
+  unsigned int version, objectSize;
+  uint64_t bufferOffset, bufferSize;
+  char typeName[sizeof(FlatImageHeader::typeName)] = {0};
+  std::memcpy(&version, image + offsetof(FlatImageHeader, version), sizeof(version));
+  std::memcpy(&objectSize, image + offsetof(FlatImageHeader, objectSize), sizeof(objectSize));
+  std::memcpy(&bufferOffset, image + offsetof(FlatImageHeader, bufferOffset), sizeof(bufferOffset));
+  std::memcpy(&bufferSize, image + offsetof(FlatImageHeader, bufferSize), sizeof(bufferSize));
+  std::strncpy(typeName, typeid(T).name(), sizeof(typeName) - 1);
+  if (version != FlatImageHeader::Version || objectSize != sizeof(T) || bufferOffset + bufferSize > size ||
+      std::memcmp(typeName, image + offsetof(FlatImageHeader, typeName), sizeof(typeName))) {
+    LOG(error) << "Flat image is not compatible with " << typeName << ": version " << version << " object size " << objectSize << " vs " << sizeof(T);
+    return false;
+  }
+  return true;
+}
+
+template <class T>
+inline T* FlatObject::cloneFlatImage(const char* image, size_t size)
+{
+  /// Bitwise copy of the object and its buffer, then the pointer fix-up, the copy owns its buffer
+  if (!isFlatImage<T>(image, size)) {
+    return nullptr;
+  }
+  FlatImageHeader header;
+  std::memcpy(&header.objectOffset, image + offsetof(FlatImageHeader, objectOffset), sizeof(header.objectOffset));
+  std::memcpy(&header.bufferOffset, image + offsetof(FlatImageHeader, bufferOffset), sizeof(header.bufferOffset));
+  std::memcpy(&header.bufferSize, image + offsetof(FlatImageHeader, bufferSize), sizeof(header.bufferSize));
+  auto* obj = new T;
+  char* buffer = new char[header.bufferSize];
+  std::memcpy((void*)obj, image + header.objectOffset, sizeof(T));
+  std::memcpy(buffer, image + header.bufferOffset, header.bufferSize);
+  obj->setActualBufferAddress(buffer);
+  obj->adoptInternalBuffer(buffer);
+  return obj;
+}
+#endif // GPUCA_GPUCODE
+
 #ifndef GPUCA_GPUCODE_DEVICE
 
 inline char* FlatObject::releaseInternalBuffer()
@@ -93,6 +93,12 @@ class Generator : public FairGenerator
   /** notification methods **/
   virtual void notifyEmbedding(const o2::dataformats::MCEventHeader* eventHeader){};
 
+  /** reseed the own random engine of the generator for the next event, if it has one **/
+  virtual void setEventSeed(ULong_t seed){};
+  /** true if, once reseeded by setEventSeed, the generator draws only from its own engine and
+      does not go through gRandom or the ROOT interpreter, so that instances can run in parallel threads **/
+  virtual bool canGenerateConcurrently() const { return false; }
+
   void setTriggerOkHook(std::function<void(std::vector<TParticle> const& p, int eventCount)> f) { mTriggerOkHook = f; }
   void setTriggerFalseHook(std::function<void(std::vector<TParticle> const& p, int eventCount)> f) { mTriggerFalseHook = f; }
 
@@ -42,6 +42,8 @@ class GeneratorPythia8 : public Generator
   /** methods to override **/
   Bool_t generateEvent() override;
   Bool_t importParticles() override { return importParticles(mPythia.event); };
+  void setEventSeed(ULong_t seed) override;
+  bool canGenerateConcurrently() const override { return mTriggers.empty() && mDeepTriggers.empty() && mHooksFileName.empty(); }
 
   /** setters **/
   void setConfig(std::string val) { mConfig = val; };
@@ -110,6 +112,9 @@ class GeneratorPythia8 : public Generator
   std::string mHooksFileName;
   std::string mHooksFuncName;
 
+  /** reseeded per event: the spectator numbers are drawn from mPythia.rndm, not gRandom **/
+  bool mEventSeeded = false; //!
+
   ClassDefOverride(GeneratorPythia8, 1);
 
 }; /** class GeneratorPythia8 **/
@@ -17,6 +17,7 @@
 #include "FairPrimaryGenerator.h"
 #include "DataFormatsCalibration/MeanVertexObject.h"
 #include "SimConfig/SimConfig.h"
+#include "TRandom3.h"
 
 class TFile;
 class TTree;
@@ -82,6 +83,12 @@ class PrimaryGenerator : public FairPrimaryGenerator
 
   void setExternalVertexForNextEvent(double x, double y, double z);
 
+  /** reseed the own vertex engine and the random engines of the generators for the next event **/
+  void setEventSeed(ULong_t seed);
+
+  /** true if all generators can run concurrently and nothing goes through gRandom (no embedding) **/
+  bool canGenerateConcurrently() const;
+
   // sets the vertex mode; if mode is kCCDB, a valid MeanVertexObject pointer must be given at the same time
   void setVertexMode(o2::conf::VertexMode const& mode, o2::dataformats::MeanVertexObject const* obj = nullptr);
 
@@ -116,6 +123,7 @@ class PrimaryGenerator : public FairPrimaryGenerator
 
   o2::conf::VertexMode mVertexMode = o2::conf::VertexMode::kDiamondParam; // !vertex mode
   std::unique_ptr<o2::dataformats::MeanVertexObject> mMeanVertex;
+  std::unique_ptr<TRandom3> mRandom; //! vertex engine once reseeded by setEventSeed; gRandom otherwise
 
  private:
   void setGeneratorInformation();
@@ -26,6 +26,7 @@
 #include "ZDCBase/FragmentParam.h"
 
 #include <iostream>
+#include <mutex>
 
 namespace o2
 {
@@ -199,6 +200,16 @@ Bool_t
 
 /*****************************************************************/
 
+void GeneratorPythia8::setEventSeed(ULong_t seed)
+{
+  /** Pythia takes a time-based seed for 0, map it to the largest allowed one **/
+  auto pythiaSeed = seed % 900000000;
+  mPythia.rndm.init(pythiaSeed ? pythiaSeed : 900000000);
+  mEventSeeded = true;
+}
+
+/*****************************************************************/
+
 void GeneratorPythia8::updateHeader(o2::dataformats::MCEventHeader* eventHeader)
 {
   /** update header **/
@@ -456,6 +467,12 @@ void GeneratorPythia8::getNfreeSpec(const Pythia8::Info& info, int& nFreenProj,
   double b = hiinfo->b();
 
   static o2::zdc::FragmentParam frag; // data-driven model to get free spectators given impact parameter
+  static std::mutex fragMutex;        // the parametrisation is shared by the instances generating in parallel
+  std::lock_guard<std::mutex> lock(fragMutex);
+
+  auto gaus = [this](double mean, double sigma) {
+    return mEventSeeded ? mean + sigma * mPythia.rndm.gauss() : gRandom->Gaus(mean, sigma);
+  };
 
   TF1 const& fneutrons = frag.getfNeutrons();
   TF1 const& fsigman = frag.getsigmaNeutrons();
@@ -467,7 +484,7 @@ void GeneratorPythia8::getNfreeSpec(const Pythia8::Info& info, int& nFreenProj,
   for (int i = 0; i < 2; i++) {
     float nave = fneutrons.Eval(b);
     float sigman = fsigman.Eval(b);
-    float nfree = gRandom->Gaus(nave, 0.68 * sigman * nave);
+    float nfree = gaus(nave, 0.68 * sigman * nave);
     nneu[i] = (int)nfree;
     if (nave < 0 || nneu[i] < 0) {
       nneu[i] = 0;
@@ -481,7 +498,7 @@ void GeneratorPythia8::getNfreeSpec(const Pythia8::Info& info, int& nFreenProj,
   for (int i = 0; i < 2; i++) {
     float pave = fprotons.Eval(b);
     float sigmap = fsigman.Eval(b);
-    float pfree = gRandom->Gaus(pave, 0.68 * sigmap * pave) / 0.7;
+    float pfree = gaus(pave, 0.68 * sigmap * pave) / 0.7;
     npro[i] = (int)pfree;
     if (pave < 0 || npro[i] < 0) {
       npro[i] = 0;
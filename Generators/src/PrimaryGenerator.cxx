@@ -253,6 +253,41 @@ void PrimaryGenerator::setExternalVertexForNextEvent(double x, double y, double
 
 /*****************************************************************/
 
+void PrimaryGenerator::setEventSeed(ULong_t seed)
+{
+  /** set seed for the next event **/
+  if (!mRandom) {
+    mRandom = std::make_unique<TRandom3>();
+  }
+  mRandom->SetSeed(seed);
+  auto genList = GetListOfGenerators();
+  for (int igen = 0; igen < genList->GetEntries(); ++igen) {
+    auto o2gen = dynamic_cast<Generator*>(genList->At(igen));
+    if (o2gen) {
+      o2gen->setEventSeed(seed);
+    }
+  }
+}
+
+/*****************************************************************/
+
+bool PrimaryGenerator::canGenerateConcurrently() const
+{
+  if (mEmbedFile) {
+    return false;
+  }
+  auto genList = GetListOfGenerators();
+  for (int igen = 0; igen < genList->GetEntries(); ++igen) {
+    auto o2gen = dynamic_cast<Generator*>(genList->At(igen));
+    if (!o2gen || !o2gen->canGenerateConcurrently()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*****************************************************************/
+
 void PrimaryGenerator::setVertexMode(o2::conf::VertexMode const& mode, o2::dataformats::MeanVertexObject const* v)
 {
   mVertexMode = mode;
@@ -301,7 +336,7 @@ void PrimaryGenerator::fixInteractionVertex()
       LOG(fatal) << "MeanVertexObject is null ... but mode is kCCDB. Please inject the valid CCDB object via setVertexMode";
     }
   }
-  auto sampledvertex = mMeanVertex->sample();
+  auto sampledvertex = mRandom ? mMeanVertex->sample(*mRandom) : mMeanVertex->sample();
 
   LOG(info) << "Sampled interacting vertex " << sampledvertex;
   SetBeam(sampledvertex.X(), sampledvertex.Y(), 0., 0.);
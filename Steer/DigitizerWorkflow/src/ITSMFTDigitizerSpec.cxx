@@ -52,6 +52,7 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
   void initDigitizerTask(framework::InitContext& ic) override
   {
     mDisableQED = ic.options().get<bool>("disable-qed");
+    mDigitizer.setNThreads(ic.options().get<int>("nthreads"));
   }
 
   void run(framework::ProcessingContext& pc)
@@ -346,7 +347,8 @@ DataProcessorSpec getITSDigitizerSpec(int channel, bool mctruth)
                            inputs, makeOutChannels(detOrig, mctruth),
                            AlgorithmSpec{adaptFromTask<ITSDPLDigitizerTask>(mctruth)},
                            Options{
-                             {"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}}}};
+                             {"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}},
+                             {"nthreads", o2::framework::VariantType::Int, 1, {"number of threads digitizing the chips"}}}};
 }
 
 DataProcessorSpec getMFTDigitizerSpec(int channel, bool mctruth)
@@ -366,7 +368,8 @@ DataProcessorSpec getMFTDigitizerSpec(int channel, bool mctruth)
   return DataProcessorSpec{(detStr + "Digitizer").c_str(),
                            inputs, makeOutChannels(detOrig, mctruth),
                            AlgorithmSpec{adaptFromTask<MFTDPLDigitizerTask>(mctruth)},
-                           Options{{"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}}}};
+                           Options{{"disable-qed", o2::framework::VariantType::Bool, false, {"disable QED handling"}},
+                                   {"nthreads", o2::framework::VariantType::Int, 1, {"number of threads digitizing the chips"}}}};
 }
 
 } // end namespace itsmft
@@ -18,6 +18,11 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 class TChain;
@@ -28,6 +33,16 @@ namespace o2
 namespace steer
 {
 
+/// Lazy reader of the MC kinematics of one or many simulation productions.
+/// The events are loaded on demand and kept in a cache which, if a memory budget is set,
+/// evicts the least recently used events. The events pinned by the handles of getTrackPtr,
+/// getTracksPtr and getTrackRefsPtr are not evicted while the handles are alive, such that
+/// the handle getters may be called concurrently also with a budget.
+/// Without a budget the pointers, references and spans returned by the other getters stay valid
+/// until the event is released. With a budget they are only valid until the next call of the reader:
+/// these getters must then be called from the thread which set the budget (otherwise they throw).
+/// The tracks can be served from a flattened sidecar of the kinematics file (see writeFlatKinematics)
+/// which is memory-mapped: getTrack(label) then reads only the requested track.
 class MCKinematicsReader
 {
  public:
@@ -76,9 +91,16 @@ class MCKinematicsReader
   /// returns nullptr if no track was found
   MCTrack const* getTrack(int event, int track) const;
 
+  /// query an MC track given a basic label object, the handle keeps the track alive
+  /// returns nullptr if no track was found
+  std::shared_ptr<const MCTrack> getTrackPtr(o2::MCCompLabel const&) const;
+
   /// variant returning all tracks for source and event at once
   std::vector<MCTrack> const& getTracks(int source, int event) const;
 
+  /// tracks for source and event, kept alive by the returned pointer even if evicted from the cache
+  std::shared_ptr<const std::vector<MCTrack>> getTracksPtr(int source, int event) const;
+
   /// API to ask releasing tracks (freeing memory) for source + event
   void releaseTracksForSourceAndEvent(int source, int event);
 
@@ -97,6 +119,8 @@ class MCKinematicsReader
   const std::vector<o2::TrackReference>& getTrackRefsByEvent(int source, int event) const;
   /// return all track references associated to a event/track (when initialized from kinematics directly)
   gsl::span<o2::TrackReference> getTrackRefs(int event, int track) const;
+  /// track references of a source/event indexed by track, kept alive by the returned pointer even if evicted from the cache
+  std::shared_ptr<const o2::dataformats::MCTruthContainer<o2::TrackReference>> getTrackRefsPtr(int source, int event) const;
 
   /// retrieves the MCEventHeader for a given eventID and sourceID
   o2::dataformats::MCEventHeader const& getMCEventHeader(int source, int event) const;
@@ -112,22 +136,65 @@ class MCKinematicsReader
     return mDigitizationContext;
   }
 
+  /// limit the memory taken by the cached tracks and track references, 0 means no limit (default).
+  /// The calling thread becomes the only one allowed to use the getters returning plain pointers and references
+  void setMemoryBudget(size_t bytes);
+  size_t getMemoryBudget() const { return mMemoryBudget; }
+
+  /// memory currently taken by the cached tracks and track references
+  size_t getCachedBytes() const;
+
+  /// serve the tracks from the flattened sidecars of the kinematics files, to be called before any concurrent use.
+  /// Returns true if the sidecar of every source could be mapped
+  bool useFlatKinematics();
+
+  /// write the flattened sidecar of a kinematics file: an index of the first track of every event
+  /// followed by the tracks, directly usable once memory-mapped. The default name is given by
+  /// getFlatKinematicsFileName
+  static bool writeFlatKinematics(std::string_view kineFile, std::string_view flatFile = "");
+  static std::string getFlatKinematicsFileName(std::string_view kineFile);
+
  private:
+  /// cached data of one event
+  struct EventData {
+    std::shared_ptr<std::vector<o2::MCTrack>> tracks;
+    std::shared_ptr<o2::dataformats::MCTruthContainer<o2::TrackReference>> trackRefs;
+    size_t bytes = 0;                             ///< memory accounted for the event
+    std::list<std::pair<int, int>>::iterator lru; ///< position in the LRU list
+    bool cached = false;                          ///< whether the event is in the LRU list
+  };
+  /// memory-mapped flattened kinematics of one source
+  struct FlatKinematics {
+    char* data = nullptr;
+    size_t size = 0;
+    size_t nEvents = 0;
+    const uint64_t* offsets = nullptr; ///< index of the first track of each event, nEvents + 1 entries
+    const o2::MCTrack* tracks = nullptr;
+  };
+
   void initTracksForSource(int source) const;
-  void loadTracksForSourceAndEvent(int source, int eventID) const;
+  std::shared_ptr<std::vector<o2::MCTrack>> const& loadTracksForSourceAndEvent(int source, int eventID) const;
   void loadHeadersForSource(int source) const;
-  void loadTrackRefsForSource(int source) const;
+  std::shared_ptr<o2::dataformats::MCTruthContainer<o2::TrackReference>> const& loadTrackRefsForSourceAndEvent(int source, int eventID) const;
   void initIndexedTrackRefs(std::vector<o2::TrackReference>& refs, o2::dataformats::MCTruthContainer<o2::TrackReference>& indexedrefs) const;
+  void touch(int source, int eventID) const;
+  void evict() const;
+  void checkBudgetThread() const;
 
   DigitizationContext const* mDigitizationContext = nullptr;
 
   // chains for each source
   std::vector<TChain*> mInputChains;
+  std::vector<std::string> mKineFileNames; // kinematics file of each source
 
-  // a vector of tracks foreach source and each collision
-  mutable std::vector<std::vector<std::vector<o2::MCTrack>*>> mTracks;                                       // the in-memory track container
-  mutable std::vector<std::vector<o2::dataformats::MCEventHeader>> mHeaders;                                 // the in-memory header container
-  mutable std::vector<std::vector<o2::dataformats::MCTruthContainer<o2::TrackReference>>> mIndexedTrackRefs; // the in-memory track ref container
+  mutable std::vector<std::vector<EventData>> mEvents;                       //! the in-memory track and track ref cache
+  mutable std::vector<std::vector<o2::dataformats::MCEventHeader>> mHeaders; // the in-memory header container
+  std::vector<FlatKinematics> mFlat;                                         //! the memory-mapped tracks of each source
+  mutable std::list<std::pair<int, int>> mLRU;                               //! cached (source, event), most recently used first
+  mutable size_t mCachedBytes = 0;                                           // memory taken by the cached events
+  size_t mMemoryBudget = 0;                                                  // 0 for unlimited
+  std::thread::id mBudgetThread;                                             //! thread which set the budget
+  mutable std::mutex mMutex;                                                 //! guards the lazy loading
 
   bool mInitialized = false; // whether initialized
 };
@@ -142,6 +209,14 @@ inline MCTrack const* MCKinematicsReader::getTrack(o2::MCCompLabel const& label)
 
 inline MCTrack const* MCKinematicsReader::getTrack(int source, int event, int track) const
 {
+  if (source < (int)mFlat.size() && mFlat[source].data) {
+    // the mapping is immutable, no need to go through the cache
+    const auto& flat = mFlat[source];
+    if (event < 0 || event >= (int)flat.nEvents || track < 0 || uint64_t(track) >= flat.offsets[event + 1] - flat.offsets[event]) {
+      return nullptr;
+    }
+    return &flat.tracks[flat.offsets[event] + track];
+  }
   return &getTracks(source, event)[track];
 }
 
@@ -150,46 +225,11 @@ inline MCTrack const* MCKinematicsReader::getTrack(int event, int track) const
   return getTrack(0, event, track);
 }
 
-inline std::vector<MCTrack> const& MCKinematicsReader::getTracks(int source, int event) const
-{
-  if (mTracks[source].size() == 0) {
-    initTracksForSource(source);
-  }
-  if (mTracks[source][event] == nullptr) {
-    loadTracksForSourceAndEvent(source, event);
-  }
-  return *mTracks[source][event];
-}
-
 inline std::vector<MCTrack> const& MCKinematicsReader::getTracks(int event) const
 {
   return getTracks(0, event);
 }
 
-inline o2::dataformats::MCEventHeader const& MCKinematicsReader::getMCEventHeader(int source, int event) const
-{
-  if (mHeaders.at(source).size() == 0) {
-    loadHeadersForSource(source);
-  }
-  return mHeaders.at(source)[event];
-}
-
-inline gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int source, int event, int track) const
-{
-  if (mIndexedTrackRefs[source].size() == 0) {
-    loadTrackRefsForSource(source);
-  }
-  return mIndexedTrackRefs[source][event].getLabels(track);
-}
-
-inline const std::vector<o2::TrackReference>& MCKinematicsReader::getTrackRefsByEvent(int source, int event) const
-{
-  if (mIndexedTrackRefs[source].size() == 0) {
-    loadTrackRefsForSource(source);
-  }
-  return mIndexedTrackRefs[source][event].getTruthArray();
-}
-
 inline gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int event, int track) const
 {
   return getTrackRefs(0, event, track);
@@ -197,15 +237,7 @@ inline gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int event,
 
 inline size_t MCKinematicsReader::getNSources() const
 {
-  return mTracks.size();
-}
-
-inline size_t MCKinematicsReader::getNEvents(int source) const
-{
-  if (mTracks[source].size() == 0) {
-    initTracksForSource(source);
-  }
-  return mTracks[source].size();
+  return mEvents.size();
 }
 
 } // namespace steer
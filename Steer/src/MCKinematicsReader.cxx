@@ -14,11 +14,37 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include <TChain.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #include <fairlogger/Logger.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace o2::steer;
 
+namespace
+{
+// layout of the flattened kinematics: header, index of the first track of each event (nEvents + 1 entries), tracks
+struct FlatKinematicsHeader {
+  static constexpr uint64_t Magic = 0x454e494b54414c46; // "FLATKINE"
+  static constexpr uint32_t Version = 1;
+  uint64_t magic = Magic;
+  uint32_t version = Version;
+  uint32_t trackSize = sizeof(o2::MCTrack); // guards against a change of the MCTrack layout
+  uint64_t nEvents = 0;
+};
+static_assert(std::is_trivially_copyable_v<o2::MCTrack>, "MCTrack is mapped from file");
+static_assert(alignof(o2::MCTrack) <= alignof(uint64_t), "MCTrack must follow the index without padding");
+} // namespace
+
 MCKinematicsReader::~MCKinematicsReader()
 {
   for (auto chain : mInputChains) {
@@ -26,6 +52,12 @@ MCKinematicsReader::~MCKinematicsReader()
   }
   mInputChains.clear();
 
+  for (auto& flat : mFlat) {
+    if (flat.data) {
+      munmap(flat.data, flat.size);
+    }
+  }
+
   if (mDigitizationContext) {
     delete mDigitizationContext;
   }
@@ -52,37 +84,156 @@ void MCKinematicsReader::initIndexedTrackRefs(std::vector<o2::TrackReference>& r
 
 void MCKinematicsReader::initTracksForSource(int source) const
 {
+  if (mEvents[source].size()) {
+    return;
+  }
+  if (source < (int)mFlat.size() && mFlat[source].data) {
+    mEvents[source].resize(mFlat[source].nEvents);
+    return;
+  }
   auto chain = mInputChains[source];
   if (chain) {
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
-    mTracks[source].resize(br->GetEntries(), nullptr);
+    mEvents[source].resize(br->GetEntries());
   }
 }
 
-void MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
+std::shared_ptr<std::vector<o2::MCTrack>> const& MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
 {
-  auto chain = mInputChains[source];
-  if (chain) {
-    // todo: get name from NameConfig
-    auto br = chain->GetBranch("MCTrack");
-    if (br) {
-      std::vector<MCTrack>* loadtracks = nullptr;
-      br->SetAddress(&loadtracks);
-      br->GetEntry(event);
-      mTracks[source][event] = new std::vector<o2::MCTrack>;
-      *mTracks[source][event] = *loadtracks;
-      delete loadtracks;
+  auto& data = mEvents[source][event];
+  if (!data.tracks) {
+    auto tracks = std::make_shared<std::vector<o2::MCTrack>>();
+    if (source < (int)mFlat.size() && mFlat[source].data) {
+      const auto& flat = mFlat[source];
+      tracks->assign(flat.tracks + flat.offsets[event], flat.tracks + flat.offsets[event + 1]);
+    } else if (auto chain = mInputChains[source]) {
+      // todo: get name from NameConfig
+      auto br = chain->GetBranch("MCTrack");
+      if (br) {
+        std::vector<MCTrack>* loadtracks = nullptr;
+        br->SetAddress(&loadtracks);
+        br->GetEntry(event);
+        if (loadtracks) {
+          tracks->swap(*loadtracks);
+        }
+        br->ResetAddress();
+        delete loadtracks;
+      }
     }
+    const size_t bytes = tracks->capacity() * sizeof(o2::MCTrack);
+    data.tracks = std::move(tracks);
+    data.bytes += bytes;
+    mCachedBytes += bytes;
   }
+  touch(source, event);
+  evict();
+  return data.tracks;
 }
 
 void MCKinematicsReader::releaseTracksForSourceAndEvent(int source, int eventID)
 {
-  if (mTracks.at(source).at(eventID) != nullptr) {
-    delete mTracks[source][eventID];
-    mTracks[source][eventID] = nullptr;
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto& data = mEvents.at(source).at(eventID);
+  if (data.tracks) {
+    const size_t bytes = data.tracks->capacity() * sizeof(o2::MCTrack);
+    data.tracks.reset();
+    data.bytes -= bytes;
+    mCachedBytes -= bytes;
+    if (!data.trackRefs && data.cached) {
+      mLRU.erase(data.lru);
+      data.cached = false;
+    }
+  }
+}
+
+void MCKinematicsReader::touch(int source, int event) const
+{
+  auto& data = mEvents[source][event];
+  if (data.cached) {
+    mLRU.splice(mLRU.begin(), mLRU, data.lru);
+  } else {
+    data.lru = mLRU.emplace(mLRU.begin(), source, event);
+    data.cached = true;
+  }
+}
+
+void MCKinematicsReader::evict() const
+{
+  if (!mMemoryBudget || mLRU.empty()) {
+    return;
+  }
+  // the most recently used event is always kept, its data is about to be returned.
+  // The events still referenced by the handles of the Ptr getters are pinned
+  auto it = std::prev(mLRU.end());
+  while (mCachedBytes > mMemoryBudget && it != mLRU.begin()) {
+    auto [source, event] = *it;
+    auto& data = mEvents[source][event];
+    if (data.tracks.use_count() > 1 || data.trackRefs.use_count() > 1) {
+      --it;
+      continue;
+    }
+    data.tracks.reset();
+    data.trackRefs.reset();
+    mCachedBytes -= data.bytes;
+    data.bytes = 0;
+    data.cached = false;
+    it = std::prev(mLRU.erase(it));
+  }
+}
+
+void MCKinematicsReader::checkBudgetThread() const
+{
+  if (mMemoryBudget && std::this_thread::get_id() != mBudgetThread) {
+    throw std::runtime_error("MCKinematicsReader: with a memory budget only the Ptr getters may be used from other threads");
+  }
+}
+
+std::vector<o2::MCTrack> const& MCKinematicsReader::getTracks(int source, int event) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  checkBudgetThread();
+  initTracksForSource(source);
+  return *loadTracksForSourceAndEvent(source, event);
+}
+
+std::shared_ptr<const MCTrack> MCKinematicsReader::getTrackPtr(o2::MCCompLabel const& label) const
+{
+  const int source = label.getSourceID();
+  const int event = label.getEventID();
+  const int track = label.getTrackID();
+  if (source < (int)mFlat.size() && mFlat[source].data) {
+    // the mapping lives as long as the reader, the handle does not own anything
+    return std::shared_ptr<const MCTrack>(std::shared_ptr<const MCTrack>{}, getTrack(source, event, track));
+  }
+  auto tracks = getTracksPtr(source, event);
+  if (track < 0 || track >= (int)tracks->size()) {
+    return nullptr;
+  }
+  return std::shared_ptr<const MCTrack>(tracks, &(*tracks)[track]);
+}
+
+std::shared_ptr<const std::vector<o2::MCTrack>> MCKinematicsReader::getTracksPtr(int source, int event) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  initTracksForSource(source);
+  return loadTracksForSourceAndEvent(source, event);
+}
+
+size_t MCKinematicsReader::getNEvents(int source) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  initTracksForSource(source);
+  return mEvents[source].size();
+}
+
+o2::dataformats::MCEventHeader const& MCKinematicsReader::getMCEventHeader(int source, int event) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mHeaders.at(source).size() == 0) {
+    loadHeadersForSource(source);
   }
+  return mHeaders.at(source)[event];
 }
 
 void MCKinematicsReader::loadHeadersForSource(int source) const
@@ -107,29 +258,174 @@ void MCKinematicsReader::loadHeadersForSource(int source) const
   }
 }
 
-void MCKinematicsReader::loadTrackRefsForSource(int source) const
+std::shared_ptr<o2::dataformats::MCTruthContainer<o2::TrackReference>> const& MCKinematicsReader::loadTrackRefsForSourceAndEvent(int source, int event) const
 {
-  auto chain = mInputChains[source];
-  if (chain) {
+  initTracksForSource(source);
+  auto& data = mEvents[source][event];
+  if (!data.trackRefs) {
+    // only the requested event is read and indexed
+    auto indexedrefs = std::make_shared<o2::dataformats::MCTruthContainer<o2::TrackReference>>();
+    auto chain = mInputChains[source];
     // todo: get name from NameConfig
-    auto br = chain->GetBranch("TrackRefs");
+    auto br = chain ? chain->GetBranch("TrackRefs") : nullptr;
     if (br) {
       std::vector<o2::TrackReference>* refs = nullptr;
       br->SetAddress(&refs);
-      mIndexedTrackRefs[source].resize(br->GetEntries());
-      for (int event = 0; event < br->GetEntries(); ++event) {
-        br->GetEntry(event);
-        if (refs) {
-          // we convert the original flat vector into an indexed structure
-          initIndexedTrackRefs(*refs, mIndexedTrackRefs[source][event]);
-          delete refs;
-          refs = nullptr;
-        }
+      br->GetEntry(event);
+      if (refs) {
+        // we convert the original flat vector into an indexed structure
+        initIndexedTrackRefs(*refs, *indexedrefs);
       }
+      br->ResetAddress();
+      delete refs;
     } else {
       LOG(warn) << "TrackRefs branch not found";
     }
+    const size_t bytes = indexedrefs->getIndexedSize() * sizeof(o2::dataformats::MCTruthHeaderElement) + indexedrefs->getNElements() * sizeof(o2::TrackReference);
+    data.trackRefs = std::move(indexedrefs);
+    data.bytes += bytes;
+    mCachedBytes += bytes;
+  }
+  touch(source, event);
+  evict();
+  return data.trackRefs;
+}
+
+gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int source, int event, int track) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  checkBudgetThread();
+  return loadTrackRefsForSourceAndEvent(source, event)->getLabels(track);
+}
+
+const std::vector<o2::TrackReference>& MCKinematicsReader::getTrackRefsByEvent(int source, int event) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  checkBudgetThread();
+  return loadTrackRefsForSourceAndEvent(source, event)->getTruthArray();
+}
+
+std::shared_ptr<const o2::dataformats::MCTruthContainer<o2::TrackReference>> MCKinematicsReader::getTrackRefsPtr(int source, int event) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return loadTrackRefsForSourceAndEvent(source, event);
+}
+
+void MCKinematicsReader::setMemoryBudget(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mMemoryBudget = bytes;
+  mBudgetThread = std::this_thread::get_id();
+  evict();
+}
+
+size_t MCKinematicsReader::getCachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mCachedBytes;
+}
+
+std::string MCKinematicsReader::getFlatKinematicsFileName(std::string_view kineFile)
+{
+  std::string name{kineFile};
+  const std::string_view ext = ".root";
+  if (name.size() > ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0) {
+    name.resize(name.size() - ext.size());
+  }
+  return name + ".flat";
+}
+
+bool MCKinematicsReader::writeFlatKinematics(std::string_view kineFile, std::string_view flatFile)
+{
+  std::unique_ptr<TFile> file(TFile::Open(std::string(kineFile).c_str()));
+  if (!file || file->IsZombie()) {
+    LOG(error) << "Could not open kinematics file " << kineFile;
+    return false;
+  }
+  auto tree = file->Get<TTree>("o2sim");
+  auto br = tree ? tree->GetBranch("MCTrack") : nullptr;
+  if (!br) {
+    LOG(error) << "MCTrack branch not found in " << kineFile;
+    return false;
+  }
+  const std::string outName = flatFile.empty() ? getFlatKinematicsFileName(kineFile) : std::string(flatFile);
+  std::ofstream out(outName, std::ios::binary);
+  if (!out) {
+    LOG(error) << "Could not create flattened kinematics file " << outName;
+    return false;
+  }
+  FlatKinematicsHeader header;
+  header.nEvents = br->GetEntries();
+  std::vector<uint64_t> offsets(header.nEvents + 1, 0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t)); // filled at the end
+  std::vector<o2::MCTrack>* tracks = nullptr;
+  br->SetAddress(&tracks);
+  for (uint64_t event = 0; event < header.nEvents; ++event) {
+    br->GetEntry(event);
+    out.write(reinterpret_cast<const char*>(tracks->data()), tracks->size() * sizeof(o2::MCTrack));
+    offsets[event + 1] = offsets[event] + tracks->size();
+  }
+  br->ResetAddress();
+  delete tracks;
+  out.seekp(sizeof(header));
+  out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+  out.close();
+  if (!out) {
+    LOG(error) << "Failed to write flattened kinematics file " << outName;
+    return false;
+  }
+  LOG(info) << "Wrote " << offsets.back() << " tracks of " << header.nEvents << " events to " << outName;
+  return true;
+}
+
+bool MCKinematicsReader::useFlatKinematics()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFlat.resize(mKineFileNames.size());
+  bool ok = true;
+  for (size_t source = 0; source < mKineFileNames.size(); ++source) {
+    auto& flat = mFlat[source];
+    if (flat.data) {
+      continue;
+    }
+    const auto name = getFlatKinematicsFileName(mKineFileNames[source]);
+    int fd = open(name.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(FlatKinematicsHeader)) {
+      LOG(warn) << "Flattened kinematics " << name << " not available, reading " << mKineFileNames[source];
+      if (fd >= 0) {
+        close(fd);
+      }
+      ok = false;
+      continue;
+    }
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      LOG(warn) << "Could not map flattened kinematics " << name;
+      ok = false;
+      continue;
+    }
+    madvise(ptr, st.st_size, MADV_RANDOM); // accessed by label
+    const auto* header = reinterpret_cast<const FlatKinematicsHeader*>(ptr);
+    const size_t indexEnd = sizeof(FlatKinematicsHeader) + (header->nEvents + 1) * sizeof(uint64_t);
+    const auto* offsets = reinterpret_cast<const uint64_t*>(reinterpret_cast<const char*>(ptr) + sizeof(FlatKinematicsHeader));
+    if (header->magic != FlatKinematicsHeader::Magic || header->version != FlatKinematicsHeader::Version || header->trackSize != sizeof(o2::MCTrack) ||
+        indexEnd > size_t(st.st_size) || indexEnd + offsets[header->nEvents] * sizeof(o2::MCTrack) > size_t(st.st_size) ||
+        (mEvents[source].size() && mEvents[source].size() != header->nEvents)) {
+      LOG(warn) << "Flattened kinematics " << name << " is not compatible, reading " << mKineFileNames[source];
+      munmap(ptr, st.st_size);
+      ok = false;
+      continue;
+    }
+    flat.data = reinterpret_cast<char*>(ptr);
+    flat.size = st.st_size;
+    flat.nEvents = header->nEvents;
+    flat.offsets = offsets;
+    flat.tracks = reinterpret_cast<const o2::MCTrack*>(flat.data + indexEnd);
   }
+  return ok;
 }
 
 bool MCKinematicsReader::initFromDigitContext(std::string_view name)
@@ -148,11 +444,13 @@ bool MCKinematicsReader::initFromDigitContext(std::string_view name)
 
   // get the chains to read
   mDigitizationContext->initSimKinematicsChains(mInputChains);
+  for (const auto& prefix : mDigitizationContext->getSimPrefixes()) {
+    mKineFileNames.emplace_back(o2::base::NameConf::getMCKinematicsFileName(prefix));
+  }
 
   // load the kinematics information
-  mTracks.resize(mInputChains.size());
+  mEvents.resize(mInputChains.size());
   mHeaders.resize(mInputChains.size());
-  mIndexedTrackRefs.resize(mInputChains.size());
 
   // actual loading will be done only if someone asks
   // the first time for a particular source ...
@@ -166,11 +464,11 @@ bool MCKinematicsReader::initFromKinematics(std::string_view name)
     LOG(info) << "MCKinematicsReader already initialized; doing nothing";
     return false;
   }
+  mKineFileNames.emplace_back(o2::base::NameConf::getMCKinematicsFileName(name.data()));
   mInputChains.emplace_back(new TChain("o2sim"));
-  mInputChains.back()->AddFile(o2::base::NameConf::getMCKinematicsFileName(name.data()).c_str());
-  mTracks.resize(1);
+  mInputChains.back()->AddFile(mKineFileNames.back().c_str());
+  mEvents.resize(1);
   mHeaders.resize(1);
-  mIndexedTrackRefs.resize(1);
   mInitialized = true;
 
   return true;
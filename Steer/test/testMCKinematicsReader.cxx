@@ -0,0 +1,118 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MCKinematicsReader class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "Steer/MCKinematicsReader.h"
+#include "CommonUtils/NameConf.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+namespace steer
+{
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReaderTest)
+{
+  // mockup kinematics: event i has 10 * (i + 1) tracks, track j of event i has pdg code 1000 * i + j
+  const std::string prefix = "kinereadertest";
+  const int nEvents = 5;
+  {
+    TFile file(o2::base::NameConf::getMCKinematicsFileName(prefix).c_str(), "RECREATE");
+    TTree tree("o2sim", "");
+    std::vector<o2::MCTrack> tracks, *tracksPtr = &tracks;
+    std::vector<o2::TrackReference> refs, *refsPtr = &refs;
+    tree.Branch("MCTrack", &tracksPtr);
+    tree.Branch("TrackRefs", &refsPtr);
+    for (int event = 0; event < nEvents; ++event) {
+      tracks.clear();
+      refs.clear();
+      for (int track = 0; track < 10 * (event + 1); ++track) {
+        tracks.emplace_back(1000 * event + track, -1, -1, -1, -1, 1., 0., 0., 0., 0., 0., 0., 0);
+        refs.emplace_back(0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 2.f, 0.f, track, 0);
+        refs.emplace_back(0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, track, 0);
+      }
+      tree.Fill();
+    }
+    tree.Write();
+    file.Close();
+  }
+
+  MCKinematicsReader reader(prefix, MCKinematicsReader::Mode::kMCKine);
+  BOOST_CHECK(reader.isInitialized());
+  BOOST_CHECK_EQUAL(reader.getNEvents(0), nEvents);
+  BOOST_CHECK_EQUAL(reader.getTrack(o2::MCCompLabel(7, 3, 0))->GetPdgCode(), 3007);
+  BOOST_CHECK_EQUAL(reader.getTracks(0, 4).size(), 50);
+
+  // track references are indexed per event and sorted by length
+  auto trackRefs = reader.getTrackRefs(0, 2, 5);
+  BOOST_CHECK_EQUAL(trackRefs.size(), 2);
+  BOOST_CHECK(trackRefs[0].getLength() < trackRefs[1].getLength());
+
+  // the budget evicts the least recently used events, the pinned events stay cached
+  auto pinned = reader.getTracksPtr(0, 0);
+  auto pinnedTrack = reader.getTrackPtr(o2::MCCompLabel(3, 1, 0));
+  auto pinnedRefs = reader.getTrackRefsPtr(0, 2);
+  const size_t eventBytes = 50 * sizeof(o2::MCTrack);
+  reader.setMemoryBudget(3 * eventBytes);
+  for (int event = 0; event < nEvents; ++event) {
+    BOOST_CHECK_EQUAL(reader.getTracks(0, event)[event].GetPdgCode(), 1000 * event + event);
+  }
+  BOOST_CHECK_EQUAL(pinned->size(), 10);
+  BOOST_CHECK_EQUAL((*pinned)[9].GetPdgCode(), 9);
+  BOOST_CHECK_EQUAL(pinnedTrack->GetPdgCode(), 1003);
+  BOOST_CHECK_EQUAL(pinnedRefs->getLabels(5).size(), 2);
+  BOOST_CHECK(reader.getTrackPtr(o2::MCCompLabel(50, 4, 0)) == nullptr);
+  // once released, the unpinned events are evicted down to the budget
+  pinned.reset();
+  pinnedTrack.reset();
+  pinnedRefs.reset();
+  reader.getTracks(0, 4);
+  BOOST_CHECK(reader.getCachedBytes() <= 3 * eventBytes);
+
+  // with a budget the plain references may be requested only by the thread which set it
+  bool thrown = false;
+  int pdgCode = 0;
+  std::thread other([&]() {
+    try {
+      reader.getTracks(0, 1);
+    } catch (std::runtime_error const&) {
+      thrown = true;
+    }
+    pdgCode = reader.getTrackPtr(o2::MCCompLabel(2, 1, 0))->GetPdgCode();
+  });
+  other.join();
+  BOOST_CHECK(thrown);
+  BOOST_CHECK_EQUAL(pdgCode, 1002);
+
+  // flattened sidecar, the tracks are then served from the mapped file
+  BOOST_CHECK(MCKinematicsReader::writeFlatKinematics(o2::base::NameConf::getMCKinematicsFileName(prefix)));
+  MCKinematicsReader flatReader(prefix, MCKinematicsReader::Mode::kMCKine);
+  BOOST_CHECK(flatReader.useFlatKinematics());
+  BOOST_CHECK_EQUAL(flatReader.getNEvents(0), nEvents);
+  for (int event = 0; event < nEvents; ++event) {
+    for (int track = 0; track < 10 * (event + 1); ++track) {
+      BOOST_CHECK_EQUAL(flatReader.getTrack(0, event, track)->GetPdgCode(), 1000 * event + track);
+    }
+    BOOST_CHECK(flatReader.getTrack(0, event, 10 * (event + 1)) == nullptr);
+  }
+  BOOST_CHECK_EQUAL(flatReader.getCachedBytes(), 0);
+  BOOST_CHECK_EQUAL(flatReader.getTracks(0, 1).size(), 20);
+}
+
+} // namespace steer
+} // namespace o2
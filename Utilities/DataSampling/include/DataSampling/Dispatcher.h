@@ -24,6 +24,7 @@
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/Task.h"
+#include "Framework/ConcreteDataMatcher.h"
 
 #include <fairmq/FwdDecls.h>
 #include "DataSampling/DataSamplingHeader.h"
@@ -64,16 +65,26 @@ class Dispatcher : public framework::Task
   framework::Options getOptions();
 
  private:
+  /// A policy matching an input, together with the output it should be sent to
+  struct PolicyMatch {
+    DataSamplingPolicy* policy;
+    framework::ConcreteDataTypeMatcher output;
+  };
+
   DataSamplingHeader prepareDataSamplingHeader(const DataSamplingPolicy& policy);
   header::Stack extractAdditionalHeaders(const char* inputHeaderStack) const;
   void reportStats(monitoring::Monitoring& monitoring) const;
-  void send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, const framework::Output& output) const;
+  void send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, const fair::mq::Message* payloadMessage, const framework::Output& output) const;
+  /// Returns the policies matching the input, the matching is done only once per input.
+  const std::vector<PolicyMatch>& getMatchingPolicies(const framework::ConcreteDataMatcher& input);
 
   std::string mName;
   DataSamplingHeader::DeviceIDType mDeviceID = "invalid";
   std::string mReconfigurationSource;
   // policies should be shared between all pipeline threads
   std::vector<std::shared_ptr<DataSamplingPolicy>> mPolicies;
+  // matching policies for each input seen so far
+  std::vector<std::pair<framework::ConcreteDataMatcher, std::vector<PolicyMatch>>> mMatchCache;
 };
 
 } // namespace o2::utilities
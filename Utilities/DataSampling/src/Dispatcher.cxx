@@ -27,6 +27,8 @@
 #include "Framework/DataProcessingHelpers.h"
 #include "Framework/DataRelayer.h"
 
+#include <fairmq/Message.h>
+
 #include <Configuration/ConfigurationInterface.h>
 #include <Configuration/ConfigurationFactory.h>
 
@@ -53,9 +55,11 @@ void Dispatcher::init(InitContext& ctx)
     std::unique_ptr<ConfigurationInterface> cfg = ConfigurationFactory::getConfiguration(mReconfigurationSource);
     policiesTree = cfg->getRecursive("dataSamplingPolicies");
     mPolicies.clear();
+    mMatchCache.clear();
   } else if (ctx.options().isSet("sampling-config-ptree")) {
     policiesTree = ctx.options().get<boost::property_tree::ptree>("sampling-config-ptree");
     mPolicies.clear();
+    mMatchCache.clear();
   } else {
     ; // we use policies declared during workflow init.
   }
@@ -81,8 +85,9 @@ void Dispatcher::run(ProcessingContext& ctx)
 {
   // todo: consider matching (and deciding) in completion policy to save some time
   //  it is not trivial though, we would have to share state with the customize() method,
-  //  which is not possible atm.
+  //  which is not possible atm. Instead, the matching is cached per input.
 
+  auto& span = ctx.inputs().span();
   for (auto inputIt = ctx.inputs().begin(); inputIt != ctx.inputs().end(); inputIt++) {
 
     const DataRef& firstPart = inputIt.getByPos(0);
@@ -92,32 +97,29 @@ void Dispatcher::run(ProcessingContext& ctx)
     const auto* firstInputHeader = DataRefUtils::getHeader<header::DataHeader*>(firstPart);
     ConcreteDataMatcher inputMatcher{firstInputHeader->dataOrigin, firstInputHeader->dataDescription, firstInputHeader->subSpecification};
 
-    for (auto& policy : mPolicies) {
-      // fixme: in principle matching could be broken by having query "TST/RAWDATA/0" and having parts with just
-      //  the first subspec == 0, but others could be different. However, we trust that DPL does necessary checks
-      //  during workflow validation and when passing messages (e.g. query "TST/RAWDATA/0" should not match
-      //  a "TST/RAWDATA/*" output.
-      if (auto route = policy->match(inputMatcher); route != nullptr && policy->decide(firstPart)) {
-        auto routeAsConcreteDataType = DataSpecUtils::asConcreteDataTypeMatcher(*route);
-        auto dsheader = prepareDataSamplingHeader(*policy);
-        for (const auto& part : inputIt) {
-          if (part.header != nullptr) {
-            // We copy every header which is not DataHeader or DataProcessingHeader,
-            // so that custom data-dependent headers are passed forward,
-            // and we add a DataSamplingHeader.
-            header::Stack headerStack{
-              std::move(extractAdditionalHeaders(part.header)),
-              dsheader};
-            const auto* partInputHeader = DataRefUtils::getHeader<header::DataHeader*>(part);
-
-            Output output{
-              routeAsConcreteDataType.origin,
-              routeAsConcreteDataType.description,
-              partInputHeader->subSpecification,
-              part.spec->lifetime,
-              std::move(headerStack)};
-            send(ctx.outputs(), part, output);
-          }
+    for (const auto& [policy, routeAsConcreteDataType] : getMatchingPolicies(inputMatcher)) {
+      if (!policy->decide(firstPart)) {
+        continue;
+      }
+      auto dsheader = prepareDataSamplingHeader(*policy);
+      for (size_t partIndex = 0; partIndex < inputIt.size(); ++partIndex) {
+        const DataRef part = inputIt.getByPos(partIndex);
+        if (part.header != nullptr) {
+          // We copy every header which is not DataHeader or DataProcessingHeader,
+          // so that custom data-dependent headers are passed forward,
+          // and we add a DataSamplingHeader.
+          header::Stack headerStack{
+            std::move(extractAdditionalHeaders(part.header)),
+            dsheader};
+          const auto* partInputHeader = DataRefUtils::getHeader<header::DataHeader*>(part);
+
+          Output output{
+            routeAsConcreteDataType.origin,
+            routeAsConcreteDataType.description,
+            partInputHeader->subSpecification,
+            part.spec->lifetime,
+            std::move(headerStack)};
+          send(ctx.outputs(), part, span.payloadMessage(inputIt.position(), partIndex), output);
         }
       }
     }
@@ -172,15 +174,43 @@ header::Stack Dispatcher::extractAdditionalHeaders(const char* inputHeaderStack)
   return headerStack;
 }
 
-void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, const Output& output) const
+const std::vector<Dispatcher::PolicyMatch>& Dispatcher::getMatchingPolicies(const ConcreteDataMatcher& input)
+{
+  for (const auto& [matcher, matches] : mMatchCache) {
+    if (matcher == input) {
+      return matches;
+    }
+  }
+
+  std::vector<PolicyMatch> matches;
+  for (auto& policy : mPolicies) {
+    // fixme: in principle matching could be broken by having query "TST/RAWDATA/0" and having parts with just
+    //  the first subspec == 0, but others could be different. However, we trust that DPL does necessary checks
+    //  during workflow validation and when passing messages (e.g. query "TST/RAWDATA/0" should not match
+    //  a "TST/RAWDATA/*" output.
+    if (auto route = policy->match(input); route != nullptr) {
+      matches.push_back({policy.get(), DataSpecUtils::asConcreteDataTypeMatcher(*route)});
+    }
+  }
+  return mMatchCache.emplace_back(input, std::move(matches)).second;
+}
+
+void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, const fair::mq::Message* payloadMessage, const Output& output) const
 {
   const auto* inputHeader = DataRefUtils::getHeader<header::DataHeader*>(inputData);
-  dataAllocator.snapshot(output, inputData.payload, DataRefUtils::getPayloadSize(inputData), inputHeader->payloadSerializationMethod);
+  auto payloadSize = DataRefUtils::getPayloadSize(inputData);
+  if (payloadMessage != nullptr && payloadMessage->GetData() == inputData.payload && payloadMessage->GetSize() == payloadSize) {
+    // the payload is passed by reference, only the header stack is new
+    dataAllocator.forward(output, *payloadMessage, inputHeader->payloadSerializationMethod);
+  } else {
+    dataAllocator.snapshot(output, inputData.payload, payloadSize, inputHeader->payloadSerializationMethod);
+  }
 }
 
 void Dispatcher::registerPolicy(std::unique_ptr<DataSamplingPolicy>&& policy)
 {
   mPolicies.emplace_back(std::move(policy));
+  mMatchCache.clear();
 }
 
 const std::string& Dispatcher::getName()
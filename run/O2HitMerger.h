@@ -58,6 +58,7 @@
 #include <ZDCSimulation/Detector.h>
 
 #include "CommonUtils/ShmManager.h"
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <list>
@@ -76,6 +77,9 @@
 #endif
 
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 
 namespace o2
 {
@@ -138,6 +142,12 @@ class O2HitMerger : public fair::mq::Device
     mForwardKine = o2::conf::SimConfig::Instance().forwardKine();
     mWriteToDisc = o2::conf::SimConfig::Instance().writeToDisc();
 
+    mNMergerThreads = std::max(1, fConfig->GetProperty<int>("merger-threads", 1));
+    if (mNMergerThreads > 1) {
+      mMergerArena.initialize(mNMergerThreads);
+      LOG(info) << "Merging hits of different detectors with " << mNMergerThreads << " threads";
+    }
+
     mOutFileName = outfilename.c_str();
     if (mWriteToDisc) {
       mOutFile = new TFile(outfilename.c_str(), "RECREATE");
@@ -752,23 +762,27 @@ class O2HitMerger : public fair::mq::Device
         eventheader->putInfo("prims_total", prims);
       };
 
-      reorderAndMergeMCTracks(flusheventID, mOutTree, nprimaries, subevOrdered, mcheaderhook, eventheader);
+      // the kinematics part (tracks, track references, header) goes into mOutTree while every
+      // detector writes to its own TTree/TFile; they are independent and can be merged concurrently
+      auto mergeKinematics = [&]() {
+        reorderAndMergeMCTracks(flusheventID, mOutTree, nprimaries, subevOrdered, mcheaderhook, eventheader);
 
-      if (mOutTree) {
-        // adjusting and merging track references
-        remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
-
-        // write MC event headers
-        auto headerbr = o2::base::getOrMakeBranch(*mOutTree, "MCEventHeader.", &eventheader);
-        headerbr->SetAddress(&eventheader);
-        headerbr->Fill();
-        headerbr->ResetAddress();
-      }
+        if (mOutTree) {
+          // adjusting and merging track references
+          remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
+
+          // write MC event headers
+          auto headerbr = o2::base::getOrMakeBranch(*mOutTree, "MCEventHeader.", &eventheader);
+          headerbr->SetAddress(&eventheader);
+          headerbr->Fill();
+          headerbr->ResetAddress();
+        }
+      };
 
       // c) do the merge procedure for all hits ... delegate this to detector specific functions
       // since they know about types; number of branches; etc.
       // this will also fix the trackIDs inside the hits
-      for (int id = 0; id < mDetectorInstances.size(); ++id) {
+      auto mergeDetector = [&](int id) {
         auto& det = mDetectorInstances[id];
         if (det) {
           auto hittree = mDetectorToTTreeMap[id];
@@ -778,6 +792,20 @@ class O2HitMerger : public fair::mq::Device
             LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
           }
         }
+      };
+
+      if (mNMergerThreads > 1) {
+        mMergerArena.execute([&]() {
+          tbb::task_group group;
+          group.run(mergeKinematics);
+          tbb::parallel_for(0, (int)mDetectorInstances.size(), mergeDetector);
+          group.wait();
+        });
+      } else {
+        mergeKinematics();
+        for (int id = 0; id < mDetectorInstances.size(); ++id) {
+          mergeDetector(id);
+        }
       }
 
       // increase the entry count in the tree
@@ -836,6 +864,9 @@ class O2HitMerger : public fair::mq::Device
 
   int mPipeToDriver = -1;
 
+  int mNMergerThreads = 1;        //! number of threads used to merge detectors concurrently
+  tbb::task_arena mMergerArena{}; //! arena bounding the merge parallelism
+
   std::vector<std::unique_ptr<o2::base::Detector>> mDetectorInstances; //!
 
   // output folder configuration
@@ -17,6 +17,8 @@
 namespace bpo = boost::program_options;
 void addCustomOptions(bpo::options_description& options)
 {
+  options.add_options()(
+    "merger-threads", bpo::value<int>()->default_value(1), "number of threads used to merge the hits of different detectors concurrently");
 }
 
 std::unique_ptr<fair::mq::Device> getDevice(fair::mq::ProgOptions& config)
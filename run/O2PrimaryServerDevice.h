@@ -37,9 +37,15 @@
 #include <thread>
 #include <TROOT.h>
 #include <TStopwatch.h>
+#include <TDatabasePDG.h>
+#include <TRandom.h>
 #include <fstream>
 #include <iostream>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <memory>
 #include "PrimaryServerState.h"
 #include "SimPublishChannelHelper.h"
 #include <chrono>
@@ -69,6 +75,7 @@ class O2PrimaryServerDevice final : public fair::mq::Device
       if (mGeneratorThread.joinable()) {
         mGeneratorThread.join();
       }
+      stopEventGeneration();
       if (mControlThread.joinable()) {
         mControlThread.join();
       }
@@ -77,6 +84,20 @@ class O2PrimaryServerDevice final : public fair::mq::Device
   }
 
  protected:
+  // one independent generator together with the stack and header it fills
+  struct GeneratorInstance {
+    o2::eventgen::PrimaryGenerator* generator = nullptr;
+    std::unique_ptr<o2::data::Stack> stack;
+    o2::dataformats::MCEventHeader header;
+    bool concurrent = false; // generates without mGenerationMutex, drawing only from its own engines
+  };
+
+  // a generated event waiting to be served to the workers
+  struct GeneratedEvent {
+    std::vector<TParticle> primaries;
+    o2::dataformats::MCEventHeader header;
+  };
+
   void initGenerator()
   {
     TStopwatch timer;
@@ -100,41 +121,45 @@ class O2PrimaryServerDevice final : public fair::mq::Device
     //
     // Not using cached instances for external kinematics since these might change input filenames etc.
     // and are in any case quickly setup.
-    mPrimGen = nullptr;
+    std::vector<o2::eventgen::PrimaryGenerator*> cached;
     if (conf.getGenerator().compare("extkin") != 0 || conf.getGenerator().compare("extkinO2") != 0) {
       auto iter = mPrimGeneratorCache.find(conf.getGenerator());
       if (iter != mPrimGeneratorCache.end()) {
-        mPrimGen = iter->second;
+        cached = iter->second;
         LOG(info) << "Found cached generator for " << conf.getGenerator();
       }
     }
 
-    if (mPrimGen == nullptr) {
-      mPrimGen = new o2::eventgen::PrimaryGenerator;
-      o2::eventgen::GeneratorFactory::setPrimaryGenerator(conf, mPrimGen);
+    // generators reading events sequentially from some input can only have one instance
+    int ngenerators = conf.getNGenerators();
+    if (ngenerators > 1 && (isFileBasedGenerator(conf.getGenerator()) || !conf.getEmbedIntoFileName().empty())) {
+      LOG(warn) << "Generator " << conf.getGenerator() << " reads its input sequentially; using a single generator instance";
+      ngenerators = 1;
+    }
 
-      // setup vertexing
-      auto vtxMode = conf.getVertexMode();
-      using o2::conf::VertexMode;
-      if (vtxMode == VertexMode::kNoVertex || vtxMode == VertexMode::kDiamondParam) {
-        mPrimGen->setVertexMode(vtxMode);
-      } else if (vtxMode == VertexMode::kCCDB) {
-        // we need to fetch the CCDB object
-        mPrimGen->setVertexMode(vtxMode, ccdbmgr.getForTimeStamp<o2::dataformats::MeanVertexObject>("GLO/Calib/MeanVertex", conf.getTimestamp()));
+    mGenerators.resize(ngenerators);
+    for (int instance = 0; instance < ngenerators; ++instance) {
+      auto& gen = mGenerators[instance];
+      if (instance < cached.size()) {
+        gen.generator = cached[instance];
       } else {
-        LOG(fatal) << "Unsupported vertex mode";
+        gen.generator = createGenerator(ccdbmgr);
+        cached.push_back(gen.generator);
       }
-
-      auto embedinto_filename = conf.getEmbedIntoFileName();
-      if (!embedinto_filename.empty()) {
-        mPrimGen->embedInto(embedinto_filename);
+      if (!gen.stack) {
+        gen.stack = std::make_unique<o2::data::Stack>();
+        gen.stack->setExternalMode(true);
+      }
+      gen.generator->SetEvent(&gen.header);
+      gen.concurrent = ngenerators > 1 && gen.generator->canGenerateConcurrently();
+      if (gen.concurrent) {
+        // the particle table is read lazily on first lookup; do it before the threads use it
+        TDatabasePDG::Instance()->GetParticle(2212);
       }
-
-      mPrimGen->Init();
-
-      mPrimGeneratorCache[conf.getGenerator()] = mPrimGen;
     }
-    mPrimGen->SetEvent(&mEventHeader);
+    mPrimGeneratorCache[conf.getGenerator()] = cached;
+    // generator initialization may draw from gRandom; leave it with the configured seed
+    o2::utils::RngHelper::setGRandomSeed(mInitialSeed);
 
     // A good moment to couple to collision context
     auto collContextFileName = mSimConfig.getConfigData().mFromCollisionContext;
@@ -155,46 +180,153 @@ class O2PrimaryServerDevice final : public fair::mq::Device
       }
     }
 
-    LOG(info) << "Generator initialization took " << timer.CpuTime() << "s";
+    LOG(info) << "Generator initialization took " << timer.CpuTime() << "s" << " for " << mGenerators.size() << " instance(s)";
     if (mMaxEvents > 0) {
-      generateEvent(); // generate a first event
+      startEventGeneration();
+      stateTransition(O2PrimaryServerState::ReadyToServe, "INITGEN");
     }
   }
 
-  // function generating one event
-  void generateEvent(/*bool changeState = false*/)
+  static bool isFileBasedGenerator(std::string const& name)
   {
-    bool changeState = true; // false;
-    LOG(info) << "Event generation started ";
-    if (changeState) {
-      stateTransition(O2PrimaryServerState::WaitingEvent, "GENEVENT");
+    return name == "extkin" || name == "extkinO2" || name == "hepmc";
+  }
+
+  // creates and initializes one instance of the configured primary generator
+  o2::eventgen::PrimaryGenerator* createGenerator(o2::ccdb::BasicCCDBManager& ccdbmgr)
+  {
+    const auto& conf = mSimConfig;
+    auto primgen = new o2::eventgen::PrimaryGenerator;
+    o2::eventgen::GeneratorFactory::setPrimaryGenerator(conf, primgen);
+
+    // setup vertexing
+    auto vtxMode = conf.getVertexMode();
+    using o2::conf::VertexMode;
+    if (vtxMode == VertexMode::kNoVertex || vtxMode == VertexMode::kDiamondParam) {
+      primgen->setVertexMode(vtxMode);
+    } else if (vtxMode == VertexMode::kCCDB) {
+      // we need to fetch the CCDB object
+      primgen->setVertexMode(vtxMode, ccdbmgr.getForTimeStamp<o2::dataformats::MeanVertexObject>("GLO/Calib/MeanVertex", conf.getTimestamp()));
+    } else {
+      LOG(fatal) << "Unsupported vertex mode";
     }
+
+    auto embedinto_filename = conf.getEmbedIntoFileName();
+    if (!embedinto_filename.empty()) {
+      primgen->embedInto(embedinto_filename);
+    }
+
+    primgen->Init();
+    return primgen;
+  }
+
+  // seed of the random engines for the given event, derived from the initial seed only
+  // such that the event content does not depend on the generator instance producing it
+  ULong_t eventSeed(int eventID) const
+  {
+    uint64_t z = mInitialSeed + 0x9e3779b97f4a7c15ULL * eventID; // splitmix64 finalizer
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return z ? z : 1; // 0 would mean a random seed for TRandom3
+  }
+
+  // function generating one event with the given generator instance
+  std::unique_ptr<GeneratedEvent> generateEvent(GeneratorInstance& gen, int eventID)
+  {
+    LOG(info) << "Event generation started for event " << eventID;
     TStopwatch timer;
     timer.Start();
+    // instances using gRandom or the ROOT interpreter (e.g. external generators or triggers)
+    // share them, hence these generate one at a time; the others only use their own engines
+    std::unique_lock<std::mutex> genlock(mGenerationMutex, std::defer_lock);
+    if (!gen.concurrent) {
+      genlock.lock();
+    }
     try {
-      mStack->Reset();
+      // with several instances each event is seeded by its ID; a single instance keeps
+      // drawing from the engines seeded at initialization, as before
+      if (mGenerators.size() > 1) {
+        const auto seed = eventSeed(eventID);
+        if (!gen.concurrent) {
+          gRandom->SetSeed(seed);
+        }
+        gen.generator->setEventSeed(seed);
+      }
+      gen.stack->Reset();
       // see if we the vertex comes from the collision context
       if (mCollissionContext) {
         const auto& vertices = mCollissionContext->getInteractionVertices();
         if (vertices.size() > 0) {
-          auto collisionindex = mEventID_to_CollID.at(mEventCounter);
+          auto collisionindex = mEventID_to_CollID.at(eventID - 1);
           auto& vertex = vertices.at(collisionindex);
-          LOG(info) << "Setting vertex " << vertex << " for event " << mEventCounter << " for prefix " << mSimConfig.getOutPrefix();
-          mPrimGen->setExternalVertexForNextEvent(vertex.X(), vertex.Y(), vertex.Z());
+          LOG(info) << "Setting vertex " << vertex << " for event " << eventID << " for prefix " << mSimConfig.getOutPrefix();
+          gen.generator->setExternalVertexForNextEvent(vertex.X(), vertex.Y(), vertex.Z());
         }
       }
-      mPrimGen->GenerateEvent(mStack);
+      gen.generator->GenerateEvent(gen.stack.get());
     } catch (std::exception const& e) {
       LOG(error) << " Exception occurred during event gen " << e.what();
     }
+    auto event = std::make_unique<GeneratedEvent>();
+    event->primaries = gen.stack->getPrimaries();
+    event->header = gen.header;
     timer.Stop();
     LOG(info) << "Event generation took " << timer.CpuTime() << "s"
-              << " and produced " << mStack->getPrimaries().size() << " primaries ";
-    if (changeState) {
-      stateTransition(O2PrimaryServerState::ReadyToServe, "GENEVENT");
+              << " and produced " << event->primaries.size() << " primaries ";
+    return event;
+  }
+
+  // loop of a generator thread; instance k produces the events k+1, k+1+K, ... so that
+  // the assignment of events to generator instances does not depend on timing; events are
+  // queued by ID and served in order
+  void generationLoop(int instance)
+  {
+    auto& gen = mGenerators[instance];
+    const int ninstances = mGenerators.size();
+    for (int eventID = instance + 1; eventID <= mMaxEvents; eventID += ninstances) {
+      {
+        // bound the number of events generated ahead of the one being served
+        std::unique_lock<std::mutex> lock(mEventQueueMutex);
+        mEventQueueCondition.wait(lock, [&]() { return mStopGeneration || eventID - mEventCounter <= mGenQueueDepth; });
+        if (mStopGeneration) {
+          return;
+        }
+      }
+      auto event = generateEvent(gen, eventID);
+      {
+        std::lock_guard<std::mutex> lock(mEventQueueMutex);
+        mEventQueue[eventID] = std::move(event);
+      }
+      mEventQueueCondition.notify_all();
     }
   }
 
+  void startEventGeneration()
+  {
+    mGenQueueDepth = std::max(1, mSimConfig.getGenQueueDepth());
+    mStopGeneration = false;
+    for (int instance = 0; instance < mGenerators.size(); ++instance) {
+      mGenerationThreads.emplace_back(&O2PrimaryServerDevice::generationLoop, this, instance);
+    }
+  }
+
+  void stopEventGeneration()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mEventQueueMutex);
+      mStopGeneration = true;
+    }
+    mEventQueueCondition.notify_all();
+    for (auto& t : mGenerationThreads) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    mGenerationThreads.clear();
+    mEventQueue.clear();
+  }
+
   // launches a thread that listens for status requests from outside asynchronously
   void launchInfoThread()
   {
@@ -262,9 +394,6 @@ class O2PrimaryServerDevice final : public fair::mq::Device
     // from now on mSimConfig should be used within this process
     mSimConfig = conf;
 
-    mStack = new o2::data::Stack();
-    mStack->setExternalMode(true);
-
     // MC ENGINE
     LOG(info) << "ENGINE SET TO " << vm["mcEngine"].as<std::string>();
     // CHUNK SIZE
@@ -360,6 +489,7 @@ class O2PrimaryServerDevice final : public fair::mq::Device
     mSimConfig.getConfigData().mTrigger = reconfig.trigger;
     mSimConfig.getConfigData().mExtKinFileName = reconfig.extKinfileName;
 
+    stopEventGeneration();
     mEventCounter = 0;
     mPartCounter = 0;
     mNeedNewEvent = true;
@@ -471,6 +601,33 @@ class O2PrimaryServerDevice final : public fair::mq::Device
       workavailable = false;
     }
 
+    if (workavailable && mNeedNewEvent) {
+      // we need a newly generated event now; take it from the queue in event order
+      std::unique_lock<std::mutex> lock(mEventQueueMutex);
+      auto iter = mEventQueue.find(mEventCounter + 1);
+      if (iter == mEventQueue.end()) {
+        stateTransition(O2PrimaryServerState::WaitingEvent, "HANDLEREQUEST");
+        LOG(info) << "Waiting for event generation do become fully available";
+        mEventQueueCondition.wait(lock, [&]() { return mStopGeneration || (iter = mEventQueue.find(mEventCounter + 1)) != mEventQueue.end(); });
+      }
+      if (iter == mEventQueue.end()) {
+        // generation was stopped while waiting: no event to serve
+        workavailable = false;
+      } else {
+        if (mState == O2PrimaryServerState::WaitingEvent) {
+          stateTransition(O2PrimaryServerState::ReadyToServe, "HANDLEREQUEST");
+        }
+        mCurrentEvent = std::move(iter->second);
+        mEventQueue.erase(iter);
+        mNeedNewEvent = false;
+        mPartCounter = 0;
+        mEventCounter++;
+        lock.unlock();
+        // a generator might be waiting for space in the queue
+        mEventQueueCondition.notify_all();
+      }
+    }
+
     PrimaryChunkAnswer header{mState, workavailable};
     fair::mq::Parts reply;
     std::unique_ptr<fair::mq::Message> headermsg(channel.NewSimpleMessage(header));
@@ -479,33 +636,13 @@ class O2PrimaryServerDevice final : public fair::mq::Device
     LOG(debug) << "Received request for work " << mEventCounter << " " << mMaxEvents << " " << mNeedNewEvent << " available " << workavailable;
     if (workavailable) {
 
-      if (mNeedNewEvent) {
-        // we need a newly generated event now
-        if (mGeneratorThread.joinable()) {
-          try {
-            mGeneratorThread.join();
-          } catch (std::exception const& e) {
-            LOG(warn) << "Exception during thread join ..ignoring";
-          }
-        }
-        // also if we are still in event waiting stage (doing some busy sleep)
-        while (mState.load() == O2PrimaryServerState::WaitingEvent) {
-          LOG(info) << "Waiting for event generation do become fully available";
-          usleep(100);
-        }
-        mNeedNewEvent = false;
-        mPartCounter = 0;
-        mEventCounter++;
-      }
-
-      auto& prims = mStack->getPrimaries();
+      auto& prims = mCurrentEvent->primaries;
       auto numberofparts = (int)std::ceil(prims.size() / (1. * mChunkGranularity));
       // number of parts should be at least 1 (even if empty)
       numberofparts = std::max(1, numberofparts);
 
       LOG(debug) << "Have " << prims.size() << " " << numberofparts;
 
-      o2::data::PrimaryChunk m;
       o2::data::SubEventInfo i;
       i.eventID = workavailable ? mEventCounter : -1;
       i.maxEvents = mMaxEvents;
@@ -513,9 +650,8 @@ class O2PrimaryServerDevice final : public fair::mq::Device
       i.nparts = numberofparts;
 
       i.seed = mUseFixedChunkSeed ? mFixedChunkSeed : mEventCounter + mInitialSeed;
-      i.index = m.mParticles.size();
-      i.mMCEventHeader = mEventHeader;
-      m.mSubEventInfo = i;
+      i.index = 0;
+      i.mMCEventHeader = mCurrentEvent->header;
 
       int endindex = prims.size() - mPartCounter * mChunkGranularity;
       int startindex = prims.size() - (mPartCounter + 1) * mChunkGranularity;
@@ -528,11 +664,15 @@ class O2PrimaryServerDevice final : public fair::mq::Device
         endindex = 0;
       }
 
+      // the particles are sent as a flat array, filled in place in the message
+      const int nparticles = std::max(0, endindex - startindex);
+      std::unique_ptr<fair::mq::Message> particlemessage(channel.NewMessage(nparticles * sizeof(o2::data::FlatParticle), fair::mq::Alignment{64}));
+      auto flatparticles = reinterpret_cast<o2::data::FlatParticle*>(particlemessage->GetData());
       for (int index = startindex; index < endindex; ++index) {
-        m.mParticles.emplace_back(prims[index]);
+        new (flatparticles++) o2::data::FlatParticle(prims[index]);
       }
 
-      LOG(info) << "Sending " << m.mParticles.size() << " particles";
+      LOG(info) << "Sending " << nparticles << " particles";
       LOG(info) << "treating ev " << mEventCounter << " part " << i.part << " out of " << i.nparts;
 
       // feedback to driver if new event started
@@ -544,20 +684,19 @@ class O2PrimaryServerDevice final : public fair::mq::Device
       mPartCounter++;
       if (mPartCounter == numberofparts) {
         mNeedNewEvent = true;
-        // start generation of a new event
-        if (mEventCounter < mMaxEvents) {
-          mGeneratorThread = std::thread(&O2PrimaryServerDevice::generateEvent, this);
-        }
+        mCurrentEvent.reset();
       }
 
+      // only the sub-event info (containing the MC event header) is ROOT streamed
       TMessage* tmsg = new TMessage(kMESS_OBJECT);
-      tmsg->WriteObjectAny((void*)&m, TClass::GetClass("o2::data::PrimaryChunk"));
+      tmsg->WriteObjectAny((void*)&i, TClass::GetClass("o2::data::SubEventInfo"));
 
       auto free_tmessage = [](void* data, void* hint) { delete static_cast<TMessage*>(hint); };
 
       std::unique_ptr<fair::mq::Message> message(channel.NewMessage(tmsg->Buffer(), tmsg->BufferSize(), free_tmessage, tmsg));
 
       reply.AddPart(std::move(message));
+      reply.AddPart(std::move(particlemessage));
     }
 
     // send answer
@@ -628,10 +767,9 @@ class O2PrimaryServerDevice final : public fair::mq::Device
 
  private:
   o2::conf::SimConfig mSimConfig = o2::conf::SimConfig::Instance(); // local sim config object
-  o2::eventgen::PrimaryGenerator* mPrimGen = nullptr;               // the current primary generator
-  o2::dataformats::MCEventHeader mEventHeader;
-  o2::data::Stack* mStack = nullptr; // the stack which is filled (pointer since constructor to be called only init method)
-  int mChunkGranularity = 500;       // how many primaries to send to a worker
+  std::vector<GeneratorInstance> mGenerators;                       // the independent primary generator instances
+  std::unique_ptr<GeneratedEvent> mCurrentEvent;                    // the event currently being served
+  int mChunkGranularity = 500;                                      // how many primaries to send to a worker
   int mPartCounter = 0;
   bool mNeedNewEvent = true;
   int mMaxEvents = 2;
@@ -641,9 +779,17 @@ class O2PrimaryServerDevice final : public fair::mq::Device
   int mPipeToDriver = -1; // handle for direct piper to driver (to communicate meta info)
   int mEventCounter = 0;
 
-  std::thread mGeneratorThread; //! a thread used to concurrently init the particle generator
-                                //  or to generate events
-  std::thread mControlThread;   //! a thread used to wait for control commands
+  std::thread mGeneratorThread;                 //! a thread used to concurrently init the particle generator
+  std::thread mControlThread;                   //! a thread used to wait for control commands
+  std::vector<std::thread> mGenerationThreads;  //! one event generation thread per generator instance
+
+  // queue of events generated ahead, keyed by event ID
+  std::map<int, std::unique_ptr<GeneratedEvent>> mEventQueue; //!
+  std::mutex mEventQueueMutex;                                //!
+  std::condition_variable mEventQueueCondition;               //!
+  int mGenQueueDepth = 1;                                     // max number of events generated ahead of the served one
+  bool mStopGeneration = false;                               // protected by mEventQueueMutex
+  std::mutex mGenerationMutex;                                //! serializes the instances using the shared gRandom
 
   // Keeps various generators instantiated in memory
   // useful when running simulation as a service (when generators
@@ -651,7 +797,7 @@ class O2PrimaryServerDevice final : public fair::mq::Device
   // TODO: some care needs to be taken (or the user warned) that the caching is based on generator name
   //       and that parameter-based reconfiguration is not yet implemented (for which we would need to hash all
   //       configuration parameters as well)
-  std::map<std::string, o2::eventgen::PrimaryGenerator*> mPrimGeneratorCache;
+  std::map<std::string, std::vector<o2::eventgen::PrimaryGenerator*>> mPrimGeneratorCache;
 
   std::atomic<O2PrimaryServerState> mState{O2PrimaryServerState::Initializing};
   std::atomic<int> mWaitingControlInput{0};
@@ -235,29 +235,42 @@ class O2SimDevice final : public fair::mq::Device
           // we need to decide what to do when the server is idle ---> if this happens immediately after a new batch request it means that the server might just lag a bit behind
           return false;
         } else {
-          auto payload = std::move(reply.At(1));
+          // part 1: ROOT streamed sub-event info; part 2: flat array of primaries
+          auto infopayload = std::move(reply.At(1));
+          auto particlepayload = std::move(reply.At(2));
           // wrap incoming bytes as a TMessageWrapper which offers "adoption" of a buffer
-          auto message = new TMessageWrapper(payload->GetData(), payload->GetSize());
-          auto chunk = static_cast<o2::data::PrimaryChunk*>(message->ReadObjectAny(message->GetClass()));
+          auto message = new TMessageWrapper(infopayload->GetData(), infopayload->GetSize());
+          auto subeventinfo = static_cast<o2::data::SubEventInfo*>(message->ReadObjectAny(message->GetClass()));
+
+          const auto nparticles = particlepayload->GetSize() / sizeof(o2::data::FlatParticle);
+          const auto particledata = static_cast<const char*>(particlepayload->GetData());
+          std::vector<TParticle> particles;
+          particles.reserve(nparticles);
+          for (size_t k = 0; k < nparticles; ++k) {
+            // the receive buffer is not guaranteed to be aligned
+            o2::data::FlatParticle flat;
+            std::memcpy(&flat, particledata + k * sizeof(o2::data::FlatParticle), sizeof(o2::data::FlatParticle));
+            particles.emplace_back(flat.toTParticle());
+          }
 
           bool goon = true;
           // no particles and eventID == -1 --> indication for no more work
-          if (chunk->mParticles.size() == 0 && chunk->mSubEventInfo.eventID == -1) {
+          if (particles.size() == 0 && subeventinfo->eventID == -1) {
             doLogInfo(workerID, "No particles in reply : quitting kernel");
             goon = false;
           }
 
           if (goon) {
-            mVMCApp->setPrimaries(chunk->mParticles);
+            mVMCApp->setPrimaries(particles);
 
-            auto info = chunk->mSubEventInfo;
+            auto info = *subeventinfo;
             mVMCApp->setSubEventInfo(&info);
 
-            LOG(info) << workerStr() << " Processing " << chunk->mParticles.size() << " primary particles "
+            LOG(info) << workerStr() << " Processing " << particles.size() << " primary particles "
                       << "for event " << info.eventID << "/" << info.maxEvents << " "
                       << "part " << info.part << "/" << info.nparts;
-            LOG(info) << workerStr() << " Setting seed for this sub-event to " << chunk->mSubEventInfo.seed;
-            gRandom->SetSeed(chunk->mSubEventInfo.seed);
+            LOG(info) << workerStr() << " Setting seed for this sub-event to " << info.seed;
+            gRandom->SetSeed(info.seed);
             o2::base::VMCSeederService::instance().setSeed();
 
             // Process one event
@@ -279,7 +292,7 @@ class O2SimDevice final : public fair::mq::Device
                       << sysinfo.GetMaxMemory() << " MB\n";
           }
           delete message;
-          delete chunk;
+          delete subeventinfo;
         }
       } else {
         LOG(info) << workerStr() << " No primary answer received from server (within timeout). Return code " << code;
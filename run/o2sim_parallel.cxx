@@ -680,8 +680,11 @@ int main(int argc, char* argv[])
     setenv("ALICE_O2SIMMERGERTODRIVER_PIPE", std::to_string(pipe_mergerdriver_fd[1]).c_str(), 1);
     const std::string name("o2-sim-hit-merger-runner");
     const std::string path = installpath + "/" + name;
+    // number of threads used to merge the hits of different detectors concurrently
+    auto mergerthreadsenv = getenv("ALICE_O2SIM_MERGERTHREADS");
+    const std::string mergerthreads = mergerthreadsenv ? mergerthreadsenv : "1";
     execl(path.c_str(), name.c_str(), "--control", "static", "--catch-signals", "0", "--id", "hitmerger", "--mq-config", localconfig.c_str(), "--color", "false",
-          (char*)nullptr);
+          "--merger-threads", mergerthreads.c_str(), (char*)nullptr);
     return 0;
   } else {
     std::cout << "Spawning hit merger on PID " << pid << "; Redirect output to " << getMergerLogName() << "\n";